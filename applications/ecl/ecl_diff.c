@@ -0,0 +1,105 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_diff.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_kw_diff.h>
+
+
+void usage(const char * exe) {
+  fprintf(stderr,"\n");
+  fprintf(stderr,"Usage: %s [-a abs_epsilon] [-r rel_epsilon] [-v] FILE1 FILE2\n\n", exe);
+  fprintf(stderr,"Will compare all the keywords in the two ECLIPSE files FILE1 and FILE2, e.g.\n");
+  fprintf(stderr,"restart or INIT files from two different simulator versions. For every\n");
+  fprintf(stderr,"keyword which differs the number of differing elements, the first\n");
+  fprintf(stderr,"differing element and the largest absolute and relative difference is\n");
+  fprintf(stderr,"printed. Without tolerances the values must be exactly equal.\n\n");
+  fprintf(stderr,"  -a abs_epsilon : Values with absolute difference above abs_epsilon differ.\n");
+  fprintf(stderr,"  -r rel_epsilon : Values with relative difference above rel_epsilon differ.\n");
+  fprintf(stderr,"  -v             : Print the equal keywords as well.\n\n");
+  fprintf(stderr,"The exit status is 0 if the files are equal and 1 otherwise.\n");
+  exit(2);
+}
+
+
+int main(int argc , char ** argv) {
+  double abs_epsilon = 0;
+  double rel_epsilon = 0;
+  bool   verbose     = false;
+  const char * file1 = NULL;
+  const char * file2 = NULL;
+  int iarg = 1;
+
+  while (iarg < argc) {
+    const char * arg = argv[iarg];
+    if (strcmp(arg , "-a") == 0 && (iarg + 1 < argc)) {
+      if (!util_sscanf_double( argv[iarg + 1] , &abs_epsilon ))
+        usage( argv[0] );
+      iarg += 2;
+    } else if (strcmp(arg , "-r") == 0 && (iarg + 1 < argc)) {
+      if (!util_sscanf_double( argv[iarg + 1] , &rel_epsilon ))
+        usage( argv[0] );
+      iarg += 2;
+    } else if (strcmp(arg , "-v") == 0) {
+      verbose = true;
+      iarg++;
+    } else if (file1 == NULL) {
+      file1 = arg;
+      iarg++;
+    } else if (file2 == NULL) {
+      file2 = arg;
+      iarg++;
+    } else
+      usage( argv[0] );
+  }
+
+  if (file2 == NULL)
+    usage( argv[0] );
+
+  {
+    ecl_file_type * ecl_file1 = ecl_file_open( file1 , 0 );
+    ecl_file_type * ecl_file2 = ecl_file_open( file2 , 0 );
+    ecl_file_diff_type * diff;
+    bool equal;
+
+    if (!ecl_file1 || !ecl_file2) {
+      fprintf(stderr,"Failed to open: %s \n", ecl_file1 ? file2 : file1);
+      exit(2);
+    }
+
+    diff = ecl_file_diff_alloc( ecl_file1 , ecl_file2 , abs_epsilon , rel_epsilon );
+    ecl_file_diff_fprintf( diff , stdout , verbose );
+    equal = ecl_file_diff_equal( diff );
+    printf("%d of %d keywords differ\n", ecl_file_diff_get_num_different( diff ) , ecl_file_diff_get_size( diff ));
+
+    ecl_file_diff_free( diff );
+    ecl_file_close( ecl_file1 );
+    ecl_file_close( ecl_file2 );
+
+    if (equal)
+      exit(0);
+    else
+      exit(1);
+  }
+}
@@ -123,6 +123,8 @@
 
 #define ECL_FILE_ID 776107
 
+#define ECL_FILE_DEFAULT_MAX_OPEN_STREAMS 16
+
 
 
 
@@ -138,6 +140,9 @@ struct ecl_file_struct {
   int             flags;
   vector_type   * map_stack;
   inv_map_type  * inv_view;
+  vector_type   * fortio_list;    /* All the fortio sources when the keywords come from several files; fortio is then the first element. */
+  ecl_file_stream_pool_type * stream_pool;
+  ecl_file_kw_cache_type    * kw_cache;   /* LRU list and memory budget for the loaded keywords of all the views. */
 };
 
 
@@ -182,7 +187,12 @@ ecl_file_type * ecl_file_alloc_empty( int flags ) {
   UTIL_TYPE_ID_INIT(ecl_file , ECL_FILE_ID);
   ecl_file->map_stack = vector_alloc_new();
   ecl_file->inv_view  = inv_map_alloc( );
+  ecl_file->kw_cache  = ecl_file_kw_cache_alloc( ecl_file->inv_view );
   ecl_file->flags     = flags;
+  ecl_file->fortio_list = NULL;
+  ecl_file->stream_pool = NULL;
+  ecl_file->global_view = NULL;
+  ecl_file->active_view = NULL;
   return ecl_file;
 }
 
@@ -505,6 +515,13 @@ ecl_file_view_type * ecl_file_get_summary_view( ecl_file_type * ecl_file , int r
 */
 
 /**
+   The ecl_file_scan__() function will scan through the file from
+   @start_offset and add all the keyword headers to @file_view. If
+   @stop_kw is non NULL the scan will stop at the first occurence of
+   @stop_kw which is not the first keyword of the scan, and the offset
+   of that keyword is returned in *@stop_offset; *@stop_offset is set
+   to -1 if the scan reaches the end of the file.
+
    The ecl_file_scan() function will scan through the whole file and
    build up an index of all the kewyords. The map created from this
    scan will be stored under the 'global_view' field; and all
@@ -512,30 +529,46 @@ ecl_file_view_type * ecl_file_get_summary_view( ecl_file_type * ecl_file , int r
    map.
 */
 
-static bool ecl_file_scan( ecl_file_type * ecl_file ) {
+static bool ecl_file_scan__( fortio_type * fortio , ecl_file_view_type * file_view , offset_type start_offset , const char * stop_kw , offset_type * stop_offset) {
   bool scan_ok = false;
-  fortio_fseek( ecl_file->fortio , 0 , SEEK_SET );
+  int num_kw = 0;
+
+  if (stop_offset)
+    *stop_offset = -1;
+
+  fortio_fseek( fortio , start_offset , SEEK_SET );
   {
     ecl_kw_type * work_kw = ecl_kw_alloc_new("WORK-KW" , 0 , ECL_INT , NULL);
 
     while (true) {
-      if (fortio_read_at_eof(ecl_file->fortio)) {
+      if (fortio_read_at_eof(fortio)) {
         scan_ok = true;
         break;
       }
 
       {
-        offset_type current_offset = fortio_ftell( ecl_file->fortio );
-        ecl_read_status_enum read_status = ecl_kw_fread_header( work_kw , ecl_file->fortio);
+        offset_type current_offset = fortio_ftell( fortio );
+        ecl_read_status_enum read_status = ecl_kw_fread_header( work_kw , fortio);
         if (read_status == ECL_KW_READ_FAIL)
           break;
 
         if (read_status == ECL_KW_READ_OK) {
-          ecl_file_kw_type * file_kw = ecl_file_kw_alloc( work_kw , current_offset);
-          if (ecl_file_kw_fskip_data( file_kw , ecl_file->fortio ))
-            ecl_file_view_add_kw( ecl_file->global_view , file_kw );
-          else
+          if (stop_kw && (num_kw > 0) && ecl_kw_name_equal( work_kw , stop_kw )) {
+            *stop_offset = current_offset;
+            scan_ok = true;
             break;
+          }
+
+          {
+            ecl_file_kw_type * file_kw = ecl_file_kw_alloc( work_kw , current_offset);
+            if (ecl_file_kw_fskip_data( file_kw , fortio )) {
+              ecl_file_view_add_kw( file_view , file_kw );
+              num_kw++;
+            } else {
+              ecl_file_kw_free( file_kw );
+              break;
+            }
+          }
         }
       }
     }
@@ -543,12 +576,17 @@ static bool ecl_file_scan( ecl_file_type * ecl_file ) {
     ecl_kw_free( work_kw );
   }
   if (scan_ok)
-    ecl_file_view_make_index( ecl_file->global_view );
+    ecl_file_view_make_index( file_view );
 
   return scan_ok;
 }
 
 
+static bool ecl_file_scan( ecl_file_type * ecl_file ) {
+  return ecl_file_scan__( ecl_file->fortio , ecl_file->global_view , 0 , NULL , NULL );
+}
+
+
 void ecl_file_select_global( ecl_file_type * ecl_file ) {
   ecl_file->active_view = ecl_file->global_view;
 }
@@ -589,6 +627,7 @@ ecl_file_type * ecl_file_open( const char * filename , int flags) {
     ecl_file_type * ecl_file = ecl_file_alloc_empty( flags );
     ecl_file->fortio = fortio;
     ecl_file->global_view = ecl_file_view_alloc( ecl_file->fortio , &ecl_file->flags , ecl_file->inv_view , true );
+    ecl_file_view_set_kw_cache( ecl_file->global_view , ecl_file->kw_cache );
 
     if (ecl_file_scan( ecl_file )) {
       ecl_file_select_global( ecl_file );
@@ -638,12 +677,19 @@ bool ecl_file_writable( const ecl_file_type * ecl_file ) {
 */
 
 void ecl_file_close(ecl_file_type * ecl_file) {
-  if (ecl_file->fortio != NULL)
+  if (ecl_file->fortio_list != NULL)
+    vector_free( ecl_file->fortio_list );
+  else if (ecl_file->fortio != NULL)
     fortio_fclose( ecl_file->fortio  );
 
   if (ecl_file->global_view)
     ecl_file_view_free( ecl_file->global_view );
 
+  if (ecl_file->stream_pool)
+    ecl_file_stream_pool_free( ecl_file->stream_pool );
+
+  ecl_file_kw_cache_free( ecl_file->kw_cache );
+
   inv_map_free( ecl_file->inv_view );
   vector_free( ecl_file->map_stack );
   free( ecl_file );
@@ -651,7 +697,11 @@ void ecl_file_close(ecl_file_type * ecl_file) {
 
 
 void ecl_file_close_fortio_stream(ecl_file_type * ecl_file) {
-    if (ecl_file->fortio != NULL) {
+    if (ecl_file->fortio_list != NULL) {
+        int i;
+        for (i = 0; i < vector_get_size( ecl_file->fortio_list ); i++)
+            fortio_fclose_stream( vector_iget( ecl_file->fortio_list , i ));
+    } else if (ecl_file->fortio != NULL) {
         fortio_fclose_stream(ecl_file->fortio);
     }
 }
@@ -668,7 +718,11 @@ void ecl_file_close_fortio_stream(ecl_file_type * ecl_file) {
 
 
 void ecl_file_fortio_detach( ecl_file_type * ecl_file ) {
-  fortio_fclose( ecl_file->fortio );
+  if (ecl_file->fortio_list != NULL) {
+    vector_free( ecl_file->fortio_list );
+    ecl_file->fortio_list = NULL;
+  } else
+    fortio_fclose( ecl_file->fortio );
   ecl_file->fortio = NULL;
 }
 
@@ -947,59 +1001,6 @@ bool ecl_file_select_rstblock_report_step( ecl_file_type * ecl_file , int report
 }
 
 
-/******************************************************************/
-
-static ecl_file_type * ecl_file_open_rstblock_report_step__( const char * filename , int report_step , int flags) {
-  ecl_file_type * ecl_file = ecl_file_open( filename , flags );
-  if (ecl_file) {
-    if (!ecl_file_select_rstblock_report_step( ecl_file , report_step )) {
-      ecl_file_close( ecl_file );
-      ecl_file = NULL;
-    }
-  }
-  return ecl_file;
-}
-
-ecl_file_type * ecl_file_open_rstblock_report_step( const char * filename , int report_step , int flags) {
-  return ecl_file_open_rstblock_report_step__(filename , report_step , flags );
-}
-
-
-/******************************************************************/
-
-static ecl_file_type * ecl_file_open_rstblock_sim_time__( const char * filename , time_t sim_time, int flags ) {
-  ecl_file_type * ecl_file = ecl_file_open( filename , flags );
-  if (ecl_file) {
-    if (!ecl_file_select_rstblock_sim_time( ecl_file , sim_time)) {
-      ecl_file_close( ecl_file );
-      ecl_file = NULL;
-    }
-  }
-  return ecl_file;
-}
-
-ecl_file_type * ecl_file_open_rstblock_sim_time( const char * filename , time_t sim_time, int flags) {
-  return ecl_file_open_rstblock_sim_time__( filename , sim_time , flags );
-}
-
-/******************************************************************/
-
-static ecl_file_type * ecl_file_iopen_rstblock__( const char * filename , int seqnum_index, int flags ) {
-  ecl_file_type * ecl_file = ecl_file_open( filename , flags );
-  if (ecl_file) {
-    if (!ecl_file_iselect_rstblock( ecl_file , seqnum_index )) {
-      ecl_file_close( ecl_file );
-      ecl_file = NULL;
-    }
-  }
-  return ecl_file;
-}
-
-
-ecl_file_type * ecl_file_iopen_rstblock( const char * filename , int seqnum_index , int flags) {
-  return ecl_file_iopen_rstblock__(filename , seqnum_index , flags );
-}
-
 static bool ecl_file_index_valid0(const char * file_name, const char * index_file_name) {
   if ( !util_file_exists( file_name ))
     return false;
@@ -1041,7 +1042,11 @@ bool ecl_file_index_valid(const char * file_name, const char * index_file_name)
 
 
 bool  ecl_file_write_index( const ecl_file_type * ecl_file , const char * index_filename) {
-  FILE * ostream = fopen(index_filename, "wb");
+  FILE * ostream;
+  if (ecl_file->fortio_list)
+    return false;   /* The index format can only reference one file. */
+
+  ostream = fopen(index_filename, "wb");
   if (!ostream)
     return false;
   {
@@ -1072,6 +1077,7 @@ ecl_file_type * ecl_file_fast_open(const char * file_name, const char * index_fi
       ecl_file->fortio = fortio;
       ecl_file->global_view = ecl_file_view_fread_alloc( ecl_file->fortio , &ecl_file->flags , ecl_file->inv_view , istream );
       if (ecl_file->global_view) {
+        ecl_file_view_set_kw_cache( ecl_file->global_view , ecl_file->kw_cache );
         ecl_file_select_global( ecl_file );
         if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_CLOSE_STREAM))
           fortio_fclose_stream( ecl_file->fortio );
@@ -1085,3 +1091,498 @@ ecl_file_type * ecl_file_fast_open(const char * file_name, const char * index_fi
   fclose(istream);
   return ecl_file;
 }
+
+
+/******************************************************************/
+/*
+  Opening one block of a unified restart file
+  -------------------------------------------
+
+  The ecl_file_open_rstblock_xxx() functions do not scan the whole
+  file. The returned ecl_file instance only contains the keywords of
+  the selected SEQNUM block, i.e. the global view of the ecl_file
+  instance is the block, and the active view is the block selected
+  with ecl_file_iselect_rstblock( ecl_file , 0 ).
+
+  If the file has a valid SEQNUM index, see
+  ecl_file_write_rstblock_index(), the offset of the block is taken
+  from the index and only the keyword headers of the selected block
+  are read. Otherwise the file is scanned one block at a time from the
+  start, and the scan stops at the end of the selected block; the
+  headers of the keywords after the block are never read.
+
+  The SEQNUM index is a small binary file with the name of the restart
+  file with the extension ".seqnum_index", containing the offset,
+  report step and simulation time of each SEQNUM block. The index is
+  only used if it is newer than the restart file, and the size of the
+  restart file agrees with the size recorded in the index.
+*/
+
+typedef struct {
+  int           size;
+  offset_type * offset;
+  int         * report_step;
+  time_t      * sim_time;
+} ecl_file_rstblock_index_type;
+
+
+static char * ecl_file_alloc_rstblock_index_filename( const char * filename ) {
+  return util_alloc_sprintf("%s.seqnum_index" , filename);
+}
+
+
+static void ecl_file_rstblock_index_free( ecl_file_rstblock_index_type * index ) {
+  free( index->offset );
+  free( index->report_step );
+  free( index->sim_time );
+  free( index );
+}
+
+
+/*
+  Will return NULL if the file does not have a valid SEQNUM index.
+*/
+
+static ecl_file_rstblock_index_type * ecl_file_fread_alloc_rstblock_index( const char * filename ) {
+  ecl_file_rstblock_index_type * index = NULL;
+  char * index_filename = ecl_file_alloc_rstblock_index_filename( filename );
+
+  if (ecl_file_index_valid0( filename , index_filename )) {
+    FILE * istream = fopen( index_filename , "rb");
+    if (istream) {
+      if (ecl_file_index_valid1( filename , istream )) {
+        offset_type file_size;
+        util_fread( &file_size , sizeof file_size , 1 , istream , __func__);
+
+        if (file_size == util_file_size( filename )) {
+          int i;
+          index = util_malloc( sizeof * index );
+          index->size = util_fread_int( istream );
+          index->offset = util_calloc( util_int_max( 1 , index->size ) , sizeof * index->offset );
+          index->report_step = util_calloc( util_int_max( 1 , index->size ) , sizeof * index->report_step );
+          index->sim_time = util_calloc( util_int_max( 1 , index->size ) , sizeof * index->sim_time );
+
+          for (i = 0; i < index->size; i++) {
+            util_fread( &index->offset[i] , sizeof index->offset[i] , 1 , istream , __func__);
+            index->report_step[i] = util_fread_int( istream );
+            index->sim_time[i] = util_fread_time_t( istream );
+          }
+        }
+      }
+      fclose( istream );
+    }
+  }
+
+  free( index_filename );
+  return index;
+}
+
+
+/**
+   Will scan through the unified restart file @filename and write the
+   SEQNUM index used by the ecl_file_open_rstblock_xxx() functions. The
+   index must be rewritten if the restart file is modified.
+*/
+
+bool ecl_file_write_rstblock_index( const char * filename ) {
+  bool write_ok = false;
+  ecl_file_type * ecl_file = ecl_file_open( filename , 0 );
+
+  if (ecl_file) {
+    char * index_filename = ecl_file_alloc_rstblock_index_filename( filename );
+    FILE * ostream = fopen( index_filename , "wb");
+
+    if (ostream) {
+      const ecl_file_view_type * global_view = ecl_file->global_view;
+      const int num_seqnum = ecl_file_view_get_num_named_kw( global_view , SEQNUM_KW );
+      offset_type file_size = util_file_size( filename );
+      int i;
+
+      {
+        char * source_file = util_split_alloc_filename( filename );
+        util_fwrite_string( source_file , ostream );
+        free( source_file );
+      }
+      util_fwrite( &file_size , sizeof file_size , 1 , ostream , __func__);
+      util_fwrite_int( num_seqnum , ostream );
+
+      for (i = 0; i < num_seqnum; i++) {
+        const ecl_file_kw_type * seqnum_kw = ecl_file_view_iget_named_file_kw( global_view , SEQNUM_KW , i );
+        const ecl_rsthead_type * rsthead = ecl_file_view_iget_rsthead( global_view , i );
+        offset_type offset = ecl_file_kw_get_offset( seqnum_kw );
+        int report_step;
+        time_t sim_time = -1;
+
+        if (rsthead) {
+          report_step = rsthead->report_step;
+          sim_time = rsthead->sim_time;
+        } else
+          report_step = ecl_kw_iget_int( ecl_file_view_iget_named_kw( global_view , SEQNUM_KW , i ) , 0 );
+
+        util_fwrite( &offset , sizeof offset , 1 , ostream , __func__);
+        util_fwrite_int( report_step , ostream );
+        util_fwrite_time_t( sim_time , ostream );
+      }
+
+      fclose( ostream );
+      write_ok = true;
+    }
+    free( index_filename );
+    ecl_file_close( ecl_file );
+  }
+  return write_ok;
+}
+
+
+static bool ecl_file_rstblock_match( int block_nr , int report_step , time_t sim_time , int query_index , int query_report_step , time_t query_sim_time) {
+  if (query_report_step >= 0)
+    return (report_step == query_report_step);
+  else if (query_sim_time != -1)
+    return (sim_time == query_sim_time);
+  else
+    return (block_nr == query_index);
+}
+
+
+/*
+  Will scan one SEQNUM block starting at @offset into a temporary view
+  with its own inv_map; the keywords are copied to the global view of
+  @ecl_file if the block matches the query, otherwise they are
+  discarded. The offset of the next SEQNUM block, or -1, is returned
+  in *@next_offset.
+*/
+
+static bool ecl_file_scan_rstblock( ecl_file_type * ecl_file , offset_type offset , int * block_nr , int query_index , int query_report_step , time_t query_sim_time , offset_type * next_offset, bool * scan_ok) {
+  int flags = 0;
+  inv_map_type * inv_map = inv_map_alloc();
+  ecl_file_view_type * block_view = ecl_file_view_alloc( ecl_file->fortio , &flags , inv_map , true );
+  bool match = false;
+
+  *scan_ok = ecl_file_scan__( ecl_file->fortio , block_view , offset , SEQNUM_KW , next_offset );
+  if (*scan_ok && ecl_file_view_has_kw( block_view , SEQNUM_KW )) {
+    const ecl_rsthead_type * rsthead = NULL;
+    int report_step = -1;
+    time_t sim_time = -1;
+
+    if ((query_report_step >= 0) || (query_sim_time != -1))
+      rsthead = ecl_file_view_iget_rsthead( block_view , 0 );
+
+    if (rsthead) {
+      report_step = rsthead->report_step;
+      sim_time = rsthead->sim_time;
+    }
+
+    match = ecl_file_rstblock_match( *block_nr , report_step , sim_time , query_index , query_report_step , query_sim_time );
+    if (match) {
+      int i;
+      for (i = 0; i < ecl_file_view_get_size( block_view ); i++)
+        ecl_file_view_add_kw( ecl_file->global_view , ecl_file_kw_alloc_copy( ecl_file_view_iget_file_kw( block_view , i )));
+      ecl_file_view_make_index( ecl_file->global_view );
+    }
+    (*block_nr)++;
+  }
+
+  ecl_file_view_free( block_view );
+  inv_map_free( inv_map );
+  return match;
+}
+
+
+/*
+  The size and mtime checks of the SEQNUM index do not catch every
+  modification of the restart file; before an indexed offset is used
+  the keyword at the offset must be a SEQNUM keyword with the report
+  step from the index.
+*/
+
+static bool ecl_file_rstblock_index_check( fortio_type * fortio , offset_type offset , int report_step ) {
+  bool valid = false;
+
+  if (fortio_fseek( fortio , offset , SEEK_SET )) {
+    ecl_kw_type * work_kw = ecl_kw_alloc_new("WORK-KW" , 0 , ECL_INT , NULL);
+
+    if ((ecl_kw_fread_header( work_kw , fortio ) == ECL_KW_READ_OK) &&
+        ecl_kw_name_equal( work_kw , SEQNUM_KW ) &&
+        (ecl_kw_get_size( work_kw ) == 1) &&
+        ecl_type_is_int( ecl_kw_get_data_type( work_kw ))) {
+
+      fortio_fseek( fortio , offset , SEEK_SET );
+      {
+        ecl_kw_type * seqnum_kw = ecl_kw_fread_alloc( fortio );
+        if (seqnum_kw) {
+          valid = (ecl_kw_iget_int( seqnum_kw , 0 ) == report_step);
+          ecl_kw_free( seqnum_kw );
+        }
+      }
+    }
+    ecl_kw_free( work_kw );
+  }
+
+  return valid;
+}
+
+
+static ecl_file_type * ecl_file_open_rstblock__( const char * filename , int query_index , int query_report_step , time_t query_sim_time , int flags) {
+  fortio_type * fortio = ecl_file_alloc_fortio( filename , flags );
+  if (!fortio)
+    return NULL;
+
+  {
+    ecl_file_type * ecl_file = ecl_file_alloc_empty( flags );
+    ecl_file_rstblock_index_type * index = ecl_file_fread_alloc_rstblock_index( filename );
+    bool found = false;
+    bool use_index = (index != NULL);
+
+    ecl_file->fortio = fortio;
+    ecl_file->global_view = ecl_file_view_alloc( ecl_file->fortio , &ecl_file->flags , ecl_file->inv_view , true );
+    ecl_file_view_set_kw_cache( ecl_file->global_view , ecl_file->kw_cache );
+
+    if (index) {
+      int i;
+      for (i = 0; i < index->size; i++) {
+        if (ecl_file_rstblock_match( i , index->report_step[i] , index->sim_time[i] , query_index , query_report_step , query_sim_time )) {
+          if (ecl_file_rstblock_index_check( ecl_file->fortio , index->offset[i] , index->report_step[i] )) {
+            offset_type next_offset;
+            found = ecl_file_scan__( ecl_file->fortio , ecl_file->global_view , index->offset[i] , SEQNUM_KW , &next_offset );
+          } else
+            use_index = false;
+          break;
+        }
+      }
+      ecl_file_rstblock_index_free( index );
+    }
+
+    if (!use_index) {
+      offset_type offset = 0;
+      int block_nr = 0;
+
+      while (true) {
+        offset_type next_offset;
+        bool scan_ok;
+
+        found = ecl_file_scan_rstblock( ecl_file , offset , &block_nr , query_index , query_report_step , query_sim_time , &next_offset , &scan_ok );
+        if (found || !scan_ok || (next_offset < 0))
+          break;
+
+        offset = next_offset;
+      }
+    }
+
+    if (found && ecl_file_iselect_rstblock( ecl_file , 0 )) {
+      if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_CLOSE_STREAM))
+        fortio_fclose_stream( ecl_file->fortio );
+      return ecl_file;
+    } else {
+      ecl_file_close( ecl_file );
+      return NULL;
+    }
+  }
+}
+
+
+ecl_file_type * ecl_file_open_rstblock_report_step( const char * filename , int report_step , int flags) {
+  return ecl_file_open_rstblock__(filename , -1 , report_step , -1 , flags );
+}
+
+
+ecl_file_type * ecl_file_open_rstblock_sim_time( const char * filename , time_t sim_time, int flags) {
+  return ecl_file_open_rstblock__( filename , -1 , -1 , sim_time , flags );
+}
+
+
+ecl_file_type * ecl_file_iopen_rstblock( const char * filename , int seqnum_index , int flags) {
+  return ecl_file_open_rstblock__(filename , seqnum_index , -1 , -1 , flags );
+}
+
+
+
+/*****************************************************************/
+/*
+  By default all keywords which are loaded stay in memory until the
+  ecl_file is closed, or a transaction is ended. For long running
+  processes browsing through large files a memory budget can be set
+  with ecl_file_set_memory_budget(); when the loaded keywords exceed
+  the budget the least recently used keywords which have been released
+  with ecl_file_release_kw() are dropped, and will be reloaded from
+  file on the next access. Keywords which have not been released are
+  never dropped, so the budget is a soft limit. A budget of 0 means no
+  budget.
+*/
+
+void ecl_file_set_memory_budget( ecl_file_type * ecl_file , size_t budget) {
+  ecl_file_kw_cache_set_budget( ecl_file->kw_cache , budget );
+}
+
+
+void ecl_file_release_kw( ecl_file_type * ecl_file , const ecl_kw_type * ecl_kw) {
+  ecl_file_view_release_kw( ecl_file->global_view , ecl_kw );
+}
+
+
+size_t ecl_file_get_memory_budget( const ecl_file_type * ecl_file ) {
+  return ecl_file_kw_cache_get_budget( ecl_file->kw_cache );
+}
+
+
+size_t ecl_file_get_resident_bytes( const ecl_file_type * ecl_file ) {
+  return ecl_file_kw_cache_get_resident_bytes( ecl_file->kw_cache );
+}
+
+
+size_t ecl_file_get_cache_hits( const ecl_file_type * ecl_file ) {
+  return ecl_file_kw_cache_get_hits( ecl_file->kw_cache );
+}
+
+
+size_t ecl_file_get_cache_misses( const ecl_file_type * ecl_file ) {
+  return ecl_file_kw_cache_get_misses( ecl_file->kw_cache );
+}
+
+
+size_t ecl_file_get_cache_evictions( const ecl_file_type * ecl_file ) {
+  return ecl_file_kw_cache_get_evictions( ecl_file->kw_cache );
+}
+
+
+/*****************************************************************/
+/*
+  A restart case which has been written as non-unified restart files,
+  i.e. CASE.X0000, CASE.X0001, ... or the formatted CASE.F0000, ...,
+  can be opened as one logical unified restart file with
+  ecl_file_open_restart_case(). The global view will contain the
+  keywords of all the files in report step order, and all the
+  rstblock functions can be used as for a unified file.
+
+  The files are scanned in parallel; after the scan the streams are
+  closed and are only reopened on demand when a keyword is loaded. At
+  most @max_open_streams files are open at the same time, when the
+  limit is reached the least recently used stream is closed. The
+  non-unified files do not contain the SEQNUM keyword, a SEQNUM
+  keyword with the report step from the filename is therefor inserted
+  in memory at the start of each file.
+*/
+
+static void ecl_file_fortio_fclose__( void * arg ) {
+  fortio_fclose( (fortio_type *) arg );
+}
+
+
+/*
+  The number of file streams which are currently open; for an
+  ecl_file created with ecl_file_open_restart_case() this is bounded
+  by the max_open_streams argument.
+*/
+
+int ecl_file_get_num_open_streams( const ecl_file_type * ecl_file ) {
+  if (ecl_file->stream_pool)
+    return ecl_file_stream_pool_get_num_open( ecl_file->stream_pool );
+  else if (ecl_file->fortio && fortio_stream_is_open( ecl_file->fortio ))
+    return 1;
+  else
+    return 0;
+}
+
+
+ecl_file_type * ecl_file_open_restart_case( const char * case_input , int max_open_streams , int flags) {
+  ecl_file_type * ecl_file = NULL;
+  stringlist_type * filelist = stringlist_alloc_new();
+  char * path;
+  char * base;
+
+  util_alloc_file_components( case_input , &path , &base , NULL );
+  if (ecl_util_select_filelist( path , base , ECL_RESTART_FILE , false , filelist ) == 0)
+    ecl_util_select_filelist( path , base , ECL_RESTART_FILE , true , filelist );
+
+  if (stringlist_get_size( filelist ) > 0) {
+    const int num_files = stringlist_get_size( filelist );
+    fortio_type ** fortio_list = util_calloc( num_files , sizeof * fortio_list );
+    ecl_file_view_type ** file_views = util_calloc( num_files , sizeof * file_views );
+    bool * scan_ok = util_calloc( num_files , sizeof * scan_ok );
+    inv_map_type * inv_map = inv_map_alloc( );
+    int file_nr;
+
+    ecl_file = ecl_file_alloc_empty( flags );
+
+#pragma omp parallel for schedule(dynamic)
+    for (file_nr = 0; file_nr < num_files; file_nr++) {
+      const char * filename = stringlist_iget( filelist , file_nr );
+      bool fmt_file;
+
+      ecl_util_fmt_file( filename , &fmt_file );
+      fortio_list[file_nr] = fortio_open_reader( filename , fmt_file , ECL_ENDIAN_FLIP );
+      file_views[file_nr] = NULL;
+      scan_ok[file_nr] = false;
+      if (fortio_list[file_nr]) {
+        file_views[file_nr] = ecl_file_view_alloc( fortio_list[file_nr] , &ecl_file->flags , inv_map , false );
+        scan_ok[file_nr] = ecl_file_scan__( fortio_list[file_nr] , file_views[file_nr] , 0 , NULL , NULL );
+        fortio_fclose_stream( fortio_list[file_nr] );
+      }
+    }
+
+    {
+      bool case_ok = true;
+      ecl_file->fortio_list = vector_alloc_new();
+      ecl_file->stream_pool = ecl_file_stream_pool_alloc( (max_open_streams > 0) ? max_open_streams : ECL_FILE_DEFAULT_MAX_OPEN_STREAMS );
+      for (file_nr = 0; file_nr < num_files; file_nr++) {
+        if (fortio_list[file_nr])
+          vector_append_owned_ref( ecl_file->fortio_list , fortio_list[file_nr] , ecl_file_fortio_fclose__ );
+        if (!scan_ok[file_nr])
+          case_ok = false;
+      }
+
+      if (case_ok) {
+        ecl_file->fortio = fortio_list[0];
+        ecl_file->global_view = ecl_file_view_alloc( ecl_file->fortio , &ecl_file->flags , ecl_file->inv_view , true );
+        ecl_file_view_set_kw_cache( ecl_file->global_view , ecl_file->kw_cache );
+        ecl_file_view_set_stream_pool( ecl_file->global_view , ecl_file->stream_pool );
+
+        for (file_nr = 0; file_nr < num_files; file_nr++) {
+          ecl_file_view_type * file_view = file_views[file_nr];
+          int i;
+
+          if (!ecl_file_view_has_kw( file_view , SEQNUM_KW )) {
+            ecl_kw_type * seqnum_kw = ecl_kw_alloc( SEQNUM_KW , 1 , ECL_INT );
+            ecl_kw_iset_int( seqnum_kw , 0 , ecl_util_filename_report_nr( stringlist_iget( filelist , file_nr )));
+            ecl_file_view_add_kw( ecl_file->global_view , ecl_file_kw_alloc_memory( seqnum_kw ));
+          }
+
+          for (i = 0; i < ecl_file_view_get_size( file_view ); i++) {
+            ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( file_view , i );
+            ecl_file_kw_set_fortio( file_kw , fortio_list[file_nr] );
+            ecl_file_view_add_kw( ecl_file->global_view , file_kw );
+          }
+        }
+        ecl_file_view_make_index( ecl_file->global_view );
+        ecl_file_select_global( ecl_file );
+      } else {
+        /* The keywords are only referenced by the views which do not own them. */
+        for (file_nr = 0; file_nr < num_files; file_nr++) {
+          if (file_views[file_nr]) {
+            int i;
+            for (i = 0; i < ecl_file_view_get_size( file_views[file_nr] ); i++)
+              ecl_file_kw_free( ecl_file_view_iget_file_kw( file_views[file_nr] , i ));
+          }
+        }
+      }
+
+      for (file_nr = 0; file_nr < num_files; file_nr++)
+        if (file_views[file_nr])
+          ecl_file_view_free( file_views[file_nr] );
+
+      if (!case_ok) {
+        ecl_file_close( ecl_file );
+        ecl_file = NULL;
+      }
+    }
+
+    inv_map_free( inv_map );
+    free( scan_ok );
+    free( file_views );
+    free( fortio_list );
+  }
+
+  free( path );
+  free( base );
+  stringlist_free( filelist );
+  return ecl_file;
+}
@@ -22,6 +22,7 @@
 #include <stdbool.h>
 
 #include <ert/util/size_t_vector.h>
+#include <ert/util/perm_vector.h>
 #include <ert/util/util.h>
 
 #include <ert/ecl/ecl_util.h>
@@ -62,6 +63,42 @@ struct ecl_file_kw_struct {
   int              ref_count;
   char           * header;
   ecl_kw_type    * kw;
+  fortio_type    * fortio;      /* Source of the keyword if different from the fortio of the view; not owned. */
+  bool             memory;      /* The keyword is not backed by a file, and kw is permanently loaded. */
+  ecl_file_kw_cache_type * cache;         /* Non NULL when the loaded keyword is linked into the LRU list of a cache. */
+  ecl_file_kw_type       * lru_prev;
+  ecl_file_kw_type       * lru_next;
+};
+
+
+/*
+  The keyword cache keeps track of the loaded keywords of one ecl_file
+  in a least recently used list, where the list links are stored in
+  the ecl_file_kw instances themselves. When a memory budget has been
+  set the least recently used keywords are dropped, i.e. the ecl_kw
+  instance is freed and the ecl_file_kw reverts to the unloaded state,
+  until the resident bytes are within the budget. A dropped keyword is
+  reloaded from file on the next access.
+
+  Every access to a keyword increments the ref_count, and only
+  keywords where the ref_count has been brought back to zero with
+  ecl_file_kw_release() are candidates for eviction; i.e. an ecl_kw
+  pointer is never freed behind the back of a caller which has not
+  released it. Eviction only happens when the budget is set, when a
+  keyword is released and when a transaction ends; never while a
+  keyword is being loaded, and never while a transaction is open.
+*/
+
+struct ecl_file_kw_cache_struct {
+  inv_map_type     * inv_map;
+  size_t             budget;             /* 0: no budget. */
+  size_t             resident_bytes;
+  size_t             hits;
+  size_t             misses;
+  size_t             evictions;
+  int                transaction_depth;
+  ecl_file_kw_type * lru_head;           /* Least recently used. */
+  ecl_file_kw_type * lru_tail;           /* Most recently used. */
 };
 
 
@@ -91,7 +128,7 @@ static void inv_map_assert_sort( inv_map_type * map ) {
     size_t_vector_permute( map->file_kw_ptr , perm );
     map->sorted = true;
 
-    free( perm );
+    perm_vector_free( perm );
   }
 }
 
@@ -129,6 +166,183 @@ ecl_file_kw_type * inv_map_get_file_kw( inv_map_type * inv_map , const ecl_kw_ty
 }
 
 
+/*****************************************************************/
+
+static size_t ecl_file_kw_get_byte_size( const ecl_file_kw_type * file_kw ) {
+  return (size_t) file_kw->kw_size * ecl_type_get_sizeof_ctype( file_kw->data_type );
+}
+
+
+ecl_file_kw_cache_type * ecl_file_kw_cache_alloc( inv_map_type * inv_map ) {
+  ecl_file_kw_cache_type * cache = util_malloc( sizeof * cache );
+  cache->inv_map = inv_map;
+  cache->budget = 0;
+  cache->resident_bytes = 0;
+  cache->hits = 0;
+  cache->misses = 0;
+  cache->evictions = 0;
+  cache->transaction_depth = 0;
+  cache->lru_head = NULL;
+  cache->lru_tail = NULL;
+  return cache;
+}
+
+
+/*
+  The keywords still linked into the cache are left loaded; they are
+  owned by the views.
+*/
+
+void ecl_file_kw_cache_free( ecl_file_kw_cache_type * cache ) {
+  ecl_file_kw_type * file_kw = cache->lru_head;
+  while (file_kw) {
+    ecl_file_kw_type * next = file_kw->lru_next;
+    file_kw->cache = NULL;
+    file_kw->lru_prev = NULL;
+    file_kw->lru_next = NULL;
+    file_kw = next;
+  }
+  free( cache );
+}
+
+
+static void ecl_file_kw_cache_unlink( ecl_file_kw_type * file_kw ) {
+  ecl_file_kw_cache_type * cache = file_kw->cache;
+  if (!cache)
+    return;
+
+  if (file_kw->lru_prev)
+    file_kw->lru_prev->lru_next = file_kw->lru_next;
+  else
+    cache->lru_head = file_kw->lru_next;
+
+  if (file_kw->lru_next)
+    file_kw->lru_next->lru_prev = file_kw->lru_prev;
+  else
+    cache->lru_tail = file_kw->lru_prev;
+
+  cache->resident_bytes -= ecl_file_kw_get_byte_size( file_kw );
+  file_kw->cache = NULL;
+  file_kw->lru_prev = NULL;
+  file_kw->lru_next = NULL;
+}
+
+
+static void ecl_file_kw_cache_push_back( ecl_file_kw_cache_type * cache , ecl_file_kw_type * file_kw ) {
+  file_kw->cache = cache;
+  file_kw->lru_prev = cache->lru_tail;
+  file_kw->lru_next = NULL;
+  if (cache->lru_tail)
+    cache->lru_tail->lru_next = file_kw;
+  else
+    cache->lru_head = file_kw;
+  cache->lru_tail = file_kw;
+  cache->resident_bytes += ecl_file_kw_get_byte_size( file_kw );
+}
+
+
+static void ecl_file_kw_cache_evict( ecl_file_kw_cache_type * cache ) {
+  ecl_file_kw_type * file_kw = cache->lru_head;
+
+  if (cache->budget == 0 || cache->transaction_depth > 0)
+    return;
+
+  while (file_kw && (cache->resident_bytes > cache->budget)) {
+    ecl_file_kw_type * next = file_kw->lru_next;
+
+    if (file_kw->ref_count == 0) {
+      ecl_file_kw_cache_unlink( file_kw );
+      /* A keyword inserted with ecl_file_kw_replace_kw() is not in the inv_map. */
+      if (inv_map_get_file_kw( cache->inv_map , file_kw->kw ) == file_kw)
+        inv_map_drop_kw( cache->inv_map , file_kw->kw );
+      ecl_kw_free( file_kw->kw );
+      file_kw->kw = NULL;
+      cache->evictions++;
+    }
+    file_kw = next;
+  }
+}
+
+
+/*
+  Should be called after @file_kw has been accessed through one of the
+  views using the cache; @loaded is true if the keyword was loaded from
+  file by the access.
+*/
+
+void ecl_file_kw_cache_touch( ecl_file_kw_cache_type * cache , ecl_file_kw_type * file_kw , bool loaded) {
+  if (file_kw->memory || file_kw->kw == NULL)
+    return;
+
+  if (loaded)
+    cache->misses++;
+  else
+    cache->hits++;
+
+  ecl_file_kw_cache_unlink( file_kw );
+  ecl_file_kw_cache_push_back( cache , file_kw );
+}
+
+
+/*
+  Will drop one reference to @file_kw; when the ref_count reaches zero
+  the keyword stays loaded, but can be evicted if the cache is above
+  the budget.
+*/
+
+void ecl_file_kw_cache_release( ecl_file_kw_cache_type * cache , ecl_file_kw_type * file_kw ) {
+  if (file_kw->memory)
+    return;
+
+  if (file_kw->ref_count > 0)
+    file_kw->ref_count--;
+
+  ecl_file_kw_cache_evict( cache );
+}
+
+
+void ecl_file_kw_cache_set_budget( ecl_file_kw_cache_type * cache , size_t budget) {
+  cache->budget = budget;
+  ecl_file_kw_cache_evict( cache );
+}
+
+
+size_t ecl_file_kw_cache_get_budget( const ecl_file_kw_cache_type * cache ) {
+  return cache->budget;
+}
+
+
+size_t ecl_file_kw_cache_get_resident_bytes( const ecl_file_kw_cache_type * cache ) {
+  return cache->resident_bytes;
+}
+
+
+size_t ecl_file_kw_cache_get_hits( const ecl_file_kw_cache_type * cache ) {
+  return cache->hits;
+}
+
+
+size_t ecl_file_kw_cache_get_misses( const ecl_file_kw_cache_type * cache ) {
+  return cache->misses;
+}
+
+
+size_t ecl_file_kw_cache_get_evictions( const ecl_file_kw_cache_type * cache ) {
+  return cache->evictions;
+}
+
+
+void ecl_file_kw_cache_start_transaction( ecl_file_kw_cache_type * cache ) {
+  cache->transaction_depth++;
+}
+
+
+void ecl_file_kw_cache_end_transaction( ecl_file_kw_cache_type * cache ) {
+  cache->transaction_depth--;
+  ecl_file_kw_cache_evict( cache );
+}
+
+
 /*****************************************************************/
 
 static UTIL_SAFE_CAST_FUNCTION( ecl_file_kw , ECL_FILE_KW_TYPE_ID )
@@ -146,10 +360,31 @@ ecl_file_kw_type * ecl_file_kw_alloc0( const char * header , ecl_data_type data_
   file_kw->file_offset = offset;
   file_kw->ref_count = 0;
   file_kw->kw = NULL;
+  file_kw->fortio = NULL;
+  file_kw->memory = false;
+  file_kw->cache = NULL;
+  file_kw->lru_prev = NULL;
+  file_kw->lru_next = NULL;
 
   return file_kw;
 }
 
+
+/**
+   Will create a ecl_file_kw instance which is not backed by a file;
+   the ecl_file_kw takes ownership of @ecl_kw which is kept in memory
+   for the lifetime of the ecl_file_kw. Used to insert synthesized
+   keywords, e.g. SEQNUM, in a view.
+*/
+
+ecl_file_kw_type * ecl_file_kw_alloc_memory( ecl_kw_type * ecl_kw ) {
+  ecl_file_kw_type * file_kw = ecl_file_kw_alloc( ecl_kw , -1 );
+  file_kw->kw = ecl_kw;
+  file_kw->ref_count = 1;
+  file_kw->memory = true;
+  return file_kw;
+}
+
 /**
    Create a new ecl_file_kw instance based on header information from
    the input keyword. Typically only the header has been loaded from
@@ -168,16 +403,23 @@ ecl_file_kw_type * ecl_file_kw_alloc( const ecl_kw_type * ecl_kw , offset_type o
 
 
 /**
-    Does NOT copy the kw pointer which must be reloaded.
+    Does NOT copy the kw pointer which must be reloaded, and does not
+    copy the fortio source; i.e. the copy will be loaded from the
+    fortio of the view it is added to. A keyword which is not backed
+    by a file is copied with the keyword data.
 */
 ecl_file_kw_type * ecl_file_kw_alloc_copy( const ecl_file_kw_type * src ) {
-  return ecl_file_kw_alloc0( src->header , ecl_file_kw_get_data_type(src) , src->kw_size , src->file_offset );
+  if (src->memory)
+    return ecl_file_kw_alloc_memory( ecl_kw_alloc_copy( src->kw ));
+  else
+    return ecl_file_kw_alloc0( src->header , ecl_file_kw_get_data_type(src) , src->kw_size , src->file_offset );
 }
 
 
 
 
 void ecl_file_kw_free( ecl_file_kw_type * file_kw ) {
+  ecl_file_kw_cache_unlink( file_kw );
   if (file_kw->kw != NULL) {
     ecl_kw_free( file_kw->kw );
     file_kw->kw = NULL;
@@ -223,6 +465,7 @@ static void ecl_file_kw_assert_kw( const ecl_file_kw_type * file_kw ) {
 
 
 static void ecl_file_kw_drop_kw( ecl_file_kw_type * file_kw , inv_map_type * inv_map ) {
+  ecl_file_kw_cache_unlink( file_kw );
   if (file_kw->kw != NULL) {
     inv_map_drop_kw( inv_map , file_kw->kw );
     ecl_kw_free( file_kw->kw );
@@ -253,7 +496,7 @@ static void ecl_file_kw_load_kw( ecl_file_kw_type * file_kw , fortio_type * fort
 */
 
 ecl_kw_type * ecl_file_kw_get_kw_ptr( ecl_file_kw_type * file_kw) {
-  if (file_kw->ref_count == 0)
+  if (file_kw->kw == NULL)
     return NULL;
 
   file_kw->ref_count++;
@@ -276,7 +519,7 @@ ecl_kw_type * ecl_file_kw_get_kw_ptr( ecl_file_kw_type * file_kw) {
 
 
 ecl_kw_type * ecl_file_kw_get_kw( ecl_file_kw_type * file_kw , fortio_type * fortio , inv_map_type * inv_map ) {
-  if (file_kw->ref_count == 0)
+  if (file_kw->kw == NULL)
     ecl_file_kw_load_kw( file_kw , fortio , inv_map);
 
   if(file_kw->kw)
@@ -326,6 +569,47 @@ ecl_data_type ecl_file_kw_get_data_type(const ecl_file_kw_type * file_kw) {
   return file_kw->data_type;
 }
 
+/*
+  The fortio source is used when the keywords of one view come from
+  several files; when it is NULL the keyword is loaded from the fortio
+  of the view.
+*/
+
+void ecl_file_kw_set_fortio( ecl_file_kw_type * file_kw , fortio_type * fortio ) {
+  file_kw->fortio = fortio;
+}
+
+
+fortio_type * ecl_file_kw_get_fortio( const ecl_file_kw_type * file_kw ) {
+  return file_kw->fortio;
+}
+
+
+bool ecl_file_kw_is_memory( const ecl_file_kw_type * file_kw ) {
+  return file_kw->memory;
+}
+
+
+/*
+  Will return a private copy of the keyword; keywords which only exist
+  in memory are copied, otherwise the keyword is read from @fortio,
+  which must be a reader of the file the keyword comes from. The
+  cached instance and the reference count are not touched, so this
+  can be called from several threads with private fortio instances.
+  Returns NULL if the keyword can not be read.
+*/
+
+ecl_kw_type * ecl_file_kw_fread_alloc_copy( const ecl_file_kw_type * file_kw , fortio_type * fortio ) {
+  if (file_kw->memory)
+    return ecl_kw_alloc_copy( file_kw->kw );
+
+  if (!fortio_fseek( fortio , file_kw->file_offset , SEEK_SET ))
+    return NULL;
+
+  return ecl_kw_fread_alloc( fortio );
+}
+
+
 offset_type ecl_file_kw_get_offset(const ecl_file_kw_type * file_kw) {
     return file_kw->file_offset;
 }
@@ -439,13 +723,27 @@ ecl_file_kw_type * ecl_file_kw_fread_alloc( FILE * stream ) {
 }
 
 
-void ecl_file_kw_start_transaction(const ecl_file_kw_type * file_kw, int * ref_count) {
+/*
+  A released keyword can stay resident with ref_count == 0, so the
+  residency is recorded separately; only keywords which were loaded
+  by the transaction are dropped when it ends.
+*/
+
+void ecl_file_kw_start_transaction(const ecl_file_kw_type * file_kw, int * ref_count, bool * resident) {
   *ref_count = file_kw->ref_count;
+  *resident = (file_kw->kw != NULL);
 }
 
 
-void ecl_file_kw_end_transaction(ecl_file_kw_type * file_kw, int ref_count) {
-  if (ref_count == 0 && file_kw->ref_count > 0) {
+void ecl_file_kw_end_transaction(ecl_file_kw_type * file_kw, inv_map_type * inv_map , int ref_count, bool resident) {
+  if (file_kw->memory)
+    return;
+
+  if (!resident && file_kw->kw != NULL) {
+    ecl_file_kw_cache_unlink( file_kw );
+    /* A keyword inserted with ecl_file_kw_replace_kw() is not in the inv_map. */
+    if (inv_map_get_file_kw( inv_map , file_kw->kw ) == file_kw)
+      inv_map_drop_kw( inv_map , file_kw->kw );
     ecl_kw_free(file_kw->kw);
     file_kw->kw = NULL;
   }
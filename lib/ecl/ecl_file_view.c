@@ -16,7 +16,9 @@
    for more details.
 */
 
+#include <string.h>
 
+#include <ert/util/util.h>
 #include <ert/util/vector.h>
 #include <ert/util/hash.h>
 #include <ert/util/stringlist.h>
@@ -24,6 +26,8 @@
 #include <ert/ecl/fortio.h>
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_endian_flip.h>
 #include <ert/ecl/ecl_file_kw.h>
 #include <ert/ecl/ecl_file_view.h>
 #include <ert/ecl/ecl_rsthead.h>
@@ -35,18 +39,83 @@ struct ecl_file_view_struct {
   hash_type         * kw_index;     /* A hash table with integer vectors of indices - see comment below. */
   stringlist_type   * distinct_kw;  /* A stringlist of the keywords occuring in the file - each string occurs ONLY ONCE. */
   fortio_type       * fortio;       /* The same fortio instance pointer as in the ecl_file styructure. */
+  fortio_type       * src_fortio;   /* The file the keywords come from - see ecl_file_view_get_src_file(). */
   bool                owner;        /* Is this map the owner of the ecl_file_kw instances; only true for the global_map. */
   inv_map_type      * inv_map;      /* Shared reference owned by the ecl_file structure. */
   vector_type       * child_list;
   int               * flags;
+  vector_type       * rsthead_list;         /* Lazily built table of restart headers, one per SEQNUM block; see ecl_file_view_get_rsthead_list(). */
+  bool                rsthead_time_sorted;  /* The sim_time and sim_days of the rsthead_list are non-decreasing. */
+  bool                rsthead_report_sorted;/* The report steps of the rsthead_list are non-decreasing. */
+  ecl_file_stream_pool_type * stream_pool;  /* Shared reference owned by the ecl_file structure; NULL unless the keywords come from several files. */
+  ecl_file_kw_cache_type    * kw_cache;     /* Shared reference owned by the ecl_file structure; NULL for private views. */
+};
+
+
+/*
+  When the keywords of a view come from several files, see
+  ecl_file_open_restart_case(), each ecl_file_kw has its own fortio
+  source and the streams are opened on demand. The stream pool is
+  shared by all the views of the ecl_file, and will limit the number
+  of simultaneously open streams by closing the least recently used
+  stream.
+*/
+
+struct ecl_file_stream_pool_struct {
+  int           max_open;
+  vector_type * open_list;    /* fortio instances with a (possibly) open stream; the most recently used is last. */
 };
 
 struct ecl_file_transaction_struct {
   const ecl_file_view_type * file_view;
   int * ref_count;
+  bool * resident;
 };
 
 
+ecl_file_stream_pool_type * ecl_file_stream_pool_alloc( int max_open ) {
+  ecl_file_stream_pool_type * pool = util_malloc( sizeof * pool );
+  pool->max_open = util_int_max( 1 , max_open );
+  pool->open_list = vector_alloc_new();
+  return pool;
+}
+
+
+void ecl_file_stream_pool_free( ecl_file_stream_pool_type * pool ) {
+  vector_free( pool->open_list );
+  free( pool );
+}
+
+
+int ecl_file_stream_pool_get_num_open( const ecl_file_stream_pool_type * pool ) {
+  int num_open = 0;
+  int i;
+  for (i = 0; i < vector_get_size( pool->open_list ); i++)
+    if (fortio_stream_is_open( vector_iget_const( pool->open_list , i )))
+      num_open++;
+  return num_open;
+}
+
+
+bool ecl_file_stream_pool_assert_open( ecl_file_stream_pool_type * pool , fortio_type * fortio ) {
+  int index;
+  for (index = 0; index < vector_get_size( pool->open_list ); index++)
+    if (vector_iget_const( pool->open_list , index ) == fortio)
+      break;
+
+  if (index < vector_get_size( pool->open_list ))
+    vector_idel( pool->open_list , index );
+  else {
+    while (vector_get_size( pool->open_list ) >= pool->max_open) {
+      fortio_fclose_stream( vector_iget( pool->open_list , 0 ));
+      vector_idel( pool->open_list , 0 );
+    }
+  }
+  vector_append_ref( pool->open_list , fortio );
+  return fortio_assert_stream_open( fortio );
+}
+
+
 /*****************************************************************/
 /* Here comes the functions related to the index ecl_file_view. These
    functions are all of them static.
@@ -65,8 +134,15 @@ bool ecl_file_view_flags_set( const ecl_file_view_type * file_view , int query_f
 }
 
 
+/*
+  If the keywords of the view come from several files the file of the
+  first file backed keyword is returned; for a restart block view this
+  is the file of the block. The file is found when the block view is
+  created, see ecl_file_view_alloc_blockview2().
+*/
+
 const char * ecl_file_view_get_src_file( const ecl_file_view_type * file_view ) {
-  return fortio_filename_ref( file_view->fortio );
+  return fortio_filename_ref( file_view->src_fortio );
 }
 
 
@@ -78,11 +154,49 @@ ecl_file_view_type * ecl_file_view_alloc( fortio_type * fortio , int * flags , i
   ecl_file_view->child_list           = vector_alloc_new();
   ecl_file_view->owner                = owner;
   ecl_file_view->fortio               = fortio;
+  ecl_file_view->src_fortio           = fortio;
   ecl_file_view->inv_map              = inv_map;
   ecl_file_view->flags                = flags;
+  ecl_file_view->rsthead_list         = NULL;
+  ecl_file_view->stream_pool          = NULL;
+  ecl_file_view->kw_cache             = NULL;
   return ecl_file_view;
 }
 
+void ecl_file_view_set_stream_pool( ecl_file_view_type * ecl_file_view , ecl_file_stream_pool_type * stream_pool ) {
+  ecl_file_view->stream_pool = stream_pool;
+}
+
+
+void ecl_file_view_set_kw_cache( ecl_file_view_type * ecl_file_view , ecl_file_kw_cache_type * kw_cache ) {
+  ecl_file_view->kw_cache = kw_cache;
+}
+
+
+/*
+  Will return the fortio instance @file_kw should be loaded from, with
+  an open stream, or NULL if the stream can not be opened.
+*/
+
+static fortio_type * ecl_file_view_assert_kw_stream( const ecl_file_view_type * ecl_file_view , const ecl_file_kw_type * file_kw ) {
+  fortio_type * fortio = ecl_file_kw_get_fortio( file_kw );
+  bool open;
+
+  if (!fortio)
+    fortio = ecl_file_view->fortio;
+
+  if (ecl_file_view->stream_pool)
+    open = ecl_file_stream_pool_assert_open( ecl_file_view->stream_pool , fortio );
+  else
+    open = fortio_assert_stream_open( fortio );
+
+  if (open)
+    return fortio;
+  else
+    return NULL;
+}
+
+
 int ecl_file_view_get_global_index( const ecl_file_view_type * ecl_file_view , const char * kw , int ith) {
   const int_vector_type * index_vector = hash_get(ecl_file_view->kw_index , kw);
   int global_index = int_vector_iget( index_vector , ith);
@@ -101,6 +215,11 @@ int ecl_file_view_get_global_index( const ecl_file_view_type * ecl_file_view , c
 
 
 void ecl_file_view_make_index( ecl_file_view_type * ecl_file_view ) {
+  if (ecl_file_view->rsthead_list) {
+    vector_free( ecl_file_view->rsthead_list );
+    ecl_file_view->rsthead_list = NULL;
+  }
+
   stringlist_clear( ecl_file_view->distinct_kw );
   hash_clear( ecl_file_view->kw_index );
   {
@@ -152,15 +271,22 @@ void ecl_file_view_add_flag( ecl_file_view_type * file_view , int flag)  {
 
 static ecl_kw_type * ecl_file_view_get_kw(const ecl_file_view_type * ecl_file_view, ecl_file_kw_type * file_kw) {
   ecl_kw_type * ecl_kw = ecl_file_kw_get_kw_ptr( file_kw );
+  bool loaded = false;
   if (!ecl_kw) {
-    if (fortio_assert_stream_open( ecl_file_view->fortio )) {
+    fortio_type * fortio = ecl_file_view_assert_kw_stream( ecl_file_view , file_kw );
+    if (fortio) {
 
-      ecl_kw = ecl_file_kw_get_kw( file_kw , ecl_file_view->fortio , ecl_file_view->inv_map);
+      ecl_kw = ecl_file_kw_get_kw( file_kw , fortio , ecl_file_view->inv_map);
+      loaded = true;
 
       if (ecl_file_view_flags_set( ecl_file_view , ECL_FILE_CLOSE_STREAM))
-        fortio_fclose_stream( ecl_file_view->fortio );
+        fortio_fclose_stream( fortio );
     }
   }
+
+  if (ecl_kw && ecl_file_view->kw_cache)
+    ecl_file_kw_cache_touch( ecl_file_view->kw_cache , file_kw , loaded );
+
   return ecl_kw;
 }
 
@@ -171,17 +297,70 @@ ecl_kw_type * ecl_file_view_iget_kw( const ecl_file_view_type * ecl_file_view ,
 
 void ecl_file_view_index_fload_kw(const ecl_file_view_type * ecl_file_view, const char* kw, int index, const int_vector_type * index_map, char* buffer) {
     ecl_file_kw_type * file_kw = ecl_file_view_iget_named_file_kw( ecl_file_view , kw , index);
+    fortio_type * fortio = ecl_file_view_assert_kw_stream( ecl_file_view , file_kw );
 
-    if (fortio_assert_stream_open( ecl_file_view->fortio )) {
+    if (fortio) {
         offset_type offset = ecl_file_kw_get_offset(file_kw);
         ecl_data_type data_type = ecl_file_kw_get_data_type(file_kw);
         int element_count = ecl_file_kw_get_size(file_kw);
 
-        ecl_kw_fread_indexed_data(ecl_file_view->fortio, offset + ECL_KW_HEADER_FORTIO_SIZE, data_type, element_count, index_map, buffer);
+        ecl_kw_fread_indexed_data(fortio, offset + ECL_KW_HEADER_FORTIO_SIZE, data_type, element_count, index_map, buffer);
     }
 }
 
 
+/*
+  The file keyword nr @index comes from; for the views of
+  ecl_file_open_restart_case() this differs between the keywords.
+*/
+
+const char * ecl_file_view_iget_src_file( const ecl_file_view_type * ecl_file_view , int index) {
+  const ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( ecl_file_view , index );
+  fortio_type * fortio = ecl_file_kw_get_fortio( file_kw );
+
+  if (!fortio)
+    fortio = ecl_file_view->fortio;
+  return fortio_filename_ref( fortio );
+}
+
+
+/*
+  Will read a private copy of keyword nr @index through the private
+  reader *@fortio, which is (re)opened when it is NULL or reads a
+  different file than the one the keyword comes from; the caller must
+  close it with fortio_fclose(). The view itself is not modified, so
+  threads with private readers can call this concurrently. Will abort
+  if the keyword can not be read.
+*/
+
+ecl_kw_type * ecl_file_view_iget_kw_copy( const ecl_file_view_type * ecl_file_view , int index , fortio_type ** fortio) {
+  const ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( ecl_file_view , index );
+  ecl_kw_type * ecl_kw;
+
+  if (!ecl_file_kw_is_memory( file_kw )) {
+    const char * filename = ecl_file_view_iget_src_file( ecl_file_view , index );
+    if ((*fortio == NULL) || !util_string_equal( fortio_filename_ref( *fortio ) , filename )) {
+      bool fmt_file;
+
+      if (*fortio)
+        fortio_fclose( *fortio );
+
+      if (!ecl_util_fmt_file( filename , &fmt_file ))
+        util_abort("%s: can not determine the format of:%s \n",__func__ , filename);
+
+      *fortio = fortio_open_reader( filename , fmt_file , ECL_ENDIAN_FLIP );
+      if (*fortio == NULL)
+        util_abort("%s: failed to open:%s \n",__func__ , filename);
+    }
+  }
+
+  ecl_kw = ecl_file_kw_fread_alloc_copy( file_kw , *fortio );
+  if (!ecl_kw)
+    util_abort("%s: failed to load keyword:%s \n",__func__ , ecl_file_kw_get_header( file_kw ));
+  return ecl_kw;
+}
+
+
 int ecl_file_view_find_kw_value( const ecl_file_view_type * ecl_file_view , const char * kw , const void * value) {
   int global_index = -1;
   if ( ecl_file_view_has_kw( ecl_file_view , kw)) {
@@ -257,7 +436,7 @@ void ecl_file_view_replace_kw( ecl_file_view_type * ecl_file_view , ecl_kw_type
 
       if (insert_copy)
         insert_kw = ecl_kw_alloc_copy( new_kw );
-      ecl_file_kw_replace_kw( ikw , ecl_file_view->fortio , insert_kw );
+      ecl_file_kw_replace_kw( ikw , ecl_file_view_assert_kw_stream( ecl_file_view , ikw ) , insert_kw );
 
       ecl_file_view_make_index( ecl_file_view );
       return;
@@ -268,20 +447,71 @@ void ecl_file_view_replace_kw( ecl_file_view_type * ecl_file_view , ecl_kw_type
 }
 
 
-bool ecl_file_view_load_all( ecl_file_view_type * ecl_file_view ) {
-  bool loadOK = false;
+/*
+  Will drop one reference to @ecl_kw, which must have been fetched from
+  this view; when the keyword is not referenced any more it can be
+  evicted by the keyword cache of the ecl_file. After the release the
+  @ecl_kw pointer should not be used.
+*/
 
-  if (fortio_assert_stream_open( ecl_file_view->fortio )) {
+void ecl_file_view_release_kw( ecl_file_view_type * ecl_file_view , const ecl_kw_type * ecl_kw) {
+  ecl_file_kw_type * file_kw = inv_map_get_file_kw( ecl_file_view->inv_map , ecl_kw );
+
+  if (!file_kw) {
     int index;
-    for (index = 0; index < vector_get_size( ecl_file_view->kw_list); index++) {
+    for (index = 0; index < vector_get_size( ecl_file_view->kw_list ); index++) {
       ecl_file_kw_type * ikw = vector_iget( ecl_file_view->kw_list , index );
-      ecl_file_kw_get_kw( ikw , ecl_file_view->fortio , ecl_file_view->inv_map);
+      if (ecl_file_kw_ptr_eq( ikw , ecl_kw )) {
+        file_kw = ikw;
+        break;
+      }
+    }
+  }
+
+  if (!file_kw)
+    util_abort("%s: could not find ecl_kw ptr: %p \n",__func__ , ecl_kw);
+
+  if (ecl_file_view->kw_cache)
+    ecl_file_kw_cache_release( ecl_file_view->kw_cache , file_kw );
+}
+
+
+bool ecl_file_view_load_all( ecl_file_view_type * ecl_file_view ) {
+  bool loadOK = true;
+  int index;
+
+  for (index = 0; index < vector_get_size( ecl_file_view->kw_list); index++) {
+    ecl_file_kw_type * ikw = vector_iget( ecl_file_view->kw_list , index );
+    fortio_type * fortio;
+
+    if (ecl_file_kw_is_memory( ikw ))
+      continue;
+
+    if (ecl_file_kw_get_kw_ptr( ikw )) {
+      if (ecl_file_view->kw_cache)
+        ecl_file_kw_cache_touch( ecl_file_view->kw_cache , ikw , false );
+      continue;
+    }
+
+    fortio = ecl_file_view_assert_kw_stream( ecl_file_view , ikw );
+    if (fortio) {
+      ecl_file_kw_get_kw( ikw , fortio , ecl_file_view->inv_map);
+      if (ecl_file_view->kw_cache)
+        ecl_file_kw_cache_touch( ecl_file_view->kw_cache , ikw , true );
+    } else {
+      loadOK = false;
+      break;
     }
-    loadOK = true;
   }
 
-  if (ecl_file_view_flags_set( ecl_file_view , ECL_FILE_CLOSE_STREAM))
+  if (ecl_file_view_flags_set( ecl_file_view , ECL_FILE_CLOSE_STREAM)) {
     fortio_fclose_stream( ecl_file_view->fortio );
+    for (index = 0; index < vector_get_size( ecl_file_view->kw_list); index++) {
+      fortio_type * fortio = ecl_file_kw_get_fortio( vector_iget_const( ecl_file_view->kw_list , index ));
+      if (fortio)
+        fortio_fclose_stream( fortio );
+    }
+  }
 
   return loadOK;
 }
@@ -299,6 +529,8 @@ void ecl_file_view_add_kw( ecl_file_view_type * ecl_file_view , ecl_file_kw_type
 }
 
 void ecl_file_view_free( ecl_file_view_type * ecl_file_view ) {
+  if (ecl_file_view->rsthead_list)
+    vector_free( ecl_file_view->rsthead_list );
   vector_free( ecl_file_view->child_list );
   hash_free( ecl_file_view->kw_index );
   stringlist_free( ecl_file_view->distinct_kw );
@@ -371,6 +603,8 @@ ecl_file_view_type * ecl_file_view_alloc_blockview2(const ecl_file_view_type * e
 
 
   ecl_file_view_type * block_map = ecl_file_view_alloc( ecl_file_view->fortio , ecl_file_view->flags , ecl_file_view->inv_map , false);
+  block_map->stream_pool = ecl_file_view->stream_pool;
+  block_map->kw_cache = ecl_file_view->kw_cache;
   int kw_index = 0;
   if (start_kw)
     kw_index = ecl_file_view_get_global_index( ecl_file_view , start_kw , occurence );
@@ -393,6 +627,18 @@ ecl_file_view_type * ecl_file_view_alloc_blockview2(const ecl_file_view_type * e
     }
   }
   ecl_file_view_make_index( block_map );
+
+  /* Only the views of ecl_file_open_restart_case() have keywords from several files. */
+  if (block_map->stream_pool) {
+    int i;
+    for (i = 0; i < vector_get_size( block_map->kw_list ); i++) {
+      fortio_type * fortio = ecl_file_kw_get_fortio( vector_iget_const( block_map->kw_list , i ));
+      if (fortio) {
+        block_map->src_fortio = fortio;
+        break;
+      }
+    }
+  }
   return block_map;
 }
 
@@ -547,57 +793,305 @@ we have introduced the following concepts:
 */
 
 
-bool ecl_file_view_has_report_step( const ecl_file_view_type * ecl_file_view , int report_step) {
-  int global_index = ecl_file_view_find_kw_value( ecl_file_view , SEQNUM_KW , &report_step );
-  if (global_index >= 0)
-    return true;
+/*
+  The restart header table
+  ------------------------
+
+  All the time and report step lookups below are based on a table
+  with one ecl_rsthead instance for each SEQNUM block in the view. The
+  table is built on first use by one pass through the keyword list,
+  where only the SEQNUM, INTEHEAD, DOUBHEAD and LOGIHEAD keywords
+  following each SEQNUM are loaded, and it is discarded when the
+  index of the view is rebuilt with ecl_file_view_make_index().
+
+  When the report steps or simulation times are non-decreasing, which
+  is the normal situation for a unified restart file, the lookups are
+  binary searches; otherwise the table is scanned linearly. In both
+  cases the first matching SEQNUM block is returned. A block which
+  lacks INTEHEAD or DOUBHEAD has a NULL entry in the table and never
+  matches.
+*/
+
+static void ecl_file_view_rsthead_free__( void * arg ) {
+  ecl_rsthead_free( (ecl_rsthead_type *) arg );
+}
+
+
+static vector_type * ecl_file_view_alloc_rsthead_list( ecl_file_view_type * ecl_file_view , bool * time_sorted , bool * report_sorted) {
+  vector_type * rsthead_list = vector_alloc_new();
+  const int num_seqnum = ecl_file_view_get_num_named_kw( ecl_file_view , SEQNUM_KW );
+
+  *time_sorted = true;
+  *report_sorted = true;
+  if (num_seqnum > 0) {
+    int * seqnum_index   = util_malloc( num_seqnum * sizeof * seqnum_index );
+    int * intehead_index = util_malloc( num_seqnum * sizeof * intehead_index );
+    int * doubhead_index = util_malloc( num_seqnum * sizeof * doubhead_index );
+    int * logihead_index = util_malloc( num_seqnum * sizeof * logihead_index );
+    int seqnum_nr = -1;
+    int i;
+
+    for (i = 0; i < vector_get_size( ecl_file_view->kw_list ); i++) {
+      const ecl_file_kw_type * file_kw = vector_iget_const( ecl_file_view->kw_list , i );
+      const char * header = ecl_file_kw_get_header( file_kw );
+
+      if (strcmp( header , SEQNUM_KW ) == 0) {
+        seqnum_nr++;
+        seqnum_index[seqnum_nr] = i;
+        intehead_index[seqnum_nr] = -1;
+        doubhead_index[seqnum_nr] = -1;
+        logihead_index[seqnum_nr] = -1;
+      } else if (seqnum_nr >= 0) {
+        if ((intehead_index[seqnum_nr] < 0) && (strcmp( header , INTEHEAD_KW ) == 0))
+          intehead_index[seqnum_nr] = i;
+        else if ((doubhead_index[seqnum_nr] < 0) && (strcmp( header , DOUBHEAD_KW ) == 0))
+          doubhead_index[seqnum_nr] = i;
+        else if ((logihead_index[seqnum_nr] < 0) && (strcmp( header , LOGIHEAD_KW ) == 0))
+          logihead_index[seqnum_nr] = i;
+      }
+    }
+
+    {
+      bool close_stream = ecl_file_view_drop_flag( ecl_file_view , ECL_FILE_CLOSE_STREAM );
+      const ecl_rsthead_type * prev = NULL;
+
+      for (seqnum_nr = 0; seqnum_nr < num_seqnum; seqnum_nr++) {
+        if ((intehead_index[seqnum_nr] >= 0) && (doubhead_index[seqnum_nr] >= 0)) {
+          const ecl_kw_type * seqnum_kw   = ecl_file_view_iget_kw( ecl_file_view , seqnum_index[seqnum_nr] );
+          const ecl_kw_type * intehead_kw = ecl_file_view_iget_kw( ecl_file_view , intehead_index[seqnum_nr] );
+          const ecl_kw_type * doubhead_kw = ecl_file_view_iget_kw( ecl_file_view , doubhead_index[seqnum_nr] );
+          const ecl_kw_type * logihead_kw = NULL;
+          ecl_rsthead_type * rsthead;
+
+          if (logihead_index[seqnum_nr] >= 0)
+            logihead_kw = ecl_file_view_iget_kw( ecl_file_view , logihead_index[seqnum_nr] );
+
+          rsthead = ecl_rsthead_alloc_from_kw( ecl_kw_iget_int( seqnum_kw , 0 ) , intehead_kw , doubhead_kw , logihead_kw );
+          if (prev) {
+            if ((rsthead->sim_time < prev->sim_time) || (rsthead->sim_days < prev->sim_days))
+              *time_sorted = false;
+            if (rsthead->report_step < prev->report_step)
+              *report_sorted = false;
+          }
+          vector_append_owned_ref( rsthead_list , rsthead , ecl_file_view_rsthead_free__ );
+          prev = rsthead;
+        } else {
+          vector_append_ref( rsthead_list , NULL );
+          *time_sorted = false;
+          *report_sorted = false;
+        }
+      }
+
+      if (close_stream) {
+        ecl_file_view_add_flag( ecl_file_view , ECL_FILE_CLOSE_STREAM );
+        fortio_fclose_stream( ecl_file_view->fortio );
+      }
+    }
+
+    free( seqnum_index );
+    free( intehead_index );
+    free( doubhead_index );
+    free( logihead_index );
+  }
+
+  return rsthead_list;
+}
+
+
+static const vector_type * ecl_file_view_get_rsthead_list( const ecl_file_view_type * ecl_file_view ) {
+  if (!ecl_file_view->rsthead_list) {
+    ecl_file_view_type * view = (ecl_file_view_type *) ecl_file_view;
+    view->rsthead_list = ecl_file_view_alloc_rsthead_list( view , &view->rsthead_time_sorted , &view->rsthead_report_sorted );
+  }
+  return ecl_file_view->rsthead_list;
+}
+
+
+/*
+  True if the restart header table has already been built; building
+  it reads the header keywords of every SEQNUM block in the view.
+*/
+
+bool ecl_file_view_has_rsthead_table( const ecl_file_view_type * ecl_file_view ) {
+  return (ecl_file_view->rsthead_list != NULL);
+}
+
+
+/**
+   Will return the restart header of SEQNUM block nr @seqnum_index, or
+   NULL if the view does not have such a block.
+*/
+
+const ecl_rsthead_type * ecl_file_view_iget_rsthead( const ecl_file_view_type * ecl_file_view , int seqnum_index) {
+  const vector_type * rsthead_list = ecl_file_view_get_rsthead_list( ecl_file_view );
+  if ((seqnum_index >= 0) && (seqnum_index < vector_get_size( rsthead_list )))
+    return vector_iget_const( rsthead_list , seqnum_index );
   else
-    return false;
+    return NULL;
 }
 
 
-time_t ecl_file_view_iget_restart_sim_date(const ecl_file_view_type * ecl_file_view , int seqnum_index) {
-  time_t sim_time = -1;
-  ecl_file_view_type * seqnum_map = seqnum_map = ecl_file_view_alloc_blockview( ecl_file_view , SEQNUM_KW , seqnum_index);
+static int ecl_file_view_rsthead_find_report_step( const ecl_file_view_type * ecl_file_view , int report_step) {
+  const vector_type * rsthead_list = ecl_file_view_get_rsthead_list( ecl_file_view );
+  const int size = vector_get_size( rsthead_list );
+
+  if (ecl_file_view->rsthead_report_sorted) {
+    int lower_index = 0;
+    int upper_index = size;
 
-  if (seqnum_map != NULL) {
-    ecl_kw_type * intehead_kw = ecl_file_view_iget_named_kw( seqnum_map , INTEHEAD_KW , 0);
-    sim_time = ecl_rsthead_date( intehead_kw );
-    ecl_file_view_free( seqnum_map );
+    while (lower_index < upper_index) {
+      int center_index = (lower_index + upper_index) / 2;
+      const ecl_rsthead_type * rsthead = vector_iget_const( rsthead_list , center_index );
+      if (rsthead->report_step < report_step)
+        lower_index = center_index + 1;
+      else
+        upper_index = center_index;
+    }
+
+    if (lower_index < size) {
+      const ecl_rsthead_type * rsthead = vector_iget_const( rsthead_list , lower_index );
+      if (rsthead->report_step == report_step)
+        return lower_index;
+    }
+  } else {
+    int index;
+    for (index = 0; index < size; index++) {
+      const ecl_rsthead_type * rsthead = vector_iget_const( rsthead_list , index );
+      if (rsthead && (rsthead->report_step == report_step))
+        return index;
+    }
   }
+  return -1;
+}
+
 
-  return sim_time;
+static int ecl_file_view_rsthead_find_sim_time( const ecl_file_view_type * ecl_file_view , time_t sim_time) {
+  const vector_type * rsthead_list = ecl_file_view_get_rsthead_list( ecl_file_view );
+  const int size = vector_get_size( rsthead_list );
+
+  if (ecl_file_view->rsthead_time_sorted) {
+    int lower_index = 0;
+    int upper_index = size;
+
+    while (lower_index < upper_index) {
+      int center_index = (lower_index + upper_index) / 2;
+      const ecl_rsthead_type * rsthead = vector_iget_const( rsthead_list , center_index );
+      if (rsthead->sim_time < sim_time)
+        lower_index = center_index + 1;
+      else
+        upper_index = center_index;
+    }
+
+    if (lower_index < size) {
+      const ecl_rsthead_type * rsthead = vector_iget_const( rsthead_list , lower_index );
+      if (rsthead->sim_time == sim_time)
+        return lower_index;
+    }
+  } else {
+    int index;
+    for (index = 0; index < size; index++) {
+      const ecl_rsthead_type * rsthead = vector_iget_const( rsthead_list , index );
+      if (rsthead && (rsthead->sim_time == sim_time))
+        return index;
+    }
+  }
+  return -1;
 }
 
 
-double ecl_file_view_iget_restart_sim_days(const ecl_file_view_type * ecl_file_view , int seqnum_index) {
-  double sim_days = 0;
-  ecl_file_view_type * seqnum_map = ecl_file_view_alloc_blockview( ecl_file_view , SEQNUM_KW , seqnum_index);
+/*
+  The sim_days comparison is approximate, so the binary search locates
+  the first block with sim_days not smaller than @sim_days, and the
+  block before it is also considered.
+*/
+
+static int ecl_file_view_rsthead_find_sim_days( const ecl_file_view_type * ecl_file_view , double sim_days) {
+  const vector_type * rsthead_list = ecl_file_view_get_rsthead_list( ecl_file_view );
+  const int size = vector_get_size( rsthead_list );
+
+  if (ecl_file_view->rsthead_time_sorted) {
+    int lower_index = 0;
+    int upper_index = size;
+    int index;
+
+    while (lower_index < upper_index) {
+      int center_index = (lower_index + upper_index) / 2;
+      const ecl_rsthead_type * rsthead = vector_iget_const( rsthead_list , center_index );
+      if (rsthead->sim_days < sim_days)
+        lower_index = center_index + 1;
+      else
+        upper_index = center_index;
+    }
 
-  if (seqnum_map != NULL) {
-    ecl_kw_type * doubhead_kw = ecl_file_view_iget_named_kw( seqnum_map , DOUBHEAD_KW , 0);
-    sim_days = ecl_kw_iget_double( doubhead_kw , DOUBHEAD_DAYS_INDEX);
-    ecl_file_view_free( seqnum_map );
+    for (index = util_int_max( 0 , lower_index - 1 ); index < util_int_min( size , lower_index + 1 ); index++) {
+      const ecl_rsthead_type * rsthead = vector_iget_const( rsthead_list , index );
+      if (util_double_approx_equal( sim_days , rsthead->sim_days ))
+        return index;
+    }
+  } else {
+    int index;
+    for (index = 0; index < size; index++) {
+      const ecl_rsthead_type * rsthead = vector_iget_const( rsthead_list , index );
+      if (rsthead && util_double_approx_equal( sim_days , rsthead->sim_days ))
+        return index;
+    }
   }
+  return -1;
+}
+
 
-  return sim_days;
+bool ecl_file_view_has_report_step( const ecl_file_view_type * ecl_file_view , int report_step) {
+  if (ecl_file_view_rsthead_find_report_step( ecl_file_view , report_step ) >= 0)
+    return true;
+  else
+    return false;
 }
 
 
+time_t ecl_file_view_iget_restart_sim_date(const ecl_file_view_type * ecl_file_view , int seqnum_index) {
+  const ecl_rsthead_type * rsthead = ecl_file_view_iget_rsthead( ecl_file_view , seqnum_index );
+  if (rsthead)
+    return rsthead->sim_time;
+  else
+    return -1;
+}
+
+
+double ecl_file_view_iget_restart_sim_days(const ecl_file_view_type * ecl_file_view , int seqnum_index) {
+  const ecl_rsthead_type * rsthead = ecl_file_view_iget_rsthead( ecl_file_view , seqnum_index );
+  if (rsthead)
+    return rsthead->sim_days;
+  else
+    return 0;
+}
 
 
+
+/*
+  The return value is the INTEHEAD occurence number; when there is one
+  INTEHEAD keyword for each SEQNUM block, i.e. no LGRs, this is the
+  same as the SEQNUM occurence and the restart header table is
+  used. Otherwise, e.g. for files with LGRs or non-unified restart
+  files without SEQNUM, the INTEHEAD keywords are scanned.
+*/
+
 int ecl_file_view_find_sim_time(const ecl_file_view_type * ecl_file_view , time_t sim_time) {
   int seqnum_index = -1;
   if ( ecl_file_view_has_kw( ecl_file_view , INTEHEAD_KW)) {
     const int_vector_type * intehead_index_list = hash_get( ecl_file_view->kw_index , INTEHEAD_KW );
-    int index = 0;
-    while (index < int_vector_size( intehead_index_list )) {
-      const ecl_kw_type * intehead_kw = ecl_file_view_iget_kw( ecl_file_view , int_vector_iget( intehead_index_list , index ));
-      if (ecl_rsthead_date( intehead_kw ) == sim_time) {
-        seqnum_index = index;
-        break;
+
+    if (int_vector_size( intehead_index_list ) == ecl_file_view_get_num_named_kw( ecl_file_view , SEQNUM_KW ))
+      seqnum_index = ecl_file_view_rsthead_find_sim_time( ecl_file_view , sim_time );
+    else {
+      int index = 0;
+      while (index < int_vector_size( intehead_index_list )) {
+        const ecl_kw_type * intehead_kw = ecl_file_view_iget_kw( ecl_file_view , int_vector_iget( intehead_index_list , index ));
+        if (ecl_rsthead_date( intehead_kw ) == sim_time) {
+          seqnum_index = index;
+          break;
+        }
+        index++;
       }
-      index++;
     }
   }
   return seqnum_index;
@@ -605,21 +1099,23 @@ int ecl_file_view_find_sim_time(const ecl_file_view_type * ecl_file_view , time_
 
 
 /**
-   This function will scan through the ecl_file looking for INTEHEAD
-   headers corresponding to sim_time. If sim_time is found the
-   function will return the INTEHEAD occurence number, i.e. for a
-   unified restart file like:
+   This function will look through the restart headers of the view
+   for a SEQNUM block with simulation time equal to sim_time, i.e. for
+   a unified restart file like:
 
+   SEQNUM    /  0
    INTEHEAD  /  01.01.2000
    ...
    PRESSURE
    SWAT
    ...
+   SEQNUM    /  5
    INTEHEAD  /  01.03.2000
    ...
    PRESSURE
    SWAT
    ...
+   SEQNUM    /  10
    INTEHEAD  /  01.05.2000
    ...
    PRESSURE
@@ -628,112 +1124,40 @@ int ecl_file_view_find_sim_time(const ecl_file_view_type * ecl_file_view , time_
 
    The function call:
 
-   ecl_file_get_restart_index( restart_file , (time_t) "01.03.2000")
+   ecl_file_view_has_sim_time( restart_view , (time_t) "01.03.2000")
 
-   will return 1. Observe that this will in general NOT agree with the
-   DATES step number.
-
-   If the sim_time can not be found the function will return -1, that
-   includes the case when the file in question is not a restart file
-   at all, and no INTEHEAD headers can be found.
+   will return true, whereas a time between two report steps will
+   return false. A view without SEQNUM keywords, e.g. a non-unified
+   restart file, has no restart headers and will always return false.
 
    Observe that the function requires on-the-second-equality; which is
    of course quite strict.
-
-   Each report step only has one occurence of SEQNUM, but one INTEHEAD
-   for each LGR; i.e. one should call iselect_rstblock() prior to
-   calling this function.
 */
 
 
 bool ecl_file_view_has_sim_time( const ecl_file_view_type * ecl_file_view , time_t sim_time) {
-  int num_INTEHEAD = ecl_file_view_get_num_named_kw( ecl_file_view , INTEHEAD_KW );
-  if (num_INTEHEAD == 0)
-    return false;       /* We have no INTEHEAD headers - probably not a restart file at all. */
-  else {
-    int intehead_index = 0;
-    while (true) {
-      time_t itime = ecl_file_view_iget_restart_sim_date( ecl_file_view , intehead_index );
-
-      if (itime == sim_time) /* Perfect hit. */
-        return true;
-
-      if (itime > sim_time)  /* We have gone past the target_time - i.e. we do not have it. */
-        return false;
-
-      intehead_index++;
-      if (intehead_index == num_INTEHEAD)  /* We have iterated through the whole thing without finding sim_time. */
-        return false;
-    }
-  }
+  if (ecl_file_view_rsthead_find_sim_time( ecl_file_view , sim_time ) >= 0)
+    return true;
+  else
+    return false;
 }
 
 
 bool ecl_file_view_has_sim_days( const ecl_file_view_type * ecl_file_view , double sim_days) {
-  int num_DOUBHEAD = ecl_file_view_get_num_named_kw( ecl_file_view , DOUBHEAD_KW );
-  if (num_DOUBHEAD == 0)
-    return false;       /* We have no DOUBHEAD headers - probably not a restart file at all. */
-  else {
-    int doubhead_index = 0;
-    while (true) {
-      double file_sim_days  = ecl_file_view_iget_restart_sim_days( ecl_file_view , doubhead_index );
-
-      if (util_double_approx_equal(sim_days, file_sim_days)) /* Perfect hit. */
-        return true;
-
-      if (file_sim_days > sim_days)  /* We have gone past the target_time - i.e. we do not have it. */
-        return false;
-
-      doubhead_index++;
-      if (doubhead_index == num_DOUBHEAD)  /* We have iterated through the whole thing without finding sim_time. */
-        return false;
-    }
-  }
+  if (ecl_file_view_rsthead_find_sim_days( ecl_file_view , sim_days ) >= 0)
+    return true;
+  else
+    return false;
 }
 
 
-
-
 int ecl_file_view_seqnum_index_from_sim_time( ecl_file_view_type * parent_map , time_t sim_time) {
-  int num_seqnum = ecl_file_view_get_num_named_kw( parent_map , SEQNUM_KW );
-  ecl_file_view_type * seqnum_map;
-
-  for (int s_idx = 0; s_idx < num_seqnum; s_idx++) {
-    seqnum_map = ecl_file_view_alloc_blockview( parent_map , SEQNUM_KW , s_idx );
-
-    if (!seqnum_map)
-      continue;
-
-    bool sim = ecl_file_view_has_sim_time( seqnum_map , sim_time);
-    ecl_file_view_free( seqnum_map );
-    if (sim)
-      return s_idx;
-  }
-  return -1;
+  return ecl_file_view_rsthead_find_sim_time( parent_map , sim_time );
 }
 
 
 int ecl_file_view_seqnum_index_from_sim_days( ecl_file_view_type * file_view , double sim_days) {
-  int num_seqnum = ecl_file_view_get_num_named_kw( file_view , SEQNUM_KW );
-  int seqnum_index = 0;
-  ecl_file_view_type * seqnum_map;
-
-  while (true) {
-    seqnum_map = ecl_file_view_alloc_blockview( file_view , SEQNUM_KW , seqnum_index);
-
-    if (seqnum_map != NULL) {
-      if (ecl_file_view_has_sim_days( seqnum_map , sim_days)) {
-        ecl_file_view_free( seqnum_map );
-        return seqnum_index;
-      } else {
-        ecl_file_view_free( seqnum_map );
-        seqnum_index++;
-      }
-    }
-
-    if (num_seqnum == seqnum_index)
-      return -1;
-  }
+  return ecl_file_view_rsthead_find_sim_days( file_view , sim_days );
 }
 
 
@@ -747,11 +1171,9 @@ ecl_file_view_type * ecl_file_view_add_restart_view( ecl_file_view_type * file_v
 
   if (input_index >= 0)
     seqnum_index = input_index;
-  else if (report_step >= 0) {
-    int global_index = ecl_file_view_find_kw_value( file_view , SEQNUM_KW , &report_step);
-    if ( global_index >= 0)
-      seqnum_index = ecl_file_view_iget_occurence( file_view , global_index );
-  } else if (sim_time != -1)
+  else if (report_step >= 0)
+    seqnum_index = ecl_file_view_rsthead_find_report_step( file_view , report_step );
+  else if (sim_time != -1)
     seqnum_index = ecl_file_view_seqnum_index_from_sim_time( file_view , sim_time );
   else if (sim_days >= 0)
     seqnum_index = ecl_file_view_seqnum_index_from_sim_days( file_view , sim_days );
@@ -811,11 +1233,14 @@ ecl_file_transaction_type * ecl_file_view_start_transaction(ecl_file_view_type *
   int size = ecl_file_view_get_size(file_view);
   t->file_view = file_view;
   t->ref_count = util_malloc( size * sizeof * t->ref_count );
+  t->resident = util_malloc( size * sizeof * t->resident );
   for (int i = 0; i < size; i++) {
     ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw(file_view, i);
-    ecl_file_kw_start_transaction(file_kw, &t->ref_count[i]);
+    ecl_file_kw_start_transaction(file_kw, &t->ref_count[i], &t->resident[i]);
   }
 
+  if (file_view->kw_cache)
+    ecl_file_kw_cache_start_transaction( file_view->kw_cache );
   return t;
 }
 
@@ -824,10 +1249,16 @@ void ecl_file_view_end_transaction( ecl_file_view_type * file_view, ecl_file_tra
     util_abort("%s: internal error - file_view / transaction mismatch\n",__func__);
 
   const int * ref_count = transaction->ref_count;
+  const bool * resident = transaction->resident;
   for (int i = 0; i < ecl_file_view_get_size(file_view); i++) {
     ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw(file_view, i);
-    ecl_file_kw_end_transaction(file_kw, ref_count[i]);
+    ecl_file_kw_end_transaction(file_kw, file_view->inv_map, ref_count[i], resident[i]);
   }
+  if (file_view->kw_cache)
+    ecl_file_kw_cache_end_transaction( file_view->kw_cache );
+  free( transaction->ref_count );
+  free( transaction->resident );
+  free( transaction );
 }
 
 
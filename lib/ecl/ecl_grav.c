@@ -33,6 +33,7 @@
 #include <ert/ecl/ecl_grav.h>
 #include <ert/ecl/ecl_kw_magic.h>
 #include <ert/ecl/ecl_grav_common.h>
+#include <ert/ecl/ecl_grav_tree.h>
 
 
 /**
@@ -572,7 +573,7 @@ static double ecl_grav_survey_eval( const ecl_grav_survey_type * base_survey,
 ecl_grav_type * ecl_grav_alloc( const ecl_grid_type * ecl_grid, const ecl_file_type * init_file) {
   ecl_grav_type * ecl_grav = util_malloc( sizeof * ecl_grav );
   ecl_grav->init_file      = init_file;
-  ecl_grav->grid_cache     = ecl_grid_cache_alloc( ecl_grid );
+  ecl_grav->grid_cache     = ecl_grid_get_cache( ecl_grid );
   ecl_grav->aquifer_cell   = ecl_grav_common_alloc_aquifer_cell( ecl_grav->grid_cache , ecl_grav->init_file );
 
   ecl_grav->surveys        = hash_alloc();
@@ -645,6 +646,106 @@ double ecl_grav_eval( const ecl_grav_type * grav , const char * base, const char
 }
 
 
+/*
+  Will allocate an array with the total mass difference of all the
+  phases in @phase_mask between the base and monitor surveys.
+*/
+
+static double * ecl_grav_alloc_mass_diff( const ecl_grav_type * grav , const char * base, const char * monitor , int phase_mask) {
+  ecl_grav_survey_type * base_survey    = ecl_grav_get_survey( grav , base );
+  ecl_grav_survey_type * monitor_survey = ecl_grav_get_survey( grav , monitor );
+  const int size       = ecl_grid_cache_get_size( grav->grid_cache );
+  const int num_phases = vector_get_size( base_survey->phase_list );
+  double * mass_diff   = util_calloc( size , sizeof * mass_diff );
+  int index;
+  int phase_nr;
+
+  if (monitor_survey != NULL) {
+    for (phase_nr = 0; phase_nr < num_phases; phase_nr++) {
+      const ecl_grav_phase_type * base_phase    = vector_iget_const( base_survey->phase_list , phase_nr );
+      const ecl_grav_phase_type * monitor_phase = vector_iget_const( monitor_survey->phase_list , phase_nr );
+      if ((base_phase->phase & phase_mask) && (base_phase->phase != monitor_phase->phase))
+        util_abort("%s comparing different phases ... \n",__func__);
+    }
+  }
+
+  /*
+    util_calloc() does not initialize the memory; every element is
+    assigned the sum over the selected phases.
+  */
+  for (index = 0; index < size; index++) {
+    double diff = 0;
+
+    for (phase_nr = 0; phase_nr < num_phases; phase_nr++) {
+      const ecl_grav_phase_type * base_phase = vector_iget_const( base_survey->phase_list , phase_nr );
+      if (base_phase->phase & phase_mask) {
+        if (monitor_survey != NULL) {
+          const ecl_grav_phase_type * monitor_phase = vector_iget_const( monitor_survey->phase_list , phase_nr );
+          diff += monitor_phase->fluid_mass[index] - base_phase->fluid_mass[index];
+        } else
+          diff -= base_phase->fluid_mass[index];
+      }
+    }
+
+    mass_diff[index] = diff;
+  }
+
+  return mass_diff;
+}
+
+
+/**
+   Evaluates the gravity change between the @base and @monitor surveys
+   for @num_stations stations in one call; the result for station i
+   is stored in deltag[i] and equals the result of ecl_grav_eval()
+   with the same arguments, up to floating point rounding.
+
+   The mass differences of all the selected phases are combined to one
+   weight array up front, so the sum over the cells is done only once
+   per station, and the stations are evaluated in parallel.
+*/
+
+void ecl_grav_eval_stations( const ecl_grav_type * grav , const char * base, const char * monitor , ecl_region_type * region ,
+                             int num_stations , const double * utm_x, const double * utm_y , const double * depth, int phase_mask , double * deltag) {
+  double * mass_diff = ecl_grav_alloc_mass_diff( grav , base , monitor , phase_mask );
+  int station;
+
+  ecl_grav_common_eval_biot_savart_stations( grav->grid_cache , region , grav->aquifer_cell , mass_diff , num_stations , utm_x , utm_y , depth , deltag );
+  for (station = 0; station < num_stations; station++)
+    deltag[station] *= 6.67428E-3;
+
+  free( mass_diff );
+}
+
+
+/**
+   Approximate version of ecl_grav_eval_stations() based on an octree
+   over the cells, see ecl_grav_tree.c for the meaning of @theta. If
+   @error_bound is non NULL it should point to an array of
+   @num_stations elements which is filled with an upper bound for the
+   absolute error of each deltag value.
+*/
+
+void ecl_grav_eval_stations_approx( const ecl_grav_type * grav , const char * base, const char * monitor , ecl_region_type * region ,
+                                    int num_stations , const double * utm_x, const double * utm_y , const double * depth, int phase_mask ,
+                                    double theta , double * deltag , double * error_bound) {
+  double * mass_diff = ecl_grav_alloc_mass_diff( grav , base , monitor , phase_mask );
+  ecl_grav_tree_type * tree = ecl_grav_tree_alloc( grav->grid_cache , region , grav->aquifer_cell , mass_diff , ECL_GRAV_TREE_LEAF_SIZE );
+  int station;
+
+#pragma omp parallel for schedule(dynamic)
+  for (station = 0; station < num_stations; station++) {
+    double error;
+    deltag[station] = 6.67428E-3 * ecl_grav_tree_eval_biot_savart( tree , theta , utm_x[station] , utm_y[station] , depth[station] , &error );
+    if (error_bound)
+      error_bound[station] = 6.67428E-3 * error;
+  }
+
+  ecl_grav_tree_free( tree );
+  free( mass_diff );
+}
+
+
 /******************************************************************/
 /* The functions ecl_grav_new_std_density() and ecl_grav_add_std_density() are
    used to "install" standard conditions densities for the various phases
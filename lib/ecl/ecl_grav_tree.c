@@ -0,0 +1,418 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grav_tree.c' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_region.h>
+#include <ert/ecl/ecl_grid_cache.h>
+#include <ert/ecl/ecl_grav_common.h>
+#include <ert/ecl/ecl_grav_tree.h>
+
+/**
+   The ecl_grav_tree structure is an octree over the cell centers and
+   weights of the cells contributing to a gravity or subsidence sum;
+   it is used to evaluate the sums approximately in the style of
+   Barnes-Hut: when a node is far away from the station compared to
+   its size, all the cells in the node are replaced with one point
+   source with the total weight of the node, placed at the |weight|
+   weighted center of the node.
+
+   A node is approximated when
+
+       diameter(node) < theta * distance(station , center(node))
+
+   i.e. theta == 0 gives the exact sum, and larger theta values give
+   faster and less accurate results; theta ~ 0.5 is a common choice.
+
+   The evaluation functions also return an upper bound for the total
+   approximation error. For an approximated node the error is bounded
+   by:
+
+       sum(|w|) * radius * max|grad K|
+
+   where radius is the maximum distance from the center to the node
+   bounding box, and max|grad K| is a bound on the gradient of the
+   kernel over the bounding box, evaluated from the minimum distance
+   between the station and the box. Since this is a worst case bound
+   the real error is typically orders of magnitude smaller.
+*/
+
+#define ECL_GRAV_TREE_TYPE_ID  66104187
+#define ECL_GRAV_TREE_MAX_DEPTH 32
+
+
+typedef struct {
+  int     begin;
+  int     end;
+  int     child[8];
+  int     num_children;
+  double  xmin , xmax , ymin , ymax , zmin , zmax;
+  double  cx , cy , cz;
+  double  weight;        /* Sum of the weights in the node. */
+  double  abs_weight;    /* Sum of the absolute values of the weights in the node. */
+  double  diameter;      /* Diagonal of the bounding box. */
+  double  radius;        /* Max distance from (cx,cy,cz) to the bounding box. */
+} ecl_grav_tree_node_type;
+
+
+struct ecl_grav_tree_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int                        size;
+  double                   * xpos;
+  double                   * ypos;
+  double                   * zpos;
+  double                   * weight;
+  int                        leaf_size;
+  int                        num_nodes;
+  int                        alloc_nodes;
+  ecl_grav_tree_node_type  * nodes;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_grav_tree , ECL_GRAV_TREE_TYPE_ID )
+
+
+static int ecl_grav_tree_add_node( ecl_grav_tree_type * tree , int begin , int end) {
+  if (tree->num_nodes == tree->alloc_nodes) {
+    tree->alloc_nodes = 2 * tree->alloc_nodes + 16;
+    tree->nodes = util_realloc( tree->nodes , tree->alloc_nodes * sizeof * tree->nodes );
+  }
+  {
+    ecl_grav_tree_node_type * node = &tree->nodes[ tree->num_nodes ];
+    node->begin        = begin;
+    node->end          = end;
+    node->num_children = 0;
+  }
+  tree->num_nodes++;
+  return tree->num_nodes - 1;
+}
+
+
+static void ecl_grav_tree_init_node( ecl_grav_tree_type * tree , ecl_grav_tree_node_type * node) {
+  double wx = 0 , wy = 0 , wz = 0;
+  int i;
+
+  node->xmin = node->xmax = tree->xpos[ node->begin ];
+  node->ymin = node->ymax = tree->ypos[ node->begin ];
+  node->zmin = node->zmax = tree->zpos[ node->begin ];
+  node->weight     = 0;
+  node->abs_weight = 0;
+
+  for (i = node->begin; i < node->end; i++) {
+    double abs_w = fabs( tree->weight[i] );
+    node->xmin = util_double_min( node->xmin , tree->xpos[i] );
+    node->xmax = util_double_max( node->xmax , tree->xpos[i] );
+    node->ymin = util_double_min( node->ymin , tree->ypos[i] );
+    node->ymax = util_double_max( node->ymax , tree->ypos[i] );
+    node->zmin = util_double_min( node->zmin , tree->zpos[i] );
+    node->zmax = util_double_max( node->zmax , tree->zpos[i] );
+
+    node->weight     += tree->weight[i];
+    node->abs_weight += abs_w;
+    wx += abs_w * tree->xpos[i];
+    wy += abs_w * tree->ypos[i];
+    wz += abs_w * tree->zpos[i];
+  }
+
+  if (node->abs_weight > 0) {
+    node->cx = util_double_min( node->xmax , util_double_max( node->xmin , wx / node->abs_weight ));
+    node->cy = util_double_min( node->ymax , util_double_max( node->ymin , wy / node->abs_weight ));
+    node->cz = util_double_min( node->zmax , util_double_max( node->zmin , wz / node->abs_weight ));
+  } else {
+    node->cx = 0.5 * (node->xmin + node->xmax);
+    node->cy = 0.5 * (node->ymin + node->ymax);
+    node->cz = 0.5 * (node->zmin + node->zmax);
+  }
+
+  {
+    double dx = node->xmax - node->xmin;
+    double dy = node->ymax - node->ymin;
+    double dz = node->zmax - node->zmin;
+    double rx = util_double_max( node->cx - node->xmin , node->xmax - node->cx );
+    double ry = util_double_max( node->cy - node->ymin , node->ymax - node->cy );
+    double rz = util_double_max( node->cz - node->zmin , node->zmax - node->cz );
+
+    node->diameter = sqrt( dx*dx + dy*dy + dz*dz );
+    node->radius   = sqrt( rx*rx + ry*ry + rz*rz );
+  }
+}
+
+
+/*
+  Will sort the points in [begin,end) into the eight octants around
+  the midpoint of the bounding box, and recursively create a child
+  node for every non-empty octant.
+*/
+
+static int ecl_grav_tree_build_node( ecl_grav_tree_type * tree , double * scratch , int begin , int end , int depth) {
+  int node_index = ecl_grav_tree_add_node( tree , begin , end );
+  ecl_grav_tree_node_type * node = &tree->nodes[ node_index ];
+  ecl_grav_tree_init_node( tree , node );
+
+  if ((end - begin) > tree->leaf_size && depth < ECL_GRAV_TREE_MAX_DEPTH && node->diameter > 0) {
+    const double xmid = 0.5 * (node->xmin + node->xmax);
+    const double ymid = 0.5 * (node->ymin + node->ymax);
+    const double zmid = 0.5 * (node->zmin + node->zmax);
+    int offset[9] = {0};
+    int octant;
+    int i;
+
+    for (i = begin; i < end; i++) {
+      octant = (tree->xpos[i] > xmid) + 2*(tree->ypos[i] > ymid) + 4*(tree->zpos[i] > zmid);
+      offset[octant + 1]++;
+    }
+    for (octant = 0; octant < 8; octant++)
+      offset[octant + 1] += offset[octant];
+
+    {
+      int pos[8];
+      const int n = end - begin;
+      for (octant = 0; octant < 8; octant++)
+        pos[octant] = offset[octant];
+
+      for (i = begin; i < end; i++) {
+        int target;
+        octant = (tree->xpos[i] > xmid) + 2*(tree->ypos[i] > ymid) + 4*(tree->zpos[i] > zmid);
+        target = pos[octant]++;
+        scratch[ target ]         = tree->xpos[i];
+        scratch[ target + n ]     = tree->ypos[i];
+        scratch[ target + 2*n ]   = tree->zpos[i];
+        scratch[ target + 3*n ]   = tree->weight[i];
+      }
+
+      for (i = 0; i < n; i++) {
+        tree->xpos[ begin + i ]   = scratch[ i ];
+        tree->ypos[ begin + i ]   = scratch[ i + n ];
+        tree->zpos[ begin + i ]   = scratch[ i + 2*n ];
+        tree->weight[ begin + i ] = scratch[ i + 3*n ];
+      }
+    }
+
+    for (octant = 0; octant < 8; octant++) {
+      if (offset[octant + 1] > offset[octant]) {
+        int child = ecl_grav_tree_build_node( tree , scratch , begin + offset[octant] , begin + offset[octant + 1] , depth + 1);
+        node = &tree->nodes[ node_index ];   /* The nodes array might have been reallocated. */
+        node->child[ node->num_children ] = child;
+        node->num_children++;
+      }
+    }
+  }
+
+  return node_index;
+}
+
+
+/**
+   Will build a tree over the active cells in @region (all active
+   cells if region == NULL) which are not aquifer cells; the weights
+   are copied into the tree, i.e. a new tree must be allocated when
+   the weights change. Nodes with @leaf_size cells or less are not
+   split further.
+*/
+
+ecl_grav_tree_type * ecl_grav_tree_alloc( const ecl_grid_cache_type * grid_cache , ecl_region_type * region , const bool * aquifer , const double * weight , int leaf_size) {
+  ecl_grav_tree_type * tree = util_malloc( sizeof * tree );
+  const double * xpos = ecl_grid_cache_get_xpos( grid_cache );
+  const double * ypos = ecl_grid_cache_get_ypos( grid_cache );
+  const double * zpos = ecl_grid_cache_get_zpos( grid_cache );
+  const int * index_list = NULL;
+  int max_size;
+
+  UTIL_TYPE_ID_INIT( tree , ECL_GRAV_TREE_TYPE_ID );
+  if (region == NULL)
+    max_size = ecl_grid_cache_get_size( grid_cache );
+  else {
+    const int_vector_type * index_vector = ecl_region_get_active_list( region );
+    max_size   = int_vector_size( index_vector );
+    index_list = int_vector_get_const_ptr( index_vector );
+  }
+
+  tree->leaf_size   = util_int_max( 1 , leaf_size );
+  tree->num_nodes   = 0;
+  tree->alloc_nodes = 0;
+  tree->nodes       = NULL;
+  tree->xpos        = util_calloc( util_int_max( 1 , max_size ) , sizeof * tree->xpos );
+  tree->ypos        = util_calloc( util_int_max( 1 , max_size ) , sizeof * tree->ypos );
+  tree->zpos        = util_calloc( util_int_max( 1 , max_size ) , sizeof * tree->zpos );
+  tree->weight      = util_calloc( util_int_max( 1 , max_size ) , sizeof * tree->weight );
+  tree->size        = 0;
+  {
+    int i;
+    for (i = 0; i < max_size; i++) {
+      int index = index_list ? index_list[i] : i;
+      if (!aquifer[index]) {
+        tree->xpos[ tree->size ]   = xpos[index];
+        tree->ypos[ tree->size ]   = ypos[index];
+        tree->zpos[ tree->size ]   = zpos[index];
+        tree->weight[ tree->size ] = weight[index];
+        tree->size++;
+      }
+    }
+  }
+
+  if (tree->size > 0) {
+    double * scratch = util_calloc( 4 * tree->size , sizeof * scratch );
+    ecl_grav_tree_build_node( tree , scratch , 0 , tree->size , 0 );
+    free( scratch );
+  }
+
+  return tree;
+}
+
+
+void ecl_grav_tree_free( ecl_grav_tree_type * tree ) {
+  free( tree->xpos );
+  free( tree->ypos );
+  free( tree->zpos );
+  free( tree->weight );
+  util_safe_free( tree->nodes );
+  free( tree );
+}
+
+
+int ecl_grav_tree_get_size( const ecl_grav_tree_type * tree ) {
+  return tree->size;
+}
+
+
+int ecl_grav_tree_get_num_nodes( const ecl_grav_tree_type * tree ) {
+  return tree->num_nodes;
+}
+
+
+/*****************************************************************/
+
+static double ecl_grav_tree_box_distance( double x , double y , double z , double xmin , double xmax , double ymin , double ymax , double zmin , double zmax) {
+  double dx = util_double_max( 0 , util_double_max( xmin - x , x - xmax ));
+  double dy = util_double_max( 0 , util_double_max( ymin - y , y - ymax ));
+  double dz = util_double_max( 0 , util_double_max( zmin - z , z - zmax ));
+  return sqrt( dx*dx + dy*dy + dz*dz );
+}
+
+
+static double ecl_grav_tree_biot_savart_point( double x , double y , double z , double utm_x , double utm_y , double depth) {
+  double dist_x  = x - utm_x;
+  double dist_y  = y - utm_y;
+  double dist_z  = z - depth;
+  double dist    = sqrt( dist_x*dist_x + dist_y*dist_y + dist_z*dist_z );
+  return dist_z / (dist * dist * dist);
+}
+
+
+/*
+  Common traversal for the two kernels. For the Geertsma kernel the
+  bound must also take the mirror image of the node bounding box
+  above the seabed into account.
+*/
+
+static double ecl_grav_tree_eval__( const ecl_grav_tree_type * tree , bool geertsma , double theta ,
+                                    double utm_x , double utm_y , double depth , double poisson_ratio , double seabed ,
+                                    double * error_bound) {
+  int stack[ 8 * ECL_GRAV_TREE_MAX_DEPTH + 8 ];
+  int stack_size = 0;
+  double sum   = 0;
+  double error = 0;
+  const double k = 3 - 4*poisson_ratio;
+
+  if (tree->num_nodes > 0)
+    stack[ stack_size++ ] = 0;
+
+  while (stack_size > 0) {
+    const ecl_grav_tree_node_type * node = &tree->nodes[ stack[ --stack_size ] ];
+    bool approximate = false;
+
+    if (node->num_children > 0) {
+      double dx = node->cx - utm_x;
+      double dy = node->cy - utm_y;
+      double dz = node->cz - depth;
+      double dist = sqrt( dx*dx + dy*dy + dz*dz );
+
+      if (node->diameter < theta * dist) {
+        if (geertsma) {
+          double r1 = ecl_grav_tree_box_distance( utm_x , utm_y , depth ,
+                                                  node->xmin , node->xmax , node->ymin , node->ymax ,
+                                                  node->zmin - seabed , node->zmax - seabed );
+          double r2 = ecl_grav_tree_box_distance( utm_x , utm_y , depth ,
+                                                  node->xmin , node->xmax , node->ymin , node->ymax ,
+                                                  seabed - node->zmax , seabed - node->zmin );
+          if (r1 > 0 && r2 > 0) {
+            double grad = 4 / (r1*r1*r1) + 12 * fabs(k) / (r2*r2*r2) + 48 * fabs(depth) / (r2*r2*r2*r2);
+            sum   += node->weight * ecl_grav_common_geertsma_displacement( node->cx , node->cy , node->cz , utm_x , utm_y , depth , poisson_ratio , seabed );
+            error += node->abs_weight * node->radius * grad;
+            approximate = true;
+          }
+        } else {
+          double r = ecl_grav_tree_box_distance( utm_x , utm_y , depth ,
+                                                 node->xmin , node->xmax , node->ymin , node->ymax , node->zmin , node->zmax );
+          if (r > 0) {
+            sum   += node->weight * ecl_grav_tree_biot_savart_point( node->cx , node->cy , node->cz , utm_x , utm_y , depth );
+            error += node->abs_weight * node->radius * 4 / (r*r*r);
+            approximate = true;
+          }
+        }
+      }
+
+      if (!approximate) {
+        int ic;
+        for (ic = 0; ic < node->num_children; ic++)
+          stack[ stack_size++ ] = node->child[ic];
+      }
+    } else {
+      int i;
+      if (geertsma) {
+        for (i = node->begin; i < node->end; i++)
+          sum += tree->weight[i] * ecl_grav_common_geertsma_displacement( tree->xpos[i] , tree->ypos[i] , tree->zpos[i] , utm_x , utm_y , depth , poisson_ratio , seabed );
+      } else {
+        for (i = node->begin; i < node->end; i++)
+          sum += tree->weight[i] * ecl_grav_tree_biot_savart_point( tree->xpos[i] , tree->ypos[i] , tree->zpos[i] , utm_x , utm_y , depth );
+      }
+    }
+  }
+
+  if (error_bound)
+    *error_bound = error;
+  return sum;
+}
+
+
+/**
+   Approximation of ecl_grav_common_eval_biot_savart(); if
+   @error_bound is non NULL it is set to an upper bound for the
+   absolute difference from the exact sum.
+*/
+
+double ecl_grav_tree_eval_biot_savart( const ecl_grav_tree_type * tree , double theta , double utm_x , double utm_y , double depth , double * error_bound) {
+  return ecl_grav_tree_eval__( tree , false , theta , utm_x , utm_y , depth , 0 , 0 , error_bound );
+}
+
+
+/**
+   Approximation of ecl_grav_common_eval_geertsma(); if @error_bound
+   is non NULL it is set to an upper bound for the absolute difference
+   from the exact sum.
+*/
+
+double ecl_grav_tree_eval_geertsma( const ecl_grav_tree_type * tree , double theta , double utm_x , double utm_y , double depth , double poisson_ratio , double seabed , double * error_bound) {
+  return ecl_grav_tree_eval__( tree , true , theta , utm_x , utm_y , depth , poisson_ratio , seabed , error_bound );
+}
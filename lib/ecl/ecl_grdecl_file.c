@@ -0,0 +1,796 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grdecl_file.c' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+
+#include <ert/util/build_config.h>
+
+#ifdef HAVE_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include <ert/util/util.h>
+#include <ert/util/hash.h>
+#include <ert/util/int_vector.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_type.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_grdecl_file.h>
+
+/*
+  The ecl_grdecl_file structure is an alternative to the FILE based
+  functions in ecl_kw_grdecl.c for large GRDECL files, e.g. include
+  files with ZCORN, COORD and property keywords for big grids:
+
+   1. The file is mapped into memory with mmap(), or read in one
+      operation when mmap() is not available; there are no fscanf()
+      calls.
+
+   2. When the file is opened all the keywords in the file are
+      indexed in one pass; the index holds the header and the byte
+      range of the data section of each keyword. Loading a keyword
+      is then a lookup in the index instead of a search through the
+      file from the current position with rewinds.
+
+   3. The numbers are converted with a small parser which handles
+      the common decimal forms directly and only falls back to
+      strtod() for the remaining cases; the Fortran style exponent
+      '1.0D+02' is also accepted.
+
+   4. Large data sections are split in chunks on line boundaries and
+      the chunks are parsed in parallel.
+
+  The file format rules are the same as for the functions in
+  ecl_kw_grdecl.c: comments start with "--" and run to the end of
+  the line, repeated values are written as N*value without spaces
+  around the '*' and the data section of a keyword is terminated
+  with '/'. In addition the terminating '/' can be attached to the
+  last value, like '0.25/', and a keyword without a terminating '/'
+  is closed when a new keyword, i.e. an alphanumeric string starting
+  with a letter, is found as the first string on a line. The default
+  value syntax 'N*' without a value is not supported.
+*/
+
+#define ECL_GRDECL_FILE_TYPE_ID    77801245
+
+#define ECL_GRDECL_PARALLEL_SIZE   (1 << 22)   /* Data sections with more bytes than this are parsed in parallel. */
+#define ECL_GRDECL_CHUNK_SIZE      (1 << 20)
+#define ECL_GRDECL_MAX_TOKEN       64
+
+
+typedef struct {
+  char   * header;
+  size_t   data_begin;
+  size_t   data_end;
+} ecl_grdecl_kw_type;
+
+
+struct ecl_grdecl_file_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  char               * filename;
+  char               * data;
+  size_t               size;
+  bool                 mapped;
+  int                  num_kw;
+  int                  alloc_size;
+  ecl_grdecl_kw_type * kw_list;
+  hash_type          * kw_index;     /* header -> int_vector of indices in kw_list. */
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_grdecl_file , ECL_GRDECL_FILE_TYPE_ID )
+
+
+static const double ecl_grdecl_double_pow10[] = { 1e0 , 1e1 , 1e2 , 1e3 , 1e4 , 1e5 , 1e6 , 1e7 , 1e8 , 1e9 , 1e10 ,
+                                                  1e11 , 1e12 , 1e13 , 1e14 , 1e15 , 1e16 , 1e17 , 1e18 , 1e19 ,
+                                                  1e20 , 1e21 , 1e22 };
+
+static const float ecl_grdecl_float_pow10[] = { 1e0f , 1e1f , 1e2f , 1e3f , 1e4f , 1e5f , 1e6f , 1e7f , 1e8f , 1e9f , 1e10f };
+
+
+static bool ecl_grdecl_isspace( char c ) {
+  return (c == ' ') || (c == '\n') || (c == '\t') || (c == '\r') || (c == '\f') || (c == '\v');
+}
+
+
+static bool ecl_grdecl_isdigit( char c ) {
+  return (c >= '0') && (c <= '9');
+}
+
+
+static bool ecl_grdecl_isalpha( char c ) {
+  return ((c >= 'A') && (c <= 'Z')) || ((c >= 'a') && (c <= 'z'));
+}
+
+
+/*
+  Returns the start of the next token in the range [pos, end), and
+  sets *token_end to the first character after the token. Comments
+  are skipped. Returns NULL if there are no more tokens.
+*/
+
+static const char * ecl_grdecl_next_token( const char * pos , const char * end , const char ** token_end) {
+  while (pos < end) {
+    if (ecl_grdecl_isspace( *pos ))
+      pos++;
+    else if ((pos[0] == '-') && (pos + 1 < end) && (pos[1] == '-')) {
+      while ((pos < end) && (*pos != '\n'))
+        pos++;
+    } else {
+      const char * tend = pos;
+      while ((tend < end) && !ecl_grdecl_isspace( *tend ))
+        tend++;
+      *token_end = tend;
+      return pos;
+    }
+  }
+  return NULL;
+}
+
+
+/*****************************************************************/
+/* Number parsing.                                                */
+
+static bool ecl_grdecl_parse_int( const char * s , const char * end , int * value) {
+  bool negative = false;
+  int64_t v = 0;
+
+  if ((s < end) && ((*s == '-') || (*s == '+'))) {
+    negative = (*s == '-');
+    s++;
+  }
+  if (s == end)
+    return false;
+
+  while (s < end) {
+    if (!ecl_grdecl_isdigit( *s ))
+      return false;
+    v = 10 * v + (*s - '0');
+    if (v > (int64_t) INT_MAX + 1)
+      return false;
+    s++;
+  }
+
+  if (negative)
+    v = -v;
+  if (v > INT_MAX)
+    return false;
+
+  *value = (int) v;
+  return true;
+}
+
+
+/*
+  Scans a decimal number [sign]digits[.digits][(e|E|d|D)[sign]digits]
+  into an integer mantissa and a power of ten. Returns false if the
+  token does not have this form, or if the mantissa has too many
+  digits to be represented exactly; the caller will then fall back to
+  the C library.
+*/
+
+static bool ecl_grdecl_scan_decimal( const char * s , const char * end , bool * negative , uint64_t * mantissa , int * exp10) {
+  const uint64_t max_mantissa = (UINT64_MAX - 9) / 10;
+  uint64_t m = 0;
+  int e = 0;
+  bool digits = false;
+
+  *negative = false;
+  if ((s < end) && ((*s == '-') || (*s == '+'))) {
+    *negative = (*s == '-');
+    s++;
+  }
+
+  while ((s < end) && ecl_grdecl_isdigit( *s )) {
+    if (m > max_mantissa)
+      return false;
+    m = 10 * m + (*s - '0');
+    digits = true;
+    s++;
+  }
+
+  if ((s < end) && (*s == '.')) {
+    s++;
+    while ((s < end) && ecl_grdecl_isdigit( *s )) {
+      if (m > max_mantissa)
+        return false;
+      m = 10 * m + (*s - '0');
+      e--;
+      digits = true;
+      s++;
+    }
+  }
+
+  if (!digits)
+    return false;
+
+  if ((s < end) && ((*s == 'e') || (*s == 'E') || (*s == 'd') || (*s == 'D'))) {
+    bool exp_negative = false;
+    int exp_value = 0;
+    s++;
+    if ((s < end) && ((*s == '-') || (*s == '+'))) {
+      exp_negative = (*s == '-');
+      s++;
+    }
+    if ((s == end) || !ecl_grdecl_isdigit( *s ))
+      return false;
+
+    while ((s < end) && ecl_grdecl_isdigit( *s )) {
+      if (exp_value < 100000)
+        exp_value = 10 * exp_value + (*s - '0');
+      s++;
+    }
+    e += exp_negative ? -exp_value : exp_value;
+  }
+
+  if (s != end)
+    return false;
+
+  *mantissa = m;
+  *exp10 = e;
+  return true;
+}
+
+
+/*
+  Copies the token to a zero terminated buffer for strtod(), with a
+  Fortran 'D' exponent replaced with 'E'.
+*/
+
+static bool ecl_grdecl_copy_token( const char * s , const char * end , char * buffer) {
+  size_t length = end - s;
+  size_t i;
+  if (length >= ECL_GRDECL_MAX_TOKEN)
+    return false;
+
+  for (i = 0; i < length; i++)
+    buffer[i] = ((s[i] == 'd') || (s[i] == 'D')) ? 'E' : s[i];
+  buffer[length] = '\0';
+  return true;
+}
+
+
+/*
+  The fast paths are exact: when both the mantissa and the power of
+  ten can be represented exactly the result of one correctly rounded
+  multiplication or division is the correctly rounded value of the
+  decimal number.
+*/
+
+static bool ecl_grdecl_parse_double( const char * s , const char * end , double * value) {
+  bool negative;
+  uint64_t mantissa;
+  int exp10;
+
+  if (ecl_grdecl_scan_decimal( s , end , &negative , &mantissa , &exp10 )) {
+    if ((mantissa <= ((uint64_t) 1 << 53)) && (exp10 >= -22) && (exp10 <= 22)) {
+      double v = (double) mantissa;
+      if (exp10 < 0)
+        v /= ecl_grdecl_double_pow10[-exp10];
+      else
+        v *= ecl_grdecl_double_pow10[exp10];
+      *value = negative ? -v : v;
+      return true;
+    }
+  }
+
+  {
+    char buffer[ECL_GRDECL_MAX_TOKEN];
+    char * error_ptr;
+    if (!ecl_grdecl_copy_token( s , end , buffer ))
+      return false;
+
+    *value = strtod( buffer , &error_ptr );
+    return (error_ptr != buffer) && (*error_ptr == '\0');
+  }
+}
+
+
+static bool ecl_grdecl_parse_float( const char * s , const char * end , float * value) {
+  bool negative;
+  uint64_t mantissa;
+  int exp10;
+
+  if (ecl_grdecl_scan_decimal( s , end , &negative , &mantissa , &exp10 )) {
+    if ((mantissa <= ((uint64_t) 1 << 24)) && (exp10 >= -10) && (exp10 <= 10)) {
+      float v = (float) mantissa;
+      if (exp10 < 0)
+        v /= ecl_grdecl_float_pow10[-exp10];
+      else
+        v *= ecl_grdecl_float_pow10[exp10];
+      *value = negative ? -v : v;
+      return true;
+    }
+  }
+
+  {
+    char buffer[ECL_GRDECL_MAX_TOKEN];
+    char * error_ptr;
+    if (!ecl_grdecl_copy_token( s , end , buffer ))
+      return false;
+
+    *value = strtof( buffer , &error_ptr );
+    return (error_ptr != buffer) && (*error_ptr == '\0');
+  }
+}
+
+
+/*
+  Parses one 'value' or 'N*value' item; returns the repeat count, or
+  zero if the item could not be parsed.
+*/
+
+static int ecl_grdecl_parse_item( const char * token , const char * token_end , ecl_type_enum type , void * value) {
+  const char * star = memchr( token , '*' , token_end - token );
+  int multiplier = 1;
+  bool ok = false;
+
+  if (star) {
+    if (!ecl_grdecl_parse_int( token , star , &multiplier ) || (multiplier <= 0))
+      return 0;
+    token = star + 1;
+  }
+
+  switch (type) {
+  case(ECL_INT_TYPE):
+    ok = ecl_grdecl_parse_int( token , token_end , value );
+    break;
+  case(ECL_FLOAT_TYPE):
+    ok = ecl_grdecl_parse_float( token , token_end , value );
+    break;
+  case(ECL_DOUBLE_TYPE):
+    ok = ecl_grdecl_parse_double( token , token_end , value );
+    break;
+  default:
+    util_abort("%s: internal error \n",__func__);
+  }
+
+  return ok ? multiplier : 0;
+}
+
+
+/*****************************************************************/
+/* Parsing of a data section.                                     */
+
+typedef struct {
+  char   * data;
+  size_t   size;
+} ecl_grdecl_chunk_type;
+
+
+#define ECL_GRDECL_FILL( ctype )                                                     \
+static void ecl_grdecl_fill_ ## ctype( char * data , size_t offset , int multiplier , const void * value_ptr) { \
+  ctype * target = (ctype *) data;                                                   \
+  const ctype value = *((const ctype *) value_ptr);                                  \
+  int i;                                                                             \
+  for (i = 0; i < multiplier; i++)                                                   \
+    target[offset + i] = value;                                                      \
+}
+
+ECL_GRDECL_FILL( int )
+ECL_GRDECL_FILL( float )
+ECL_GRDECL_FILL( double )
+#undef ECL_GRDECL_FILL
+
+
+static void ecl_grdecl_parse_chunk( const char * header , const char * pos , const char * end , bool strict ,
+                                    ecl_data_type data_type , ecl_grdecl_chunk_type * chunk) {
+  const ecl_type_enum type = ecl_type_get_type( data_type );
+  const int sizeof_ctype = ecl_type_get_sizeof_ctype( data_type );
+  size_t alloc_size = util_size_t_max( 64 , (end - pos) / 8 );
+  size_t size = 0;
+  char * data = util_malloc( alloc_size * sizeof_ctype );
+  const char * token_end;
+  const char * token;
+
+  while ((token = ecl_grdecl_next_token( pos , end , &token_end )) != NULL) {
+    double value_buffer;
+    int multiplier = ecl_grdecl_parse_item( token , token_end , type , &value_buffer );
+
+    if (multiplier > 0) {
+      if (size + multiplier > alloc_size) {
+        alloc_size = util_size_t_max( 2 * alloc_size , size + multiplier );
+        data = util_realloc( data , alloc_size * sizeof_ctype );
+      }
+
+      if (type == ECL_FLOAT_TYPE)
+        ecl_grdecl_fill_float( data , size , multiplier , &value_buffer );
+      else if (type == ECL_DOUBLE_TYPE)
+        ecl_grdecl_fill_double( data , size , multiplier , &value_buffer );
+      else
+        ecl_grdecl_fill_int( data , size , multiplier , &value_buffer );
+      size += multiplier;
+    } else if (strict) {
+      char buffer[ECL_GRDECL_MAX_TOKEN];
+      int length = util_int_min( ECL_GRDECL_MAX_TOKEN - 1 , token_end - token );
+      memcpy( buffer , token , length );
+      buffer[length] = '\0';
+      util_abort("%s: Malformed content:\"%s\" when reading keyword:%s \n",__func__ , buffer , header);
+    }
+
+    pos = token_end;
+  }
+
+  chunk->data = data;
+  chunk->size = size;
+}
+
+
+/*****************************************************************/
+/* Indexing.                                                      */
+
+static bool ecl_grdecl_file_is_header( const char * begin , const char * token , const char * token_end ) {
+  const char * pos;
+
+  if (!ecl_grdecl_isalpha( token[0] ))
+    return false;
+
+  /* Must be the first string on the line. */
+  pos = token;
+  while ((pos > begin) && ((pos[-1] == ' ') || (pos[-1] == '\t') || (pos[-1] == '\r')))
+    pos--;
+  if ((pos > begin) && (pos[-1] != '\n'))
+    return false;
+
+  for (pos = token; pos < token_end; pos++)
+    if (!ecl_grdecl_isalpha( *pos ) && !ecl_grdecl_isdigit( *pos ) && (*pos != '_'))
+      return false;
+
+  /* The strings accepted by strtod() as numbers. */
+  {
+    char buffer[ECL_GRDECL_MAX_TOKEN];
+    if (ecl_grdecl_copy_token( token , token_end , buffer )) {
+      util_strupr( buffer );
+      if ((strcmp( buffer , "NAN" ) == 0) || (strcmp( buffer , "INF" ) == 0) || (strcmp( buffer , "INFINITY" ) == 0))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+
+static ecl_grdecl_kw_type * ecl_grdecl_file_add_kw( ecl_grdecl_file_type * grdecl_file , const char * token , const char * token_end) {
+  ecl_grdecl_kw_type * kw;
+  if (grdecl_file->num_kw == grdecl_file->alloc_size) {
+    grdecl_file->alloc_size = util_int_max( 16 , 2 * grdecl_file->alloc_size );
+    grdecl_file->kw_list = util_realloc( grdecl_file->kw_list , grdecl_file->alloc_size * sizeof * grdecl_file->kw_list );
+  }
+
+  kw = &grdecl_file->kw_list[ grdecl_file->num_kw ];
+  kw->header = util_alloc_substring_copy( token , 0 , token_end - token );
+  kw->data_begin = token_end - grdecl_file->data;
+  kw->data_end = kw->data_begin;
+
+  if (!hash_has_key( grdecl_file->kw_index , kw->header ))
+    hash_insert_hash_owned_ref( grdecl_file->kw_index , kw->header , int_vector_alloc( 0 , 0 ) , int_vector_free__ );
+  int_vector_append( hash_get( grdecl_file->kw_index , kw->header ) , grdecl_file->num_kw );
+
+  grdecl_file->num_kw++;
+  return kw;
+}
+
+
+static void ecl_grdecl_file_build_index( ecl_grdecl_file_type * grdecl_file ) {
+  const char * begin = grdecl_file->data;
+  const char * end = begin + grdecl_file->size;
+  const char * token_end;
+  const char * token = ecl_grdecl_next_token( begin , end , &token_end );
+
+  while (token) {
+    ecl_grdecl_kw_type * kw = ecl_grdecl_file_add_kw( grdecl_file , token , token_end );
+    const char * pos = token_end;
+
+    while (true) {
+      token = ecl_grdecl_next_token( pos , end , &token_end );
+      if (token == NULL) {
+        kw->data_end = grdecl_file->size;
+        break;
+      }
+
+      if (token_end[-1] == '/') {
+        kw->data_end = (token_end - 1) - begin;
+        token = ecl_grdecl_next_token( token_end , end , &token_end );
+        break;
+      }
+
+      if (ecl_grdecl_file_is_header( begin , token , token_end )) {
+        kw->data_end = token - begin;
+        break;
+      }
+
+      pos = token_end;
+    }
+  }
+}
+
+
+/*****************************************************************/
+
+static void ecl_grdecl_file_load( ecl_grdecl_file_type * grdecl_file ) {
+  const char * filename = grdecl_file->filename;
+  grdecl_file->size = util_file_size( filename );
+  grdecl_file->mapped = false;
+  grdecl_file->data = NULL;
+
+  if (grdecl_file->size == 0)
+    return;
+
+#ifdef HAVE_MMAP
+  {
+    int fd = open( filename , O_RDONLY );
+    if (fd == -1)
+      util_abort("%s: failed to open:%s error:%d/%s \n",__func__ , filename , errno , strerror( errno ));
+
+    grdecl_file->data = mmap( NULL , grdecl_file->size , PROT_READ , MAP_PRIVATE , fd , 0 );
+    close( fd );
+    if (grdecl_file->data == MAP_FAILED)
+      grdecl_file->data = NULL;
+    else
+      grdecl_file->mapped = true;
+  }
+#endif
+
+  if (!grdecl_file->data) {
+    FILE * stream = util_fopen( filename , "r");
+    grdecl_file->data = util_malloc( grdecl_file->size );
+    util_fread( grdecl_file->data , 1 , grdecl_file->size , stream , __func__ );
+    fclose( stream );
+  }
+}
+
+
+ecl_grdecl_file_type * ecl_grdecl_file_open( const char * filename ) {
+  if (!util_file_readable( filename ))
+    return NULL;
+  {
+    ecl_grdecl_file_type * grdecl_file = util_malloc( sizeof * grdecl_file );
+    UTIL_TYPE_ID_INIT( grdecl_file , ECL_GRDECL_FILE_TYPE_ID );
+    grdecl_file->filename   = util_alloc_string_copy( filename );
+    grdecl_file->num_kw     = 0;
+    grdecl_file->alloc_size = 0;
+    grdecl_file->kw_list    = NULL;
+    grdecl_file->kw_index   = hash_alloc();
+
+    ecl_grdecl_file_load( grdecl_file );
+    ecl_grdecl_file_build_index( grdecl_file );
+    return grdecl_file;
+  }
+}
+
+
+void ecl_grdecl_file_close( ecl_grdecl_file_type * grdecl_file ) {
+  int i;
+  for (i = 0; i < grdecl_file->num_kw; i++)
+    free( grdecl_file->kw_list[i].header );
+  free( grdecl_file->kw_list );
+  hash_free( grdecl_file->kw_index );
+
+#ifdef HAVE_MMAP
+  if (grdecl_file->mapped)
+    munmap( grdecl_file->data , grdecl_file->size );
+  else
+    free( grdecl_file->data );
+#else
+  free( grdecl_file->data );
+#endif
+
+  free( grdecl_file->filename );
+  free( grdecl_file );
+}
+
+
+const char * ecl_grdecl_file_get_src_file( const ecl_grdecl_file_type * grdecl_file ) {
+  return grdecl_file->filename;
+}
+
+
+int ecl_grdecl_file_get_size( const ecl_grdecl_file_type * grdecl_file ) {
+  return grdecl_file->num_kw;
+}
+
+
+const char * ecl_grdecl_file_iget_header( const ecl_grdecl_file_type * grdecl_file , int index) {
+  if ((index < 0) || (index >= grdecl_file->num_kw))
+    util_abort("%s: invalid index:%d valid range: [0,%d) \n",__func__ , index , grdecl_file->num_kw);
+
+  return grdecl_file->kw_list[index].header;
+}
+
+
+bool ecl_grdecl_file_has_kw( const ecl_grdecl_file_type * grdecl_file , const char * kw) {
+  return hash_has_key( grdecl_file->kw_index , kw );
+}
+
+
+int ecl_grdecl_file_get_num_named_kw( const ecl_grdecl_file_type * grdecl_file , const char * kw) {
+  if (hash_has_key( grdecl_file->kw_index , kw ))
+    return int_vector_size( hash_get( grdecl_file->kw_index , kw ));
+  else
+    return 0;
+}
+
+
+/*
+  Returns the index of occurence nr @occurence of @kw, or -1 if the
+  file does not have that many occurences of @kw.
+*/
+
+int ecl_grdecl_file_get_global_index( const ecl_grdecl_file_type * grdecl_file , const char * kw , int occurence) {
+  if (occurence < ecl_grdecl_file_get_num_named_kw( grdecl_file , kw ))
+    return int_vector_iget( hash_get( grdecl_file->kw_index , kw ) , occurence );
+  else
+    return -1;
+}
+
+
+/*
+  Will parse the data section of keyword nr @index in the file and
+  return it as a new ecl_kw instance. The @strict and @size arguments
+  have the same meaning as for the ecl_kw_fscanf_alloc_grdecl__()
+  function.
+*/
+
+ecl_kw_type * ecl_grdecl_file_iget_kw__( const ecl_grdecl_file_type * grdecl_file , int index , bool strict , int size , ecl_data_type data_type) {
+  const char * header = ecl_grdecl_file_iget_header( grdecl_file , index );
+  const ecl_grdecl_kw_type * kw = &grdecl_file->kw_list[index];
+  const char * begin = grdecl_file->data + kw->data_begin;
+  const char * end   = grdecl_file->data + kw->data_end;
+  const size_t data_bytes = end - begin;
+  const int sizeof_ctype = ecl_type_get_sizeof_ctype( data_type );
+  int num_chunks = 1;
+  const char ** chunk_begin;
+  ecl_grdecl_chunk_type * chunks;
+  size_t kw_size = 0;
+  char * data;
+  int c;
+
+  if (!ecl_type_is_numeric( data_type ))
+    util_abort("%s: sorry only types FLOAT, INT and DOUBLE supported\n",__func__);
+
+  if (data_bytes > ECL_GRDECL_PARALLEL_SIZE)
+    num_chunks = (data_bytes + ECL_GRDECL_CHUNK_SIZE - 1) / ECL_GRDECL_CHUNK_SIZE;
+
+  /* The chunk boundaries are moved forward to the start of a line. */
+  chunk_begin = util_malloc( (num_chunks + 1) * sizeof * chunk_begin );
+  chunk_begin[0] = begin;
+  for (c = 1; c < num_chunks; c++) {
+    const char * pos = begin + (size_t) c * ECL_GRDECL_CHUNK_SIZE;
+    if (pos < chunk_begin[c - 1])
+      pos = chunk_begin[c - 1];
+    while ((pos < end) && (*pos != '\n'))
+      pos++;
+    chunk_begin[c] = pos;
+  }
+  chunk_begin[num_chunks] = end;
+
+  chunks = util_malloc( num_chunks * sizeof * chunks );
+  #pragma omp parallel for schedule(dynamic) if (num_chunks > 1)
+  for (c = 0; c < num_chunks; c++)
+    ecl_grdecl_parse_chunk( header , chunk_begin[c] , chunk_begin[c + 1] , strict , data_type , &chunks[c] );
+
+  for (c = 0; c < num_chunks; c++)
+    kw_size += chunks[c].size;
+
+  if (kw_size > ECL_KW_MAX_SIZE)
+    util_abort("%s: keyword:%s has %zu elements - more than the maximum of %d \n",__func__ , header , kw_size , ECL_KW_MAX_SIZE);
+
+  if (num_chunks == 1)
+    data = chunks[0].data;
+  else {
+    size_t offset = 0;
+    data = util_malloc( kw_size * sizeof_ctype );
+    for (c = 0; c < num_chunks; c++) {
+      memcpy( &data[offset * sizeof_ctype] , chunks[c].data , chunks[c].size * sizeof_ctype );
+      offset += chunks[c].size;
+      free( chunks[c].data );
+    }
+  }
+  data = util_realloc( data , kw_size * sizeof_ctype );
+  free( chunks );
+  free( chunk_begin );
+
+  if ((size > 0) && (size != kw_size)) {
+    free( data );
+    util_abort("%s: size mismatch when loading:%s. File:%d elements. Requested:%d elements \n",
+               __func__ , header , (int) kw_size , size);
+  }
+
+  {
+    ecl_kw_type * ecl_kw = ecl_kw_alloc_new( header , kw_size , data_type , NULL );
+    ecl_kw_set_data_ptr( ecl_kw , data );
+    return ecl_kw;
+  }
+}
+
+
+ecl_kw_type * ecl_grdecl_file_iget_kw( const ecl_grdecl_file_type * grdecl_file , int index , ecl_data_type data_type) {
+  return ecl_grdecl_file_iget_kw__( grdecl_file , index , true , 0 , data_type );
+}
+
+
+/*
+  Returns NULL if the file does not have occurence nr @occurence of
+  @kw. If @size > 0 the number of elements loaded must be equal to
+  @size.
+*/
+
+ecl_kw_type * ecl_grdecl_file_iget_named_kw( const ecl_grdecl_file_type * grdecl_file , const char * kw , int occurence , int size , ecl_data_type data_type) {
+  int index = ecl_grdecl_file_get_global_index( grdecl_file , kw , occurence );
+  if (index < 0)
+    return NULL;
+
+  return ecl_grdecl_file_iget_kw__( grdecl_file , index , true , size , data_type );
+}
+
+
+/*
+  Creates a grid from the SPECGRID, ZCORN, COORD and the optional
+  ACTNUM and MAPAXES keywords in the file; returns NULL if any of the
+  required keywords are missing.
+*/
+
+ecl_grid_type * ecl_grdecl_file_alloc_grid( const ecl_grdecl_file_type * grdecl_file ) {
+  int specgrid_index = ecl_grdecl_file_get_global_index( grdecl_file , SPECGRID_KW , 0 );
+  if ((specgrid_index < 0) ||
+      !ecl_grdecl_file_has_kw( grdecl_file , ZCORN_KW ) ||
+      !ecl_grdecl_file_has_kw( grdecl_file , COORD_KW ))
+    return NULL;
+
+  {
+    ecl_kw_type * specgrid_kw = ecl_grdecl_file_iget_kw__( grdecl_file , specgrid_index , false , 0 , ECL_INT );
+    ecl_grid_type * grid;
+    int nx , ny , nz;
+
+    if (ecl_kw_get_size( specgrid_kw ) < 3)
+      util_abort("%s: malformed %s keyword in:%s \n",__func__ , SPECGRID_KW , grdecl_file->filename);
+
+    nx = ecl_kw_iget_int( specgrid_kw , SPECGRID_NX_INDEX );
+    ny = ecl_kw_iget_int( specgrid_kw , SPECGRID_NY_INDEX );
+    nz = ecl_kw_iget_int( specgrid_kw , SPECGRID_NZ_INDEX );
+    ecl_kw_free( specgrid_kw );
+
+    {
+      ecl_kw_type * zcorn_kw   = ecl_grdecl_file_iget_named_kw( grdecl_file , ZCORN_KW , 0 , 8 * nx * ny * nz , ECL_FLOAT );
+      ecl_kw_type * coord_kw   = ecl_grdecl_file_iget_named_kw( grdecl_file , COORD_KW , 0 , 6 * (nx + 1) * (ny + 1) , ECL_FLOAT );
+      ecl_kw_type * actnum_kw  = ecl_grdecl_file_iget_named_kw( grdecl_file , ACTNUM_KW , 0 , nx * ny * nz , ECL_INT );
+      ecl_kw_type * mapaxes_kw = ecl_grdecl_file_iget_named_kw( grdecl_file , MAPAXES_KW , 0 , 6 , ECL_FLOAT );
+
+      grid = ecl_grid_alloc_GRDECL_kw( nx , ny , nz , zcorn_kw , coord_kw , actnum_kw , mapaxes_kw );
+
+      ecl_kw_free( zcorn_kw );
+      ecl_kw_free( coord_kw );
+      if (actnum_kw)
+        ecl_kw_free( actnum_kw );
+      if (mapaxes_kw)
+        ecl_kw_free( mapaxes_kw );
+    }
+    return grid;
+  }
+}
@@ -21,6 +21,16 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <math.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <ert/util/build_config.h>
+
+#ifdef HAVE_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 #include <ert/util/util.h>
 #include <ert/util/double_vector.h>
@@ -40,6 +50,7 @@
 #include <ert/ecl/ecl_endian_flip.h>
 #include <ert/ecl/ecl_coarse_cell.h>
 #include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_grid_cache.h>
 #include <ert/ecl/grid_dims.h>
 #include <ert/ecl/nnc_info.h>
 
@@ -361,10 +372,13 @@
   in to assemble information of the NNC. The NNC information is
   organized as follows:
 
-       For cells with NNC's attached the information is kept in a
+       For cells with NNC's attached the information is available as a
        nnc_info_type structure. For a particular cell the nnc_info
        structure keeps track of which other cells this particular cell
-       is connected to, on a per grid (i.e. LGR) basis.
+       is connected to, on a per grid (i.e. LGR) basis. Internally the
+       connections are stored in CSR arrays, see the comment about NNC
+       storage; these can be used directly with
+       ecl_grid_iget_nnc_csr().
 
        In the nnc_info structure the different grids are identified
        through the lgr_nr.
@@ -694,7 +708,6 @@ struct ecl_cell_struct {
   int                    host_cell;          /* the global index of the host cell for an lgr cell, set to -1 for normal cells. */
   int                    coarse_group;       /* The index of the coarse group holding this cell -1 for non-coarsened cells. */
   int                    cell_flags;
-  nnc_info_type        * nnc_info;           /* Non-neighbour connection info*/
 };
 
 
@@ -703,8 +716,14 @@ static void          ecl_grid_init_mapaxes_data_float( const ecl_grid_type * gri
 float *              ecl_grid_alloc_coord_data( const ecl_grid_type * grid );
 static const float * ecl_grid_get_mapaxes( const ecl_grid_type * grid );
 
+typedef struct ecl_grid_lazy_struct ecl_grid_lazy_type;
+typedef struct ecl_grid_snapshot_struct ecl_grid_snapshot_type;
+typedef struct ecl_grid_nnc_csr_struct ecl_grid_nnc_csr_type;
+
 #define ECL_GRID_ID       991010
 
+#define ECL_GRID_PARALLEL_SIZE 100000    /* Loops over grids with more cells than this are split between OpenMP threads; cell loops on lazy grids stay serial because the cell cache is not thread safe. */
+
 struct ecl_grid_struct {
   UTIL_TYPE_ID_DECLARATION;
   int                   lgr_nr;        /* EGRID files: corresponds to item 4 in gridhead - 0 for the main grid.
@@ -761,9 +780,16 @@ struct ecl_grid_struct {
 
   ert_ecl_unit_enum     unit_system;
   int                   eclipse_version;
+  ecl_grid_lazy_type  * lazy;       /* Only != NULL for grids loaded with ecl_grid_alloc_EGRID_lazy(); then cells == NULL. */
+  ecl_grid_snapshot_type * snapshot; /* Only != NULL for grids loaded with ecl_grid_alloc_snapshot(); owned by the main grid. */
+  vector_type         * nnc_csr_list;   /* ecl_grid_nnc_csr_type instances - see the comment about NNC storage. */
+  nnc_info_type       * nnc_view;       /* Rebuilt by ecl_grid_get_cell_nnc_info1(); can be NULL. */
+  ecl_grid_cache_type  * cache;          /* Shared cell center/volume cache - see ecl_grid_get_cache(); can be NULL. */
+  vector_type         * snapshot_lgr_list;       /* Only for snapshot grids: the lgr grids with host cells in this grid ... */
+  vector_type         * snapshot_lgr_host_cells; /* ... and the sorted list of host cells (int_vector) for each of them. */
 };
 
-static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2,  bool include_nnc , bool * equal) {
+static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2, bool * equal) {
   int i;
 
   if (c1->active != c2->active)
@@ -787,12 +813,6 @@ static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2
       point_compare( &c1->corner_list[i] , &c2->corner_list[i] , equal );
 
   }
-
-  if (include_nnc) {
-    if (*equal)
-      *equal = nnc_info_equal( c1->nnc_info , c2->nnc_info );
-  }
-
 }
 
 
@@ -1096,8 +1116,6 @@ static void ecl_cell_init( ecl_cell_type * cell , bool init_valid) {
   cell->active_index[FRACTURE_INDEX] = -1;
   if (init_valid)
     cell->cell_flags = CELL_FLAG_VALID;
-
-  cell->nnc_info = NULL;
 }
 
 
@@ -1532,8 +1550,20 @@ UTIL_IS_INSTANCE_FUNCTION( ecl_grid , ECL_GRID_ID);
 
 
 
+static ecl_cell_type * ecl_grid_lazy_get_cell(const ecl_grid_type * grid , int global_index);
+static void            ecl_grid_lazy_update_index( ecl_grid_type * ecl_grid );
+static void            ecl_grid_lazy_set_hostnum( ecl_grid_type * lgr_grid , const int * hostnum);
+static void            ecl_grid_lazy_install_lgr( ecl_grid_type * host_grid , const ecl_grid_type * lgr_grid , const int * hostnum);
+static bool            ecl_grid_snapshot_borrowed( const ecl_grid_type * grid , const void * ptr);
+static void            ecl_grid_snapshot_detach_index_map( ecl_grid_type * grid );
+static void            ecl_grid_snapshot_release( ecl_grid_type * grid );
+static void            ecl_grid_snapshot_free( ecl_grid_snapshot_type * snapshot );
+
 static ecl_cell_type * ecl_grid_get_cell(const ecl_grid_type * grid,
                                          int global_index) {
+  if (grid->lazy)
+    return ecl_grid_lazy_get_cell( grid , global_index );
+
   return &grid->cells[global_index];
 }
 
@@ -1553,17 +1583,274 @@ static void ecl_grid_taint_cells( ecl_grid_type * ecl_grid ) {
 }
 
 
-static void ecl_grid_free_cells( ecl_grid_type * grid ) {
-  if (!grid->cells)
+/*****************************************************************/
+/* NNC storage */
+
+/*
+  The NNC connections of a grid are stored in compressed sparse row
+  (CSR) format, with one ecl_grid_nnc_csr_type instance for each grid
+  at the other end of the connections. For the main grid there is
+  typically one instance for the connections within the main grid,
+  and one for each LGR with connections to the main grid. The
+  connections from cell g are the elements [offset[g], offset[g+1])
+  of the grid_index and nnc_index arrays.
+
+  Connections added with ecl_grid_add_self_nnc(), or when loading the
+  grid, are appended to the add_xxx vectors, and the CSR arrays are
+  rebuilt the next time the connections are accessed. The grid holds
+  one nnc_info instance which ecl_grid_get_cell_nnc_info1() rebuilds
+  from the CSR arrays on every call; the returned pointer is only valid
+  until the next call for the same grid, and does not see connections
+  added after the call. Since both the CSR rebuild and the nnc_info
+  instance modify the grid, ecl_grid_get_cell_nnc_info1() is not
+  thread safe.
+
+  Bulk consumers should use the CSR arrays directly through
+  ecl_grid_iget_nnc_csr().
+*/
+
+struct ecl_grid_nnc_csr_struct {
+  int               lgr_nr;        /* The lgr_nr of the grid at the other end of the connections. */
+  int               num_nnc;
+  int             * offset;        /* size + 1 elements. */
+  int             * grid_index;    /* The global index of the connected cell in grid lgr_nr. */
+  int             * nnc_index;     /* The index into the NNC keywords. */
+  int_vector_type * add_index1;    /* Connections added since the CSR arrays were built. */
+  int_vector_type * add_index2;
+  int_vector_type * add_nnc_index;
+};
+
+
+static ecl_grid_nnc_csr_type * ecl_grid_nnc_csr_alloc( int lgr_nr ) {
+  ecl_grid_nnc_csr_type * csr = util_malloc( sizeof * csr );
+  csr->lgr_nr        = lgr_nr;
+  csr->num_nnc       = 0;
+  csr->offset        = NULL;
+  csr->grid_index    = NULL;
+  csr->nnc_index     = NULL;
+  csr->add_index1    = int_vector_alloc(0,0);
+  csr->add_index2    = int_vector_alloc(0,0);
+  csr->add_nnc_index = int_vector_alloc(0,0);
+  return csr;
+}
+
+
+static void ecl_grid_nnc_csr_free_data( const ecl_grid_type * grid , ecl_grid_nnc_csr_type * csr) {
+  if (!ecl_grid_snapshot_borrowed( grid , csr->offset ))
+    util_safe_free( csr->offset );
+
+  if (!ecl_grid_snapshot_borrowed( grid , csr->grid_index ))
+    util_safe_free( csr->grid_index );
+
+  if (!ecl_grid_snapshot_borrowed( grid , csr->nnc_index ))
+    util_safe_free( csr->nnc_index );
+}
+
+
+static void ecl_grid_free_nnc( ecl_grid_type * grid ) {
+  int i;
+  if (grid->nnc_view) {
+    nnc_info_free( grid->nnc_view );
+    grid->nnc_view = NULL;
+  }
+  for (i = 0; i < vector_get_size( grid->nnc_csr_list ); i++) {
+    ecl_grid_nnc_csr_type * csr = vector_iget( grid->nnc_csr_list , i );
+    ecl_grid_nnc_csr_free_data( grid , csr );
+    int_vector_free( csr->add_index1 );
+    int_vector_free( csr->add_index2 );
+    int_vector_free( csr->add_nnc_index );
+    free( csr );
+  }
+  vector_free( grid->nnc_csr_list );
+}
+
+
+static ecl_grid_nnc_csr_type * ecl_grid_get_nnc_csr( const ecl_grid_type * grid , int lgr_nr) {
+  int i;
+  for (i = 0; i < vector_get_size( grid->nnc_csr_list ); i++) {
+    ecl_grid_nnc_csr_type * csr = vector_iget( grid->nnc_csr_list , i );
+    if (csr->lgr_nr == lgr_nr)
+      return csr;
+  }
+  return NULL;
+}
+
+
+static ecl_grid_nnc_csr_type * ecl_grid_get_or_create_nnc_csr( ecl_grid_type * grid , int lgr_nr) {
+  ecl_grid_nnc_csr_type * csr = ecl_grid_get_nnc_csr( grid , lgr_nr );
+  if (!csr) {
+    csr = ecl_grid_nnc_csr_alloc( lgr_nr );
+    vector_append_ref( grid->nnc_csr_list , csr );
+  }
+  return csr;
+}
+
+
+static void ecl_grid_add_nnc__( ecl_grid_type * grid , int lgr_nr2 , int global_index1 , int global_index2 , int nnc_index) {
+  ecl_grid_nnc_csr_type * csr = ecl_grid_get_or_create_nnc_csr( grid , lgr_nr2 );
+
+  if ((global_index1 < 0) || (global_index1 >= grid->size))
+    util_abort("%s: invalid global index:%d - grid size:%d \n",__func__ , global_index1 , grid->size);
+
+  int_vector_append( csr->add_index1 , global_index1 );
+  int_vector_append( csr->add_index2 , global_index2 );
+  int_vector_append( csr->add_nnc_index , nnc_index );
+}
+
+
+/*
+  Merges the added connections into the CSR arrays; within each row
+  the existing connections come first, followed by the added
+  connections in the order they were added.
+*/
+
+static void ecl_grid_nnc_csr_build( ecl_grid_type * grid , ecl_grid_nnc_csr_type * csr) {
+  int num_add = int_vector_size( csr->add_index1 );
+  if (num_add == 0)
     return;
+  {
+    const int * add_index1    = int_vector_get_const_ptr( csr->add_index1 );
+    const int * add_index2    = int_vector_get_const_ptr( csr->add_index2 );
+    const int * add_nnc_index = int_vector_get_const_ptr( csr->add_nnc_index );
+    int num_nnc     = csr->num_nnc + num_add;
+    int * offset     = util_calloc( grid->size + 1 , sizeof * offset );
+    int * grid_index = util_calloc( num_nnc , sizeof * grid_index );
+    int * nnc_index  = util_calloc( num_nnc , sizeof * nnc_index );
+    int * pos;
+    int g, i;
+
+    offset[0] = 0;
+    for (g = 0; g < grid->size; g++)
+      offset[g + 1] = csr->offset ? csr->offset[g + 1] - csr->offset[g] : 0;
+
+    for (i = 0; i < num_add; i++)
+      offset[add_index1[i] + 1]++;
+
+    for (g = 0; g < grid->size; g++)
+      offset[g + 1] += offset[g];
+
+    pos = util_alloc_copy( offset , grid->size * sizeof * pos );
+    if (csr->offset) {
+      for (g = 0; g < grid->size; g++) {
+        for (i = csr->offset[g]; i < csr->offset[g + 1]; i++) {
+          grid_index[pos[g]] = csr->grid_index[i];
+          nnc_index[pos[g]]  = csr->nnc_index[i];
+          pos[g]++;
+        }
+      }
+    }
+
+    for (i = 0; i < num_add; i++) {
+      g = add_index1[i];
+      grid_index[pos[g]] = add_index2[i];
+      nnc_index[pos[g]]  = add_nnc_index[i];
+      pos[g]++;
+    }
+    free( pos );
 
-  for (int i=0; i < grid->size; i++) {
-    ecl_cell_type * cell = ecl_grid_get_cell( grid , i );
-    if (cell->nnc_info)
-      nnc_info_free(cell->nnc_info);
+    ecl_grid_nnc_csr_free_data( grid , csr );
+    csr->offset     = offset;
+    csr->grid_index = grid_index;
+    csr->nnc_index  = nnc_index;
+    csr->num_nnc    = num_nnc;
+
+    int_vector_reset( csr->add_index1 );
+    int_vector_reset( csr->add_index2 );
+    int_vector_reset( csr->add_nnc_index );
   }
-  free( grid->cells );
+}
+
+
+/*
+  Observe that this function is called from const accessors, and
+  will modify the grid if connections have been added.
+*/
+
+static void ecl_grid_assert_nnc( const ecl_grid_type * grid ) {
+  ecl_grid_type * mutable_grid = (ecl_grid_type *) grid;
+  int i;
+  for (i = 0; i < vector_get_size( grid->nnc_csr_list ); i++)
+    ecl_grid_nnc_csr_build( mutable_grid , vector_iget( grid->nnc_csr_list , i ));
+}
+
+
+static int ecl_grid_nnc_csr_get_row_size( const ecl_grid_nnc_csr_type * csr , int global_index) {
+  if (csr && csr->offset)
+    return csr->offset[global_index + 1] - csr->offset[global_index];
+  else
+    return 0;
+}
 
+
+static bool ecl_grid_has_cell_nnc( const ecl_grid_type * grid , int global_index) {
+  int i;
+  for (i = 0; i < vector_get_size( grid->nnc_csr_list ); i++) {
+    if (ecl_grid_nnc_csr_get_row_size( vector_iget_const( grid->nnc_csr_list , i ) , global_index ) > 0)
+      return true;
+  }
+  return false;
+}
+
+
+/*
+  Compares the connections of cell global_index in the two grids; as
+  with nnc_info_equal() the order of the LGRs does not matter, but the
+  order of the connections to one LGR does.
+*/
+
+static bool ecl_grid_cell_nnc_equal( const ecl_grid_type * grid1 , const ecl_grid_type * grid2 , int global_index) {
+  int i;
+  for (i = 0; i < vector_get_size( grid1->nnc_csr_list ); i++) {
+    const ecl_grid_nnc_csr_type * csr1 = vector_iget_const( grid1->nnc_csr_list , i );
+    const ecl_grid_nnc_csr_type * csr2 = ecl_grid_get_nnc_csr( grid2 , csr1->lgr_nr );
+    int size = ecl_grid_nnc_csr_get_row_size( csr1 , global_index );
+
+    if (size != ecl_grid_nnc_csr_get_row_size( csr2 , global_index ))
+      return false;
+
+    if (size > 0) {
+      int offset1 = csr1->offset[global_index];
+      int offset2 = csr2->offset[global_index];
+      if (memcmp( &csr1->grid_index[offset1] , &csr2->grid_index[offset2] , size * sizeof * csr1->grid_index ) != 0)
+        return false;
+
+      if (memcmp( &csr1->nnc_index[offset1] , &csr2->nnc_index[offset2] , size * sizeof * csr1->nnc_index ) != 0)
+        return false;
+    }
+  }
+
+  for (i = 0; i < vector_get_size( grid2->nnc_csr_list ); i++) {
+    const ecl_grid_nnc_csr_type * csr2 = vector_iget_const( grid2->nnc_csr_list , i );
+    if (!ecl_grid_get_nnc_csr( grid1 , csr2->lgr_nr ) && (ecl_grid_nnc_csr_get_row_size( csr2 , global_index ) > 0))
+      return false;
+  }
+
+  return true;
+}
+
+
+static void ecl_grid_copy_nnc( ecl_grid_type * target_grid , const ecl_grid_type * src_grid ) {
+  int i;
+  ecl_grid_assert_nnc( src_grid );
+  for (i = 0; i < vector_get_size( src_grid->nnc_csr_list ); i++) {
+    const ecl_grid_nnc_csr_type * src_csr = vector_iget_const( src_grid->nnc_csr_list , i );
+    ecl_grid_nnc_csr_type * target_csr = ecl_grid_get_or_create_nnc_csr( target_grid , src_csr->lgr_nr );
+
+    target_csr->num_nnc    = src_csr->num_nnc;
+    target_csr->offset     = util_alloc_copy( src_csr->offset , (src_grid->size + 1) * sizeof * src_csr->offset );
+    target_csr->grid_index = util_alloc_copy( src_csr->grid_index , src_csr->num_nnc * sizeof * src_csr->grid_index );
+    target_csr->nnc_index  = util_alloc_copy( src_csr->nnc_index , src_csr->num_nnc * sizeof * src_csr->nnc_index );
+  }
+}
+
+
+
+static void ecl_grid_free_cells( ecl_grid_type * grid ) {
+  if (!grid->cells)
+    return;
+
+  if (!ecl_grid_snapshot_borrowed( grid , grid->cells ))
+    free( grid->cells );
 }
 
 static bool ecl_grid_alloc_cells( ecl_grid_type * grid , bool init_valid) {
@@ -1593,13 +1880,12 @@ static bool ecl_grid_alloc_cells( ecl_grid_type * grid , bool init_valid) {
    is performed.
 */
 
-static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid,
-                                            int dualp_flag,
-                                            int nx,
-                                            int ny,
-                                            int nz,
-                                            int lgr_nr,
-                                            bool init_valid) {
+static ecl_grid_type * ecl_grid_alloc_empty__(ecl_grid_type * global_grid,
+                                              int dualp_flag,
+                                              int nx,
+                                              int ny,
+                                              int nz,
+                                              int lgr_nr) {
   ecl_grid_type * grid = util_malloc(sizeof * grid );
   UTIL_TYPE_ID_INIT(grid , ECL_GRID_ID);
   grid->total_active   = 0;
@@ -1621,6 +1907,14 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid,
   grid->fracture_index_map    = NULL;
   grid->inv_fracture_index_map = NULL;
   grid->unit_system            = ECL_METRIC_UNITS;
+  grid->cells                  = NULL;
+  grid->lazy                   = NULL;
+  grid->snapshot               = NULL;
+  grid->nnc_csr_list           = vector_alloc_new();
+  grid->nnc_view               = NULL;
+  grid->cache                  = NULL;
+  grid->snapshot_lgr_list      = NULL;
+  grid->snapshot_lgr_host_cells = NULL;
 
 
   if (global_grid != NULL) {
@@ -1664,6 +1958,18 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid,
   grid->children        = hash_alloc();
   grid->coarse_cells    = vector_alloc_new();
   grid->eclipse_version = 0;
+  return grid;
+}
+
+
+static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid,
+                                            int dualp_flag,
+                                            int nx,
+                                            int ny,
+                                            int nz,
+                                            int lgr_nr,
+                                            bool init_valid) {
+  ecl_grid_type * grid = ecl_grid_alloc_empty__( global_grid , dualp_flag , nx , ny , nz , lgr_nr );
 
   /* This is the large allocation - which can potentially fail. */
   if (!ecl_grid_alloc_cells( grid , init_valid )) {
@@ -1684,12 +1990,8 @@ static int ecl_grid_get_global_index__(const ecl_grid_type * ecl_grid,
 }
 
 
-static void ecl_grid_set_cell_EGRID(ecl_grid_type * ecl_grid , int i, int j , int k ,
-                                    double x[4][2] , double y[4][2] , double z[4][2] ,
-                                    const int * actnum, const int * corsnum) {
-
-  const int global_index   = ecl_grid_get_global_index__(ecl_grid , i , j  , k );
-  ecl_cell_type * cell     = ecl_grid_get_cell( ecl_grid , global_index );
+static void ecl_cell_set_corners_EGRID(const ecl_grid_type * ecl_grid , ecl_cell_type * cell ,
+                                       double x[4][2] , double y[4][2] , double z[4][2]) {
   int ip , iz;
 
   for (iz = 0; iz < 2; iz++) {
@@ -1701,8 +2003,17 @@ static void ecl_grid_set_cell_EGRID(ecl_grid_type * ecl_grid , int i, int j , in
         point_mapaxes_transform( &cell->corner_list[c] , ecl_grid->origo , ecl_grid->unit_x , ecl_grid->unit_y );
     }
   }
+}
+
 
+static void ecl_grid_set_cell_EGRID(ecl_grid_type * ecl_grid , int i, int j , int k ,
+                                    double x[4][2] , double y[4][2] , double z[4][2] ,
+                                    const int * actnum, const int * corsnum) {
+
+  const int global_index   = ecl_grid_get_global_index__(ecl_grid , i , j  , k );
+  ecl_cell_type * cell     = ecl_grid_get_cell( ecl_grid , global_index );
 
+  ecl_cell_set_corners_EGRID( ecl_grid , cell , x , y , z );
 
 
   /*
@@ -1844,6 +2155,8 @@ static void ecl_grid_init_index_map__(ecl_grid_type * ecl_grid,
 
 
 static void ecl_grid_realloc_index_map(ecl_grid_type * ecl_grid) {
+  ecl_grid_snapshot_detach_index_map( ecl_grid );
+
   /* Creating the inverse mapping for the matrix cells. */
   ecl_grid->index_map     = util_realloc(ecl_grid->index_map,
                                          ecl_grid->size * sizeof * ecl_grid->index_map);
@@ -2010,9 +2323,27 @@ static void ecl_grid_set_active_index(ecl_grid_type * ecl_grid) {
 }
 
 
+/*
+  The cache of cell centers and volumes is indexed by active index,
+  and must be dropped when the active cells change.
+*/
+
+static void ecl_grid_drop_cache( ecl_grid_type * ecl_grid ) {
+  if (ecl_grid->cache) {
+    ecl_grid_cache_detach( ecl_grid->cache );
+    ecl_grid->cache = NULL;
+  }
+}
+
+
 static void ecl_grid_update_index( ecl_grid_type * ecl_grid) {
-  ecl_grid_set_active_index(ecl_grid);
-  ecl_grid_realloc_index_map(ecl_grid);
+  ecl_grid_drop_cache( ecl_grid );
+  if (ecl_grid->lazy)
+    ecl_grid_lazy_update_index( ecl_grid );
+  else {
+    ecl_grid_set_active_index(ecl_grid);
+    ecl_grid_realloc_index_map(ecl_grid);
+  }
 }
 
 
@@ -2195,12 +2526,24 @@ static void ecl_grid_install_lgr_EGRID(ecl_grid_type * host_grid , ecl_grid_type
 
   for (global_lgr_index = 0; global_lgr_index < lgr_grid->size; global_lgr_index++) {
     int host_index = hostnum[ global_lgr_index ] - 1;
-    ecl_cell_type * lgr_cell  = ecl_grid_get_cell( lgr_grid , global_lgr_index);
-    ecl_cell_type * host_cell = ecl_grid_get_cell( host_grid ,  host_index );
 
-    ecl_cell_install_lgr( host_cell , lgr_grid );
-    lgr_cell->host_cell = host_index;
+    if (!lgr_grid->lazy) {
+      ecl_cell_type * lgr_cell  = ecl_grid_get_cell( lgr_grid , global_lgr_index);
+      lgr_cell->host_cell = host_index;
+    }
+
+    if (!host_grid->lazy) {
+      ecl_cell_type * host_cell = ecl_grid_get_cell( host_grid ,  host_index );
+      ecl_cell_install_lgr( host_cell , lgr_grid );
+    }
   }
+
+  if (lgr_grid->lazy)
+    ecl_grid_lazy_set_hostnum( lgr_grid , hostnum );
+
+  if (host_grid->lazy)
+    ecl_grid_lazy_install_lgr( host_grid , lgr_grid , hostnum );
+
   ecl_grid_install_lgr_common( host_grid , lgr_grid );
 }
 
@@ -2300,6 +2643,78 @@ int ecl_grid_zcorn_index(const ecl_grid_type * grid , int i, int j , int k , int
 }
 
 
+/*
+  Will load the four pillars surrounding column (i,j) from the coord
+  array, and calculate the direction vectors (ex,ey,ez) of the pillars.
+*/
+
+static void ecl_grid_init_pillars_EGRID(int nx,
+                                        const float * coord,
+                                        int i,
+                                        int j,
+                                        point_type pillars[4][2],
+                                        double ex[4],
+                                        double ey[4],
+                                        double ez[4]) {
+  int pillar_index[4];
+  int ip;
+  pillar_index[0] = 6 * ( j      * (nx + 1) + i    );
+  pillar_index[1] = 6 * ( j      * (nx + 1) + i + 1);
+  pillar_index[2] = 6 * ((j + 1) * (nx + 1) + i    );
+  pillar_index[3] = 6 * ((j + 1) * (nx + 1) + i + 1);
+
+  for (ip = 0; ip < 4; ip++) {
+    int index = pillar_index[ip];
+    point_set(&pillars[ip][0] , coord[index] , coord[index + 1] , coord[index + 2]);
+
+    index += 3;
+    point_set(&pillars[ip][1] , coord[index] , coord[index + 1] , coord[index + 2]);
+  }
+
+  for (ip = 0; ip <  4; ip++) {
+    ex[ip] = pillars[ip][1].x - pillars[ip][0].x;
+    ey[ip] = pillars[ip][1].y - pillars[ip][0].y;
+    ez[ip] = pillars[ip][1].z - pillars[ip][0].z;
+  }
+}
+
+
+/*
+  Will calculate the x,y,z coordinates of the eight corners of cell
+  (i,j,k) based on the pillars of the column and the zcorn array.
+*/
+
+static void ecl_grid_init_cell_xyz_EGRID(int nx,
+                                         int ny,
+                                         const float * zcorn,
+                                         int i,
+                                         int j,
+                                         int k,
+                                         point_type pillars[4][2],
+                                         const double ex[4],
+                                         const double ey[4],
+                                         const double ez[4],
+                                         double x[4][2],
+                                         double y[4][2],
+                                         double z[4][2]) {
+  {
+    int c;
+    for (c = 0; c < 2; c++) {
+      z[0][c] = zcorn[k*8*nx*ny + j*4*nx + 2*i            + c*4*nx*ny];
+      z[1][c] = zcorn[k*8*nx*ny + j*4*nx + 2*i  +  1      + c*4*nx*ny];
+      z[2][c] = zcorn[k*8*nx*ny + j*4*nx + 2*nx + 2*i     + c*4*nx*ny];
+      z[3][c] = zcorn[k*8*nx*ny + j*4*nx + 2*nx + 2*i + 1 + c*4*nx*ny];
+    }
+  }
+
+  {
+    int ip;
+    for (ip = 0; ip <  4; ip++)
+      ecl_grid_pillar_cross_planes(&pillars[ip][0] , ex[ip], ey[ip] , ez[ip] , z[ip] , x[ip] , y[ip]);
+  }
+}
+
+
 static void ecl_grid_init_GRDECL_data_jslice(ecl_grid_type * ecl_grid,
                                              const float * zcorn,
                                              const float * coord,
@@ -2314,62 +2729,19 @@ static void ecl_grid_init_GRDECL_data_jslice(ecl_grid_type * ecl_grid,
 
   for (i=0; i < nx; i++) {
     point_type pillars[4][2];
-    int pillar_index[4];
-    pillar_index[0] = 6 * ( j      * (nx + 1) + i    );
-    pillar_index[1] = 6 * ( j      * (nx + 1) + i + 1);
-    pillar_index[2] = 6 * ((j + 1) * (nx + 1) + i    );
-    pillar_index[3] = 6 * ((j + 1) * (nx + 1) + i + 1);
-
-    {
-      int ip;
-      for (ip = 0; ip < 4; ip++) {
-        int index = pillar_index[ip];
-        point_set(&pillars[ip][0] , coord[index] , coord[index + 1] , coord[index + 2]);
-
-        index += 3;
-        point_set(&pillars[ip][1] , coord[index] , coord[index + 1] , coord[index + 2]);
-      }
-    }
-
-    {
-      double ex[4];
-      double ey[4];
-      double ez[4];
-      int k;
-
-      {
-        int ip;
-        for (ip = 0; ip <  4; ip++) {
-          ex[ip] = pillars[ip][1].x - pillars[ip][0].x;
-          ey[ip] = pillars[ip][1].y - pillars[ip][0].y;
-          ez[ip] = pillars[ip][1].z - pillars[ip][0].z;
-        }
-      }
-
+    double ex[4];
+    double ey[4];
+    double ez[4];
+    int k;
 
-      for (k=0; k < nz; k++) {
-        double x[4][2];
-        double y[4][2];
-        double z[4][2];
-
-        {
-          int c;
-          for (c = 0; c < 2; c++) {
-            z[0][c] = zcorn[k*8*nx*ny + j*4*nx + 2*i            + c*4*nx*ny];
-            z[1][c] = zcorn[k*8*nx*ny + j*4*nx + 2*i  +  1      + c*4*nx*ny];
-            z[2][c] = zcorn[k*8*nx*ny + j*4*nx + 2*nx + 2*i     + c*4*nx*ny];
-            z[3][c] = zcorn[k*8*nx*ny + j*4*nx + 2*nx + 2*i + 1 + c*4*nx*ny];
-          }
-        }
-
-        {
-          int ip;
-          for (ip = 0; ip <  4; ip++)
-            ecl_grid_pillar_cross_planes(&pillars[ip][0] , ex[ip], ey[ip] , ez[ip] , z[ip] , x[ip] , y[ip]);
-        }
+    ecl_grid_init_pillars_EGRID( nx , coord , i , j , pillars , ex , ey , ez );
+    for (k=0; k < nz; k++) {
+      double x[4][2];
+      double y[4][2];
+      double z[4][2];
 
-        ecl_grid_set_cell_EGRID(ecl_grid , i , j , k , x , y , z , actnum , corsnum);
-      }
+      ecl_grid_init_cell_xyz_EGRID( nx , ny , zcorn , i , j , k , pillars , ex , ey , ez , x , y , z);
+      ecl_grid_set_cell_EGRID(ecl_grid , i , j , k , x , y , z , actnum , corsnum);
     }
   }
 }
@@ -2388,6 +2760,383 @@ void ecl_grid_init_GRDECL_data(ecl_grid_type * ecl_grid,
 }
 
 
+/*****************************************************************/
+/* Lazy grids */
+
+/*
+  A lazy grid keeps the COORD, ZCORN and ACTNUM keywords as loaded
+  from the EGRID file and does not allocate the cells array at all;
+  when a cell is requested with ecl_grid_get_cell() the geometry is
+  calculated from the COORD and ZCORN data and stored in a small LRU
+  cache of materialized cells. The index maps, the LGR relationships
+  and the NNC information are established when the grid is loaded, so
+  all the read accessors work as for a normal grid.
+
+  Observe the following:
+
+   1. The cell pointer returned by ecl_grid_get_cell() for a lazy
+      grid is only valid until the cache slot is reused. Since the
+      least recently used slot is always evicted first it is safe to
+      hold on to the cell pointers from the (cache_size - 1) most
+      recent lookups; the minimum cache size guarantees that the
+      functions working on two cells simultaneously are safe.
+
+   2. The cache is updated also by const accessors, i.e. a lazy grid
+      can not be accessed from several threads simultaneously.
+
+   3. Grids with coarsening groups are always loaded in the normal
+      way.
+*/
+
+#define ECL_GRID_LAZY_MIN_CACHE_SIZE 8
+
+struct ecl_grid_lazy_struct {
+  ecl_kw_type          * zcorn_kw;
+  int                  * actnum;         /* NULL is interpreted as all cells active. */
+  int                  * hostnum;        /* Only for lgr: the host cell in the parent grid for all cells. */
+  vector_type          * lgr_list;       /* The lgr grids with host cells in this grid ... */
+  vector_type          * lgr_host_cells; /* ... and the sorted list of host cells (int_vector) for each of them. */
+
+  int                    cache_size;
+  ecl_cell_type        * cache_cells;
+  int                  * cache_index;    /* The global index of the cell in each slot; -1 for free slots. */
+  int                  * cache_prev;     /* The slots form a doubly linked list in LRU order. */
+  int                  * cache_next;
+  int                    cache_head;     /* The most recently used slot. */
+  int                    cache_tail;     /* The least recently used slot - will be evicted first. */
+  int                    num_buckets;    /* Hash table global_index -> slot with chaining; num_buckets is a power of two. */
+  int                  * bucket_head;
+  int                  * bucket_next;
+};
+
+
+static void ecl_grid_lazy_flush( ecl_grid_lazy_type * lazy ) {
+  int slot;
+  for (slot = 0; slot < lazy->cache_size; slot++) {
+    lazy->cache_index[slot] = -1;
+    lazy->bucket_next[slot] = -1;
+  }
+
+  for (slot = 0; slot < lazy->num_buckets; slot++)
+    lazy->bucket_head[slot] = -1;
+}
+
+
+static ecl_grid_lazy_type * ecl_grid_lazy_alloc( const ecl_kw_type * zcorn_kw , const ecl_kw_type * actnum_kw , int size , int cache_size) {
+  ecl_grid_lazy_type * lazy = util_malloc( sizeof * lazy );
+
+  lazy->zcorn_kw = ecl_kw_alloc_copy( zcorn_kw );
+  if (actnum_kw)
+    lazy->actnum = util_alloc_copy( ecl_kw_get_int_ptr( actnum_kw ) , size * sizeof * lazy->actnum );
+  else
+    lazy->actnum = NULL;
+
+  lazy->hostnum        = NULL;
+  lazy->lgr_list       = vector_alloc_new();
+  lazy->lgr_host_cells = vector_alloc_new();
+
+  lazy->cache_size  = util_int_max( cache_size , ECL_GRID_LAZY_MIN_CACHE_SIZE );
+  lazy->cache_cells = util_calloc( lazy->cache_size , sizeof * lazy->cache_cells );
+  lazy->cache_index = util_calloc( lazy->cache_size , sizeof * lazy->cache_index );
+  lazy->cache_prev  = util_calloc( lazy->cache_size , sizeof * lazy->cache_prev );
+  lazy->cache_next  = util_calloc( lazy->cache_size , sizeof * lazy->cache_next );
+  lazy->bucket_next = util_calloc( lazy->cache_size , sizeof * lazy->bucket_next );
+
+  lazy->num_buckets = 1;
+  while (lazy->num_buckets < 2 * lazy->cache_size)
+    lazy->num_buckets *= 2;
+  lazy->bucket_head = util_calloc( lazy->num_buckets , sizeof * lazy->bucket_head );
+
+  {
+    int slot;
+    for (slot = 0; slot < lazy->cache_size; slot++) {
+      lazy->cache_prev[slot] = slot - 1;
+      lazy->cache_next[slot] = slot + 1;
+    }
+    lazy->cache_next[lazy->cache_size - 1] = -1;
+    lazy->cache_head = 0;
+    lazy->cache_tail = lazy->cache_size - 1;
+  }
+  ecl_grid_lazy_flush( lazy );
+  return lazy;
+}
+
+
+static void ecl_grid_lazy_free( ecl_grid_lazy_type * lazy , int size) {
+  ecl_kw_free( lazy->zcorn_kw );
+  util_safe_free( lazy->actnum );
+  util_safe_free( lazy->hostnum );
+  vector_free( lazy->lgr_list );
+  vector_free( lazy->lgr_host_cells );
+
+  free( lazy->cache_cells );
+  free( lazy->cache_index );
+  free( lazy->cache_prev );
+  free( lazy->cache_next );
+  free( lazy->bucket_head );
+  free( lazy->bucket_next );
+  free( lazy );
+}
+
+
+static int ecl_grid_lazy_lookup( const ecl_grid_lazy_type * lazy , int global_index) {
+  int slot = lazy->bucket_head[ global_index & (lazy->num_buckets - 1) ];
+  while (slot >= 0) {
+    if (lazy->cache_index[slot] == global_index)
+      return slot;
+    slot = lazy->bucket_next[slot];
+  }
+  return -1;
+}
+
+
+static void ecl_grid_lazy_unhash( ecl_grid_lazy_type * lazy , int slot) {
+  int bucket = lazy->cache_index[slot] & (lazy->num_buckets - 1);
+  if (lazy->bucket_head[bucket] == slot)
+    lazy->bucket_head[bucket] = lazy->bucket_next[slot];
+  else {
+    int prev = lazy->bucket_head[bucket];
+    while (lazy->bucket_next[prev] != slot)
+      prev = lazy->bucket_next[prev];
+    lazy->bucket_next[prev] = lazy->bucket_next[slot];
+  }
+  lazy->bucket_next[slot] = -1;
+  lazy->cache_index[slot] = -1;
+}
+
+
+static void ecl_grid_lazy_hash( ecl_grid_lazy_type * lazy , int slot , int global_index) {
+  int bucket = global_index & (lazy->num_buckets - 1);
+  lazy->cache_index[slot] = global_index;
+  lazy->bucket_next[slot] = lazy->bucket_head[bucket];
+  lazy->bucket_head[bucket] = slot;
+}
+
+
+static void ecl_grid_lazy_touch( ecl_grid_lazy_type * lazy , int slot) {
+  if (slot == lazy->cache_head)
+    return;
+
+  lazy->cache_next[ lazy->cache_prev[slot] ] = lazy->cache_next[slot];
+  if (slot == lazy->cache_tail)
+    lazy->cache_tail = lazy->cache_prev[slot];
+  else
+    lazy->cache_prev[ lazy->cache_next[slot] ] = lazy->cache_prev[slot];
+
+  lazy->cache_prev[slot] = -1;
+  lazy->cache_next[slot] = lazy->cache_head;
+  lazy->cache_prev[ lazy->cache_head ] = slot;
+  lazy->cache_head = slot;
+}
+
+
+static const ecl_grid_type * ecl_grid_lookup_cell_lgr( const vector_type * lgr_list , const vector_type * lgr_host_cells , int global_index) {
+  int lgr_index;
+  for (lgr_index = 0; lgr_index < vector_get_size( lgr_list ); lgr_index++) {
+    const int_vector_type * host_cells = vector_iget_const( lgr_host_cells , lgr_index );
+    if (int_vector_contains_sorted( host_cells , global_index ))
+      return vector_iget_const( lgr_list , lgr_index );
+  }
+  return NULL;
+}
+
+
+static const ecl_grid_type * ecl_grid_lazy_get_cell_lgr( const ecl_grid_lazy_type * lazy , int global_index) {
+  return ecl_grid_lookup_cell_lgr( lazy->lgr_list , lazy->lgr_host_cells , global_index );
+}
+
+
+static void ecl_grid_lazy_init_cell( const ecl_grid_type * grid , int global_index , ecl_cell_type * cell) {
+  const ecl_grid_lazy_type * lazy = grid->lazy;
+  int i,j,k;
+
+  ecl_cell_init( cell , true );
+  ecl_grid_get_ijk1( grid , global_index , &i , &j , &k );
+  {
+    point_type pillars[4][2];
+    double ex[4], ey[4], ez[4];
+    double x[4][2], y[4][2], z[4][2];
+
+    ecl_grid_init_pillars_EGRID( grid->nx , ecl_kw_get_float_ptr( grid->coord_kw ) , i , j , pillars , ex , ey , ez );
+    ecl_grid_init_cell_xyz_EGRID( grid->nx , grid->ny , ecl_kw_get_float_ptr( lazy->zcorn_kw ) , i , j , k , pillars , ex , ey , ez , x , y , z);
+    ecl_cell_set_corners_EGRID( grid , cell , x , y , z );
+  }
+
+  if (lazy->actnum)
+    cell->active = lazy->actnum[global_index];
+  else
+    cell->active = CELL_ACTIVE;
+
+  if (cell->active & CELL_ACTIVE_MATRIX)
+    cell->active_index[MATRIX_INDEX] = grid->index_map[global_index];
+
+  if ((cell->active & CELL_ACTIVE_FRACTURE) && grid->fracture_index_map)
+    cell->active_index[FRACTURE_INDEX] = grid->fracture_index_map[global_index];
+
+  if (lazy->hostnum)
+    cell->host_cell = lazy->hostnum[global_index];
+
+  cell->lgr = ecl_grid_lazy_get_cell_lgr( lazy , global_index );
+  ecl_cell_taint_cell( cell );
+}
+
+
+static ecl_cell_type * ecl_grid_lazy_get_cell(const ecl_grid_type * grid , int global_index) {
+  ecl_grid_lazy_type * lazy = grid->lazy;
+  int slot = ecl_grid_lazy_lookup( lazy , global_index );
+  ecl_cell_type * cell;
+
+  if (slot < 0) {
+    slot = lazy->cache_tail;
+    if (lazy->cache_index[slot] >= 0)
+      ecl_grid_lazy_unhash( lazy , slot );
+
+    ecl_grid_lazy_init_cell( grid , global_index , &lazy->cache_cells[slot] );
+    ecl_grid_lazy_hash( lazy , slot , global_index );
+  }
+  ecl_grid_lazy_touch( lazy , slot );
+
+  cell = &lazy->cache_cells[slot];
+  return cell;
+}
+
+
+static int * ecl_grid_lazy_alloc_inv_index_map( const ecl_grid_type * ecl_grid , const int * index_map , int total_active) {
+  int * inv_index_map = util_calloc( total_active , sizeof * inv_index_map );
+  int global_index;
+  for (global_index = 0; global_index < ecl_grid->size; global_index++) {
+    if (index_map[global_index] >= 0)
+      inv_index_map[ index_map[global_index] ] = global_index;
+  }
+  return inv_index_map;
+}
+
+
+/*
+  The lazy grids do not support coarsening, so the index maps can be
+  created directly from the actnum array without going through the
+  cells.
+*/
+
+static void ecl_grid_lazy_update_index( ecl_grid_type * ecl_grid ) {
+  const int * actnum = ecl_grid->lazy->actnum;
+  bool dualp = (ecl_grid->dualp_flag != FILEHEAD_SINGLE_POROSITY);
+  int active_index = 0;
+  int active_fracture_index = 0;
+  int global_index;
+
+  ecl_grid->index_map = util_realloc( ecl_grid->index_map , ecl_grid->size * sizeof * ecl_grid->index_map );
+  if (dualp)
+    ecl_grid->fracture_index_map = util_realloc( ecl_grid->fracture_index_map , ecl_grid->size * sizeof * ecl_grid->fracture_index_map );
+
+  for (global_index = 0; global_index < ecl_grid->size; global_index++) {
+    int active = actnum ? actnum[global_index] : CELL_ACTIVE;
+
+    if (active & CELL_ACTIVE_MATRIX) {
+      ecl_grid->index_map[global_index] = active_index;
+      active_index++;
+    } else
+      ecl_grid->index_map[global_index] = -1;
+
+    if (dualp) {
+      if (active & CELL_ACTIVE_FRACTURE) {
+        ecl_grid->fracture_index_map[global_index] = active_fracture_index;
+        active_fracture_index++;
+      } else
+        ecl_grid->fracture_index_map[global_index] = -1;
+    }
+  }
+
+  ecl_grid->total_active = active_index;
+  ecl_grid->total_active_fracture = active_fracture_index;
+
+  util_safe_free( ecl_grid->inv_index_map );
+  ecl_grid->inv_index_map = ecl_grid_lazy_alloc_inv_index_map( ecl_grid , ecl_grid->index_map , active_index );
+  if (dualp) {
+    util_safe_free( ecl_grid->inv_fracture_index_map );
+    ecl_grid->inv_fracture_index_map = ecl_grid_lazy_alloc_inv_index_map( ecl_grid , ecl_grid->fracture_index_map , active_fracture_index );
+  }
+
+  ecl_grid_lazy_flush( ecl_grid->lazy );
+}
+
+
+static void ecl_grid_lazy_reset_actnum( ecl_grid_type * ecl_grid , const int * actnum) {
+  ecl_grid_lazy_type * lazy = ecl_grid->lazy;
+  if (actnum)
+    lazy->actnum = util_realloc_copy( lazy->actnum , actnum , ecl_grid->size * sizeof * lazy->actnum );
+  else {
+    util_safe_free( lazy->actnum );
+    lazy->actnum = NULL;
+  }
+}
+
+
+static void ecl_grid_lazy_set_hostnum( ecl_grid_type * lgr_grid , const int * hostnum) {
+  ecl_grid_lazy_type * lazy = lgr_grid->lazy;
+  int global_lgr_index;
+
+  lazy->hostnum = util_realloc( lazy->hostnum , lgr_grid->size * sizeof * lazy->hostnum );
+  for (global_lgr_index = 0; global_lgr_index < lgr_grid->size; global_lgr_index++)
+    lazy->hostnum[global_lgr_index] = hostnum[global_lgr_index] - 1;
+
+  ecl_grid_lazy_flush( lazy );
+}
+
+
+static void ecl_grid_lazy_install_lgr( ecl_grid_type * host_grid , const ecl_grid_type * lgr_grid , const int * hostnum) {
+  ecl_grid_lazy_type * lazy = host_grid->lazy;
+  int_vector_type * host_cells = int_vector_alloc( 0 , 0 );
+  int global_lgr_index;
+
+  for (global_lgr_index = 0; global_lgr_index < lgr_grid->size; global_lgr_index++)
+    int_vector_append( host_cells , hostnum[global_lgr_index] - 1);
+  int_vector_select_unique( host_cells );
+
+  vector_append_ref( lazy->lgr_list , lgr_grid );
+  vector_append_owned_ref( lazy->lgr_host_cells , host_cells , int_vector_free__ );
+  ecl_grid_lazy_flush( lazy );
+}
+
+
+bool ecl_grid_is_lazy( const ecl_grid_type * grid ) {
+  return (grid->lazy != NULL);
+}
+
+
+/*
+  Will return a reference to the grid cache owned by the grid; the
+  cache is created on the first call and then shared by all callers.
+  For a main grid loaded from file the cache is loaded from the file
+  ecl_grid_cache_alloc_filename() next to the grid file if that file
+  exists, is not older than the grid file and matches the grid. The
+  returned reference must be released with ecl_grid_cache_free(). The
+  grid drops the cache when the active cells are changed with
+  ecl_grid_reset_actnum(), and a later call creates a new cache.
+*/
+
+ecl_grid_cache_type * ecl_grid_get_cache( const ecl_grid_type * grid ) {
+  if (!grid->cache) {
+    // C++ style const cast.
+    ecl_grid_type * g = (ecl_grid_type *) grid;
+
+    if ((grid->lgr_nr == ECL_GRID_MAINGRID_LGR_NR) && grid->name && util_file_exists( grid->name )) {
+      char * cache_file = ecl_grid_cache_alloc_filename( grid->name );
+      if (util_file_exists( cache_file ) && (util_file_difftime( grid->name , cache_file ) <= 0))
+        g->cache = ecl_grid_cache_fread_alloc( grid , cache_file );
+      free( cache_file );
+    }
+
+    if (!g->cache)
+      g->cache = ecl_grid_cache_alloc( grid );
+  }
+
+  ecl_grid_cache_incref( grid->cache );
+  return grid->cache;
+}
+
+
+
 
 /*
   2---3
@@ -2449,9 +3198,8 @@ static void ecl_grid_copy_content( ecl_grid_type * target_grid , const ecl_grid_
     const ecl_cell_type * src_cell = ecl_grid_get_cell( src_grid , global_index );
 
     ecl_cell_memcpy( target_cell , src_cell );
-    if (src_cell->nnc_info)
-      target_cell->nnc_info = nnc_info_alloc_copy( src_cell->nnc_info );
   }
+  ecl_grid_copy_nnc( target_grid , src_grid );
   ecl_grid_copy_mapaxes( target_grid , src_grid );
 
   target_grid->parent_name = util_alloc_string_copy( src_grid->parent_name );
@@ -2656,6 +3404,40 @@ static ecl_grid_type * ecl_grid_alloc_GRDECL_kw__(ecl_grid_type * global_grid ,
 }
 
 
+static ecl_grid_type * ecl_grid_alloc_EGRID_lazy_kw__(ecl_grid_type * global_grid ,
+                                                      int dualp_flag,
+                                                      bool apply_mapaxes,
+                                                      const ecl_kw_type * gridhead_kw ,
+                                                      const ecl_kw_type * zcorn_kw ,
+                                                      const ecl_kw_type * coord_kw ,
+                                                      const ecl_kw_type * actnum_kw ,    /* Can be NULL */
+                                                      const ecl_kw_type * mapaxes_kw ,   /* Can be NULL */
+                                                      int cache_size) {
+  int gtype   = ecl_kw_iget_int(gridhead_kw , GRIDHEAD_TYPE_INDEX);
+  int nx      = ecl_kw_iget_int(gridhead_kw , GRIDHEAD_NX_INDEX);
+  int ny      = ecl_kw_iget_int(gridhead_kw , GRIDHEAD_NY_INDEX);
+  int nz      = ecl_kw_iget_int(gridhead_kw , GRIDHEAD_NZ_INDEX);
+  int lgr_nr  = ecl_kw_iget_int(gridhead_kw , GRIDHEAD_LGR_INDEX);
+
+  if (gtype != GRIDHEAD_GRIDTYPE_CORNERPOINT)
+    util_abort("%s: gtype:%d fatal error when loading grid - must have corner point grid - aborting\n",__func__ , gtype );
+
+  {
+    ecl_grid_type * ecl_grid = ecl_grid_alloc_empty__( global_grid , dualp_flag , nx , ny , nz , lgr_nr );
+    if (mapaxes_kw != NULL) {
+      const float * mapaxes_data = ecl_grid_get_mapaxes_from_kw__( mapaxes_kw );
+      if (mapaxes_data != NULL)
+        ecl_grid_init_mapaxes( ecl_grid , apply_mapaxes , mapaxes_data );
+    }
+
+    ecl_grid->coord_kw = ecl_kw_alloc_copy( coord_kw );
+    ecl_grid->lazy = ecl_grid_lazy_alloc( zcorn_kw , actnum_kw , ecl_grid->size , cache_size );
+    ecl_grid_update_index( ecl_grid );
+    return ecl_grid;
+  }
+}
+
+
 /**
    If you create/load ecl_kw instances for the various fields, this
    function can be used to create a GRID instance, without going
@@ -2690,20 +3472,14 @@ ecl_grid_type * ecl_grid_alloc_GRDECL_kw( int nx, int ny , int nz ,
 
 
 
-static void ecl_grid_init_cell_nnc_info(ecl_grid_type * ecl_grid, int global_index) {
-  ecl_cell_type * grid_cell = ecl_grid_get_cell(ecl_grid, global_index);
-
-  if (!grid_cell->nnc_info)
-    grid_cell->nnc_info = nnc_info_alloc(ecl_grid->lgr_nr);
-}
 
 /*
   The function ecl_grid_add_self_nnc() will add a NNC connection
   between two cells in the same grid. Observe that there are two
   peculiarities with this implementation:
 
-   1. In the ecl_grid structure the nnc information is distributed
-      among the cells. The main purpose of adding the nnc information
+   1. In the ecl_grid structure the nnc information is stored per
+      grid pair, see the comment about NNC storage. The main purpose of adding the nnc information
       like this is to include the NNC information in the EGRID files
       when writing to disk. Before being written to disk the NNC
       information is serialized into vectors NNC1 and NNC2. It is the
@@ -2741,9 +3517,7 @@ static void ecl_grid_init_cell_nnc_info(ecl_grid_type * ecl_grid, int global_ind
 */
 
 void ecl_grid_add_self_nnc( ecl_grid_type * grid, int cell_index1, int cell_index2, int nnc_index) {
-  ecl_cell_type * grid_cell = ecl_grid_get_cell(grid, cell_index1);
-  ecl_grid_init_cell_nnc_info(grid, cell_index1);
-  nnc_info_add_nnc(grid_cell->nnc_info, grid->lgr_nr, cell_index2, nnc_index);
+  ecl_grid_add_nnc__( grid , grid->lgr_nr , cell_index1 , cell_index2 , nnc_index );
 }
 
 /*
@@ -2804,11 +3578,7 @@ static void ecl_grid_init_nnc_cells( ecl_grid_type * grid1, ecl_grid_type * grid
 
 
 
-    {
-      ecl_cell_type * grid1_cell = ecl_grid_get_cell(grid1, grid1_cell_index);
-      ecl_grid_init_cell_nnc_info(grid1, grid1_cell_index);
-      nnc_info_add_nnc(grid1_cell->nnc_info, grid2->lgr_nr, grid2_cell_index , nnc_index);
-    }
+    ecl_grid_add_nnc__( grid1 , grid2->lgr_nr , grid1_cell_index , grid2_cell_index , nnc_index );
   }
 }
 
@@ -2902,7 +3672,7 @@ static void ecl_grid_init_nnc_amalgamated(ecl_grid_type * main_grid, ecl_file_ty
 */
 
 
-static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const ecl_file_type * ecl_file , int grid_nr, bool apply_mapaxes) {
+static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const ecl_file_type * ecl_file , int grid_nr, bool apply_mapaxes, int lazy_cache_size) {
   ecl_kw_type * gridhead_kw  = ecl_file_iget_named_kw( ecl_file , GRIDHEAD_KW  , grid_nr);
   ecl_kw_type * zcorn_kw     = ecl_file_iget_named_kw( ecl_file , ZCORN_KW     , grid_nr);
   ecl_kw_type * coord_kw     = ecl_file_iget_named_kw( ecl_file , COORD_KW     , grid_nr);
@@ -2937,15 +3707,28 @@ static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const
 
 
   {
-    ecl_grid_type * ecl_grid = ecl_grid_alloc_GRDECL_kw__( main_grid ,
-                                                           dualp_flag ,
-                                                           apply_mapaxes,
-                                                           gridhead_kw ,
-                                                           zcorn_kw ,
-                                                           coord_kw ,
-                                                           actnum_kw ,
-                                                           mapaxes_kw ,
-                                                           corsnum_kw );
+    ecl_grid_type * ecl_grid;
+
+    if ((lazy_cache_size > 0) && (corsnum_kw == NULL))
+      ecl_grid = ecl_grid_alloc_EGRID_lazy_kw__( main_grid ,
+                                                 dualp_flag ,
+                                                 apply_mapaxes,
+                                                 gridhead_kw ,
+                                                 zcorn_kw ,
+                                                 coord_kw ,
+                                                 actnum_kw ,
+                                                 mapaxes_kw ,
+                                                 lazy_cache_size );
+    else
+      ecl_grid = ecl_grid_alloc_GRDECL_kw__( main_grid ,
+                                             dualp_flag ,
+                                             apply_mapaxes,
+                                             gridhead_kw ,
+                                             zcorn_kw ,
+                                             coord_kw ,
+                                             actnum_kw ,
+                                             mapaxes_kw ,
+                                             corsnum_kw );
 
     if (ECL_GRID_MAINGRID_LGR_NR != grid_nr) ecl_grid_set_lgr_name_EGRID(ecl_grid , ecl_file , grid_nr);
     ecl_grid->eclipse_version = eclipse_version;
@@ -2955,7 +3738,7 @@ static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const
 
 
 
-ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes) {
+static ecl_grid_type * ecl_grid_alloc_EGRID_file__(const char * grid_file, bool apply_mapaxes, int lazy_cache_size) {
   ecl_file_enum   file_type;
   file_type = ecl_util_get_file_type(grid_file , NULL , NULL);
   if (file_type != ECL_EGRID_FILE)
@@ -2964,11 +3747,11 @@ ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes)
     ecl_file_type * ecl_file   = ecl_file_open( grid_file , 0);
     if (ecl_file) {
       int num_grid               = ecl_file_get_num_named_kw( ecl_file , GRIDHEAD_KW );
-      ecl_grid_type * main_grid  = ecl_grid_alloc_EGRID__( NULL , ecl_file , 0 , apply_mapaxes);
+      ecl_grid_type * main_grid  = ecl_grid_alloc_EGRID__( NULL , ecl_file , 0 , apply_mapaxes, lazy_cache_size);
       int grid_nr;
 
       for ( grid_nr = 1; grid_nr < num_grid; grid_nr++) {
-        ecl_grid_type * lgr_grid = ecl_grid_alloc_EGRID__( main_grid , ecl_file , grid_nr , false);  /* The apply_mapaxes argument is ignored for LGR - it inherits from parent anyway. */
+        ecl_grid_type * lgr_grid = ecl_grid_alloc_EGRID__( main_grid , ecl_file , grid_nr , false, lazy_cache_size);  /* The apply_mapaxes argument is ignored for LGR - it inherits from parent anyway. */
         ecl_grid_add_lgr( main_grid , lgr_grid );
         {
           ecl_grid_type * host_grid;
@@ -2993,6 +3776,528 @@ ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes)
 }
 
 
+ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes) {
+  return ecl_grid_alloc_EGRID_file__( grid_file , apply_mapaxes , 0 );
+}
+
+
+/**
+   Will load the EGRID file without calculating the geometry of the
+   cells, see the comment about lazy grids above. The cache_size
+   argument is the number of cells with geometry which are kept in
+   memory.
+*/
+
+ecl_grid_type * ecl_grid_alloc_EGRID_lazy(const char * grid_file, bool apply_mapaxes, int cache_size) {
+  return ecl_grid_alloc_EGRID_file__( grid_file , apply_mapaxes , util_int_max( cache_size , ECL_GRID_LAZY_MIN_CACHE_SIZE ));
+}
+
+
+/*****************************************************************/
+/* Grid snapshots */
+
+/*
+  A grid snapshot is a binary image of a fully constructed grid,
+  including LGRs, NNC information and the active index maps, written
+  with ecl_grid_fwrite_snapshot(). When the snapshot is loaded with
+  ecl_grid_alloc_snapshot() the file is mapped into memory, and the
+  cells and the index maps of the grid point directly into the
+  mapped file; i.e. loading a snapshot does not involve parsing or
+  geometry calculations. The file is mapped MAP_PRIVATE, so
+  processes on the same node loading the same snapshot will share
+  the physical pages as long as they are not modified.
+
+  Observe the following:
+
+   1. The cells are stored in the native memory layout of the
+      ecl_cell_type struct; a snapshot can only be loaded by the same
+      build of the library on a machine with the same byte order.
+      This is checked when the snapshot is loaded.
+
+   2. The cell center and volume are calculated before the cells are
+      written, so that normal read access to the cells does not
+      write to the mapped pages.
+
+   3. The lgr pointers in the cells are not stored, and they are not
+      written back to the mapped cells either; when loading, a sorted
+      list of host cells is assembled on the heap for each LGR, and
+      ecl_grid_get_cell_lgr1() looks the LGR up there. The NNC CSR
+      arrays are stored and used directly from the mapped file.
+
+   4. If the grid is modified, e.g. with ecl_grid_reset_actnum(), the
+      index maps are copied to the heap before they are updated.
+
+  When mmap() is not available the snapshot is read into a malloc()
+  buffer in one operation instead.
+*/
+
+#define ECL_GRID_SNAPSHOT_MAGIC      "ECLGSNAP"
+#define ECL_GRID_SNAPSHOT_VERSION    2
+#define ECL_GRID_SNAPSHOT_BYTE_ORDER 0x01020304
+#define ECL_GRID_SNAPSHOT_ALIGNMENT  64
+
+struct ecl_grid_snapshot_struct {
+  char   * data;
+  size_t   size;
+  bool     mapped;
+};
+
+
+typedef struct {
+  char     magic[8];
+  int      version;
+  int      byte_order;
+  int      cell_size;     /* sizeof(ecl_cell_type) for the library which wrote the snapshot. */
+  int      num_grids;     /* The main grid followed by the LGRs in the order of the LGR_list. */
+  int64_t  file_size;
+} ecl_grid_snapshot_header_type;
+
+
+typedef struct {
+  int      lgr_nr;
+  int      nx, ny, nz;
+  int      total_active;
+  int      total_active_fracture;
+  int      dualp_flag;
+  int      unit_system;
+  int      eclipse_version;
+  int      use_mapaxes;
+  int      has_mapaxes;
+  int      coarsening_active;
+  int      parent_box[6];
+  int      coord_size;
+  int      num_nnc_csr;
+  double   unit_x[2];
+  double   unit_y[2];
+  double   origo[2];
+  float    mapaxes[6];
+
+  /* Byte offsets from the start of the file; 0 for missing elements. */
+  int64_t  name_offset;
+  int64_t  parent_name_offset;
+  int64_t  cells_offset;
+  int64_t  index_map_offset;
+  int64_t  inv_index_map_offset;
+  int64_t  fracture_index_map_offset;
+  int64_t  inv_fracture_index_map_offset;
+  int64_t  coord_offset;
+  int64_t  nnc_csr_offset;
+} ecl_grid_snapshot_grid_type;
+
+
+typedef struct {
+  int      lgr_nr;
+  int      num_nnc;
+  int64_t  offset_offset;
+  int64_t  grid_index_offset;
+  int64_t  nnc_index_offset;
+} ecl_grid_snapshot_nnc_type;
+
+
+
+static bool ecl_grid_snapshot_borrowed( const ecl_grid_type * grid , const void * ptr) {
+  if (grid->snapshot && ptr) {
+    const char * p = ptr;
+    return ((p >= grid->snapshot->data) && (p < grid->snapshot->data + grid->snapshot->size));
+  } else
+    return false;
+}
+
+
+/*
+  Used before the index maps are reallocated; the maps which point
+  into the snapshot are replaced with heap copies.
+*/
+
+static void ecl_grid_snapshot_detach_index_map( ecl_grid_type * grid ) {
+  if (ecl_grid_snapshot_borrowed( grid , grid->index_map ))
+    grid->index_map = util_alloc_copy( grid->index_map , grid->size * sizeof * grid->index_map );
+
+  if (ecl_grid_snapshot_borrowed( grid , grid->inv_index_map ))
+    grid->inv_index_map = util_alloc_copy( grid->inv_index_map , grid->total_active * sizeof * grid->inv_index_map );
+
+  if (ecl_grid_snapshot_borrowed( grid , grid->fracture_index_map ))
+    grid->fracture_index_map = util_alloc_copy( grid->fracture_index_map , grid->size * sizeof * grid->fracture_index_map );
+
+  if (ecl_grid_snapshot_borrowed( grid , grid->inv_fracture_index_map ))
+    grid->inv_fracture_index_map = util_alloc_copy( grid->inv_fracture_index_map , grid->total_active_fracture * sizeof * grid->inv_fracture_index_map );
+}
+
+
+/*
+  Sets all the pointers into the snapshot to NULL, so that the
+  remaining fields can be freed in the normal way.
+*/
+
+static void ecl_grid_snapshot_release( ecl_grid_type * grid ) {
+  if (ecl_grid_snapshot_borrowed( grid , grid->cells ))
+    grid->cells = NULL;
+
+  if (ecl_grid_snapshot_borrowed( grid , grid->index_map ))
+    grid->index_map = NULL;
+
+  if (ecl_grid_snapshot_borrowed( grid , grid->inv_index_map ))
+    grid->inv_index_map = NULL;
+
+  if (ecl_grid_snapshot_borrowed( grid , grid->fracture_index_map ))
+    grid->fracture_index_map = NULL;
+
+  if (ecl_grid_snapshot_borrowed( grid , grid->inv_fracture_index_map ))
+    grid->inv_fracture_index_map = NULL;
+}
+
+
+static void ecl_grid_snapshot_free( ecl_grid_snapshot_type * snapshot ) {
+#ifdef HAVE_MMAP
+  if (snapshot->mapped)
+    munmap( snapshot->data , snapshot->size );
+  else
+    free( snapshot->data );
+#else
+  free( snapshot->data );
+#endif
+  free( snapshot );
+}
+
+
+static ecl_grid_snapshot_type * ecl_grid_snapshot_alloc( const char * filename ) {
+  size_t size = util_file_size( filename );
+  ecl_grid_snapshot_type * snapshot = util_malloc( sizeof * snapshot );
+  snapshot->size = size;
+  snapshot->mapped = false;
+  snapshot->data = NULL;
+
+#ifdef HAVE_MMAP
+  {
+    int fd = open( filename , O_RDONLY );
+    if (fd == -1)
+      util_abort("%s: failed to open:%s error:%d/%s \n",__func__ , filename , errno , strerror( errno ));
+
+    snapshot->data = mmap( NULL , size , PROT_READ | PROT_WRITE , MAP_PRIVATE , fd , 0 );
+    close( fd );
+    if (snapshot->data == MAP_FAILED)
+      snapshot->data = NULL;
+    else
+      snapshot->mapped = true;
+  }
+#endif
+
+  if (!snapshot->data) {
+    FILE * stream = util_fopen( filename , "r");
+    snapshot->data = util_malloc( size );
+    util_fread( snapshot->data , 1 , size , stream , __func__ );
+    fclose( stream );
+  }
+
+  return snapshot;
+}
+
+
+static const void * ecl_grid_snapshot_get_data( const ecl_grid_snapshot_type * snapshot , int64_t offset , size_t byte_size) {
+  if (offset == 0)
+    return NULL;
+
+  if ((offset < 0) || ((size_t) offset + byte_size > snapshot->size))
+    util_abort("%s: invalid offset:%lld in grid snapshot - file is corrupt\n",__func__ , (long long) offset);
+
+  return snapshot->data + offset;
+}
+
+
+static int64_t ecl_grid_snapshot_fwrite_data( FILE * stream , const void * data , size_t byte_size) {
+  if (data == NULL)
+    return 0;
+  {
+    int64_t offset = util_ftell( stream );
+    while (offset % ECL_GRID_SNAPSHOT_ALIGNMENT) {
+      fputc( 0 , stream );
+      offset++;
+    }
+
+    util_fwrite( data , 1 , byte_size , stream , __func__ );
+    return offset;
+  }
+}
+
+
+static int64_t ecl_grid_snapshot_fwrite_string( FILE * stream , const char * s ) {
+  if (s == NULL)
+    return 0;
+  else
+    return ecl_grid_snapshot_fwrite_data( stream , s , strlen( s ) + 1 );
+}
+
+
+/*
+  The cells are written in blocks of copies where the center and
+  volume have been calculated, and the lgr pointer has been cleared.
+*/
+
+static int64_t ecl_grid_snapshot_fwrite_cells( FILE * stream , const ecl_grid_type * grid ) {
+  const int block_size = 4096;
+  ecl_cell_type * block = util_calloc( block_size , sizeof * block );
+  int64_t offset = 0;
+  int block_start;
+
+  for (block_start = 0; block_start < grid->size; block_start += block_size) {
+    int num_cells = util_int_min( block_size , grid->size - block_start );
+    int c;
+
+    for (c = 0; c < num_cells; c++) {
+      ecl_cell_type * cell = &block[c];
+      memset( cell , 0 , sizeof * cell );
+      ecl_cell_memcpy( cell , ecl_grid_get_cell( grid , block_start + c ));
+      ecl_cell_get_signed_volume( cell );
+      cell->lgr = NULL;
+    }
+
+    if (block_start == 0)
+      offset = ecl_grid_snapshot_fwrite_data( stream , block , num_cells * sizeof * block );
+    else
+      util_fwrite( block , sizeof * block , num_cells , stream , __func__ );
+  }
+
+  free( block );
+  return offset;
+}
+
+
+static int64_t ecl_grid_snapshot_fwrite_nnc( FILE * stream , const ecl_grid_type * grid , int * num_nnc_csr) {
+  int csr_nr;
+  int64_t offset;
+  ecl_grid_snapshot_nnc_type * nnc_list;
+
+  ecl_grid_assert_nnc( grid );
+  *num_nnc_csr = vector_get_size( grid->nnc_csr_list );
+  if (*num_nnc_csr == 0)
+    return 0;
+
+  nnc_list = util_calloc( *num_nnc_csr , sizeof * nnc_list );
+  for (csr_nr = 0; csr_nr < *num_nnc_csr; csr_nr++) {
+    const ecl_grid_nnc_csr_type * csr = vector_iget_const( grid->nnc_csr_list , csr_nr );
+    ecl_grid_snapshot_nnc_type * nnc = &nnc_list[csr_nr];
+
+    nnc->lgr_nr            = csr->lgr_nr;
+    nnc->num_nnc           = csr->num_nnc;
+    nnc->offset_offset     = ecl_grid_snapshot_fwrite_data( stream , csr->offset , (grid->size + 1) * sizeof * csr->offset );
+    nnc->grid_index_offset = ecl_grid_snapshot_fwrite_data( stream , csr->grid_index , csr->num_nnc * sizeof * csr->grid_index );
+    nnc->nnc_index_offset  = ecl_grid_snapshot_fwrite_data( stream , csr->nnc_index , csr->num_nnc * sizeof * csr->nnc_index );
+  }
+  offset = ecl_grid_snapshot_fwrite_data( stream , nnc_list , *num_nnc_csr * sizeof * nnc_list );
+  free( nnc_list );
+  return offset;
+}
+
+
+static void ecl_grid_snapshot_fwrite_grid( FILE * stream , const ecl_grid_type * grid , ecl_grid_snapshot_grid_type * grid_header) {
+  memset( grid_header , 0 , sizeof * grid_header );
+  grid_header->lgr_nr                = grid->lgr_nr;
+  grid_header->nx                    = grid->nx;
+  grid_header->ny                    = grid->ny;
+  grid_header->nz                    = grid->nz;
+  grid_header->total_active          = grid->total_active;
+  grid_header->total_active_fracture = grid->total_active_fracture;
+  grid_header->dualp_flag            = grid->dualp_flag;
+  grid_header->unit_system           = grid->unit_system;
+  grid_header->eclipse_version       = grid->eclipse_version;
+  grid_header->use_mapaxes           = grid->use_mapaxes;
+  grid_header->coarsening_active     = grid->coarsening_active;
+  memcpy( grid_header->parent_box , grid->parent_box , sizeof grid_header->parent_box );
+  memcpy( grid_header->unit_x , grid->unit_x , sizeof grid_header->unit_x );
+  memcpy( grid_header->unit_y , grid->unit_y , sizeof grid_header->unit_y );
+  memcpy( grid_header->origo  , grid->origo  , sizeof grid_header->origo );
+  if (grid->mapaxes) {
+    grid_header->has_mapaxes = 1;
+    memcpy( grid_header->mapaxes , grid->mapaxes , sizeof grid_header->mapaxes );
+  }
+
+  grid_header->name_offset        = ecl_grid_snapshot_fwrite_string( stream , grid->name );
+  grid_header->parent_name_offset = ecl_grid_snapshot_fwrite_string( stream , grid->parent_name );
+  grid_header->cells_offset       = ecl_grid_snapshot_fwrite_cells( stream , grid );
+  grid_header->nnc_csr_offset     = ecl_grid_snapshot_fwrite_nnc( stream , grid , &grid_header->num_nnc_csr );
+
+  grid_header->index_map_offset     = ecl_grid_snapshot_fwrite_data( stream , grid->index_map , grid->size * sizeof * grid->index_map );
+  grid_header->inv_index_map_offset = ecl_grid_snapshot_fwrite_data( stream , grid->inv_index_map , grid->total_active * sizeof * grid->inv_index_map );
+  if (grid->dualp_flag != FILEHEAD_SINGLE_POROSITY) {
+    grid_header->fracture_index_map_offset     = ecl_grid_snapshot_fwrite_data( stream , grid->fracture_index_map , grid->size * sizeof * grid->fracture_index_map );
+    grid_header->inv_fracture_index_map_offset = ecl_grid_snapshot_fwrite_data( stream , grid->inv_fracture_index_map , grid->total_active_fracture * sizeof * grid->inv_fracture_index_map );
+  }
+
+  if (grid->coord_kw) {
+    grid_header->coord_size   = ecl_kw_get_size( grid->coord_kw );
+    grid_header->coord_offset = ecl_grid_snapshot_fwrite_data( stream , ecl_kw_get_float_ptr( grid->coord_kw ) , grid_header->coord_size * sizeof(float));
+  }
+}
+
+
+void ecl_grid_fwrite_snapshot( const ecl_grid_type * grid , const char * filename ) {
+  FILE * stream = util_mkdir_fopen( filename , "w");
+  int num_lgr = vector_get_size( grid->LGR_list );
+  ecl_grid_snapshot_header_type header;
+  ecl_grid_snapshot_grid_type * grid_headers = util_calloc( 1 + num_lgr , sizeof * grid_headers );
+
+  memset( &header , 0 , sizeof header );
+  memcpy( header.magic , ECL_GRID_SNAPSHOT_MAGIC , sizeof header.magic );
+  header.version    = ECL_GRID_SNAPSHOT_VERSION;
+  header.byte_order = ECL_GRID_SNAPSHOT_BYTE_ORDER;
+  header.cell_size  = sizeof(ecl_cell_type);
+  header.num_grids  = 1 + num_lgr;
+
+  /* The headers are written first as placeholders, and then again when the offsets are known. */
+  util_fwrite( &header , sizeof header , 1 , stream , __func__ );
+  util_fwrite( grid_headers , sizeof * grid_headers , header.num_grids , stream , __func__ );
+
+  ecl_grid_snapshot_fwrite_grid( stream , grid , &grid_headers[0] );
+  {
+    int lgr_index;
+    for (lgr_index = 0; lgr_index < num_lgr; lgr_index++)
+      ecl_grid_snapshot_fwrite_grid( stream , vector_iget_const( grid->LGR_list , lgr_index ) , &grid_headers[lgr_index + 1]);
+  }
+
+  header.file_size = util_ftell( stream );
+  util_fseek( stream , 0 , SEEK_SET );
+  util_fwrite( &header , sizeof header , 1 , stream , __func__ );
+  util_fwrite( grid_headers , sizeof * grid_headers , header.num_grids , stream , __func__ );
+
+  fclose( stream );
+  free( grid_headers );
+}
+
+
+
+static ecl_grid_type * ecl_grid_alloc_snapshot_grid( ecl_grid_snapshot_type * snapshot , ecl_grid_type * main_grid , const ecl_grid_snapshot_grid_type * grid_header) {
+  ecl_grid_type * grid = ecl_grid_alloc_empty__( main_grid , grid_header->dualp_flag , grid_header->nx , grid_header->ny , grid_header->nz , grid_header->lgr_nr );
+  grid->snapshot              = snapshot;
+  grid->total_active          = grid_header->total_active;
+  grid->total_active_fracture = grid_header->total_active_fracture;
+  grid->unit_system           = grid_header->unit_system;
+  grid->eclipse_version       = grid_header->eclipse_version;
+  grid->coarsening_active     = grid_header->coarsening_active;
+  memcpy( grid->parent_box , grid_header->parent_box , sizeof grid->parent_box );
+
+  if (main_grid == NULL) {
+    grid->use_mapaxes = grid_header->use_mapaxes;
+    memcpy( grid->unit_x , grid_header->unit_x , sizeof grid->unit_x );
+    memcpy( grid->unit_y , grid_header->unit_y , sizeof grid->unit_y );
+    memcpy( grid->origo  , grid_header->origo  , sizeof grid->origo );
+  }
+  if (grid_header->has_mapaxes)
+    grid->mapaxes = util_alloc_copy( grid_header->mapaxes , sizeof grid_header->mapaxes );
+
+  grid->name        = util_alloc_string_copy( ecl_grid_snapshot_get_data( snapshot , grid_header->name_offset , 0 ));
+  grid->parent_name = util_alloc_string_copy( ecl_grid_snapshot_get_data( snapshot , grid_header->parent_name_offset , 0 ));
+
+  grid->cells                  = (ecl_cell_type *) ecl_grid_snapshot_get_data( snapshot , grid_header->cells_offset , grid->size * sizeof * grid->cells );
+  grid->index_map              = (int *) ecl_grid_snapshot_get_data( snapshot , grid_header->index_map_offset , grid->size * sizeof * grid->index_map );
+  grid->inv_index_map          = (int *) ecl_grid_snapshot_get_data( snapshot , grid_header->inv_index_map_offset , grid->total_active * sizeof * grid->inv_index_map );
+  grid->fracture_index_map     = (int *) ecl_grid_snapshot_get_data( snapshot , grid_header->fracture_index_map_offset , grid->size * sizeof * grid->fracture_index_map );
+  grid->inv_fracture_index_map = (int *) ecl_grid_snapshot_get_data( snapshot , grid_header->inv_fracture_index_map_offset , grid->total_active_fracture * sizeof * grid->inv_fracture_index_map );
+
+  if (grid->cells == NULL)
+    util_abort("%s: grid snapshot without cells - file is corrupt\n",__func__);
+
+  if (grid_header->coord_offset)
+    grid->coord_kw = ecl_kw_alloc_new( COORD_KW , grid_header->coord_size , ECL_FLOAT ,
+                                       ecl_grid_snapshot_get_data( snapshot , grid_header->coord_offset , grid_header->coord_size * sizeof(float)));
+
+  if (grid->coarsening_active) {
+    ecl_grid_init_coarse_cells( grid );
+    ecl_grid_update_index( grid );
+  }
+
+  return grid;
+}
+
+
+static void ecl_grid_snapshot_init_nnc( ecl_grid_type * grid , const ecl_grid_snapshot_type * snapshot , const ecl_grid_snapshot_grid_type * grid_header) {
+  const ecl_grid_snapshot_nnc_type * nnc_list = ecl_grid_snapshot_get_data( snapshot , grid_header->nnc_csr_offset , grid_header->num_nnc_csr * sizeof * nnc_list );
+  int csr_nr;
+  for (csr_nr = 0; csr_nr < grid_header->num_nnc_csr; csr_nr++) {
+    const ecl_grid_snapshot_nnc_type * nnc = &nnc_list[csr_nr];
+    ecl_grid_nnc_csr_type * csr = ecl_grid_get_or_create_nnc_csr( grid , nnc->lgr_nr );
+
+    csr->num_nnc    = nnc->num_nnc;
+    csr->offset     = (int *) ecl_grid_snapshot_get_data( snapshot , nnc->offset_offset , (grid->size + 1) * sizeof * csr->offset );
+    csr->grid_index = (int *) ecl_grid_snapshot_get_data( snapshot , nnc->grid_index_offset , nnc->num_nnc * sizeof * csr->grid_index );
+    csr->nnc_index  = (int *) ecl_grid_snapshot_get_data( snapshot , nnc->nnc_index_offset , nnc->num_nnc * sizeof * csr->nnc_index );
+  }
+}
+
+
+/**
+   Will load a grid snapshot written with ecl_grid_fwrite_snapshot(),
+   see the comment about grid snapshots above.
+*/
+
+ecl_grid_type * ecl_grid_alloc_snapshot( const char * filename ) {
+  if (!util_file_exists( filename ))
+    return NULL;
+  {
+    ecl_grid_snapshot_type * snapshot = ecl_grid_snapshot_alloc( filename );
+    const ecl_grid_snapshot_header_type * header = (const ecl_grid_snapshot_header_type *) snapshot->data;
+    const ecl_grid_snapshot_grid_type * grid_headers;
+    ecl_grid_type * main_grid;
+
+    if ((snapshot->size < sizeof * header) || (memcmp( header->magic , ECL_GRID_SNAPSHOT_MAGIC , sizeof header->magic ) != 0))
+      util_abort("%s: %s is not a grid snapshot \n",__func__ , filename);
+
+    if (header->version != ECL_GRID_SNAPSHOT_VERSION)
+      util_abort("%s: %s: snapshot version:%d not supported - expected:%d \n",__func__ , filename , header->version , ECL_GRID_SNAPSHOT_VERSION);
+
+    if ((header->byte_order != ECL_GRID_SNAPSHOT_BYTE_ORDER) || (header->cell_size != sizeof(ecl_cell_type)))
+      util_abort("%s: %s was written by a different platform or library build - can not be loaded\n",__func__ , filename);
+
+    if (header->file_size != (int64_t) snapshot->size)
+      util_abort("%s: %s has size:%lld - expected:%lld; file is truncated or corrupt\n",__func__ , filename , (long long) snapshot->size , (long long) header->file_size);
+
+    grid_headers = ecl_grid_snapshot_get_data( snapshot , sizeof * header , header->num_grids * sizeof * grid_headers );
+    main_grid = ecl_grid_alloc_snapshot_grid( snapshot , NULL , &grid_headers[0] );
+    {
+      int grid_nr;
+      for (grid_nr = 1; grid_nr < header->num_grids; grid_nr++) {
+        ecl_grid_type * lgr_grid = ecl_grid_alloc_snapshot_grid( snapshot , main_grid , &grid_headers[grid_nr] );
+        ecl_grid_add_lgr( main_grid , lgr_grid );
+      }
+
+      for (grid_nr = 1; grid_nr < header->num_grids; grid_nr++) {
+        ecl_grid_type * lgr_grid = vector_iget( main_grid->LGR_list , grid_nr - 1 );
+        ecl_grid_type * host_grid;
+        int global_lgr_index;
+
+        if (lgr_grid->parent_name == NULL)
+          host_grid = main_grid;
+        else
+          host_grid = ecl_grid_get_lgr( main_grid , lgr_grid->parent_name );
+
+        {
+          int_vector_type * host_cells = int_vector_alloc( 0 , 0 );
+          for (global_lgr_index = 0; global_lgr_index < lgr_grid->size; global_lgr_index++) {
+            const ecl_cell_type * lgr_cell = ecl_grid_get_cell( lgr_grid , global_lgr_index );
+            if (lgr_cell->host_cell != HOST_CELL_NONE)
+              int_vector_append( host_cells , lgr_cell->host_cell );
+          }
+          int_vector_select_unique( host_cells );
+
+          if (host_grid->snapshot_lgr_list == NULL) {
+            host_grid->snapshot_lgr_list = vector_alloc_new();
+            host_grid->snapshot_lgr_host_cells = vector_alloc_new();
+          }
+          vector_append_ref( host_grid->snapshot_lgr_list , lgr_grid );
+          vector_append_owned_ref( host_grid->snapshot_lgr_host_cells , host_cells , int_vector_free__ );
+        }
+        ecl_grid_install_lgr_common( host_grid , lgr_grid );
+      }
+
+      ecl_grid_snapshot_init_nnc( main_grid , snapshot , &grid_headers[0] );
+      for (grid_nr = 1; grid_nr < header->num_grids; grid_nr++)
+        ecl_grid_snapshot_init_nnc( vector_iget( main_grid->LGR_list , grid_nr - 1 ) , snapshot , &grid_headers[grid_nr] );
+    }
+
+    return main_grid;
+  }
+}
+
+
 
 
 
@@ -3761,18 +5066,26 @@ static bool ecl_grid_compare_coarse_cells(const ecl_grid_type * g1 , const ecl_g
 static bool ecl_grid_compare_cells(const ecl_grid_type * g1 , const ecl_grid_type * g2, bool include_nnc , bool verbose) {
   int g;
   bool equal = true;
+
+  if (include_nnc) {
+    ecl_grid_assert_nnc( g1 );
+    ecl_grid_assert_nnc( g2 );
+  }
+
   for (g = 0; g < g1->size; g++) {
     bool this_equal = true;
     ecl_cell_type *c1 = ecl_grid_get_cell( g1 , g );
     ecl_cell_type *c2 = ecl_grid_get_cell( g2 , g );
-    ecl_cell_compare(c1 , c2 ,  include_nnc , &this_equal);
+    ecl_cell_compare(c1 , c2 , &this_equal);
+    if (this_equal && include_nnc)
+      this_equal = ecl_grid_cell_nnc_equal( g1 , g2 , g );
 
     if (!this_equal) {
       if (verbose) {
         int i,j,k;
         ecl_grid_get_ijk1( g1 , g , &i , &j , &k);
 
-        printf("Difference in cell: %d : %d,%d,%d  nnc_equal:%d Volume:%g \n",g,i,j,k , nnc_info_equal( c1->nnc_info , c2->nnc_info) , ecl_cell_get_volume( c1 ));
+        printf("Difference in cell: %d : %d,%d,%d  nnc_equal:%d Volume:%g \n",g,i,j,k , ecl_grid_cell_nnc_equal( g1 , g2 , g ) , ecl_cell_get_volume( c1 ));
         printf("-----------------------------------------------------------------\n");
         ecl_cell_dump_ascii( c1 , i , j , k , stdout , NULL);
         printf("-----------------------------------------------------------------\n");
@@ -4456,7 +5769,17 @@ int ecl_grid_get_block_count3d(const ecl_grid_type * grid , int i , int j, int k
 /*****************************************************************/
 
 void ecl_grid_free(ecl_grid_type * grid) {
+  ecl_grid_drop_cache( grid );
   ecl_grid_free_cells( grid );
+  if (grid->lazy)
+    ecl_grid_lazy_free( grid->lazy , grid->size );
+  ecl_grid_free_nnc( grid );
+  if (grid->snapshot)
+    ecl_grid_snapshot_release( grid );
+  if (grid->snapshot_lgr_list) {
+    vector_free( grid->snapshot_lgr_list );
+    vector_free( grid->snapshot_lgr_host_cells );
+  }
   util_safe_free(grid->index_map);
   util_safe_free(grid->inv_index_map);
 
@@ -4483,6 +5806,8 @@ void ecl_grid_free(ecl_grid_type * grid) {
   util_safe_free( grid->parent_name );
   util_safe_free( grid->visited );
   util_safe_free( grid->name );
+  if (grid->snapshot && (grid->global_grid == NULL))
+    ecl_grid_snapshot_free( grid->snapshot );
   free( grid );
 }
 
@@ -5024,9 +6349,36 @@ double ecl_grid_get_cell_dy1A( const ecl_grid_type * grid , int active_index) {
 }
 
 
+/*
+  The returned nnc_info instance is rebuilt from the CSR arrays on each
+  call and owned by the grid; it is only valid until the next call for
+  the same grid. See the comment about NNC storage.
+*/
+
 const nnc_info_type * ecl_grid_get_cell_nnc_info1( const ecl_grid_type * grid , int global_index) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
-  return cell->nnc_info;
+  ecl_grid_assert_nnc( grid );
+  if (!ecl_grid_has_cell_nnc( grid , global_index ))
+    return NULL;
+
+  {
+    ecl_grid_type * mutable_grid = (ecl_grid_type *) grid;
+    nnc_info_type * nnc_info = nnc_info_alloc( grid->lgr_nr );
+    int csr_nr;
+
+    for (csr_nr = 0; csr_nr < vector_get_size( grid->nnc_csr_list ); csr_nr++) {
+      const ecl_grid_nnc_csr_type * csr = vector_iget_const( grid->nnc_csr_list , csr_nr );
+      int i;
+      if (csr->offset) {
+        for (i = csr->offset[global_index]; i < csr->offset[global_index + 1]; i++)
+          nnc_info_add_nnc( nnc_info , csr->lgr_nr , csr->grid_index[i] , csr->nnc_index[i] );
+      }
+    }
+
+    if (grid->nnc_view)
+      nnc_info_free( grid->nnc_view );
+    mutable_grid->nnc_view = nnc_info;
+    return nnc_info;
+  }
 }
 
 const nnc_info_type * ecl_grid_get_cell_nnc_info3( const ecl_grid_type * grid , int i , int j , int k) {
@@ -5035,6 +6387,32 @@ const nnc_info_type * ecl_grid_get_cell_nnc_info3( const ecl_grid_type * grid ,
 }
 
 
+/*
+  The NNC connections in CSR format, see the comment about NNC
+  storage. There is one set of CSR arrays for each grid with
+  connections from this grid; the return value is the lgr_nr of the
+  grid at the other end. The offset array has global_size + 1
+  elements, the connections from cell g are the elements
+  [offset[g], offset[g+1]) of the grid_index and nnc_index arrays.
+*/
+
+int ecl_grid_get_num_nnc_csr( const ecl_grid_type * grid ) {
+  return vector_get_size( grid->nnc_csr_list );
+}
+
+
+int ecl_grid_iget_nnc_csr( const ecl_grid_type * grid , int index , const int ** offset , const int ** grid_index , const int ** nnc_index) {
+  const ecl_grid_nnc_csr_type * csr;
+
+  ecl_grid_assert_nnc( grid );
+  csr = vector_iget_const( grid->nnc_csr_list , index );
+  *offset     = csr->offset;
+  *grid_index = csr->grid_index;
+  *nnc_index  = csr->nnc_index;
+  return csr->lgr_nr;
+}
+
+
 /*****************************************************************/
 /* Functions to query whether a cell is active or not.           */
 
@@ -5222,8 +6600,12 @@ ecl_grid_type * ecl_grid_get_lgr_from_lgr_nr(const ecl_grid_type * main_grid, in
 
 
 const ecl_grid_type * ecl_grid_get_cell_lgr1(const ecl_grid_type * grid , int global_index ) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
-  return cell->lgr;
+  if (grid->snapshot_lgr_list)
+    return ecl_grid_lookup_cell_lgr( grid->snapshot_lgr_list , grid->snapshot_lgr_host_cells , global_index );
+  else {
+    const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
+    return cell->lgr;
+  }
 }
 
 
@@ -5699,7 +7081,8 @@ void ecl_grid_grdecl_fprintf_kw( const ecl_grid_type * ecl_grid , const ecl_kw_t
       util_abort("%s: invalid type \n",__func__);
 
     {
-      ecl_kw_type * tmp_kw = ecl_kw_alloc_scatter_copy( ecl_kw , ecl_grid->size , ecl_grid->inv_index_map , default_ptr );
+      ecl_kw_type * tmp_kw = ecl_kw_alloc( ecl_kw_get_header( ecl_kw ) , ecl_grid->size , ecl_kw_get_data_type( ecl_kw ));
+      ecl_grid_scatter_kw( ecl_grid , ecl_kw , tmp_kw , default_ptr );
       ecl_kw_fprintf_grdecl__( tmp_kw , special_header , stream );
       ecl_kw_free( tmp_kw );
     }
@@ -6258,8 +7641,10 @@ void ecl_grid_init_coord_data( const ecl_grid_type * grid , float * coord ) {
     chunks of data, where each chunk contains the coordinates (x,y,z)
     of the top and the bottom of the pillar.
   */
-  int i,j;
+  int j;
+  #pragma omp parallel for if ((grid->size > ECL_GRID_PARALLEL_SIZE) && !ecl_grid_is_lazy( grid ))
   for (j=0; j <= grid->ny; j++) {
+    int i;
     for (i=0; i <= grid->nx; i++)
       ecl_grid_init_coord_section( grid , i , j , coord , NULL);
 
@@ -6274,8 +7659,10 @@ void ecl_grid_init_coord_data_double( const ecl_grid_type * grid , double * coor
     chunks of data, where each chunk contains the coordinates (x,y,z)
     f the top and the bottom of the pillar.
   */
-  int i,j;
+  int j;
+  #pragma omp parallel for if ((grid->size > ECL_GRID_PARALLEL_SIZE) && !ecl_grid_is_lazy( grid ))
   for (j=0; j <= grid->ny; j++) {
+    int i;
     for (i=0; i <= grid->nx; i++)
       ecl_grid_init_coord_section( grid , i , j , NULL , coord);
 
@@ -6307,8 +7694,10 @@ static void ecl_grid_init_zcorn_data__( const ecl_grid_type * grid , float * zco
   int nx = grid->nx;
   int ny = grid->ny;
   int nz = grid->nz;
-  int i,j,k;
+  int j;
+  #pragma omp parallel for if ((grid->size > ECL_GRID_PARALLEL_SIZE) && !ecl_grid_is_lazy( grid ))
   for (j=0; j < ny; j++) {
+    int i,k;
     for (i=0; i < nx; i++) {
       for (k=0; k < nz; k++) {
         const int cell_index   = ecl_grid_get_global_index3( grid , i,j,k);
@@ -6447,33 +7836,145 @@ ecl_kw_type * ecl_grid_alloc_actnum_kw( const ecl_grid_type * grid ) {
 }
 
 
-void ecl_grid_compressed_kw_copy( const ecl_grid_type * grid , ecl_kw_type * target_kw , const ecl_kw_type * src_kw) {
-  if ((ecl_kw_get_size( target_kw ) == ecl_grid_get_nactive(grid)) && (ecl_kw_get_size( src_kw ) == ecl_grid_get_global_size(grid))) {
-    int active_index = 0;
-    int global_index;
-    for (global_index = 0; global_index < ecl_grid_get_global_size( grid ); global_index++) {
-      if (ecl_grid_cell_active1(grid, global_index)) {
-        ecl_kw_iset( target_kw , active_index , ecl_kw_iget_ptr(src_kw , global_index));
-        active_index++;
-      }
+/*****************************************************************/
+/* Bulk gather/scatter between active and global layout */
+
+/*
+  The ecl_grid_gather_xxx() functions copy the active elements of a
+  global sized array (nx*ny*nz) to an active sized array (nactive);
+  the ecl_grid_scatter_xxx() functions do the opposite. If the
+  @default_value pointer is non NULL the inactive elements of the
+  global array are set to *default_value, otherwise they are left
+  untouched.
+
+  The kernels are straight indexed loops over index_map /
+  inv_index_map; the compiler will turn them into hardware gather
+  instructions when the target supports it. For large grids the loops
+  are split between OpenMP threads.
+
+  Observe that the bool version works on C bool arrays; the BOOL
+  ecl_kw keywords are stored as int and go through the int version.
+*/
+
+#define ECL_GRID_GATHER_SCATTER( ctype )                                                                    \
+void ecl_grid_gather_ ## ctype( const ecl_grid_type * grid , const ctype * global_data , ctype * active_data) { \
+  const int * inv_index_map = grid->inv_index_map;                                                         \
+  const int nactive = grid->total_active;                                                                  \
+  int active_index;                                                                                        \
+  _Pragma("omp parallel for if (nactive > ECL_GRID_PARALLEL_SIZE)")                                        \
+  for (active_index = 0; active_index < nactive; active_index++)                                           \
+    active_data[active_index] = global_data[ inv_index_map[active_index] ];                                \
+}                                                                                                          \
+                                                                                                           \
+void ecl_grid_scatter_ ## ctype( const ecl_grid_type * grid , const ctype * active_data , ctype * global_data , const ctype * default_value) { \
+  if (default_value) {                                                                                     \
+    const int * index_map = grid->index_map;                                                               \
+    const int size = grid->size;                                                                           \
+    const ctype def = *default_value;                                                                      \
+    int global_index;                                                                                      \
+    _Pragma("omp parallel for if (size > ECL_GRID_PARALLEL_SIZE)")                                         \
+    for (global_index = 0; global_index < size; global_index++) {                                          \
+      const int active_index = index_map[global_index];                                                    \
+      global_data[global_index] = (active_index >= 0) ? active_data[ active_index ] : def;                 \
+    }                                                                                                      \
+  } else {                                                                                                 \
+    const int * inv_index_map = grid->inv_index_map;                                                       \
+    const int nactive = grid->total_active;                                                                \
+    int active_index;                                                                                      \
+    _Pragma("omp parallel for if (nactive > ECL_GRID_PARALLEL_SIZE)")                                      \
+    for (active_index = 0; active_index < nactive; active_index++)                                         \
+      global_data[ inv_index_map[active_index] ] = active_data[active_index];                              \
+  }                                                                                                        \
+}
+
+ECL_GRID_GATHER_SCATTER( int )
+ECL_GRID_GATHER_SCATTER( float )
+ECL_GRID_GATHER_SCATTER( double )
+ECL_GRID_GATHER_SCATTER( bool )
+
+#undef ECL_GRID_GATHER_SCATTER
+
+
+/*
+  Keyword versions of the gather/scatter functions. The keywords must
+  have the same type, @global_kw must have nx*ny*nz elements and
+  @active_kw nactive elements. Keywords of type CHAR/MESS/Cnnn are
+  handled with an element by element copy.
+*/
+
+static void ecl_grid_assert_gather_scatter_kw( const ecl_grid_type * grid , const ecl_kw_type * global_kw , const ecl_kw_type * active_kw , const char * caller) {
+  if ((ecl_kw_get_size( active_kw ) != grid->total_active) || (ecl_kw_get_size( global_kw ) != grid->size))
+    util_abort("%s: size mismatch global:%d  active:%d  expected %d,%d \n", caller , ecl_kw_get_size( global_kw ) , ecl_kw_get_size( active_kw ) , grid->size , grid->total_active);
+
+  if (!ecl_type_is_equal( ecl_kw_get_data_type( global_kw ) , ecl_kw_get_data_type( active_kw )))
+    util_abort("%s: type mismatch between keywords \n", caller);
+}
+
+
+void ecl_grid_gather_kw( const ecl_grid_type * grid , const ecl_kw_type * global_kw , ecl_kw_type * active_kw) {
+  ecl_grid_assert_gather_scatter_kw( grid , global_kw , active_kw , __func__ );
+  switch (ecl_type_get_type( ecl_kw_get_data_type( global_kw ))) {
+  case(ECL_INT_TYPE):
+  case(ECL_BOOL_TYPE):
+    ecl_grid_gather_int( grid , ecl_kw_get_ptr( global_kw ) , ecl_kw_get_ptr( active_kw ));
+    break;
+  case(ECL_FLOAT_TYPE):
+    ecl_grid_gather_float( grid , ecl_kw_get_ptr( global_kw ) , ecl_kw_get_ptr( active_kw ));
+    break;
+  case(ECL_DOUBLE_TYPE):
+    ecl_grid_gather_double( grid , ecl_kw_get_ptr( global_kw ) , ecl_kw_get_ptr( active_kw ));
+    break;
+  default:
+    {
+      int active_index;
+      for (active_index = 0; active_index < grid->total_active; active_index++)
+        ecl_kw_iset( active_kw , active_index , ecl_kw_iget_ptr( global_kw , grid->inv_index_map[active_index] ));
     }
-  } else
-    util_abort("%s: size mismatch target:%d  src:%d  expected %d,%d \n",ecl_kw_get_size( target_kw ), ecl_kw_get_size( src_kw ) , ecl_grid_get_nactive(grid) , ecl_grid_get_global_size(grid));
+  }
 }
 
 
-void ecl_grid_global_kw_copy( const ecl_grid_type * grid , ecl_kw_type * target_kw , const ecl_kw_type * src_kw) {
-  if ((ecl_kw_get_size( src_kw ) == ecl_grid_get_nactive(grid)) && (ecl_kw_get_size( target_kw ) == ecl_grid_get_global_size(grid))) {
-    int active_index = 0;
-    int global_index;
-    for (global_index = 0; global_index < ecl_grid_get_global_size( grid ); global_index++) {
-      if (ecl_grid_cell_active1(grid, global_index)) {
-        ecl_kw_iset( target_kw , global_index , ecl_kw_iget_ptr(src_kw , active_index));
-        active_index++;
+void ecl_grid_scatter_kw( const ecl_grid_type * grid , const ecl_kw_type * active_kw , ecl_kw_type * global_kw , const void * default_value) {
+  ecl_grid_assert_gather_scatter_kw( grid , global_kw , active_kw , __func__ );
+  switch (ecl_type_get_type( ecl_kw_get_data_type( global_kw ))) {
+  case(ECL_INT_TYPE):
+  case(ECL_BOOL_TYPE):
+    ecl_grid_scatter_int( grid , ecl_kw_get_ptr( active_kw ) , ecl_kw_get_ptr( global_kw ) , default_value);
+    break;
+  case(ECL_FLOAT_TYPE):
+    ecl_grid_scatter_float( grid , ecl_kw_get_ptr( active_kw ) , ecl_kw_get_ptr( global_kw ) , default_value);
+    break;
+  case(ECL_DOUBLE_TYPE):
+    ecl_grid_scatter_double( grid , ecl_kw_get_ptr( active_kw ) , ecl_kw_get_ptr( global_kw ) , default_value);
+    break;
+  default:
+    {
+      int global_index;
+      for (global_index = 0; global_index < grid->size; global_index++) {
+        int active_index = grid->index_map[global_index];
+        if (active_index >= 0)
+          ecl_kw_iset( global_kw , global_index , ecl_kw_iget_ptr( active_kw , active_index ));
+        else if (default_value)
+          ecl_kw_iset( global_kw , global_index , default_value );
       }
     }
-  } else
-    util_abort("%s: size mismatch target:%d  src:%d  expected %d,%d \n",ecl_kw_get_size( target_kw ), ecl_kw_get_size( src_kw ) , ecl_grid_get_global_size(grid), ecl_grid_get_nactive(grid));
+  }
+}
+
+
+void ecl_grid_compressed_kw_copy( const ecl_grid_type * grid , ecl_kw_type * target_kw , const ecl_kw_type * src_kw) {
+  if ((ecl_kw_get_size( target_kw ) == ecl_grid_get_nactive(grid)) && (ecl_kw_get_size( src_kw ) == ecl_grid_get_global_size(grid)))
+    ecl_grid_gather_kw( grid , src_kw , target_kw );
+  else
+    util_abort("%s: size mismatch target:%d  src:%d  expected %d,%d \n",__func__ , ecl_kw_get_size( target_kw ), ecl_kw_get_size( src_kw ) , ecl_grid_get_nactive(grid) , ecl_grid_get_global_size(grid));
+}
+
+
+void ecl_grid_global_kw_copy( const ecl_grid_type * grid , ecl_kw_type * target_kw , const ecl_kw_type * src_kw) {
+  if ((ecl_kw_get_size( src_kw ) == ecl_grid_get_nactive(grid)) && (ecl_kw_get_size( target_kw ) == ecl_grid_get_global_size(grid)))
+    ecl_grid_scatter_kw( grid , src_kw , target_kw , NULL );
+  else
+    util_abort("%s: size mismatch target:%d  src:%d  expected %d,%d \n",__func__ , ecl_kw_get_size( target_kw ), ecl_kw_get_size( src_kw ) , ecl_grid_get_global_size(grid), ecl_grid_get_nactive(grid));
 }
 
 
@@ -6545,12 +8046,16 @@ ecl_kw_type * ecl_grid_alloc_gridhead_kw( int nx, int ny , int nz , int grid_nr)
 void ecl_grid_reset_actnum( ecl_grid_type * grid , const int * actnum ) {
   const int global_size = ecl_grid_get_global_size( grid );
   int g;
-  for (g=0; g < global_size; g++) {
-    ecl_cell_type * cell = ecl_grid_get_cell( grid , g );
-    if (actnum)
-      cell->active = actnum[g];
-    else
-      cell->active = 1;
+  if (grid->lazy)
+    ecl_grid_lazy_reset_actnum( grid , actnum );
+  else {
+    for (g=0; g < global_size; g++) {
+      ecl_cell_type * cell = ecl_grid_get_cell( grid , g );
+      if (actnum)
+        cell->active = actnum[g];
+      else
+        cell->active = 1;
+    }
   }
   ecl_grid_update_index( grid );
 }
@@ -6562,16 +8067,17 @@ static void  ecl_grid_fwrite_self_nnc( const ecl_grid_type * grid , fortio_type
   int_vector_type * g2 = int_vector_alloc(0 , default_index );
   int g;
 
-  for (g=0; g < ecl_grid_get_global_size(grid); g++) {
-    ecl_cell_type * cell = ecl_grid_get_cell( grid , g );
-    const nnc_info_type * nnc_info = cell->nnc_info;
-    if (nnc_info) {
-      const nnc_vector_type * nnc_vector = nnc_info_get_self_vector(nnc_info);
-      int i;
-      for (i = 0; i < nnc_vector_get_size( nnc_vector ); i++) {
-        int nnc_index = nnc_vector_iget_nnc_index( nnc_vector , i );
-        int_vector_iset( g1 , nnc_index , 1 + g );
-        int_vector_iset( g2 , nnc_index , 1 + nnc_vector_iget_grid_index( nnc_vector , i ));
+  ecl_grid_assert_nnc( grid );
+  {
+    const ecl_grid_nnc_csr_type * csr = ecl_grid_get_nnc_csr( grid , grid->lgr_nr );
+    if (csr) {
+      for (g=0; g < ecl_grid_get_global_size(grid); g++) {
+        int i;
+        for (i = csr->offset[g]; i < csr->offset[g + 1]; i++) {
+          int nnc_index = csr->nnc_index[i];
+          int_vector_iset( g1 , nnc_index , 1 + g );
+          int_vector_iset( g2 , nnc_index , 1 + csr->grid_index[i] );
+        }
       }
     }
   }
@@ -6855,12 +8361,13 @@ bool ecl_grid_dual_grid( const ecl_grid_type * ecl_grid ) {
 }
 
 static int ecl_grid_get_num_nnc__( const ecl_grid_type * grid ) {
-  int g;
   int num_nnc = 0;
-  for (g = 0; g < grid->size; g++) {
-    const nnc_info_type * nnc_info = ecl_grid_get_cell_nnc_info1( grid , g );
-    if (nnc_info)
-      num_nnc += nnc_info_get_total_size( nnc_info );
+  int i;
+
+  ecl_grid_assert_nnc( grid );
+  for (i = 0; i < vector_get_size( grid->nnc_csr_list ); i++) {
+    const ecl_grid_nnc_csr_type * csr = vector_iget_const( grid->nnc_csr_list , i );
+    num_nnc += csr->num_nnc;
   }
   return num_nnc;
 }
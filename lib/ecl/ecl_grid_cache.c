@@ -18,6 +18,7 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <stdbool.h>
 
@@ -27,6 +28,8 @@
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_file.h>
 #include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
 #include <ert/ecl/ecl_grid_cache.h>
 
 
@@ -37,32 +40,74 @@
    position of all the active cells. This is just a minor
    simplification to speed up repeated calls to get the true world
    coordinates of a cell.
+
+   The cache is reference counted; ecl_grid_get_cache() will return a
+   reference to a cache which is owned by, and shared through, the
+   grid. Every reference, including the one returned from
+   ecl_grid_cache_alloc(), should be released with
+   ecl_grid_cache_free(). The reference counting is not thread safe.
+
+   When the grid drops its cache, because the grid is freed or the
+   active cells change, the cache is detached from the grid with
+   ecl_grid_cache_detach(); outstanding references keep the content
+   from the time of the detach and never touch the grid again.
 */
 
+#define GRID_CACHE_HEAD_KW    "GCHEAD"
+#define GRID_CACHE_INDEX_KW   "GCINDEX"
+#define GRID_CACHE_XPOS_KW    "GCXPOS"
+#define GRID_CACHE_YPOS_KW    "GCYPOS"
+#define GRID_CACHE_ZPOS_KW    "GCZPOS"
+#define GRID_CACHE_VOLUME_KW  "GCVOLUME"
+
+#define GRID_CACHE_HEAD_SIZE  4
+#define GRID_CACHE_HEAD_NX    0
+#define GRID_CACHE_HEAD_NY    1
+#define GRID_CACHE_HEAD_NZ    2
+#define GRID_CACHE_HEAD_SIZE_INDEX 3
+
+
 struct ecl_grid_cache_struct {
   int                   size;         /* The length of the vectors, equal to the number of active elements in the grid. */
+  int                   refcount;
+  int                   nx, ny, nz;
   double              * xpos;
   double              * ypos;
   double              * zpos;
   double              * volume;       /* Will be initialized on demand. */
   int                 * global_index; /* Maps from active index (i.e. natural index in this context) - to the corresponding global index. */
-  const ecl_grid_type * grid;
+  const ecl_grid_type * grid;         /* NULL when the cache has been detached from the grid. */
 };
 
 
 
-
-
-ecl_grid_cache_type * ecl_grid_cache_alloc( const ecl_grid_type * grid ) {
+static ecl_grid_cache_type * ecl_grid_cache_alloc_empty( const ecl_grid_type * grid ) {
   ecl_grid_cache_type * grid_cache = util_malloc( sizeof * grid_cache );
 
   grid_cache->grid          = grid;
+  grid_cache->refcount      = 1;
+  grid_cache->nx            = ecl_grid_get_nx( grid );
+  grid_cache->ny            = ecl_grid_get_ny( grid );
+  grid_cache->nz            = ecl_grid_get_nz( grid );
   grid_cache->volume        = NULL;
   grid_cache->size          = ecl_grid_get_active_size( grid );
   grid_cache->xpos          = util_calloc( grid_cache->size , sizeof * grid_cache->xpos );
   grid_cache->ypos          = util_calloc( grid_cache->size , sizeof * grid_cache->ypos );
   grid_cache->zpos          = util_calloc( grid_cache->size , sizeof * grid_cache->zpos );
   grid_cache->global_index  = util_calloc( grid_cache->size , sizeof * grid_cache->global_index );
+  return grid_cache;
+}
+
+
+/*
+  The cell geometry of a lazy grid is materialized on demand in
+  shared storage, so the cells of a lazy grid must be visited
+  serially; for all other grids each iteration only touches its own
+  cell and the loops are run in parallel.
+*/
+
+ecl_grid_cache_type * ecl_grid_cache_alloc( const ecl_grid_type * grid ) {
+  ecl_grid_cache_type * grid_cache = ecl_grid_cache_alloc_empty( grid );
   {
     int active_index;
 
@@ -70,6 +115,7 @@ ecl_grid_cache_type * ecl_grid_cache_alloc( const ecl_grid_type * grid ) {
     /* Go trough all the active cells and extract the cell center
        position and store it in xpos/ypos/zpos. */
 
+#pragma omp parallel for if (!ecl_grid_is_lazy( grid ))
     for (active_index = 0; active_index < grid_cache->size; active_index++) {
       int global_index = ecl_grid_get_global_index1A( grid , active_index );
       grid_cache->global_index[ active_index ] = global_index;
@@ -83,6 +129,15 @@ ecl_grid_cache_type * ecl_grid_cache_alloc( const ecl_grid_type * grid ) {
   return grid_cache;
 }
 
+
+void ecl_grid_cache_incref( ecl_grid_cache_type * grid_cache ) {
+  grid_cache->refcount++;
+}
+
+int ecl_grid_cache_get_refcount( const ecl_grid_cache_type * grid_cache ) {
+  return grid_cache->refcount;
+}
+
 int ecl_grid_cache_get_size( const ecl_grid_cache_type * grid_cache ) {
   return grid_cache->size;
 }
@@ -113,16 +168,172 @@ const double * ecl_grid_cache_get_volume( const ecl_grid_cache_type * grid_cache
   if (!grid_cache->volume) {
     // C++ style const cast.
     ecl_grid_cache_type * gc = (ecl_grid_cache_type *) grid_cache;
-    gc->volume = util_calloc( gc->size , sizeof * gc->volume );
-    for (int active_index = 0; active_index < grid_cache->size; active_index++)
-      gc->volume[active_index] = ecl_grid_get_cell_volume1A( gc->grid , active_index );
+    int active_index;
+    double * volume = util_calloc( gc->size , sizeof * volume );
+
+#pragma omp parallel for if (!ecl_grid_is_lazy( gc->grid ))
+    for (active_index = 0; active_index < gc->size; active_index++)
+      volume[active_index] = ecl_grid_get_cell_volume1( gc->grid , gc->global_index[active_index] );
+
+    gc->volume = volume;
   }
 
   return grid_cache->volume;
 }
 
 
+/*****************************************************************/
+/*
+  The cache can be stored in a small binary file next to the grid
+  file, the keywords are written with the ordinary ecl_kw machinery.
+  When loading, the dimensions and the active cells stored in the
+  file must agree with the grid; otherwise the file is ignored and
+  NULL is returned.
+*/
+
+char * ecl_grid_cache_alloc_filename( const char * grid_file ) {
+  char * path;
+  char * basename;
+  char * filename;
+
+  util_alloc_file_components( grid_file , &path , &basename , NULL );
+  filename = util_alloc_filename( path , basename , "GCACHE" );
+  free( path );
+  free( basename );
+  return filename;
+}
+
+
+void ecl_grid_cache_fwrite( const ecl_grid_cache_type * grid_cache , const char * filename ) {
+  const double * volume = ecl_grid_cache_get_volume( grid_cache );
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  if (!fortio)
+    util_abort("%s: failed to open:%s for writing \n",__func__ , filename);
+  {
+    int head[GRID_CACHE_HEAD_SIZE];
+    ecl_kw_type * head_kw;
+    ecl_kw_type * index_kw;
+    ecl_kw_type * xpos_kw;
+    ecl_kw_type * ypos_kw;
+    ecl_kw_type * zpos_kw;
+    ecl_kw_type * volume_kw;
+
+    head[GRID_CACHE_HEAD_NX] = grid_cache->nx;
+    head[GRID_CACHE_HEAD_NY] = grid_cache->ny;
+    head[GRID_CACHE_HEAD_NZ] = grid_cache->nz;
+    head[GRID_CACHE_HEAD_SIZE_INDEX] = grid_cache->size;
+
+    head_kw   = ecl_kw_alloc_new_shared( GRID_CACHE_HEAD_KW , GRID_CACHE_HEAD_SIZE , ECL_INT , head );
+    index_kw  = ecl_kw_alloc_new_shared( GRID_CACHE_INDEX_KW , grid_cache->size , ECL_INT , grid_cache->global_index );
+    xpos_kw   = ecl_kw_alloc_new_shared( GRID_CACHE_XPOS_KW , grid_cache->size , ECL_DOUBLE , grid_cache->xpos );
+    ypos_kw   = ecl_kw_alloc_new_shared( GRID_CACHE_YPOS_KW , grid_cache->size , ECL_DOUBLE , grid_cache->ypos );
+    zpos_kw   = ecl_kw_alloc_new_shared( GRID_CACHE_ZPOS_KW , grid_cache->size , ECL_DOUBLE , grid_cache->zpos );
+    volume_kw = ecl_kw_alloc_new_shared( GRID_CACHE_VOLUME_KW , grid_cache->size , ECL_DOUBLE , (double *) volume );
+
+    ecl_kw_fwrite( head_kw , fortio );
+    ecl_kw_fwrite( index_kw , fortio );
+    ecl_kw_fwrite( xpos_kw , fortio );
+    ecl_kw_fwrite( ypos_kw , fortio );
+    ecl_kw_fwrite( zpos_kw , fortio );
+    ecl_kw_fwrite( volume_kw , fortio );
+
+    ecl_kw_free( head_kw );
+    ecl_kw_free( index_kw );
+    ecl_kw_free( xpos_kw );
+    ecl_kw_free( ypos_kw );
+    ecl_kw_free( zpos_kw );
+    ecl_kw_free( volume_kw );
+  }
+  fortio_fclose( fortio );
+}
+
+
+static bool ecl_grid_cache_fread_data( fortio_type * fortio , const char * kw , int size , ecl_data_type data_type , void * data) {
+  ecl_kw_type * ecl_kw = ecl_kw_fread_alloc( fortio );
+  bool valid = false;
+
+  if (ecl_kw) {
+    if (ecl_kw_name_equal( ecl_kw , kw ) &&
+        (ecl_kw_get_size( ecl_kw ) == size) &&
+        ecl_type_is_equal( ecl_kw_get_data_type( ecl_kw ) , data_type )) {
+      memcpy( data , ecl_kw_get_ptr( ecl_kw ) , size * ecl_type_get_sizeof_ctype( data_type ));
+      valid = true;
+    }
+    ecl_kw_free( ecl_kw );
+  }
+  return valid;
+}
+
+
+ecl_grid_cache_type * ecl_grid_cache_fread_alloc( const ecl_grid_type * grid , const char * filename ) {
+  ecl_grid_cache_type * grid_cache = NULL;
+  fortio_type * fortio;
+
+  if (!util_file_exists( filename ))
+    return NULL;
+
+  fortio = fortio_open_reader( filename , false , ECL_ENDIAN_FLIP );
+  if (fortio) {
+    int head[GRID_CACHE_HEAD_SIZE];
+    bool valid = false;
+
+    if (ecl_grid_cache_fread_data( fortio , GRID_CACHE_HEAD_KW , GRID_CACHE_HEAD_SIZE , ECL_INT , head ))
+      valid = (head[GRID_CACHE_HEAD_NX] == ecl_grid_get_nx( grid )) &&
+              (head[GRID_CACHE_HEAD_NY] == ecl_grid_get_ny( grid )) &&
+              (head[GRID_CACHE_HEAD_NZ] == ecl_grid_get_nz( grid )) &&
+              (head[GRID_CACHE_HEAD_SIZE_INDEX] == ecl_grid_get_active_size( grid ));
+
+    if (valid) {
+      grid_cache = ecl_grid_cache_alloc_empty( grid );
+      grid_cache->volume = util_calloc( grid_cache->size , sizeof * grid_cache->volume );
+
+      valid = ecl_grid_cache_fread_data( fortio , GRID_CACHE_INDEX_KW , grid_cache->size , ECL_INT , grid_cache->global_index ) &&
+              ecl_grid_cache_fread_data( fortio , GRID_CACHE_XPOS_KW , grid_cache->size , ECL_DOUBLE , grid_cache->xpos ) &&
+              ecl_grid_cache_fread_data( fortio , GRID_CACHE_YPOS_KW , grid_cache->size , ECL_DOUBLE , grid_cache->ypos ) &&
+              ecl_grid_cache_fread_data( fortio , GRID_CACHE_ZPOS_KW , grid_cache->size , ECL_DOUBLE , grid_cache->zpos ) &&
+              ecl_grid_cache_fread_data( fortio , GRID_CACHE_VOLUME_KW , grid_cache->size , ECL_DOUBLE , grid_cache->volume );
+
+      if (valid) {
+        int active_index;
+        for (active_index = 0; active_index < grid_cache->size; active_index++) {
+          if (grid_cache->global_index[active_index] != ecl_grid_get_global_index1A( grid , active_index )) {
+            valid = false;
+            break;
+          }
+        }
+      }
+
+      if (!valid) {
+        ecl_grid_cache_free( grid_cache );
+        grid_cache = NULL;
+      }
+    }
+    fortio_fclose( fortio );
+  }
+  return grid_cache;
+}
+
+
+
+/*
+  Releases the reference held by the grid. If there are other
+  references the volumes are calculated first, so the cache does not
+  need the grid afterwards.
+*/
+
+void ecl_grid_cache_detach( ecl_grid_cache_type * grid_cache ) {
+  if (grid_cache->refcount > 1)
+    ecl_grid_cache_get_volume( grid_cache );
+  grid_cache->grid = NULL;
+  ecl_grid_cache_free( grid_cache );
+}
+
+
 void ecl_grid_cache_free( ecl_grid_cache_type * grid_cache ) {
+  grid_cache->refcount--;
+  if (grid_cache->refcount > 0)
+    return;
+
   free( grid_cache->xpos );
   free( grid_cache->ypos );
   free( grid_cache->zpos );
@@ -2018,6 +2018,20 @@ void ecl_kw_alloc_float_data(ecl_kw_type * ecl_kw , float * values) {
 /*****************************************************************/
 /* Macros for typed mathematical functions.                      */
 
+/*
+  The elementwise functions are plain counted loops over the raw
+  storage which the compiler can vectorize; for keywords with more
+  than ECL_KW_PARALLEL_SIZE elements the loops are in addition split
+  over OpenMP threads. The reductions (sum, max/min) are evaluated in
+  blocks of ECL_KW_REDUCE_BLOCK elements which are combined in a fixed
+  order afterwards, i.e. the result does not depend on the number of
+  threads.
+*/
+
+#define ECL_KW_PARALLEL_SIZE 100000
+#define ECL_KW_REDUCE_BLOCK  16384
+#define ECL_KW_SUM_LANES     8
+
 #define ECL_KW_SCALE_TYPED( ctype , ECL_TYPE )                                                        \
 void ecl_kw_scale_ ## ctype (ecl_kw_type * ecl_kw , ctype scale_factor) {                             \
   if (ecl_kw_get_type(ecl_kw) != ECL_TYPE)                                                            \
@@ -2026,6 +2040,7 @@ void ecl_kw_scale_ ## ctype (ecl_kw_type * ecl_kw , ctype scale_factor) {
      ctype * data = ecl_kw_get_data_ref(ecl_kw);                                                      \
      int    size  = ecl_kw_get_size(ecl_kw);                                                          \
      int i;                                                                                           \
+     _Pragma("omp parallel for if (size > ECL_KW_PARALLEL_SIZE)")                                     \
      for (i=0; i < size; i++)                                                                         \
         data[i] *= scale_factor;                                                                      \
   }                                                                                                   \
@@ -2055,6 +2070,7 @@ void ecl_kw_shift_ ## ctype (ecl_kw_type * ecl_kw , ctype shift_value) {
      ctype * data = ecl_kw_get_data_ref(ecl_kw);                                                      \
      int    size  = ecl_kw_get_size(ecl_kw);                                                          \
      int i;                                                                                           \
+     _Pragma("omp parallel for if (size > ECL_KW_PARALLEL_SIZE)")                                     \
      for (i=0; i < size; i++)                                                                         \
         data[i] += shift_value;                                                                       \
   }                                                                                                   \
@@ -2137,7 +2153,7 @@ static void ecl_kw_inplace_add_indexed_ ## ctype( ecl_kw_type * target_kw , cons
 ECL_KW_TYPED_INPLACE_ADD_INDEXED( int )
 ECL_KW_TYPED_INPLACE_ADD_INDEXED( double )
 ECL_KW_TYPED_INPLACE_ADD_INDEXED( float )
-#undef ECL_KW_TYPED_INPLACE_ADD
+#undef ECL_KW_TYPED_INPLACE_ADD_INDEXED
 
 void ecl_kw_inplace_add_indexed( ecl_kw_type * target_kw , const int_vector_type * index_set , const ecl_kw_type * add_kw) {
   ecl_type_enum type = ecl_kw_get_type(target_kw);
@@ -2166,8 +2182,10 @@ static void ecl_kw_inplace_add_ ## ctype( ecl_kw_type * target_kw , const ecl_kw
  {                                                                                         \
     ctype * target_data = ecl_kw_get_data_ref( target_kw );                                \
     const ctype * add_data = ecl_kw_get_data_ref( add_kw );                                \
+    const int size = target_kw->size;                                                      \
     int i;                                                                                 \
-    for (i=0; i < target_kw->size; i++)                                                    \
+    _Pragma("omp parallel for if (size > ECL_KW_PARALLEL_SIZE)")                           \
+    for (i=0; i < size; i++)                                                               \
       target_data[i] += add_data[i];                                                       \
  }                                                                                         \
 }
@@ -2206,8 +2224,10 @@ void ecl_kw_inplace_sub_ ## ctype( ecl_kw_type * target_kw , const ecl_kw_type *
  {                                                                                         \
     ctype * target_data = ecl_kw_get_data_ref( target_kw );                                \
     const ctype * sub_data = ecl_kw_get_data_ref( sub_kw );                                \
+    const int size = target_kw->size;                                                      \
     int i;                                                                                 \
-    for (i=0; i < target_kw->size; i++)                                                    \
+    _Pragma("omp parallel for if (size > ECL_KW_PARALLEL_SIZE)")                           \
+    for (i=0; i < size; i++)                                                               \
       target_data[i] -= sub_data[i];                                                       \
  }                                                                                         \
 }
@@ -2254,7 +2274,7 @@ static void ecl_kw_inplace_sub_indexed_ ## ctype( ecl_kw_type * target_kw , cons
 ECL_KW_TYPED_INPLACE_SUB_INDEXED( int )
 ECL_KW_TYPED_INPLACE_SUB_INDEXED( double )
 ECL_KW_TYPED_INPLACE_SUB_INDEXED( float )
-#undef ECL_KW_TYPED_INPLACE_SUB
+#undef ECL_KW_TYPED_INPLACE_SUB_INDEXED
 
 void ecl_kw_inplace_sub_indexed( ecl_kw_type * target_kw , const int_vector_type * index_set , const ecl_kw_type * sub_kw) {
   ecl_type_enum type = ecl_kw_get_type(target_kw);
@@ -2276,12 +2296,14 @@ void ecl_kw_inplace_sub_indexed( ecl_kw_type * target_kw , const int_vector_type
 
 /*****************************************************************/
 
-#define ECL_KW_TYPED_INPLACE_ABS( ctype , abs_func)     \
-void ecl_kw_inplace_abs_ ## ctype( ecl_kw_type * kw ) { \
-  ctype * data = ecl_kw_get_data_ref( kw );             \
-  int i;                                                \
-  for (i=0; i < kw->size; i++)                          \
-    data[i] = abs_func(data[i]);                        \
+#define ECL_KW_TYPED_INPLACE_ABS( ctype , abs_func)                 \
+void ecl_kw_inplace_abs_ ## ctype( ecl_kw_type * kw ) {             \
+  ctype * data = ecl_kw_get_data_ref( kw );                         \
+  const int size = kw->size;                                        \
+  int i;                                                            \
+  _Pragma("omp parallel for if (size > ECL_KW_PARALLEL_SIZE)")      \
+  for (i=0; i < size; i++)                                          \
+    data[i] = abs_func(data[i]);                                    \
 }
 
 ECL_KW_TYPED_INPLACE_ABS( int , abs )
@@ -2318,8 +2340,10 @@ void ecl_kw_inplace_mul_ ## ctype( ecl_kw_type * target_kw , const ecl_kw_type *
  {                                                                                         \
     ctype * target_data = ecl_kw_get_data_ref( target_kw );                                \
     const ctype * mul_data = ecl_kw_get_data_ref( mul_kw );                                \
+    const int size = target_kw->size;                                                      \
     int i;                                                                                 \
-    for (i=0; i < target_kw->size; i++)                                                    \
+    _Pragma("omp parallel for if (size > ECL_KW_PARALLEL_SIZE)")                           \
+    for (i=0; i < size; i++)                                                               \
       target_data[i] *= mul_data[i];                                                       \
  }                                                                                         \
 }
@@ -2366,7 +2390,7 @@ static void ecl_kw_inplace_mul_indexed_ ## ctype( ecl_kw_type * target_kw , cons
 ECL_KW_TYPED_INPLACE_MUL_INDEXED( int )
 ECL_KW_TYPED_INPLACE_MUL_INDEXED( double )
 ECL_KW_TYPED_INPLACE_MUL_INDEXED( float )
-#undef ECL_KW_TYPED_INPLACE_MUL
+#undef ECL_KW_TYPED_INPLACE_MUL_INDEXED
 
 void ecl_kw_inplace_mul_indexed( ecl_kw_type * target_kw , const int_vector_type * index_set , const ecl_kw_type * mul_kw) {
   ecl_type_enum type = ecl_kw_get_type(target_kw);
@@ -2396,8 +2420,10 @@ void ecl_kw_inplace_div_ ## ctype( ecl_kw_type * target_kw , const ecl_kw_type *
  {                                                                                         \
     ctype * target_data = ecl_kw_get_data_ref( target_kw );                                \
     const ctype * div_data = ecl_kw_get_data_ref( div_kw );                                \
+    const int size = target_kw->size;                                                      \
     int i;                                                                                 \
-    for (i=0; i < target_kw->size; i++)                                                    \
+    _Pragma("omp parallel for if (size > ECL_KW_PARALLEL_SIZE)")                           \
+    for (i=0; i < size; i++)                                                               \
       target_data[i] /= div_data[i];                                                       \
  }                                                                                         \
 }
@@ -2436,7 +2462,7 @@ static void ecl_kw_inplace_div_indexed_ ## ctype( ecl_kw_type * target_kw , cons
     int i;                                                                                 \
     for (i=0; i < set_size; i++) {                                                         \
       int index = index_data[i];                                                           \
-      target_data[index] *= div_data[index];                                               \
+      target_data[index] /= div_data[index];                                               \
     }                                                                                      \
   }                                                                                        \
 }
@@ -2448,7 +2474,7 @@ static void ecl_kw_inplace_div_indexed_ ## ctype( ecl_kw_type * target_kw , cons
 ECL_KW_TYPED_INPLACE_DIV_INDEXED( int )
 ECL_KW_TYPED_INPLACE_DIV_INDEXED( double )
 ECL_KW_TYPED_INPLACE_DIV_INDEXED( float )
-#undef ECL_KW_TYPED_INPLACE_DIV
+#undef ECL_KW_TYPED_INPLACE_DIV_INDEXED
 
 void ecl_kw_inplace_div_indexed( ecl_kw_type * target_kw , const int_vector_type * index_set , const ecl_kw_type * div_kw) {
   ecl_type_enum type = ecl_kw_get_type(target_kw);
@@ -2559,16 +2585,64 @@ bool ecl_kw_is_kw_file(fortio_type * fortio) {
 }
 
 
-#define KW_MAX_MIN(type)                                       \
-{                                                              \
-  type * data = ecl_kw_get_data_ref(ecl_kw);                   \
-  type max = data[0];                                          \
-  type min = data[0];                                          \
-  int i;                                                       \
-  for (i=1; i < ecl_kw_get_size(ecl_kw); i++)                  \
-      util_update_ ## type ## _max_min(data[i] , &max , &min); \
-  memcpy(_max , &max , ecl_kw_get_sizeof_ctype(ecl_kw));       \
-  memcpy(_min , &min , ecl_kw_get_sizeof_ctype(ecl_kw));       \
+static int ecl_kw_num_reduce_blocks( int size ) {
+  return (size + ECL_KW_REDUCE_BLOCK - 1) / ECL_KW_REDUCE_BLOCK;
+}
+
+
+/*
+  The max/min of every block is seeded with data[0], that way the
+  handling of NaN values is the same as for a plain serial loop:
+  NaN values are ignored unless data[0] itself is NaN.
+*/
+
+#define ECL_KW_MAX_MIN_DATA( ctype )                                                              \
+static void ecl_kw_max_min_data_ ## ctype( const ctype * data , int size , ctype * _max , ctype * _min) { \
+  const int num_blocks = ecl_kw_num_reduce_blocks( size );                                        \
+  ctype * block_max = util_malloc( num_blocks * sizeof * block_max );                             \
+  ctype * block_min = util_malloc( num_blocks * sizeof * block_min );                             \
+  ctype max = data[0];                                                                            \
+  ctype min = data[0];                                                                            \
+  int block;                                                                                      \
+                                                                                                  \
+  _Pragma("omp parallel for if (size > ECL_KW_PARALLEL_SIZE)")                                    \
+  for (block = 0; block < num_blocks; block++) {                                                  \
+    const int offset = block * ECL_KW_REDUCE_BLOCK;                                               \
+    const int limit  = util_int_min( size , offset + ECL_KW_REDUCE_BLOCK );                       \
+    ctype local_max = data[0];                                                                    \
+    ctype local_min = data[0];                                                                    \
+    int i;                                                                                        \
+    for (i = offset; i < limit; i++) {                                                            \
+      local_max = (data[i] > local_max) ? data[i] : local_max;                                    \
+      local_min = (data[i] < local_min) ? data[i] : local_min;                                    \
+    }                                                                                             \
+    block_max[block] = local_max;                                                                 \
+    block_min[block] = local_min;                                                                 \
+  }                                                                                               \
+                                                                                                  \
+  for (block = 0; block < num_blocks; block++) {                                                  \
+    max = (block_max[block] > max) ? block_max[block] : max;                                      \
+    min = (block_min[block] < min) ? block_min[block] : min;                                      \
+  }                                                                                               \
+                                                                                                  \
+  free( block_max );                                                                              \
+  free( block_min );                                                                              \
+  *_max = max;                                                                                    \
+  *_min = min;                                                                                    \
+}
+
+ECL_KW_MAX_MIN_DATA( int )
+ECL_KW_MAX_MIN_DATA( float )
+ECL_KW_MAX_MIN_DATA( double )
+#undef ECL_KW_MAX_MIN_DATA
+
+
+#define KW_MAX_MIN(type)                                                              \
+{                                                                                     \
+  type max , min;                                                                     \
+  ecl_kw_max_min_data_ ## type( ecl_kw_get_data_ref(ecl_kw) , ecl_kw_get_size(ecl_kw) , &max , &min); \
+  memcpy(_max , &max , ecl_kw_get_sizeof_ctype(ecl_kw));                              \
+  memcpy(_min , &min , ecl_kw_get_sizeof_ctype(ecl_kw));                              \
 }
 
 
@@ -2627,15 +2701,80 @@ ECL_KW_MIN( double )
 #undef ECL_KW_MAX_MIN
 
 
-#define KW_SUM_INDEXED(type)                                       \
-{                                                                  \
-  const type * data = ecl_kw_get_data_ref(ecl_kw);                 \
-  type sum = 0;                                                    \
-  int size = int_vector_size( index_list );                        \
-  const int * index_ptr = int_vector_get_const_ptr( index_list );  \
-  for (int i = 0; i < size; i++)                                   \
-     sum += data[index_ptr[i]];                                    \
-  memcpy(_sum , &sum , ecl_kw_get_sizeof_ctype(ecl_kw));           \
+/*
+  Summation of one block. The elements are accumulated in
+  ECL_KW_SUM_LANES independent partial sums; that is a loop the
+  compiler can vectorize without reassociating floating point
+  additions, and as a bonus the partial sums reduce the rounding
+  error compared to one running sum. If @index is != NULL the
+  elements data[index[i]] are summed.
+*/
+
+#define ECL_KW_BLOCK_SUM( ctype )                                                                 \
+static ctype ecl_kw_block_sum_ ## ctype( const ctype * data , const int * index , int size) {     \
+  ctype lane[ECL_KW_SUM_LANES] = { 0 };                                                           \
+  ctype sum = 0;                                                                                  \
+  int i = 0;                                                                                      \
+  int l;                                                                                          \
+                                                                                                  \
+  if (index) {                                                                                    \
+    for (; i + ECL_KW_SUM_LANES <= size; i += ECL_KW_SUM_LANES)                                   \
+      for (l = 0; l < ECL_KW_SUM_LANES; l++)                                                      \
+        lane[l] += data[index[i + l]];                                                            \
+    for (; i < size; i++)                                                                         \
+      sum += data[index[i]];                                                                      \
+  } else {                                                                                        \
+    for (; i + ECL_KW_SUM_LANES <= size; i += ECL_KW_SUM_LANES)                                   \
+      for (l = 0; l < ECL_KW_SUM_LANES; l++)                                                      \
+        lane[l] += data[i + l];                                                                   \
+    for (; i < size; i++)                                                                         \
+      sum += data[i];                                                                             \
+  }                                                                                               \
+                                                                                                  \
+  for (l = 0; l < ECL_KW_SUM_LANES; l++)                                                          \
+    sum += lane[l];                                                                               \
+  return sum;                                                                                     \
+}                                                                                                 \
+                                                                                                  \
+static ctype ecl_kw_sum_data_ ## ctype( const ctype * data , const int * index , int size) {      \
+  if (size <= ECL_KW_REDUCE_BLOCK)                                                                \
+    return ecl_kw_block_sum_ ## ctype( data , index , size );                                     \
+  else {                                                                                          \
+    const int num_blocks = ecl_kw_num_reduce_blocks( size );                                      \
+    ctype * block_sum = util_malloc( num_blocks * sizeof * block_sum );                           \
+    ctype sum = 0;                                                                                \
+    int block;                                                                                    \
+                                                                                                  \
+    _Pragma("omp parallel for if (size > ECL_KW_PARALLEL_SIZE)")                                  \
+    for (block = 0; block < num_blocks; block++) {                                                \
+      const int offset = block * ECL_KW_REDUCE_BLOCK;                                             \
+      const int block_size = util_int_min( ECL_KW_REDUCE_BLOCK , size - offset );                 \
+      if (index)                                                                                  \
+        block_sum[block] = ecl_kw_block_sum_ ## ctype( data , &index[offset] , block_size );      \
+      else                                                                                        \
+        block_sum[block] = ecl_kw_block_sum_ ## ctype( &data[offset] , NULL , block_size );       \
+    }                                                                                             \
+                                                                                                  \
+    for (block = 0; block < num_blocks; block++)                                                  \
+      sum += block_sum[block];                                                                    \
+                                                                                                  \
+    free( block_sum );                                                                            \
+    return sum;                                                                                   \
+  }                                                                                               \
+}
+
+ECL_KW_BLOCK_SUM( int )
+ECL_KW_BLOCK_SUM( float )
+ECL_KW_BLOCK_SUM( double )
+#undef ECL_KW_BLOCK_SUM
+
+
+#define KW_SUM_INDEXED(type)                                                                        \
+{                                                                                                   \
+  type sum = ecl_kw_sum_data_ ## type( ecl_kw_get_data_ref(ecl_kw) ,                                \
+                                       int_vector_get_const_ptr( index_list ) ,                     \
+                                       int_vector_size( index_list ));                              \
+  memcpy(_sum , &sum , ecl_kw_get_sizeof_ctype(ecl_kw));                                            \
 }
 
 
@@ -2666,22 +2805,14 @@ void ecl_kw_element_sum_indexed(const ecl_kw_type * ecl_kw , const int_vector_ty
     util_abort("%s: invalid type for element sum \n",__func__);
   }
 }
-#undef KW_SUM
-
-
-
-
+#undef KW_SUM_INDEXED
 
 
 
-
-#define KW_SUM(type)                                        \
-{                                                           \
-  const type * data = ecl_kw_get_data_ref(ecl_kw);          \
-  type sum = 0;                                             \
-  for (int i=0; i < ecl_kw_get_size(ecl_kw); i++)           \
-     sum += data[i];                                        \
-  memcpy(_sum , &sum , ecl_kw_get_sizeof_ctype(ecl_kw));    \
+#define KW_SUM(type)                                                                               \
+{                                                                                                  \
+  type sum = ecl_kw_sum_data_ ## type( ecl_kw_get_data_ref(ecl_kw) , NULL , ecl_kw_get_size(ecl_kw)); \
+  memcpy(_sum , &sum , ecl_kw_get_sizeof_ctype(ecl_kw));                                           \
 }
 
 
@@ -2704,6 +2835,80 @@ void ecl_kw_element_sum(const ecl_kw_type * ecl_kw , void * _sum) {
 #undef KW_SUM
 
 
+/*
+  Compensated (Kahan) summation in double precision. This is slower
+  than ecl_kw_element_sum(), but for large float keywords - where the
+  plain sum is accumulated in float - the result is essentially exact.
+  Each block is summed with its own compensation term, and the block
+  sums are then combined with a final compensated sum.
+*/
+
+#define ECL_KW_KAHAN_SUM( ctype )                                                                 \
+static double ecl_kw_kahan_sum_data_ ## ctype( const ctype * data , const int * index , int size) { \
+  const int num_blocks = ecl_kw_num_reduce_blocks( size );                                        \
+  double * block_sum = util_malloc( (num_blocks + 1) * sizeof * block_sum );                      \
+  double sum = 0;                                                                                 \
+  double comp = 0;                                                                                \
+  int block;                                                                                      \
+                                                                                                  \
+  _Pragma("omp parallel for if (size > ECL_KW_PARALLEL_SIZE)")                                    \
+  for (block = 0; block < num_blocks; block++) {                                                  \
+    const int offset = block * ECL_KW_REDUCE_BLOCK;                                               \
+    const int limit  = util_int_min( size , offset + ECL_KW_REDUCE_BLOCK );                       \
+    double local_sum = 0;                                                                         \
+    double local_comp = 0;                                                                        \
+    int i;                                                                                        \
+    for (i = offset; i < limit; i++) {                                                            \
+      double y = (index ? data[index[i]] : data[i]) - local_comp;                                 \
+      double t = local_sum + y;                                                                   \
+      local_comp = (t - local_sum) - y;                                                           \
+      local_sum = t;                                                                              \
+    }                                                                                             \
+    block_sum[block] = local_sum;                                                                 \
+  }                                                                                               \
+                                                                                                  \
+  for (block = 0; block < num_blocks; block++) {                                                  \
+    double y = block_sum[block] - comp;                                                           \
+    double t = sum + y;                                                                           \
+    comp = (t - sum) - y;                                                                         \
+    sum = t;                                                                                      \
+  }                                                                                               \
+                                                                                                  \
+  free( block_sum );                                                                              \
+  return sum;                                                                                     \
+}
+
+ECL_KW_KAHAN_SUM( int )
+ECL_KW_KAHAN_SUM( float )
+ECL_KW_KAHAN_SUM( double )
+#undef ECL_KW_KAHAN_SUM
+
+
+static double ecl_kw_element_sum_kahan__( const ecl_kw_type * ecl_kw , const int * index , int size) {
+  switch (ecl_kw_get_type(ecl_kw)) {
+  case(ECL_FLOAT_TYPE):
+    return ecl_kw_kahan_sum_data_float( ecl_kw_get_data_ref( ecl_kw ) , index , size );
+  case(ECL_DOUBLE_TYPE):
+    return ecl_kw_kahan_sum_data_double( ecl_kw_get_data_ref( ecl_kw ) , index , size );
+  case(ECL_INT_TYPE):
+    return ecl_kw_kahan_sum_data_int( ecl_kw_get_data_ref( ecl_kw ) , index , size );
+  default:
+    util_abort("%s: invalid type for element sum \n",__func__);
+    return 0;
+  }
+}
+
+
+double ecl_kw_element_sum_kahan( const ecl_kw_type * ecl_kw ) {
+  return ecl_kw_element_sum_kahan__( ecl_kw , NULL , ecl_kw_get_size( ecl_kw ));
+}
+
+
+double ecl_kw_element_sum_indexed_kahan( const ecl_kw_type * ecl_kw , const int_vector_type * index_list) {
+  return ecl_kw_element_sum_kahan__( ecl_kw , int_vector_get_const_ptr( index_list ) , int_vector_size( index_list ));
+}
+
+
 double ecl_kw_element_sum_float( const ecl_kw_type * ecl_kw ) {
   float float_sum;
   double double_sum;
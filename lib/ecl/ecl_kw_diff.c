@@ -0,0 +1,488 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_kw_diff.c' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/vector.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_type.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_kw_diff.h>
+
+/*
+  The ecl_kw_diff structure holds the result of comparing two
+  keywords element by element. In addition to the yes/no answer of
+  ecl_kw_numeric_equal() it records the number of differing
+  elements, the first differing index and the largest absolute and
+  relative difference. The tolerances have the same meaning as in
+  util_double_approx_equal__(): two values differ if the absolute
+  difference is larger than @abs_epsilon, or if the relative
+  difference
+
+      |v1 - v2| / (|v1| + |v2|)
+
+  is larger than @rel_epsilon; a tolerance <= 0 is not checked. If
+  both tolerances are <= 0 the values must be exactly equal. Two NaN
+  values are considered equal, a NaN and a number are different.
+  Integer keywords are compared in the same way as the floating point
+  keywords, whereas character and bool keywords are compared exactly.
+
+  The ecl_file_diff structure compares all keywords in two ecl_file
+  instances; the keywords are matched on header and occurence
+  number. The keywords are read directly from the files, compared
+  and discarded again, the keyword pairs are handled in parallel and
+  each thread holds at most one pair in memory - i.e. the memory
+  usage is bounded by the largest keywords and not by the file size.
+*/
+
+#define ECL_KW_DIFF_TYPE_ID    77650913
+#define ECL_FILE_DIFF_TYPE_ID  77650914
+
+#define ECL_KW_DIFF_PARALLEL_SIZE 100000
+#define ECL_KW_DIFF_BLOCK         16384
+
+struct ecl_kw_diff_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  char                    * header;
+  int                       occurence;
+  ecl_kw_diff_status_enum   status;
+  int                       size;
+  int                       count;
+  int                       first_index;
+  double                    max_abs_diff;
+  double                    max_rel_diff;
+};
+
+
+struct ecl_file_diff_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  vector_type * diff_list;
+  int           num_different;
+};
+
+
+typedef struct {
+  int    count;
+  int    first_index;
+  double max_abs_diff;
+  double max_rel_diff;
+} ecl_kw_diff_block_type;
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_kw_diff , ECL_KW_DIFF_TYPE_ID )
+UTIL_SAFE_CAST_FUNCTION( ecl_kw_diff , ECL_KW_DIFF_TYPE_ID )
+UTIL_IS_INSTANCE_FUNCTION( ecl_file_diff , ECL_FILE_DIFF_TYPE_ID )
+
+
+/*
+  The numeric kernel is written without early exit and with the
+  difference test as plain arithmetic on the comparison results, so
+  the loop over the block can be vectorized. The first differing
+  index is only searched for, in a second pass, in blocks which are
+  known to contain a difference.
+*/
+
+#define ECL_KW_DIFF_NUMERIC(ctype)                                                                   \
+static int ecl_kw_diff_elm_ ## ctype( ctype x1 , ctype x2 , double abs_epsilon , double rel_epsilon ,  \
+                                      double * abs_diff , double * rel_diff) {                         \
+  const double v1    = x1;                                                                             \
+  const double v2    = x2;                                                                             \
+  const int    nan1  = (v1 != v1);                                                                     \
+  const int    nan2  = (v2 != v2);                                                                     \
+  const double diff  = fabs( v1 - v2 );                                                                \
+  const double scale = fabs( v1 ) + fabs( v2 );                                                        \
+  const double rel   = (scale > 0) ? diff / scale : 0;                                                 \
+  int tolerance_diff;                                                                                  \
+                                                                                                       \
+  if ((abs_epsilon > 0) || (rel_epsilon > 0))                                                          \
+    tolerance_diff = ((abs_epsilon > 0) & (diff > abs_epsilon)) | ((rel_epsilon > 0) & (rel > rel_epsilon)); \
+  else                                                                                                 \
+    tolerance_diff = (v1 != v2);                                                                       \
+                                                                                                       \
+  *abs_diff = diff;                                                                                    \
+  *rel_diff = rel;                                                                                     \
+  return (nan1 != nan2) | ((nan1 == 0) & (nan2 == 0) & tolerance_diff);                                \
+}                                                                                                      \
+                                                                                                       \
+static void ecl_kw_diff_block_ ## ctype( const ctype * data1 , const ctype * data2 , int offset , int limit , \
+                                         double abs_epsilon , double rel_epsilon ,                     \
+                                         ecl_kw_diff_block_type * block) {                             \
+  int    count = 0;                                                                                    \
+  double max_abs = 0;                                                                                  \
+  double max_rel = 0;                                                                                  \
+  int i;                                                                                               \
+                                                                                                       \
+  for (i = offset; i < limit; i++) {                                                                   \
+    double abs_diff , rel_diff;                                                                        \
+    count  += ecl_kw_diff_elm_ ## ctype( data1[i] , data2[i] , abs_epsilon , rel_epsilon , &abs_diff , &rel_diff ); \
+    max_abs = (abs_diff > max_abs) ? abs_diff : max_abs;                                               \
+    max_rel = (rel_diff > max_rel) ? rel_diff : max_rel;                                               \
+  }                                                                                                    \
+                                                                                                       \
+  block->count        = count;                                                                         \
+  block->max_abs_diff = max_abs;                                                                       \
+  block->max_rel_diff = max_rel;                                                                       \
+  block->first_index  = -1;                                                                            \
+  if (count > 0) {                                                                                     \
+    for (i = offset; i < limit; i++) {                                                                 \
+      double abs_diff , rel_diff;                                                                      \
+      if (ecl_kw_diff_elm_ ## ctype( data1[i] , data2[i] , abs_epsilon , rel_epsilon , &abs_diff , &rel_diff )) { \
+        block->first_index = i;                                                                        \
+        break;                                                                                         \
+      }                                                                                                \
+    }                                                                                                  \
+  }                                                                                                    \
+}
+
+ECL_KW_DIFF_NUMERIC( int )
+ECL_KW_DIFF_NUMERIC( float )
+ECL_KW_DIFF_NUMERIC( double )
+#undef ECL_KW_DIFF_NUMERIC
+
+
+static void ecl_kw_diff_block_bytes( const char * data1 , const char * data2 , int sizeof_ctype , int offset , int limit ,
+                                     ecl_kw_diff_block_type * block) {
+  int i;
+  block->count        = 0;
+  block->first_index  = -1;
+  block->max_abs_diff = 0;
+  block->max_rel_diff = 0;
+  for (i = offset; i < limit; i++) {
+    if (memcmp( &data1[i * sizeof_ctype] , &data2[i * sizeof_ctype] , sizeof_ctype ) != 0) {
+      if (block->count == 0)
+        block->first_index = i;
+      block->count++;
+    }
+  }
+}
+
+
+static void ecl_kw_diff_block( const ecl_kw_type * kw1 , const ecl_kw_type * kw2 , int offset , int limit ,
+                               double abs_epsilon , double rel_epsilon , ecl_kw_diff_block_type * block) {
+  const ecl_data_type data_type = ecl_kw_get_data_type( kw1 );
+  const void * data1 = ecl_kw_get_void_ptr( kw1 );
+  const void * data2 = ecl_kw_get_void_ptr( kw2 );
+
+  if (ecl_type_is_float( data_type ))
+    ecl_kw_diff_block_float( data1 , data2 , offset , limit , abs_epsilon , rel_epsilon , block );
+  else if (ecl_type_is_double( data_type ))
+    ecl_kw_diff_block_double( data1 , data2 , offset , limit , abs_epsilon , rel_epsilon , block );
+  else if (ecl_type_is_int( data_type ))
+    ecl_kw_diff_block_int( data1 , data2 , offset , limit , abs_epsilon , rel_epsilon , block );
+  else
+    ecl_kw_diff_block_bytes( data1 , data2 , ecl_kw_get_sizeof_ctype( kw1 ) , offset , limit , block );
+}
+
+
+static void ecl_kw_diff_compare( ecl_kw_diff_type * diff , const ecl_kw_type * kw1 , const ecl_kw_type * kw2 , double abs_epsilon , double rel_epsilon) {
+  const int size = ecl_kw_get_size( kw1 );
+  const int num_blocks = (size + ECL_KW_DIFF_BLOCK - 1) / ECL_KW_DIFF_BLOCK;
+  ecl_kw_diff_block_type * blocks = util_malloc( util_int_max( 1 , num_blocks ) * sizeof * blocks );
+  int b;
+
+  #pragma omp parallel for if (size > ECL_KW_DIFF_PARALLEL_SIZE)
+  for (b = 0; b < num_blocks; b++) {
+    const int offset = b * ECL_KW_DIFF_BLOCK;
+    const int limit  = util_int_min( size , offset + ECL_KW_DIFF_BLOCK );
+    ecl_kw_diff_block( kw1 , kw2 , offset , limit , abs_epsilon , rel_epsilon , &blocks[b] );
+  }
+
+  for (b = 0; b < num_blocks; b++) {
+    if ((diff->first_index < 0) && (blocks[b].count > 0))
+      diff->first_index = blocks[b].first_index;
+    diff->count += blocks[b].count;
+    diff->max_abs_diff = util_double_max( diff->max_abs_diff , blocks[b].max_abs_diff );
+    diff->max_rel_diff = util_double_max( diff->max_rel_diff , blocks[b].max_rel_diff );
+  }
+
+  if (diff->count > 0)
+    diff->status = ECL_KW_DIFF_VALUES;
+  free( blocks );
+}
+
+
+static ecl_kw_diff_type * ecl_kw_diff_alloc__( const char * header , int occurence ,
+                                               const ecl_kw_type * kw1 , const ecl_kw_type * kw2 ,
+                                               double abs_epsilon , double rel_epsilon) {
+  ecl_kw_diff_type * diff = util_malloc( sizeof * diff );
+  UTIL_TYPE_ID_INIT( diff , ECL_KW_DIFF_TYPE_ID );
+  diff->header       = util_alloc_string_copy( header );
+  diff->occurence    = occurence;
+  diff->status       = ECL_KW_DIFF_EQUAL;
+  diff->size         = 0;
+  diff->count        = 0;
+  diff->first_index  = -1;
+  diff->max_abs_diff = 0;
+  diff->max_rel_diff = 0;
+
+  if (kw1 == NULL)
+    diff->status = ECL_KW_DIFF_MISSING1;
+  else if (kw2 == NULL)
+    diff->status = ECL_KW_DIFF_MISSING2;
+  else if (!ecl_type_is_equal( ecl_kw_get_data_type( kw1 ) , ecl_kw_get_data_type( kw2 )))
+    diff->status = ECL_KW_DIFF_TYPE_MISMATCH;
+  else if (ecl_kw_get_size( kw1 ) != ecl_kw_get_size( kw2 ))
+    diff->status = ECL_KW_DIFF_SIZE_MISMATCH;
+  else {
+    diff->size = ecl_kw_get_size( kw1 );
+    ecl_kw_diff_compare( diff , kw1 , kw2 , abs_epsilon , rel_epsilon );
+  }
+
+  return diff;
+}
+
+
+/*
+  Either of the keywords can be NULL, that is reported as a missing
+  keyword.
+*/
+
+ecl_kw_diff_type * ecl_kw_diff_alloc( const ecl_kw_type * kw1 , const ecl_kw_type * kw2 , double abs_epsilon , double rel_epsilon) {
+  const ecl_kw_type * kw = kw1 ? kw1 : kw2;
+  if (kw == NULL)
+    util_abort("%s: both keywords are NULL \n",__func__);
+
+  return ecl_kw_diff_alloc__( ecl_kw_get_header( kw ) , 0 , kw1 , kw2 , abs_epsilon , rel_epsilon );
+}
+
+
+void ecl_kw_diff_free( ecl_kw_diff_type * diff ) {
+  free( diff->header );
+  free( diff );
+}
+
+
+static void ecl_kw_diff_free__( void * arg ) {
+  ecl_kw_diff_type * diff = ecl_kw_diff_safe_cast( arg );
+  ecl_kw_diff_free( diff );
+}
+
+
+const char * ecl_kw_diff_get_header( const ecl_kw_diff_type * diff ) {
+  return diff->header;
+}
+
+int ecl_kw_diff_get_occurence( const ecl_kw_diff_type * diff ) {
+  return diff->occurence;
+}
+
+ecl_kw_diff_status_enum ecl_kw_diff_get_status( const ecl_kw_diff_type * diff ) {
+  return diff->status;
+}
+
+bool ecl_kw_diff_equal( const ecl_kw_diff_type * diff ) {
+  return (diff->status == ECL_KW_DIFF_EQUAL);
+}
+
+int ecl_kw_diff_get_size( const ecl_kw_diff_type * diff ) {
+  return diff->size;
+}
+
+int ecl_kw_diff_get_count( const ecl_kw_diff_type * diff ) {
+  return diff->count;
+}
+
+int ecl_kw_diff_get_first_index( const ecl_kw_diff_type * diff ) {
+  return diff->first_index;
+}
+
+double ecl_kw_diff_get_max_abs_diff( const ecl_kw_diff_type * diff ) {
+  return diff->max_abs_diff;
+}
+
+double ecl_kw_diff_get_max_rel_diff( const ecl_kw_diff_type * diff ) {
+  return diff->max_rel_diff;
+}
+
+
+void ecl_kw_diff_fprintf( const ecl_kw_diff_type * diff , FILE * stream ) {
+  fprintf(stream , "%-8s[%3d] : " , diff->header , diff->occurence );
+  switch (diff->status) {
+  case(ECL_KW_DIFF_EQUAL):
+    fprintf(stream , "equal\n");
+    break;
+  case(ECL_KW_DIFF_VALUES):
+    fprintf(stream , "%d/%d elements differ  first:%d  max abs diff:%g  max rel diff:%g\n",
+            diff->count , diff->size , diff->first_index , diff->max_abs_diff , diff->max_rel_diff );
+    break;
+  case(ECL_KW_DIFF_TYPE_MISMATCH):
+    fprintf(stream , "different types\n");
+    break;
+  case(ECL_KW_DIFF_SIZE_MISMATCH):
+    fprintf(stream , "different sizes\n");
+    break;
+  case(ECL_KW_DIFF_MISSING1):
+    fprintf(stream , "missing in first file\n");
+    break;
+  case(ECL_KW_DIFF_MISSING2):
+    fprintf(stream , "missing in second file\n");
+    break;
+  }
+}
+
+/*****************************************************************/
+
+/*
+  The keywords are read as private copies through per thread readers,
+  see ecl_file_view_iget_kw_copy(), so the files can be compared in
+  parallel; this also works for the views of
+  ecl_file_open_restart_case() where the keywords come from several
+  files.
+*/
+
+static ecl_kw_type * ecl_file_diff_fread_kw( fortio_type ** fortio , const ecl_file_view_type * view , int index) {
+  if (index >= 0)
+    return ecl_file_view_iget_kw_copy( view , index , fortio );
+  else
+    return NULL;
+}
+
+
+/*
+  Will compare all the keywords in @file1 and @file2. The keywords
+  are matched as the i'th occurence of a header in @file1 with the
+  i'th occurence of the same header in @file2, and the result is
+  ordered as the keywords in @file1, followed by the keywords which
+  are only found in @file2.
+*/
+
+ecl_file_diff_type * ecl_file_diff_alloc( ecl_file_type * file1 , ecl_file_type * file2 , double abs_epsilon , double rel_epsilon) {
+  const ecl_file_view_type * view1 = ecl_file_get_global_view( file1 );
+  const ecl_file_view_type * view2 = ecl_file_get_global_view( file2 );
+  const int size1 = ecl_file_view_get_size( view1 );
+  const int size2 = ecl_file_view_get_size( view2 );
+  int * index1 = util_malloc( (size1 + size2 + 1) * sizeof * index1 );
+  int * index2 = util_malloc( (size1 + size2 + 1) * sizeof * index2 );
+  int * occurence = util_malloc( (size1 + size2 + 1) * sizeof * occurence );
+  const char ** header = util_malloc( (size1 + size2 + 1) * sizeof * header );
+  ecl_kw_diff_type ** diff_list;
+  ecl_file_diff_type * file_diff = util_malloc( sizeof * file_diff );
+  int num_pairs = 0;
+  int i;
+
+  UTIL_TYPE_ID_INIT( file_diff , ECL_FILE_DIFF_TYPE_ID );
+  file_diff->diff_list = vector_alloc_new();
+  file_diff->num_different = 0;
+
+  for (i = 0; i < size1; i++) {
+    header[num_pairs]    = ecl_file_view_iget_header( view1 , i );
+    occurence[num_pairs] = ecl_file_view_iget_occurence( view1 , i );
+    index1[num_pairs]    = i;
+    if (occurence[num_pairs] < ecl_file_view_get_num_named_kw( view2 , header[num_pairs] ))
+      index2[num_pairs] = ecl_file_view_get_global_index( view2 , header[num_pairs] , occurence[num_pairs] );
+    else
+      index2[num_pairs] = -1;
+    num_pairs++;
+  }
+
+  for (i = 0; i < size2; i++) {
+    header[num_pairs]    = ecl_file_view_iget_header( view2 , i );
+    occurence[num_pairs] = ecl_file_view_iget_occurence( view2 , i );
+    if (occurence[num_pairs] >= ecl_file_view_get_num_named_kw( view1 , header[num_pairs] )) {
+      index1[num_pairs] = -1;
+      index2[num_pairs] = i;
+      num_pairs++;
+    }
+  }
+
+  diff_list = util_malloc( (num_pairs + 1) * sizeof * diff_list );
+
+  #pragma omp parallel
+  {
+    fortio_type * fortio1 = NULL;
+    fortio_type * fortio2 = NULL;
+    int pair;
+
+    #pragma omp for schedule(dynamic)
+    for (pair = 0; pair < num_pairs; pair++) {
+      ecl_kw_type * kw1 = ecl_file_diff_fread_kw( &fortio1 , view1 , index1[pair] );
+      ecl_kw_type * kw2 = ecl_file_diff_fread_kw( &fortio2 , view2 , index2[pair] );
+
+      diff_list[pair] = ecl_kw_diff_alloc__( header[pair] , occurence[pair] , kw1 , kw2 , abs_epsilon , rel_epsilon );
+      if (kw1)
+        ecl_kw_free( kw1 );
+      if (kw2)
+        ecl_kw_free( kw2 );
+    }
+
+    if (fortio1)
+      fortio_fclose( fortio1 );
+    if (fortio2)
+      fortio_fclose( fortio2 );
+  }
+
+  for (i = 0; i < num_pairs; i++) {
+    vector_append_owned_ref( file_diff->diff_list , diff_list[i] , ecl_kw_diff_free__ );
+    if (!ecl_kw_diff_equal( diff_list[i] ))
+      file_diff->num_different++;
+  }
+
+  free( diff_list );
+  free( header );
+  free( occurence );
+  free( index1 );
+  free( index2 );
+  return file_diff;
+}
+
+
+void ecl_file_diff_free( ecl_file_diff_type * diff ) {
+  vector_free( diff->diff_list );
+  free( diff );
+}
+
+
+int ecl_file_diff_get_size( const ecl_file_diff_type * diff ) {
+  return vector_get_size( diff->diff_list );
+}
+
+
+const ecl_kw_diff_type * ecl_file_diff_iget( const ecl_file_diff_type * diff , int index) {
+  return vector_iget_const( diff->diff_list , index );
+}
+
+
+int ecl_file_diff_get_num_different( const ecl_file_diff_type * diff ) {
+  return diff->num_different;
+}
+
+
+bool ecl_file_diff_equal( const ecl_file_diff_type * diff ) {
+  return (diff->num_different == 0);
+}
+
+
+void ecl_file_diff_fprintf( const ecl_file_diff_type * diff , FILE * stream , bool print_equal) {
+  int i;
+  for (i = 0; i < vector_get_size( diff->diff_list ); i++) {
+    const ecl_kw_diff_type * kw_diff = vector_iget_const( diff->diff_list , i );
+    if (print_equal || !ecl_kw_diff_equal( kw_diff ))
+      ecl_kw_diff_fprintf( kw_diff , stream );
+  }
+}
@@ -16,6 +16,7 @@
    for more details.
 */
 
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
@@ -27,6 +28,12 @@
 
 #define MAX_GRDECL_HEADER_SIZE 512
 
+#define GRDECL_WRITE_BLOCK_SIZE     16384   /* Number of elements formatted as one unit of work. */
+#define GRDECL_WRITE_BATCH_SIZE     32      /* Number of blocks formatted before they are written to the stream. */
+#define GRDECL_WRITE_PARALLEL_SIZE  100000
+#define GRDECL_LINE_WIDTH           78
+#define GRDECL_MAX_ITEM_SIZE        48
+
 /*
   This file is devoted to different routines for reading and writing
   GRDECL formatted files. These files are very weakly formatted; and
@@ -285,15 +292,18 @@ static char * fscanf_alloc_grdecl_data( const char * header , bool strict , ecl_
         // of the '*'.
 
         int multiplier;
+        int    int_value;
+        float  float_value;
+        double double_value;
         void * value_ptr = NULL;
         bool   char_input = false;
 
         if (ecl_type_is_int(data_type)) {
-          int value;
+          int * value = &int_value;
 
-          if (sscanf(buffer , "%d*%d" , &multiplier , &value) == 2)
+          if (sscanf(buffer , "%d*%d" , &multiplier , value) == 2)
             {}
-          else if (sscanf( buffer , "%d" , &value) == 1)
+          else if (sscanf( buffer , "%d" , value) == 1)
             multiplier = 1;
           else {
             char_input = true;
@@ -301,13 +311,13 @@ static char * fscanf_alloc_grdecl_data( const char * header , bool strict , ecl_
               util_abort("%s: Malformed content:\"%s\" when reading keyword:%s \n",__func__ , buffer , header);
           }
 
-          value_ptr = &value;
+          value_ptr = value;
         } else if (ecl_type_is_float(data_type)) {
-          float value;
+          float * value = &float_value;
 
-          if (sscanf(buffer , "%d*%g" , &multiplier , &value) == 2)
+          if (sscanf(buffer , "%d*%g" , &multiplier , value) == 2)
             {}
-          else if (sscanf( buffer , "%g" , &value) == 1)
+          else if (sscanf( buffer , "%g" , value) == 1)
             multiplier = 1;
           else {
             char_input = true;
@@ -315,13 +325,13 @@ static char * fscanf_alloc_grdecl_data( const char * header , bool strict , ecl_
               util_abort("%s: Malformed content:\"%s\" when reading keyword:%s \n",__func__ , buffer , header);
           }
 
-          value_ptr = &value;
+          value_ptr = value;
         } else if (ecl_type_is_double(data_type)) {
-          double value;
+          double * value = &double_value;
 
-          if (sscanf(buffer , "%d*%lg" , &multiplier , &value) == 2)
+          if (sscanf(buffer , "%d*%lg" , &multiplier , value) == 2)
             {}
-          else if (sscanf( buffer , "%lg" , &value) == 1)
+          else if (sscanf( buffer , "%lg" , value) == 1)
             multiplier = 1;
           else {
             char_input = true;
@@ -329,7 +339,7 @@ static char * fscanf_alloc_grdecl_data( const char * header , bool strict , ecl_
               util_abort("%s: Malformed content:\"%s\" when reading keyword:%s \n",__func__ , buffer , header);
           }
 
-          value_ptr = &value;
+          value_ptr = value;
         } else
           util_abort("%s: sorry type:%s not supported \n",__func__ , ecl_type_alloc_name(data_type));
 
@@ -573,6 +583,159 @@ ecl_kw_type * ecl_kw_fscanf_alloc_current_grdecl( FILE * stream , ecl_data_type
 
 
 
+/*
+  The numeric keywords are written with a buffered formatter instead
+  of the formatted fortio writer:
+
+   1. Runs of equal values are written as N*value.
+
+   2. The values are written with the shortest of a few precisions
+      which reads back to the same value, i.e. float values are
+      written with 7 or 9 significant digits and double values with
+      15 or 17 significant digits.
+
+   3. The keyword is split in blocks of GRDECL_WRITE_BLOCK_SIZE
+      elements; each block is formatted to a memory buffer and the
+      buffers are written to the stream in order with fwrite(). For
+      large keywords the blocks are formatted in parallel. The block
+      boundaries are fixed, so the output does not depend on the
+      number of threads; a run of equal values which crosses a block
+      boundary is written as two items.
+*/
+
+typedef struct {
+  char   * data;
+  size_t   size;
+  size_t   alloc_size;
+} grdecl_text_type;
+
+
+static int grdecl_format_int( char * buffer , int value ) {
+  char digits[16];
+  unsigned int u = (value < 0) ? 0U - (unsigned int) value : (unsigned int) value;
+  int num_digits = 0;
+  int length = 0;
+
+  do {
+    digits[num_digits++] = '0' + (u % 10);
+    u /= 10;
+  } while (u > 0);
+
+  if (value < 0)
+    buffer[length++] = '-';
+
+  while (num_digits > 0)
+    buffer[length++] = digits[--num_digits];
+
+  buffer[length] = '\0';
+  return length;
+}
+
+
+static int grdecl_format_float( char * buffer , float value ) {
+  int length = snprintf( buffer , GRDECL_MAX_ITEM_SIZE , "%.7g" , value );
+  if (strtof( buffer , NULL ) != value)
+    length = snprintf( buffer , GRDECL_MAX_ITEM_SIZE , "%.9g" , value );
+  return length;
+}
+
+
+static int grdecl_format_double( char * buffer , double value ) {
+  int length = snprintf( buffer , GRDECL_MAX_ITEM_SIZE , "%.15g" , value );
+  if (strtod( buffer , NULL ) != value)
+    length = snprintf( buffer , GRDECL_MAX_ITEM_SIZE , "%.17g" , value );
+  return length;
+}
+
+
+static void grdecl_text_append( grdecl_text_type * text , const char * item , int length ) {
+  if (text->size + length + 2 > text->alloc_size) {
+    text->alloc_size = 2 * (text->size + length + 2);
+    text->data = util_realloc( text->data , text->alloc_size );
+  }
+  memcpy( &text->data[ text->size ] , item , length );
+  text->size += length;
+}
+
+
+static void grdecl_format_block( const ecl_kw_type * ecl_kw , int offset , int length , grdecl_text_type * text ) {
+  const ecl_type_enum type = ecl_type_get_type( ecl_kw_get_data_type( ecl_kw ));
+  const int sizeof_ctype   = ecl_kw_get_sizeof_ctype( ecl_kw );
+  const char * data        = ecl_kw_get_void_ptr( ecl_kw );
+  const int end            = offset + length;
+  int line_length = 0;
+  int index = offset;
+
+  text->size = 0;
+  while (index < end) {
+    const char * value = &data[ index * sizeof_ctype ];
+    char item[GRDECL_MAX_ITEM_SIZE + 16];
+    int item_length = 0;
+    int run = 1;
+
+    while ((index + run < end) && (memcmp( value , &data[ (index + run) * sizeof_ctype ] , sizeof_ctype ) == 0))
+      run++;
+
+    if (run > 1) {
+      item_length = grdecl_format_int( item , run );
+      item[item_length++] = '*';
+    }
+
+    if (type == ECL_FLOAT_TYPE)
+      item_length += grdecl_format_float( &item[item_length] , *((const float *) value) );
+    else if (type == ECL_DOUBLE_TYPE)
+      item_length += grdecl_format_double( &item[item_length] , *((const double *) value) );
+    else
+      item_length += grdecl_format_int( &item[item_length] , *((const int *) value) );
+
+    if ((line_length > 0) && (line_length + 1 + item_length > GRDECL_LINE_WIDTH)) {
+      grdecl_text_append( text , "\n" , 1 );
+      line_length = 0;
+    }
+
+    grdecl_text_append( text , " " , 1 );
+    grdecl_text_append( text , item , item_length );
+    line_length += 1 + item_length;
+    index += run;
+  }
+
+  if (line_length > 0)
+    grdecl_text_append( text , "\n" , 1 );
+}
+
+
+static void ecl_kw_fprintf_grdecl_data( const ecl_kw_type * ecl_kw , FILE * stream ) {
+  const int size       = ecl_kw_get_size( ecl_kw );
+  const int num_blocks = (size + GRDECL_WRITE_BLOCK_SIZE - 1) / GRDECL_WRITE_BLOCK_SIZE;
+  grdecl_text_type text[GRDECL_WRITE_BATCH_SIZE];
+  int batch_start;
+  int b;
+
+  for (b = 0; b < GRDECL_WRITE_BATCH_SIZE; b++) {
+    text[b].data = NULL;
+    text[b].size = 0;
+    text[b].alloc_size = 0;
+  }
+
+  for (batch_start = 0; batch_start < num_blocks; batch_start += GRDECL_WRITE_BATCH_SIZE) {
+    const int batch_size = util_int_min( GRDECL_WRITE_BATCH_SIZE , num_blocks - batch_start );
+
+    #pragma omp parallel for schedule(dynamic) if (size > GRDECL_WRITE_PARALLEL_SIZE)
+    for (b = 0; b < batch_size; b++) {
+      int offset = (batch_start + b) * GRDECL_WRITE_BLOCK_SIZE;
+      int length = util_int_min( GRDECL_WRITE_BLOCK_SIZE , size - offset );
+      grdecl_format_block( ecl_kw , offset , length , &text[b] );
+    }
+
+    for (b = 0; b < batch_size; b++)
+      util_fwrite( text[b].data , 1 , text[b].size , stream , __func__ );
+  }
+
+  for (b = 0; b < GRDECL_WRITE_BATCH_SIZE; b++)
+    free( text[b].data );
+}
+
+
 /*
   This method allows to write with a different header,
   i.e. PORO_XXXX. This header is even allowed to break the 8 character
@@ -585,7 +748,9 @@ void ecl_kw_fprintf_grdecl__(const ecl_kw_type * ecl_kw , const char * special_h
   else
     fprintf(stream,"%s\n" , ecl_kw_get_header(ecl_kw));
 
-  {
+  if (ecl_type_is_numeric( ecl_kw_get_data_type( ecl_kw )))
+    ecl_kw_fprintf_grdecl_data( ecl_kw , stream );
+  else {
     fortio_type * fortio = fortio_alloc_FILE_wrapper(NULL , false , true , true , stream);   /* Endian flip should *NOT* be used */
     ecl_kw_fwrite_data(ecl_kw , fortio);
     fortio_free_FILE_wrapper( fortio );
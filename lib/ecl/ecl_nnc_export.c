@@ -37,6 +37,7 @@ static int  ecl_nnc_export__( const ecl_grid_type * grid , int lgr_index1 , cons
   int nnc_index = *nnc_offset;
   int lgr_nr1 = ecl_grid_get_lgr_nr( grid );
   int global_index1;
+  int csr_nr;
   int valid_trans = 0 ;
   const ecl_grid_type * global_grid = ecl_grid_get_global_grid( grid );
 
@@ -44,37 +45,32 @@ static int  ecl_nnc_export__( const ecl_grid_type * grid , int lgr_index1 , cons
     global_grid = grid;
 
 
-  for (global_index1 = 0; global_index1 < ecl_grid_get_global_size( grid ); global_index1++) {
-    const nnc_info_type * nnc_info = ecl_grid_get_cell_nnc_info1( grid , global_index1 );
-    if (nnc_info) {
-      int lgr_index2;
-      for (lgr_index2=0; lgr_index2 < nnc_info_get_size( nnc_info ); lgr_index2++) {
-        const nnc_vector_type * nnc_vector = nnc_info_iget_vector( nnc_info , lgr_index2 );
-        const int_vector_type * grid2_index_list = nnc_vector_get_grid_index_list( nnc_vector );
-        const int_vector_type * nnc_index_list = nnc_vector_get_nnc_index_list( nnc_vector );
-        int lgr_nr2 = nnc_vector_get_lgr_nr( nnc_vector );
-        const ecl_kw_type * tran_kw = ecl_nnc_export_get_tranx_kw(global_grid  , init_file , lgr_nr1 , lgr_nr2 );
-
-        int index2;
-        ecl_nnc_type nnc;
-
-        nnc.grid_nr1 = lgr_nr1;
-        nnc.grid_nr2 = lgr_nr2;
-        nnc.global_index1 = global_index1;
-
-        for (index2 = 0; index2 < nnc_vector_get_size( nnc_vector ); index2++) {
-          nnc.global_index2 = int_vector_iget( grid2_index_list , index2 );
-          nnc.input_index = int_vector_iget( nnc_index_list, index2 );
-          if(tran_kw) {
-            nnc.trans = ecl_kw_iget_as_double(tran_kw, nnc.input_index);
-            valid_trans++;
-          }else{
-            nnc.trans = ERT_ECL_DEFAULT_NNC_TRANS;
-          }
-
-          nnc_data[nnc_index] = nnc;
-          nnc_index++;
+  for (csr_nr = 0; csr_nr < ecl_grid_get_num_nnc_csr( grid ); csr_nr++) {
+    const int * offset;
+    const int * grid2_index;
+    const int * nnc_input_index;
+    int lgr_nr2 = ecl_grid_iget_nnc_csr( grid , csr_nr , &offset , &grid2_index , &nnc_input_index );
+    const ecl_kw_type * tran_kw = ecl_nnc_export_get_tranx_kw(global_grid  , init_file , lgr_nr1 , lgr_nr2 );
+    ecl_nnc_type nnc;
+
+    nnc.grid_nr1 = lgr_nr1;
+    nnc.grid_nr2 = lgr_nr2;
+    for (global_index1 = 0; global_index1 < ecl_grid_get_global_size( grid ); global_index1++) {
+      int index2;
+      nnc.global_index1 = global_index1;
+
+      for (index2 = offset[global_index1]; index2 < offset[global_index1 + 1]; index2++) {
+        nnc.global_index2 = grid2_index[index2];
+        nnc.input_index = nnc_input_index[index2];
+        if(tran_kw) {
+          nnc.trans = ecl_kw_iget_as_double(tran_kw, nnc.input_index);
+          valid_trans++;
+        }else{
+          nnc.trans = ERT_ECL_DEFAULT_NNC_TRANS;
         }
+
+        nnc_data[nnc_index] = nnc;
+        nnc_index++;
       }
     }
   }
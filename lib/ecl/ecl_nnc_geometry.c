@@ -53,23 +53,19 @@ static void ecl_nnc_geometry_add_pairs( const ecl_nnc_geometry_type * nnc_geo ,
     global_grid = grid;
 
 
-  for (int global_index1 = 0; global_index1 < ecl_grid_get_global_size( grid ); global_index1++) {
-    const nnc_info_type * nnc_info = ecl_grid_get_cell_nnc_info1( grid , global_index1 );
-    if (!nnc_info)
-      continue;
-
-    for (int lgr_index2 = 0; lgr_index2 < nnc_info_get_size( nnc_info ); lgr_index2++) {
-      const nnc_vector_type * nnc_vector = nnc_info_iget_vector( nnc_info , lgr_index2 );
-      const int_vector_type * grid2_index_list = nnc_vector_get_grid_index_list( nnc_vector );
-      const int_vector_type * nnc_index_list = nnc_vector_get_nnc_index_list( nnc_vector );
-      int lgr_nr2 = nnc_vector_get_lgr_nr( nnc_vector );
-
-      for (int index2 = 0; index2 < nnc_vector_get_size( nnc_vector ); index2++) {
+  for (int csr_nr = 0; csr_nr < ecl_grid_get_num_nnc_csr( grid ); csr_nr++) {
+    const int * offset;
+    const int * grid2_index;
+    const int * nnc_index;
+    int lgr_nr2 = ecl_grid_iget_nnc_csr( grid , csr_nr , &offset , &grid2_index , &nnc_index );
+
+    for (int global_index1 = 0; global_index1 < ecl_grid_get_global_size( grid ); global_index1++) {
+      for (int index2 = offset[global_index1]; index2 < offset[global_index1 + 1]; index2++) {
         ecl_nnc_pair_type pair = {.grid_nr1 = lgr_nr1,
                                   .global_index1 = global_index1,
                                   .grid_nr2 = lgr_nr2,
-                                  .global_index2 = int_vector_iget( grid2_index_list , index2 ),
-                                  .input_index = int_vector_iget( nnc_index_list, index2 )};
+                                  .global_index2 = grid2_index[index2],
+                                  .input_index = nnc_index[index2]};
 
         struct_vector_append( nnc_geo->data , &pair);
       }
@@ -18,6 +18,7 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <ert/util/int_vector.h>
@@ -95,7 +96,8 @@
 
 struct ecl_region_struct {
   UTIL_TYPE_ID_DECLARATION;
-  bool                * active_mask;          /* This marks active|inactive in the region, which is unrelated to active in the grid. */
+  uint64_t            * select_mask;          /* Packed bitset with one bit per global cell; marks selected|not selected in the region, which is unrelated to active in the grid. */
+  int                   mask_size;            /* Number of 64 bit words in select_mask; the unused bits of the last word are always zero. */
   int_vector_type     * global_index_list;    /* This is a list of the cells in the region - irrespective of whether they are active in the grid or not. */
   int_vector_type     * active_index_list;    /* This means cells in the region which are also active in the grid */
   int_vector_type     * global_active_list;   /* This is a list of (maximum) nactive elements, where the values are in the [0,..nx*ny*nz) range. */
@@ -116,6 +118,213 @@ UTIL_IS_INSTANCE_FUNCTION( ecl_region , ECL_REGION_TYPE_ID)
 UTIL_SAFE_CAST_FUNCTION( ecl_region , ECL_REGION_TYPE_ID)
 
 
+/*****************************************************************/
+/* Bitset primitives */
+
+#define ECL_REGION_WORD_BITS 64
+
+static int ecl_region_num_words( int size ) {
+  return (size + ECL_REGION_WORD_BITS - 1) / ECL_REGION_WORD_BITS;
+}
+
+
+static inline int ecl_region_popcount( uint64_t word ) {
+#ifdef __GNUC__
+  return __builtin_popcountll( word );
+#else
+  int count = 0;
+  while (word) {
+    word &= word - 1;
+    count++;
+  }
+  return count;
+#endif
+}
+
+
+static inline int ecl_region_ctz( uint64_t word ) {
+#ifdef __GNUC__
+  return __builtin_ctzll( word );
+#else
+  int bit = 0;
+  while ((word & 1) == 0) {
+    word >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+
+/*
+  Mask with the bits of the last word which correspond to real cells;
+  all operations which can set bits wholesale (reset, select_all,
+  invert, ...) must and with this to keep the padding bits zero.
+*/
+
+static uint64_t ecl_region_tail_mask( const ecl_region_type * region ) {
+  int tail_bits = region->grid_vol % ECL_REGION_WORD_BITS;
+  if (tail_bits == 0)
+    return ~UINT64_C(0);
+  else
+    return (UINT64_C(1) << tail_bits) - 1;
+}
+
+
+static inline bool ecl_region_iget_mask( const ecl_region_type * region , int global_index ) {
+  return (region->select_mask[ global_index / ECL_REGION_WORD_BITS ] >> (global_index % ECL_REGION_WORD_BITS)) & 1;
+}
+
+
+static inline void ecl_region_iset_mask( ecl_region_type * region , int global_index , bool select) {
+  uint64_t bit = UINT64_C(1) << (global_index % ECL_REGION_WORD_BITS);
+  if (select)
+    region->select_mask[ global_index / ECL_REGION_WORD_BITS ] |= bit;
+  else
+    region->select_mask[ global_index / ECL_REGION_WORD_BITS ] &= ~bit;
+}
+
+
+static void ecl_region_fill_mask( ecl_region_type * region , bool select ) {
+  uint64_t fill = select ? ~UINT64_C(0) : 0;
+  int w;
+  for (w = 0; w < region->mask_size; w++)
+    region->select_mask[w] = fill;
+  if (region->mask_size > 0)
+    region->select_mask[ region->mask_size - 1 ] &= ecl_region_tail_mask( region );
+}
+
+
+/*
+  Will select/deselect the contiguous range [begin,end) of global
+  indices; whole words are written directly.
+*/
+
+static void ecl_region_select_range( ecl_region_type * region , int begin , int end , bool select) {
+  while (begin < end) {
+    int w         = begin / ECL_REGION_WORD_BITS;
+    int first_bit = begin % ECL_REGION_WORD_BITS;
+    int last_bit  = util_int_min( ECL_REGION_WORD_BITS , first_bit + end - begin );
+    uint64_t bits = ~UINT64_C(0) << first_bit;
+
+    if (last_bit < ECL_REGION_WORD_BITS)
+      bits &= (UINT64_C(1) << last_bit) - 1;
+
+    if (select)
+      region->select_mask[w] |= bits;
+    else
+      region->select_mask[w] &= ~bits;
+
+    begin += last_bit - first_bit;
+  }
+}
+
+
+/*
+  The keyword based selections are implemented in two steps: first a
+  match bitset with one bit per keyword element is built with a
+  branch free compare kernel, then the match bitset is applied to the
+  region. The kernels work on one 64 bit word at a time; the inner
+  loop has no function calls and no branches so that the compiler can
+  vectorize it, and the words are independent so the outer loop is
+  split between OpenMP threads.
+
+  The kernels are instantiated for the different data types and
+  comparisons with the macros below; in the expression the element
+  value is available as 'value', the arguments as 'arg1' and 'arg2'.
+*/
+
+#define ECL_REGION_MATCH_KERNEL( name , ctype , expr )                                   \
+static void ecl_region_match_ ## name( const ctype * data , ctype arg1 , ctype arg2 , int size , uint64_t * match) { \
+  const int num_words = ecl_region_num_words( size );                                    \
+  int w;                                                                                 \
+  (void) arg2;                                                                           \
+  _Pragma("omp parallel for")                                                            \
+  for (w = 0; w < num_words; w++) {                                                      \
+    const ctype * word_data = &data[ w * ECL_REGION_WORD_BITS ];                         \
+    const int length = util_int_min( ECL_REGION_WORD_BITS , size - w * ECL_REGION_WORD_BITS ); \
+    uint64_t bits = 0;                                                                   \
+    int bit;                                                                             \
+    for (bit = 0; bit < length; bit++) {                                                 \
+      const ctype value = word_data[bit];                                                \
+      bits |= ((uint64_t) (expr)) << bit;                                                \
+    }                                                                                    \
+    match[w] = bits;                                                                     \
+  }                                                                                      \
+}
+
+
+#define ECL_REGION_CMP_KERNEL( name , ctype , expr )                                     \
+static void ecl_region_match_ ## name( const ctype * data1 , const ctype * data2 , int size , uint64_t * match) { \
+  const int num_words = ecl_region_num_words( size );                                    \
+  int w;                                                                                 \
+  _Pragma("omp parallel for")                                                            \
+  for (w = 0; w < num_words; w++) {                                                      \
+    const ctype * word_data1 = &data1[ w * ECL_REGION_WORD_BITS ];                       \
+    const ctype * word_data2 = &data2[ w * ECL_REGION_WORD_BITS ];                       \
+    const int length = util_int_min( ECL_REGION_WORD_BITS , size - w * ECL_REGION_WORD_BITS ); \
+    uint64_t bits = 0;                                                                   \
+    int bit;                                                                             \
+    for (bit = 0; bit < length; bit++) {                                                 \
+      const ctype value1 = word_data1[bit];                                              \
+      const ctype value2 = word_data2[bit];                                              \
+      bits |= ((uint64_t) (expr)) << bit;                                                \
+    }                                                                                    \
+    match[w] = bits;                                                                     \
+  }                                                                                      \
+}
+
+
+ECL_REGION_MATCH_KERNEL( int_equal       , int    , value == arg1 )
+ECL_REGION_MATCH_KERNEL( int_less        , int    , value <  arg1 )
+ECL_REGION_MATCH_KERNEL( int_more        , int    , value >  arg1 )
+ECL_REGION_MATCH_KERNEL( float_less      , float  , value <  arg1 )
+ECL_REGION_MATCH_KERNEL( float_more      , float  , value >= arg1 )
+ECL_REGION_MATCH_KERNEL( float_interval  , float  , (value >= arg1) & (value < arg2) )
+ECL_REGION_MATCH_KERNEL( double_less     , double , value <  arg1 )
+ECL_REGION_MATCH_KERNEL( double_more     , double , value >= arg1 )
+ECL_REGION_CMP_KERNEL( float_cmp_less    , float  , value1 <  value2 )
+ECL_REGION_CMP_KERNEL( float_cmp_more    , float  , value1 >= value2 )
+
+
+static uint64_t * ecl_region_alloc_match( int size ) {
+  return util_calloc( util_int_max( 1 , ecl_region_num_words( size )) , sizeof(uint64_t) );
+}
+
+
+/*
+  Applies a match bitset built from a keyword to the region. For a
+  global keyword the match words line up with the region words and
+  are applied wholesale; for an active keyword the set bits are mapped
+  to global indices one at a time.
+*/
+
+static void ecl_region_apply_match( ecl_region_type * region , const uint64_t * match , bool global_kw , bool select) {
+  if (global_kw) {
+    int w;
+#pragma omp parallel for
+    for (w = 0; w < region->mask_size; w++) {
+      if (select)
+        region->select_mask[w] |= match[w];
+      else
+        region->select_mask[w] &= ~match[w];
+    }
+  } else {
+    const int num_words = ecl_region_num_words( region->grid_active );
+    int w;
+    for (w = 0; w < num_words; w++) {
+      uint64_t bits = match[w];
+      while (bits) {
+        int active_index = w * ECL_REGION_WORD_BITS + ecl_region_ctz( bits );
+        int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
+        ecl_region_iset_mask( region , global_index , select );
+        bits &= bits - 1;
+      }
+    }
+  }
+}
+
+
 static void ecl_region_invalidate_index_list( ecl_region_type * region ) {
   region->global_index_list_valid  = false;
   region->active_index_list_valid  = false;
@@ -142,7 +351,8 @@ ecl_region_type * ecl_region_alloc( const ecl_grid_type * ecl_grid , bool presel
   region->parent_grid = ecl_grid;
   ecl_grid_get_dims( ecl_grid , &region->grid_nx , &region->grid_ny , &region->grid_nz , &region->grid_active);
   region->grid_vol          = region->grid_nx * region->grid_ny * region->grid_nz;
-  region->active_mask       = util_calloc(region->grid_vol , sizeof * region->active_mask );
+  region->mask_size         = ecl_region_num_words( region->grid_vol );
+  region->select_mask       = util_calloc( util_int_max( 1 , region->mask_size ) , sizeof * region->select_mask );
   region->active_index_list  = int_vector_alloc(0 , 0);
   region->global_index_list  = int_vector_alloc(0 , 0);
   region->global_active_list = int_vector_alloc(0 , 0);
@@ -159,14 +369,14 @@ ecl_region_type * ecl_region_alloc( const ecl_grid_type * ecl_grid , bool presel
 
 ecl_region_type * ecl_region_alloc_copy( const ecl_region_type * ecl_region ) {
   ecl_region_type * new_region = ecl_region_alloc( ecl_region->parent_grid , ecl_region->preselect );
-  memcpy( new_region->active_mask , ecl_region->active_mask , ecl_region->grid_vol * sizeof * ecl_region->active_mask );
+  memcpy( new_region->select_mask , ecl_region->select_mask , ecl_region->mask_size * sizeof * ecl_region->select_mask );
   ecl_region_invalidate_index_list( new_region );
   return new_region;
 }
 
 
 void ecl_region_free( ecl_region_type * region ) {
-  free( region->active_mask );
+  free( region->select_mask );
   int_vector_free( region->active_index_list );
   int_vector_free( region->global_index_list );
   int_vector_free( region->global_active_list );
@@ -185,15 +395,44 @@ void ecl_region_free__( void * __region ) {
 /*****************************************************************/
 
 
+/*
+  The index lists are built by compaction of the bitset: the total
+  number of selected cells is found with popcount, the lists are sized
+  once, and the set bits of each word are then visited directly with
+  count-trailing-zeros instead of testing every cell.
+*/
+
+static int ecl_region_count_selected( const ecl_region_type * region ) {
+  int count = 0;
+  int w;
+#pragma omp parallel for reduction(+:count)
+  for (w = 0; w < region->mask_size; w++)
+    count += ecl_region_popcount( region->select_mask[w] );
+  return count;
+}
+
+
 static void ecl_region_assert_global_index_list( ecl_region_type * region ) {
   if (!region->global_index_list_valid) {
-    int global_index;
+    int count = ecl_region_count_selected( region );
 
     int_vector_reset( region->global_index_list  );
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      if (region->active_mask[ global_index ])
-        int_vector_append( region->global_index_list , global_index );
-
+    if (count > 0) {
+      int * index_list;
+      int list_index = 0;
+      int w;
+
+      int_vector_resize( region->global_index_list , count );
+      index_list = int_vector_get_ptr( region->global_index_list );
+      for (w = 0; w < region->mask_size; w++) {
+        uint64_t bits = region->select_mask[w];
+        while (bits) {
+          index_list[ list_index ] = w * ECL_REGION_WORD_BITS + ecl_region_ctz( bits );
+          list_index++;
+          bits &= bits - 1;
+        }
+      }
+    }
     region->global_index_list_valid = true;
   }
 }
@@ -201,18 +440,35 @@ static void ecl_region_assert_global_index_list( ecl_region_type * region ) {
 
 static void ecl_region_assert_active_index_list( ecl_region_type * region ) {
   if (!region->active_index_list_valid) {
-    int global_index;
+    int count = ecl_region_count_selected( region );
 
     int_vector_reset( region->active_index_list  );
     int_vector_reset( region->global_active_list );
-    for (global_index = 0; global_index < region->grid_vol; global_index++) {
-      if (region->active_mask[ global_index ]) {
-        int active_index = ecl_grid_get_active_index1( region->parent_grid , global_index );
-        if (active_index >= 0) {
-          int_vector_append( region->active_index_list , active_index );
-          int_vector_append( region->global_active_list , global_index );
+    if (count > 0) {
+      int * active_list;
+      int * global_list;
+      int list_index = 0;
+      int w;
+
+      int_vector_resize( region->active_index_list  , count );
+      int_vector_resize( region->global_active_list , count );
+      active_list = int_vector_get_ptr( region->active_index_list );
+      global_list = int_vector_get_ptr( region->global_active_list );
+      for (w = 0; w < region->mask_size; w++) {
+        uint64_t bits = region->select_mask[w];
+        while (bits) {
+          int global_index = w * ECL_REGION_WORD_BITS + ecl_region_ctz( bits );
+          int active_index = ecl_grid_get_active_index1( region->parent_grid , global_index );
+          if (active_index >= 0) {
+            active_list[ list_index ] = active_index;
+            global_list[ list_index ] = global_index;
+            list_index++;
+          }
+          bits &= bits - 1;
         }
       }
+      int_vector_resize( region->active_index_list  , list_index );
+      int_vector_resize( region->global_active_list , list_index );
     }
     region->active_index_list_valid = true;
   }
@@ -239,6 +495,15 @@ const int_vector_type * ecl_region_get_global_list( ecl_region_type * region ) {
   return region->global_index_list;
 }
 
+/**
+   Returns the total number of cells, active and inactive, in the grid
+   the region was allocated for.
+*/
+
+int ecl_region_get_grid_global_size( const ecl_region_type * region ) {
+  return region->grid_vol;
+}
+
 /*****************************************************************/
 /* Stupid cpp compat/legacy/cruft functions. */
 int ecl_region_get_active_size_cpp(  ecl_region_type * region ) {
@@ -276,9 +541,7 @@ static void ecl_region_assert_kw( const ecl_region_type * region , const ecl_kw_
 /*****************************************************************/
 
 void ecl_region_reset( ecl_region_type * ecl_region ) {
-  int i;
-  for (i=0; i < ecl_region->grid_vol; i++)
-    ecl_region->active_mask[i] = ecl_region->preselect;
+  ecl_region_fill_mask( ecl_region , ecl_region->preselect );
   ecl_region_invalidate_index_list( ecl_region );
 }
 
@@ -287,7 +550,7 @@ void ecl_region_reset( ecl_region_type * ecl_region ) {
 
 static void ecl_region_select_cell__( ecl_region_type * region , int i , int j , int k, bool select) {
   int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-  region->active_mask[global_index] = select;
+  ecl_region_iset_mask( region , global_index , select );
   ecl_region_invalidate_index_list( region );
 }
 
@@ -309,22 +572,11 @@ static void ecl_region_select_equal__( ecl_region_type * region , const ecl_kw_t
   if (!ecl_type_is_int(ecl_kw_get_data_type( ecl_kw )))
     util_abort("%s: sorry - select by equality is only supported for integer keywords \n",__func__);
   {
-    const int * kw_data = ecl_kw_get_int_ptr( ecl_kw );
-    if (global_kw) {
-      int global_index;
-      for (global_index = 0; global_index < region->grid_vol; global_index++) {
-        if (kw_data[ global_index ] == value)
-          region->active_mask[ global_index ] = select;
-      }
-    } else {
-      int active_index;
-      for (active_index = 0; active_index < region->grid_active; active_index++) {
-        if (kw_data[active_index] == value) {
-          int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-          region->active_mask[ global_index ] = select;
-        }
-      }
-    }
+    const int size = ecl_kw_get_size( ecl_kw );
+    uint64_t * match = ecl_region_alloc_match( size );
+    ecl_region_match_int_equal( ecl_kw_get_int_ptr( ecl_kw ) , value , value , size , match );
+    ecl_region_apply_match( region , match , global_kw , select );
+    free( match );
   }
   ecl_region_invalidate_index_list( region );
 }
@@ -351,14 +603,14 @@ static void ecl_region_select_bool_equal__( ecl_region_type * region , const ecl
       int global_index;
       for (global_index = 0; global_index < region->grid_vol; global_index++) {
         if (ecl_kw_iget_bool(ecl_kw , global_index) == value)
-          region->active_mask[ global_index ] = select;
+          ecl_region_iset_mask( region , global_index , select );
       }
     } else {
       int active_index;
       for (active_index = 0; active_index < region->grid_active; active_index++) {
         if (ecl_kw_iget_bool(ecl_kw , active_index) == value) {
           int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-          region->active_mask[ global_index ] = select;
+          ecl_region_iset_mask( region , global_index , select );
         }
       }
     }
@@ -395,22 +647,11 @@ static void ecl_region_select_in_interval__( ecl_region_type * region , const ec
   if (!ecl_type_is_float(ecl_kw_get_data_type( ecl_kw )))
     util_abort("%s: sorry - select by in_interval is only supported for float keywords \n",__func__);
   {
-    const float * kw_data = ecl_kw_get_float_ptr( ecl_kw );
-    if (global_kw) {
-      int global_index;
-      for (global_index = 0; global_index < region->grid_vol; global_index++) {
-        if (kw_data[ global_index ] >= min_value && kw_data[ global_index ] < max_value)
-          region->active_mask[ global_index ] = select;
-      }
-    } else {
-      int active_index;
-      for (active_index = 0; active_index < region->grid_active; active_index++) {
-        if (kw_data[ active_index ] >= min_value && kw_data[ active_index ] < max_value) {
-          int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-          region->active_mask[ global_index ] = select;
-        }
-      }
-    }
+    const int size = ecl_kw_get_size( ecl_kw );
+    uint64_t * match = ecl_region_alloc_match( size );
+    ecl_region_match_float_interval( ecl_kw_get_float_ptr( ecl_kw ) , min_value , max_value , size , match );
+    ecl_region_apply_match( region , match , global_kw , select );
+    free( match );
   }
   ecl_region_invalidate_index_list( region );
 }
@@ -427,11 +668,6 @@ void ecl_region_deselect_in_interval( ecl_region_type * region , const ecl_kw_ty
 
 /*****************************************************************/
 
-/**
-   This is waaaay to fucking large:
-
-   Float / Int / double *  Active / Global  *  More / Less ==> In total 12 code blocks written out ...
-*/
 
 
 /*
@@ -445,97 +681,34 @@ static void ecl_region_select_with_limit__( ecl_region_type * region , const ecl
     util_abort("%s: sorry - select by in_interval is only supported for float and integer keywords \n",__func__);
 
   {
+    const int size = ecl_kw_get_size( ecl_kw );
+    uint64_t * match = ecl_region_alloc_match( size );
+
     if (ecl_type_is_float(data_type)) {
       const float * kw_data = ecl_kw_get_float_ptr( ecl_kw );
       float float_limit = limit;
-      if (global_kw) {
-        int global_index;
-        for (global_index = 0; global_index < region->grid_vol; global_index++) {
-          if (select_less) {
-            if (kw_data[ global_index ] < float_limit)
-              region->active_mask[ global_index ] = select;
-          } else {
-            if (kw_data[ global_index ] >= float_limit)
-              region->active_mask[ global_index ] = select;
-          }
-        }
-      } else {
-        int active_index;
-        for (active_index = 0; active_index < region->grid_active; active_index++) {
-          if (select_less) {
-            if (kw_data[ active_index ] < float_limit) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          } else {
-            if (kw_data[ active_index ] >= float_limit) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          }
-        }
-      }
+      if (select_less)
+        ecl_region_match_float_less( kw_data , float_limit , float_limit , size , match );
+      else
+        ecl_region_match_float_more( kw_data , float_limit , float_limit , size , match );
     } else if (ecl_type_is_int(data_type)) {
       const int * kw_data = ecl_kw_get_int_ptr( ecl_kw );
       int int_limit = (int) limit;
-      if (global_kw) {
-        int global_index;
-        for (global_index = 0; global_index < region->grid_vol; global_index++) {
-          if (select_less) {
-            if (kw_data[ global_index ] < int_limit)
-              region->active_mask[ global_index ] = select;
-          } else {
-            if (kw_data[ global_index ] > int_limit)
-              region->active_mask[ global_index ] = select;
-          }
-        }
-      } else {
-        int active_index;
-        for (active_index = 0; active_index < region->grid_active; active_index++) {
-          if (select_less) {
-            if (kw_data[ active_index ] < int_limit) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          } else {
-            if (kw_data[ active_index ] > int_limit) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          }
-        }
-      }
+      if (select_less)
+        ecl_region_match_int_less( kw_data , int_limit , int_limit , size , match );
+      else
+        ecl_region_match_int_more( kw_data , int_limit , int_limit , size , match );
     } else if (ecl_type_is_double(data_type)) {
       const double * kw_data = ecl_kw_get_double_ptr( ecl_kw );
       double double_limit = (double) limit;
-      if (global_kw) {
-        int global_index;
-        for (global_index = 0; global_index < region->grid_vol; global_index++) {
-          if (select_less) {
-            if (kw_data[ global_index ] < double_limit)
-              region->active_mask[ global_index ] = select;
-          } else {
-            if (kw_data[ global_index ] >= double_limit)
-              region->active_mask[ global_index ] = select;
-          }
-        }
-      } else {
-        int active_index;
-        for (active_index = 0; active_index < region->grid_active; active_index++) {
-          if (select_less) {
-            if (kw_data[ active_index ] < double_limit) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          } else {
-            if (kw_data[ active_index ] >= double_limit) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          }
-        }
-      }
+      if (select_less)
+        ecl_region_match_double_less( kw_data , double_limit , double_limit , size , match );
+      else
+        ecl_region_match_double_more( kw_data , double_limit , double_limit , size , match );
     }
+
+    ecl_region_apply_match( region , match , global_kw , select );
+    free( match );
   }
   ecl_region_invalidate_index_list( region );
 }
@@ -570,37 +743,18 @@ static void ecl_region_cmp_select__( ecl_region_type * region , const ecl_kw_typ
     util_abort("%s: sorry - select by cmp() is only supported for float keywords \n",__func__);
   {
     if (ecl_kw_size_and_type_equal(kw1, kw2)) {
-
       const float * kw1_data = ecl_kw_get_float_ptr( kw1 );
       const float * kw2_data = ecl_kw_get_float_ptr( kw2 );
+      const int size = ecl_kw_get_size( kw1 );
+      uint64_t * match = ecl_region_alloc_match( size );
 
-      if (global_kw) {
-        int global_index;
-        for (global_index = 0; global_index < region->grid_vol; global_index++) {
-          if (select_less) {
-            if (kw1_data[ global_index ] < kw2_data[ global_index ])
-              region->active_mask[ global_index ] = select;
-          } else {
-            if (kw1_data[ global_index ] >= kw2_data[ global_index ] )
-              region->active_mask[ global_index ] = select;
-          }
-        }
-      } else {
-        int active_index;
-        for (active_index = 0; active_index < region->grid_active; active_index++) {
-          if (select_less) {
-            if (kw1_data[ active_index ] < kw2_data[ active_index] ) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          } else {
-            if (kw1_data[ active_index ] >= kw2_data[ active_index ]) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          }
-        }
-      }
+      if (select_less)
+        ecl_region_match_float_cmp_less( kw1_data , kw2_data , size , match );
+      else
+        ecl_region_match_float_cmp_more( kw1_data , kw2_data , size , match );
+
+      ecl_region_apply_match( region , match , global_kw , select );
+      free( match );
     } else
       util_abort("%s: type/size mismatch between keywords. \n",__func__);
   }
@@ -639,7 +793,7 @@ static void ecl_region_select_from_box__( ecl_region_type * region , const ecl_b
   int box_index;
 
   for (box_index = 0; box_index < box_size; box_index++)
-    region->active_mask[ active_list[box_index] ] = select;
+    ecl_region_iset_mask( region , active_list[box_index] , select );
 
   ecl_region_invalidate_index_list( region );
 }
@@ -704,7 +858,7 @@ static void ecl_region_select_i1i2__( ecl_region_type * region , int i1 , int i2
       for (j = 0; j < region->grid_ny; j++)
         for (i = i1; i <= i2; i++) {
           int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-          region->active_mask[global_index] = select;
+          ecl_region_iset_mask( region , global_index , select );
         }
   }
   ecl_region_invalidate_index_list( region );
@@ -738,14 +892,13 @@ static void ecl_region_select_j1j2__( ecl_region_type * region , int j1 , int j2
 
   j1 = util_int_max(0 , j1);
   j2 = util_int_min(region->grid_ny - 1 , j2);
-  {
-    int i,j,k;
-    for (k = 0; k < region->grid_nz; k++)
-      for ( j = j1; j <= j2; j++)
-        for ( i = 0; i < region->grid_nx; i++) {
-          int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-          region->active_mask[global_index] = select;
-        }
+  if (j1 <= j2) {
+    int k;
+    for (k = 0; k < region->grid_nz; k++) {
+      int begin = ecl_grid_get_global_index3( region->parent_grid , 0 , j1 , k);
+      int end   = ecl_grid_get_global_index3( region->parent_grid , region->grid_nx - 1 , j2 , k) + 1;
+      ecl_region_select_range( region , begin , end , select );
+    }
   }
   ecl_region_invalidate_index_list( region );
 }
@@ -777,14 +930,10 @@ static void ecl_region_select_k1k2__( ecl_region_type * region , int k1 , int k2
     util_abort("%s: i1 > i2 - this is illogical ... \n",__func__);
   k1 = util_int_max(0 , k1);
   k2 = util_int_min(region->grid_nz - 1 , k2);
-  {
-    int i,j,k;
-    for (k = k1; k <= k2; k++)
-      for (j = 0; j < region->grid_ny; j++)
-        for (i = 0; i < region->grid_nx; i++) {
-          int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-          region->active_mask[global_index] = select;
-        }
+  if (k1 <= k2) {
+    int begin = ecl_grid_get_global_index3( region->parent_grid , 0 , 0 , k1);
+    int end   = ecl_grid_get_global_index3( region->parent_grid , region->grid_nx - 1 , region->grid_ny - 1 , k2) + 1;
+    ecl_region_select_range( region , begin , end , select );
   }
   ecl_region_invalidate_index_list( region );
 }
@@ -815,11 +964,11 @@ static void ecl_region_select_from_depth__( ecl_region_type * region , double de
     if (select_deep) {
       // The select/deselect mechanism should be applied to deep cells.
       if (cell_depth >= depth_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_iset_mask( region , global_index , select );
     } else {
       // The select/deselect mechanism should be applied to shallow cells.
       if (cell_depth <= depth_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_iset_mask( region , global_index , select );
     }
   }
   ecl_region_invalidate_index_list( region );
@@ -853,11 +1002,11 @@ static void ecl_region_select_from_volume__( ecl_region_type * region , double v
     if (select_small) {
       // The select/deselect mechanism should be applied to small cells.
       if (cell_size <= volum_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_iset_mask( region , global_index , select );
     } else {
       // The select/deselect mechanism should be applied to large cells.
       if (cell_size >= volum_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_iset_mask( region , global_index , select );
     }
   }
   ecl_region_invalidate_index_list( region );
@@ -889,11 +1038,11 @@ static void ecl_region_select_from_dz__( ecl_region_type * region , double dz_li
     if (select_thin) {
       // The select/deselect mechanism should be applied to thin cells.
       if (cell_dz <= dz_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_iset_mask( region , global_index , select );
     } else {
       // The select/deselect mechanism should be applied to thick cells.
       if (cell_dz >= dz_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_iset_mask( region , global_index , select );
     }
   }
   ecl_region_invalidate_index_list( region );
@@ -921,10 +1070,10 @@ static void ecl_region_select_active_cells__( ecl_region_type * ecl_region , boo
   for (global_index = 0; global_index < ecl_region->grid_vol; global_index++) {
     if (select_active) {
       if (ecl_grid_get_active_index1( ecl_region->parent_grid , global_index) >= 0)
-        ecl_region->active_mask[ global_index ] = select;
+        ecl_region_iset_mask( ecl_region , global_index , select );
     } else {
       if (ecl_grid_get_active_index1( ecl_region->parent_grid , global_index) < 0)
-        ecl_region->active_mask[ global_index ] = select;
+        ecl_region_iset_mask( ecl_region , global_index , select );
     }
   }
   ecl_region_invalidate_index_list( ecl_region );
@@ -954,7 +1103,7 @@ void ecl_region_deselect_inactive_cells( ecl_region_type * region ) {
 
 static void ecl_region_select_global_index__( ecl_region_type * region , int global_index , bool select) {
   if ((global_index >= 0) && (global_index < region->grid_vol))
-    region->active_mask[ global_index ] = select;
+    ecl_region_iset_mask( region , global_index , select );
   else
     util_abort("%s: global_index:%d invalid - legal interval: [0,%d) \n",__func__ , global_index , region->grid_vol);
   ecl_region_invalidate_index_list( region );
@@ -993,9 +1142,9 @@ static void ecl_region_cylinder_select__( ecl_region_type * region , double x0 ,
       if ((z >= z1) && (z <= z2)) {
         double pointR2 = (x - x0) * (x - x0) + (y - y0) * (y - y0);
         if ((pointR2 < R2) && (select_inside))
-          region->active_mask[ global_index ] = select;
+          ecl_region_iset_mask( region , global_index , select );
         else if ((pointR2 > R2) && (!select_inside))
-          region->active_mask[ global_index ] = select;
+          ecl_region_iset_mask( region , global_index , select );
       }
     }
   } else {
@@ -1020,7 +1169,7 @@ static void ecl_region_cylinder_select__( ecl_region_type * region , double x0 ,
             int k;
             for (k=0; k < nz; k++) {
               int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-              region->active_mask[ global_index ] = select;
+              ecl_region_iset_mask( region , global_index , select );
             }
           }
         }
@@ -1074,9 +1223,9 @@ static void ecl_region_plane_select__( ecl_region_type * region, const double n[
       ecl_grid_get_xyz1( region->parent_grid , global_index , &x , &y , &z);
       D = a*x + b*y + c*z + d;
       if ((D >= 0) && (select_above))
-        region->active_mask[ global_index ] = select;
+        ecl_region_iset_mask( region , global_index , select );
       else if ((D < 0) && (!select_above))
-        region->active_mask[ global_index ] = select;
+        ecl_region_iset_mask( region , global_index , select );
     }
   }
   ecl_region_invalidate_index_list( region );
@@ -1146,7 +1295,7 @@ static void ecl_region_polygon_select__( ecl_region_type * region ,
           int k;
           for (k=k1; k < k2; k++) {
             global_index = ecl_grid_get_global_index3( region->parent_grid , i , j , k);
-            region->active_mask[ global_index ] = select;
+            ecl_region_iset_mask( region , global_index , select );
           }
         }
       }
@@ -1178,7 +1327,7 @@ void ecl_region_deselect_outside_polygon( ecl_region_type * region , const geo_p
 static void ecl_region_select_active_index__( ecl_region_type * region , int active_index , bool select) {
   if ((active_index >= 0) && (active_index < region->grid_active)) {
     int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index);
-    region->active_mask[ global_index ] = select;
+    ecl_region_iset_mask( region , global_index , select );
   } else
     util_abort("%s: active_index:%d invalid - legal interval: [0,%d) \n",__func__ , active_index , region->grid_vol);
   ecl_region_invalidate_index_list( region );
@@ -1206,7 +1355,7 @@ static void ecl_region_select_from_layer__( ecl_region_type * region , const lay
     int index;
     for (index = 0; index < int_vector_size( i_list ); index++) {
       int global_index = ecl_grid_get_global_index3( region->parent_grid , i[index] , j[index] , k);
-      region->active_mask[ global_index ] = select;
+      ecl_region_iset_mask( region , global_index , select );
     }
 
   }
@@ -1229,9 +1378,7 @@ void ecl_region_deselect_from_layer( ecl_region_type * region , const layer_type
 /*****************************************************************/
 
 static void ecl_region_select_all__( ecl_region_type * region , bool select) {
-  int global_index;
-  for (global_index = 0; global_index < region->grid_vol; global_index++)
-    region->active_mask[ global_index ] = select;
+  ecl_region_fill_mask( region , select );
   ecl_region_invalidate_index_list( region );
 }
 
@@ -1248,9 +1395,11 @@ void ecl_region_deselect_all( ecl_region_type * region ) {
 /*****************************************************************/
 
 void ecl_region_invert_selection( ecl_region_type * region ) {
-  int global_index;
-  for (global_index = 0; global_index < region->grid_vol; global_index++)
-    region->active_mask[ global_index ] = !region->active_mask[ global_index ];
+  int w;
+  for (w = 0; w < region->mask_size; w++)
+    region->select_mask[w] = ~region->select_mask[w];
+  if (region->mask_size > 0)
+    region->select_mask[ region->mask_size - 1 ] &= ecl_region_tail_mask( region );
   ecl_region_invalidate_index_list( region );
 }
 
@@ -1264,18 +1413,18 @@ void ecl_region_invert_selection( ecl_region_type * region ) {
 
 bool ecl_region_contains_ijk( const ecl_region_type * ecl_region , int i , int j , int k) {
   int global_index = ecl_grid_get_global_index3( ecl_region->parent_grid , i , j , k );
-  return ecl_region->active_mask[ global_index ];
+  return ecl_region_iget_mask( ecl_region , global_index );
 }
 
 
 bool ecl_region_contains_global( const ecl_region_type * ecl_region , int global_index) {
-  return ecl_region->active_mask[ global_index ];
+  return ecl_region_iget_mask( ecl_region , global_index );
 }
 
 
 bool ecl_region_contains_active( const ecl_region_type * ecl_region , int active_index) {
   int global_index = ecl_grid_get_global_index1A( ecl_region->parent_grid , active_index );
-  return ecl_region->active_mask[ global_index ];
+  return ecl_region_iget_mask( ecl_region , global_index );
 }
 
 
@@ -1294,9 +1443,9 @@ bool ecl_region_contains_active( const ecl_region_type * ecl_region , int active
 
 void ecl_region_intersection( ecl_region_type * region , const ecl_region_type * new_region ) {
   if (region->parent_grid == new_region->parent_grid) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      region->active_mask[global_index] = (region->active_mask[global_index] && new_region->active_mask[global_index]);
+    int w;
+    for (w = 0; w < region->mask_size; w++)
+      region->select_mask[w] &= new_region->select_mask[w];
 
     ecl_region_invalidate_index_list( region );
   } else
@@ -1312,9 +1461,9 @@ void ecl_region_intersection( ecl_region_type * region , const ecl_region_type *
 */
 void ecl_region_union( ecl_region_type * region , const ecl_region_type * new_region ) {
   if (region->parent_grid == new_region->parent_grid) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      region->active_mask[global_index] = (region->active_mask[global_index] || new_region->active_mask[global_index]);
+    int w;
+    for (w = 0; w < region->mask_size; w++)
+      region->select_mask[w] |= new_region->select_mask[w];
 
     ecl_region_invalidate_index_list( region );
   } else
@@ -1330,9 +1479,9 @@ void ecl_region_union( ecl_region_type * region , const ecl_region_type * new_re
 */
 void ecl_region_subtract( ecl_region_type * region , const ecl_region_type * new_region) {
   if (region->parent_grid == new_region->parent_grid) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      region->active_mask[global_index] &= !new_region->active_mask[global_index];
+    int w;
+    for (w = 0; w < region->mask_size; w++)
+      region->select_mask[w] &= ~new_region->select_mask[w];
 
     ecl_region_invalidate_index_list( region );
   } else
@@ -1348,9 +1497,11 @@ void ecl_region_subtract( ecl_region_type * region , const ecl_region_type * new
 */
 void ecl_region_xor( ecl_region_type * region , const ecl_region_type * new_region) {
   if (region->parent_grid == new_region->parent_grid) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      region->active_mask[global_index] ^= !new_region->active_mask[global_index];
+    int w;
+    for (w = 0; w < region->mask_size; w++)
+      region->select_mask[w] ^= ~new_region->select_mask[w];
+    if (region->mask_size > 0)
+      region->select_mask[ region->mask_size - 1 ] &= ecl_region_tail_mask( region );
 
     ecl_region_invalidate_index_list( region );
   } else
@@ -1485,7 +1636,7 @@ const char * ecl_region_get_name( const ecl_region_type * region ) {
 
 bool ecl_region_equal( const ecl_region_type * region1 , const ecl_region_type * region2) {
   if (region1->parent_grid == region2->parent_grid) {  // Must be exactly the same grid instance to compare as equal.
-    if (memcmp(region1->active_mask , region2->active_mask , region1->grid_vol * sizeof * region1->active_mask ) == 0)
+    if (memcmp(region1->select_mask , region2->select_mask , region1->mask_size * sizeof * region1->select_mask ) == 0)
       return true;
     else
       return false;
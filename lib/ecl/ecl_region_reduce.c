@@ -0,0 +1,488 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_region_reduce.c' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_type.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region_reduce.h>
+
+/*
+  The ecl_region_reduce structure computes statistics of field
+  keywords, like PRESSURE or SOIL, for all the regions given by an
+  integer region keyword, like FIPNUM, in one pass over the cells.
+  For every field and region it computes:
+
+     sum    : sum(w*x) over the cells in the region.
+     weight : sum(w) over the cells in the region.
+     mean   : sum / weight.
+     min    : min(x) over the cells in the region.
+     max    : max(x) over the cells in the region.
+
+  where w is the weight keyword, e.g. PORV or RPORV, or 1 if no
+  weight is given. I.e. with PORV as weight the sum of SOIL is the oil
+  pore volume of the region and the mean of PRESSURE is the pore
+  volume weighted pressure. Cells with region value <= 0 are not
+  part of any region.
+
+  The cells are split in a fixed number of chunks which are reduced
+  in parallel into separate accumulators, the accumulators are then
+  merged in order; the result is therefore independent of the number
+  of threads. The innermost loop updates the accumulators with a
+  scatter on the region value; that does not vectorize, but it is
+  branch free apart from the region check.
+
+  Field and weight keywords must have the same size as the region
+  keyword; if the region keyword has one element per active cell and
+  a grid is given, keywords with one element per global cell, like
+  PORV from the INIT file, are compressed to the active cells first.
+*/
+
+#define ECL_REGION_REDUCE_TYPE_ID   77125310
+
+#define ECL_REGION_REDUCE_MAX_CHUNKS  32
+#define ECL_REGION_REDUCE_MIN_CHUNK   8192
+
+
+typedef struct {
+  double * sum;
+  double * weight;
+  double * min;
+  double * max;
+} ecl_region_reduce_acc_type;
+
+
+struct ecl_region_reduce_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  const ecl_grid_type        * grid;
+  int                          size;
+  int                        * region;
+  int                          max_region;
+  int                        * count;        /* [max_region + 1] */
+  int                          num_fields;
+  ecl_region_reduce_acc_type * result;       /* [num_fields] */
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_region_reduce , ECL_REGION_REDUCE_TYPE_ID )
+
+
+static void ecl_region_reduce_acc_init( ecl_region_reduce_acc_type * acc , int num_regions ) {
+  int r;
+  acc->sum    = util_calloc( num_regions , sizeof * acc->sum );
+  acc->weight = util_calloc( num_regions , sizeof * acc->weight );
+  acc->min    = util_calloc( num_regions , sizeof * acc->min );
+  acc->max    = util_calloc( num_regions , sizeof * acc->max );
+  for (r = 0; r < num_regions; r++) {
+    acc->sum[r]    = 0;
+    acc->weight[r] = 0;
+    acc->min[r]    = INFINITY;
+    acc->max[r]    = -INFINITY;
+  }
+}
+
+
+static void ecl_region_reduce_acc_free( ecl_region_reduce_acc_type * acc ) {
+  free( acc->sum );
+  free( acc->weight );
+  free( acc->min );
+  free( acc->max );
+}
+
+
+static void ecl_region_reduce_acc_merge( ecl_region_reduce_acc_type * target , const ecl_region_reduce_acc_type * src , int num_regions ) {
+  int r;
+  for (r = 0; r < num_regions; r++) {
+    target->sum[r]    += src->sum[r];
+    target->weight[r] += src->weight[r];
+    target->min[r]     = util_double_min( target->min[r] , src->min[r] );
+    target->max[r]     = util_double_max( target->max[r] , src->max[r] );
+  }
+}
+
+
+#define ECL_REGION_REDUCE_KERNEL(ctype)                                                                        \
+static void ecl_region_reduce_chunk_##ctype( const int * region , const ctype * data , const double * weight , \
+                                             int i1 , int i2 , ecl_region_reduce_acc_type * acc) {             \
+  double * sum  = acc->sum;                                                                                    \
+  double * wsum = acc->weight;                                                                                 \
+  double * min  = acc->min;                                                                                    \
+  double * max  = acc->max;                                                                                    \
+  int i;                                                                                                       \
+  for (i = i1; i < i2; i++) {                                                                                  \
+    const int r = region[i];                                                                                   \
+    if (r > 0) {                                                                                               \
+      const double x = data[i];                                                                                \
+      const double w = weight ? weight[i] : 1.0;                                                               \
+      sum[r]  += w * x;                                                                                        \
+      wsum[r] += w;                                                                                            \
+      min[r]   = (x < min[r]) ? x : min[r];                                                                    \
+      max[r]   = (x > max[r]) ? x : max[r];                                                                    \
+    }                                                                                                          \
+  }                                                                                                            \
+}
+
+ECL_REGION_REDUCE_KERNEL(float)
+ECL_REGION_REDUCE_KERNEL(double)
+ECL_REGION_REDUCE_KERNEL(int)
+
+#undef ECL_REGION_REDUCE_KERNEL
+
+
+static int ecl_region_reduce_num_chunks( int size ) {
+  int num_chunks = (size + ECL_REGION_REDUCE_MIN_CHUNK - 1) / ECL_REGION_REDUCE_MIN_CHUNK;
+  return util_int_max( 1 , util_int_min( ECL_REGION_REDUCE_MAX_CHUNKS , num_chunks ));
+}
+
+
+ecl_region_reduce_type * ecl_region_reduce_alloc( const ecl_grid_type * grid , const ecl_kw_type * region_kw ) {
+  ecl_region_reduce_type * reducer;
+
+  if (!ecl_type_is_int( ecl_kw_get_data_type( region_kw )))
+    util_abort("%s: the region keyword:%s must be of integer type \n",__func__ , ecl_kw_get_header( region_kw ));
+
+  reducer = util_malloc( sizeof * reducer );
+  UTIL_TYPE_ID_INIT( reducer , ECL_REGION_REDUCE_TYPE_ID );
+  reducer->grid       = grid;
+  reducer->size       = ecl_kw_get_size( region_kw );
+  reducer->region     = util_calloc( util_int_max( 1 , reducer->size ) , sizeof * reducer->region );
+  reducer->max_region = 0;
+  reducer->num_fields = 0;
+  reducer->result     = NULL;
+  {
+    const int * region = ecl_kw_get_int_ptr( region_kw );
+    int i;
+    for (i = 0; i < reducer->size; i++) {
+      reducer->region[i]  = region[i];
+      reducer->max_region = util_int_max( reducer->max_region , region[i] );
+    }
+  }
+
+  reducer->count = util_calloc( reducer->max_region + 1 , sizeof * reducer->count );
+  {
+    int r, i;
+    for (r = 0; r <= reducer->max_region; r++)
+      reducer->count[r] = 0;
+    for (i = 0; i < reducer->size; i++)
+      if (reducer->region[i] > 0)
+        reducer->count[ reducer->region[i] ]++;
+  }
+  return reducer;
+}
+
+
+static void ecl_region_reduce_clear_result( ecl_region_reduce_type * reducer ) {
+  int f;
+  for (f = 0; f < reducer->num_fields; f++)
+    ecl_region_reduce_acc_free( &reducer->result[f] );
+  free( reducer->result );
+  reducer->result     = NULL;
+  reducer->num_fields = 0;
+}
+
+
+void ecl_region_reduce_free( ecl_region_reduce_type * reducer ) {
+  ecl_region_reduce_clear_result( reducer );
+  free( reducer->count );
+  free( reducer->region );
+  free( reducer );
+}
+
+
+/*
+  Returns a keyword with the same size as the region keyword; either
+  @ecl_kw itself or a newly allocated copy compressed to the active
+  cells which the calling scope must free.
+*/
+
+static const ecl_kw_type * ecl_region_reduce_get_kw( const ecl_region_reduce_type * reducer , const ecl_kw_type * ecl_kw , ecl_kw_type ** tmp_kw) {
+  const int size = ecl_kw_get_size( ecl_kw );
+  *tmp_kw = NULL;
+
+  if (size == reducer->size)
+    return ecl_kw;
+
+  if (reducer->grid &&
+      (reducer->size == ecl_grid_get_active_size( reducer->grid )) &&
+      (size == ecl_grid_get_global_size( reducer->grid ))) {
+    *tmp_kw = ecl_kw_alloc( ecl_kw_get_header( ecl_kw ) , reducer->size , ecl_kw_get_data_type( ecl_kw ));
+    ecl_grid_gather_kw( reducer->grid , ecl_kw , *tmp_kw );
+    return *tmp_kw;
+  }
+
+  util_abort("%s: size mismatch: keyword:%s has %d elements - the region keyword has %d \n",__func__ ,
+             ecl_kw_get_header( ecl_kw ) , size , reducer->size );
+  return NULL;
+}
+
+
+static double * ecl_region_reduce_alloc_weight( const ecl_region_reduce_type * reducer , const ecl_kw_type * weight_kw ) {
+  ecl_kw_type * tmp_kw;
+  const ecl_kw_type * kw = ecl_region_reduce_get_kw( reducer , weight_kw , &tmp_kw );
+  double * weight = util_calloc( util_int_max( 1 , reducer->size ) , sizeof * weight );
+  ecl_kw_get_data_as_double( kw , weight );
+  if (tmp_kw)
+    ecl_kw_free( tmp_kw );
+  return weight;
+}
+
+
+static void ecl_region_reduce_chunk( const ecl_region_reduce_type * reducer , const ecl_kw_type * field_kw , const double * weight ,
+                                     int i1 , int i2 , ecl_region_reduce_acc_type * acc) {
+  ecl_data_type data_type = ecl_kw_get_data_type( field_kw );
+
+  if (ecl_type_is_float( data_type ))
+    ecl_region_reduce_chunk_float( reducer->region , ecl_kw_get_float_ptr( field_kw ) , weight , i1 , i2 , acc );
+  else if (ecl_type_is_double( data_type ))
+    ecl_region_reduce_chunk_double( reducer->region , ecl_kw_get_double_ptr( field_kw ) , weight , i1 , i2 , acc );
+  else
+    ecl_region_reduce_chunk_int( reducer->region , ecl_kw_get_int_ptr( field_kw ) , weight , i1 , i2 , acc );
+}
+
+
+/*
+  Will compute the statistics for all regions for the @num_fields
+  keywords in @field_kw; @weight_kw can be NULL, or contain NULL
+  entries, for unweighted statistics. The result is available with
+  the ecl_region_reduce_iget_xxx() functions until the next call.
+*/
+
+void ecl_region_reduce_eval( ecl_region_reduce_type * reducer , int num_fields , const ecl_kw_type ** field_kw , const ecl_kw_type ** weight_kw ) {
+  const int num_regions = reducer->max_region + 1;
+  const int num_chunks  = ecl_region_reduce_num_chunks( reducer->size );
+  const int chunk_size  = (reducer->size + num_chunks - 1) / num_chunks;
+  const ecl_kw_type ** fields  = util_calloc( util_int_max( 1 , num_fields ) , sizeof * fields );
+  ecl_kw_type       ** tmp_kw  = util_calloc( util_int_max( 1 , num_fields ) , sizeof * tmp_kw );
+  double            ** weights = util_calloc( util_int_max( 1 , num_fields ) , sizeof * weights );
+  ecl_region_reduce_acc_type * acc = util_calloc( num_chunks * util_int_max( 1 , num_fields ) , sizeof * acc );
+  int f, c;
+
+  for (f = 0; f < num_fields; f++) {
+    ecl_data_type data_type = ecl_kw_get_data_type( field_kw[f] );
+    if (!(ecl_type_is_float( data_type ) || ecl_type_is_double( data_type ) || ecl_type_is_int( data_type )))
+      util_abort("%s: keyword:%s must be of float, double or integer type \n",__func__ , ecl_kw_get_header( field_kw[f] ));
+
+    fields[f]  = ecl_region_reduce_get_kw( reducer , field_kw[f] , &tmp_kw[f] );
+    weights[f] = NULL;
+    if (weight_kw && weight_kw[f]) {
+      int prev;
+      for (prev = 0; prev < f; prev++) {
+        if (weight_kw[prev] == weight_kw[f]) {
+          weights[f] = weights[prev];
+          break;
+        }
+      }
+      if (!weights[f])
+        weights[f] = ecl_region_reduce_alloc_weight( reducer , weight_kw[f] );
+    }
+  }
+
+  for (c = 0; c < num_chunks * num_fields; c++)
+    ecl_region_reduce_acc_init( &acc[c] , num_regions );
+
+#pragma omp parallel for schedule(static)
+  for (c = 0; c < num_chunks; c++) {
+    const int i1 = c * chunk_size;
+    const int i2 = util_int_min( reducer->size , i1 + chunk_size );
+    int field;
+    for (field = 0; field < num_fields; field++)
+      ecl_region_reduce_chunk( reducer , fields[field] , weights[field] , i1 , i2 , &acc[c * num_fields + field] );
+  }
+
+  ecl_region_reduce_clear_result( reducer );
+  reducer->num_fields = num_fields;
+  reducer->result     = util_calloc( util_int_max( 1 , num_fields ) , sizeof * reducer->result );
+  for (f = 0; f < num_fields; f++) {
+    ecl_region_reduce_acc_init( &reducer->result[f] , num_regions );
+    for (c = 0; c < num_chunks; c++)
+      ecl_region_reduce_acc_merge( &reducer->result[f] , &acc[c * num_fields + f] , num_regions );
+  }
+
+  for (c = 0; c < num_chunks * num_fields; c++)
+    ecl_region_reduce_acc_free( &acc[c] );
+  free( acc );
+
+  for (f = 0; f < num_fields; f++) {
+    int next;
+    if (tmp_kw[f])
+      ecl_kw_free( tmp_kw[f] );
+
+    if (weights[f]) {
+      for (next = f + 1; next < num_fields; next++)
+        if (weights[next] == weights[f])
+          weights[next] = NULL;
+      free( weights[f] );
+    }
+  }
+  free( weights );
+  free( tmp_kw );
+  free( fields );
+}
+
+
+static ecl_kw_type * ecl_region_reduce_fread_kw( fortio_type ** fortio , const ecl_file_view_type * view , const char * kw) {
+  return ecl_file_view_iget_kw_copy( view , ecl_file_view_get_global_index( view , kw , 0 ) , fortio );
+}
+
+
+/*
+  Will stream through all the report steps in @restart_file and
+  evaluate the statistics of the keywords in @fields for each of
+  them; after each report step @step_callback is called and the
+  result for that step can be queried from the reducer. The keywords
+  are read directly from the file - or the files of a case opened with
+  ecl_file_open_restart_case() - and released after use, so only one
+  report step is held in memory at a time.
+
+  The weight used is the keyword @restart_weight_kw, e.g. RPORV, from
+  the report step if it is present there; otherwise @weight_kw,
+  e.g. PORV from the INIT file. Both can be NULL.
+*/
+
+void ecl_region_reduce_eval_restart( ecl_region_reduce_type * reducer , ecl_file_type * restart_file , const stringlist_type * fields ,
+                                     const ecl_kw_type * weight_kw , const char * restart_weight_kw ,
+                                     ecl_region_reduce_step_ftype * step_callback , void * arg) {
+  const char * filename = ecl_file_get_src_file( restart_file );
+  const int num_fields = stringlist_get_size( fields );
+  const int num_blocks = ecl_file_get_num_named_kw( restart_file , SEQNUM_KW );
+  const ecl_kw_type ** field_kw  = util_calloc( util_int_max( 1 , num_fields ) , sizeof * field_kw );
+  const ecl_kw_type ** weights   = util_calloc( util_int_max( 1 , num_fields ) , sizeof * weights );
+  fortio_type * fortio = NULL;
+  int block;
+
+  for (block = 0; block < util_int_max( 1 , num_blocks ); block++) {
+    ecl_file_view_type * view;
+    ecl_kw_type * step_weight = NULL;
+    int report_step;
+    int f;
+
+    if (num_blocks > 0) {
+      view = ecl_file_get_restart_view( restart_file , block , -1 , -1 , -1 );
+      report_step = ecl_kw_iget_int( ecl_file_view_iget_named_kw( view , SEQNUM_KW , 0 ) , 0 );
+    } else {
+      view = ecl_file_get_global_view( restart_file );
+      report_step = ecl_util_filename_report_nr( filename );
+    }
+
+    if (restart_weight_kw && ecl_file_view_has_kw( view , restart_weight_kw ))
+      step_weight = ecl_region_reduce_fread_kw( &fortio , view , restart_weight_kw );
+
+    for (f = 0; f < num_fields; f++) {
+      const char * kw = stringlist_iget( fields , f );
+      if (!ecl_file_view_has_kw( view , kw ))
+        util_abort("%s: keyword:%s is missing in report step:%d \n",__func__ , kw , report_step);
+
+      field_kw[f] = ecl_region_reduce_fread_kw( &fortio , view , kw );
+      weights[f]  = step_weight ? step_weight : weight_kw;
+    }
+
+    ecl_region_reduce_eval( reducer , num_fields , field_kw , weights );
+    if (step_callback)
+      step_callback( reducer , report_step , arg );
+
+    for (f = 0; f < num_fields; f++)
+      ecl_kw_free( (ecl_kw_type *) field_kw[f] );
+    if (step_weight)
+      ecl_kw_free( step_weight );
+  }
+
+  if (fortio)
+    fortio_fclose( fortio );
+  free( weights );
+  free( field_kw );
+}
+
+
+int ecl_region_reduce_get_num_fields( const ecl_region_reduce_type * reducer ) {
+  return reducer->num_fields;
+}
+
+
+int ecl_region_reduce_get_max_region( const ecl_region_reduce_type * reducer ) {
+  return reducer->max_region;
+}
+
+
+static void ecl_region_reduce_assert_index( const ecl_region_reduce_type * reducer , int field , int region ) {
+  if ((field < 0) || (field >= reducer->num_fields))
+    util_abort("%s: invalid field index:%d - valid range: [0,%d) \n",__func__ , field , reducer->num_fields);
+
+  if ((region < 0) || (region > reducer->max_region))
+    util_abort("%s: invalid region:%d - valid range: [0,%d] \n",__func__ , region , reducer->max_region);
+}
+
+
+int ecl_region_reduce_iget_count( const ecl_region_reduce_type * reducer , int region ) {
+  if ((region < 0) || (region > reducer->max_region))
+    util_abort("%s: invalid region:%d - valid range: [0,%d] \n",__func__ , region , reducer->max_region);
+  return reducer->count[region];
+}
+
+
+double ecl_region_reduce_iget_sum( const ecl_region_reduce_type * reducer , int field , int region ) {
+  ecl_region_reduce_assert_index( reducer , field , region );
+  return reducer->result[field].sum[region];
+}
+
+
+double ecl_region_reduce_iget_weight( const ecl_region_reduce_type * reducer , int field , int region ) {
+  ecl_region_reduce_assert_index( reducer , field , region );
+  return reducer->result[field].weight[region];
+}
+
+
+/*
+  The mean, min and max of an empty region are NAN.
+*/
+
+double ecl_region_reduce_iget_mean( const ecl_region_reduce_type * reducer , int field , int region ) {
+  ecl_region_reduce_assert_index( reducer , field , region );
+  if (reducer->count[region] == 0)
+    return NAN;
+  return reducer->result[field].sum[region] / reducer->result[field].weight[region];
+}
+
+
+double ecl_region_reduce_iget_min( const ecl_region_reduce_type * reducer , int field , int region ) {
+  ecl_region_reduce_assert_index( reducer , field , region );
+  if (reducer->count[region] == 0)
+    return NAN;
+  return reducer->result[field].min[region];
+}
+
+
+double ecl_region_reduce_iget_max( const ecl_region_reduce_type * reducer , int field , int region ) {
+  ecl_region_reduce_assert_index( reducer , field , region );
+  if (reducer->count[region] == 0)
+    return NAN;
+  return reducer->result[field].max[region];
+}
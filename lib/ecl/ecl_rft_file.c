@@ -32,8 +32,13 @@
 
 #include <ert/ecl/ecl_rft_file.h>
 #include <ert/ecl/ecl_rft_node.h>
+#include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/ecl_file_view.h>
 #include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/fortio.h>
 #include <ert/ecl/ecl_kw_magic.h>
 
 
@@ -53,14 +58,76 @@
 
 #define ECL_RFT_FILE_ID 6610632
 
+/*
+  Loading an RFT file is done in two steps:
+
+    1. The file is opened with ecl_file_open() and the keyword list
+       is split in blocks starting with the TIME keyword - in one
+       pass. For each block the small WELLETC and DATE keywords are
+       read, to get the well name, the recording date and the type of
+       the RFT. These keywords are read in parallel, with one fortio
+       instance per thread, when the file has many blocks.
+
+    2. The ecl_rft_node instance for a block is only created when it
+       is requested with one of the ecl_rft_file_xxx_node() /
+       ecl_rft_file_xxx_rft() functions; the node is created from a
+       private ecl_file_view with copies of the ecl_file_kw instances
+       of the block, and the file is read through a fortio instance
+       which is opened on first use.
+
+  The nodes of each well are indexed by recording date, so that
+  ecl_rft_file_get_well_time_rft() is a binary search. Observe that
+  since the nodes are created lazily by the const query functions an
+  ecl_rft_file instance can not be used from several threads
+  simultaneously.
+
+  If the file has a valid sidecar index, see ecl_rft_file_append(),
+  the well name and recording date of the blocks found in the index
+  are taken from there, and WELLETC and DATE are not read.
+*/
+
+#define ECL_RFT_FILE_PARALLEL_SIZE 64
+
+typedef struct {
+  vector_type       * kw_list;       /* ecl_file_kw copies for the block; NULL if the node has been added in memory. */
+  offset_type         offset;        /* File offset of the TIME keyword starting the block. */
+  char              * well_name;
+  time_t              date;
+  ecl_rft_node_type * node;          /* NULL until the node has been loaded. */
+} ecl_rft_file_block_type;
+
+
 struct ecl_rft_file_struct {
   UTIL_TYPE_ID_DECLARATION;
   char        * filename;
-  vector_type * data;          /* This vector just contains all the rft nodes in one long vector. */
+  vector_type * data;          /* This vector just contains all the rft blocks in one long vector. */
   hash_type   * well_index;    /* This indexes well names into the data vector - very similar to the scheme used in ecl_file. */
+  hash_type   * time_index;    /* For each well: the indices into the data vector sorted by recording date. */
+  fortio_type * fortio;        /* Used to load nodes; opened on first use. */
 };
 
 
+static ecl_rft_file_block_type * ecl_rft_file_block_alloc_index( offset_type offset , time_t date , const char * well_name ) {
+  ecl_rft_file_block_type * block = util_malloc( sizeof * block );
+  block->kw_list = NULL;
+  block->offset = offset;
+  block->well_name = util_alloc_string_copy( well_name );
+  block->date = date;
+  block->node = NULL;
+  return block;
+}
+
+
+static void ecl_rft_file_block_free__( void * arg ) {
+  ecl_rft_file_block_type * block = (ecl_rft_file_block_type *) arg;
+  if (block->kw_list)
+    vector_free( block->kw_list );
+  if (block->node)
+    ecl_rft_node_free( block->node );
+  free( block->well_name );
+  free( block );
+}
+
 
 static ecl_rft_file_type * ecl_rft_file_alloc_empty(const char * filename) {
   ecl_rft_file_type * rft_vector = util_malloc(sizeof * rft_vector );
@@ -68,6 +135,8 @@ static ecl_rft_file_type * ecl_rft_file_alloc_empty(const char * filename) {
   rft_vector->data       = vector_alloc_new();
   rft_vector->filename   = util_alloc_string_copy(filename);
   rft_vector->well_index = hash_alloc();
+  rft_vector->time_index = hash_alloc();
+  rft_vector->fortio     = NULL;
   return rft_vector;
 }
 
@@ -82,42 +151,364 @@ UTIL_SAFE_CAST_FUNCTION( ecl_rft_file , ECL_RFT_FILE_ID );
 UTIL_IS_INSTANCE_FUNCTION( ecl_rft_file , ECL_RFT_FILE_ID );
 
 
-static void ecl_rft_file_add_node(ecl_rft_file_type * rft_vector , const ecl_rft_node_type * rft_node) {
-  vector_append_owned_ref( rft_vector->data , rft_node , ecl_rft_node_free__);
+static ecl_file_view_type * ecl_rft_file_alloc_block_view( const vector_type * kw_list , fortio_type * fortio , int * flags , inv_map_type * inv_map) {
+  ecl_file_view_type * block_view = ecl_file_view_alloc( fortio , flags , inv_map , true );
+  int i;
+  for (i = 0; i < vector_get_size( kw_list ); i++)
+    ecl_file_view_add_kw( block_view , ecl_file_kw_alloc_copy( vector_iget_const( kw_list , i )));
+  ecl_file_view_make_index( block_view );
+  return block_view;
+}
+
+
+/*
+  Will read the WELLETC and DATE keywords of the block and set the
+  well name and recording date. Returns false if the block does not
+  contain RFT or PLT data, i.e. SEGMENT data which is not supported.
+*/
+
+static bool ecl_rft_file_block_load_header( ecl_rft_file_block_type * block , fortio_type * fortio ) {
+  int flags = 0;
+  inv_map_type * inv_map = inv_map_alloc();
+  ecl_file_view_type * block_view = ecl_rft_file_alloc_block_view( block->kw_list , fortio , &flags , inv_map );
+  const ecl_kw_type * welletc = ecl_file_view_iget_named_kw( block_view , WELLETC_KW , 0 );
+  const char * type_string = ecl_kw_iget_ptr( welletc , WELLETC_TYPE_INDEX );
+  bool valid = false;
+
+  if ((strchr( type_string , 'P' ) != NULL) || (strchr( type_string , 'R' ) != NULL)) {
+    const ecl_kw_type * date_kw = ecl_file_view_iget_named_kw( block_view , DATE_KW , 0 );
+    block->well_name = util_alloc_strip_copy( ecl_kw_iget_ptr( welletc , WELLETC_NAME_INDEX ));
+    block->date = ecl_util_make_date( ecl_kw_iget_int( date_kw , DATE_DAY_INDEX ) ,
+                                      ecl_kw_iget_int( date_kw , DATE_MONTH_INDEX ) ,
+                                      ecl_kw_iget_int( date_kw , DATE_YEAR_INDEX ));
+    valid = true;
+  }
+
+  ecl_file_view_free( block_view );
+  inv_map_free( inv_map );
+  return valid;
+}
+
+
+static fortio_type * ecl_rft_file_get_fortio( ecl_rft_file_type * rft_file ) {
+  if (rft_file->fortio == NULL) {
+    bool fmt_file;
+    if (!ecl_util_fmt_file( rft_file->filename , &fmt_file ))
+      util_abort("%s: could not determine formatted/unformatted status of:%s \n",__func__ , rft_file->filename);
+
+    rft_file->fortio = fortio_open_reader( rft_file->filename , fmt_file , ECL_ENDIAN_FLIP );
+    if (rft_file->fortio == NULL)
+      util_abort("%s: failed to open RFT file:%s \n",__func__ , rft_file->filename);
+  }
+  return rft_file->fortio;
+}
+
+
+static ecl_rft_node_type * ecl_rft_file_block_get_node( ecl_rft_file_type * rft_file , ecl_rft_file_block_type * block ) {
+  if (block->node == NULL) {
+    int flags = 0;
+    inv_map_type * inv_map = inv_map_alloc();
+    ecl_file_view_type * block_view = ecl_rft_file_alloc_block_view( block->kw_list , ecl_rft_file_get_fortio( rft_file ) , &flags , inv_map );
+
+    block->node = ecl_rft_node_alloc( block_view );
+    if (block->node == NULL)
+      util_abort("%s: failed to load RFT node for well:%s from:%s \n",__func__ , block->well_name , rft_file->filename);
+
+    ecl_file_view_free( block_view );
+    inv_map_free( inv_map );
+  }
+  return block->node;
+}
+
+
+/*
+  Will add the block at data index @global_index to the well index;
+  the time index is built when all the blocks have been added.
+*/
+
+static void ecl_rft_file_index_block( ecl_rft_file_type * rft_file , const ecl_rft_file_block_type * block , int global_index) {
+  if (!hash_has_key( rft_file->well_index , block->well_name))
+    hash_insert_hash_owned_ref( rft_file->well_index , block->well_name , int_vector_alloc( 0 , 0 ) , int_vector_free__);
+  {
+    int_vector_type * index_list = hash_get( rft_file->well_index , block->well_name );
+    int_vector_append(index_list , global_index);
+  }
+}
+
+
+typedef struct {
+  time_t date;
+  int    global_index;
+} ecl_rft_file_time_node_type;
+
+
+static int ecl_rft_file_time_node_cmp( const void * arg1 , const void * arg2 ) {
+  const ecl_rft_file_time_node_type * node1 = (const ecl_rft_file_time_node_type *) arg1;
+  const ecl_rft_file_time_node_type * node2 = (const ecl_rft_file_time_node_type *) arg2;
+
+  if (node1->date != node2->date)
+    return (node1->date < node2->date) ? -1 : 1;
+  else
+    return node1->global_index - node2->global_index;
 }
 
 
+static void ecl_rft_file_build_time_index( ecl_rft_file_type * rft_file ) {
+  hash_iter_type * iter = hash_iter_alloc( rft_file->well_index );
+  while (!hash_iter_is_complete( iter )) {
+    const char * well_name = hash_iter_get_next_key( iter );
+    const int_vector_type * index_list = hash_get( rft_file->well_index , well_name );
+    const int size = int_vector_size( index_list );
+    ecl_rft_file_time_node_type * time_nodes = util_calloc( util_int_max( 1 , size ) , sizeof * time_nodes );
+    int_vector_type * time_list = int_vector_alloc( size , 0 );
+    int i;
+
+    for (i = 0; i < size; i++) {
+      const ecl_rft_file_block_type * block = vector_iget_const( rft_file->data , int_vector_iget( index_list , i ));
+      time_nodes[i].date = block->date;
+      time_nodes[i].global_index = int_vector_iget( index_list , i );
+    }
+    qsort( time_nodes , size , sizeof * time_nodes , ecl_rft_file_time_node_cmp );
+
+    for (i = 0; i < size; i++)
+      int_vector_iset( time_list , i , time_nodes[i].global_index );
+
+    hash_insert_hash_owned_ref( rft_file->time_index , well_name , time_list , int_vector_free__ );
+    free( time_nodes );
+  }
+  hash_iter_free( iter );
+}
+
+
+/*
+  The sidecar index
+  -----------------
+
+  When nodes are added with ecl_rft_file_append() the file offset,
+  recording date and well name of each new node is appended to a small
+  text file with the same name as the RFT file and the extension
+  ".index", e.g. CASE.RFT -> CASE.RFT.index:
+
+     NODE <offset> <date> <well>
+     NODE <offset> <date> <well>
+     END <file size> <mtime>
+
+  Every append operation ends with an END line with the size and
+  modification time of the RFT file. The index is only used if the
+  last END line agrees with the current size and modification time of
+  the RFT file, and the last NODE record is the start of the last
+  block in the file; otherwise it is discarded and rebuilt on the
+  next append.
+*/
+
+static char * ecl_rft_file_alloc_index_filename( const char * rft_file_name ) {
+  return util_alloc_sprintf("%s.index" , rft_file_name);
+}
+
+
+static void ecl_rft_file_fprintf_index_end( FILE * stream , const char * rft_file_name ) {
+  fprintf(stream , "END %lld %lld\n" , (long long) util_file_size( rft_file_name ) , (long long) util_file_mtime( rft_file_name ));
+}
+
+
+/*
+  Will check that there is a TIME keyword at @offset in the RFT file,
+  and no other TIME keyword between @offset and the end of the file.
+  Only the headers of the last block are read.
+*/
+
+static bool ecl_rft_file_check_last_block( const char * rft_file_name , offset_type offset ) {
+  bool fmt_file;
+  bool valid = false;
+
+  if (ecl_util_fmt_file( rft_file_name , &fmt_file )) {
+    fortio_type * fortio = fortio_open_reader( rft_file_name , fmt_file , ECL_ENDIAN_FLIP );
+    if (fortio) {
+      ecl_kw_type * ecl_kw = ecl_kw_alloc_empty();
+
+      if (fortio_fseek( fortio , offset , SEEK_SET ) &&
+          (ecl_kw_fread_header( ecl_kw , fortio ) == ECL_KW_READ_OK) &&
+          ecl_kw_name_equal( ecl_kw , TIME_KW )) {
+        valid = true;
+        while (valid) {
+          if (!ecl_kw_fskip_data( ecl_kw , fortio ))
+            valid = false;
+          else if (fortio_read_at_eof( fortio ))
+            break;
+          else if (ecl_kw_fread_header( ecl_kw , fortio ) != ECL_KW_READ_OK)
+            valid = false;
+          else if (ecl_kw_name_equal( ecl_kw , TIME_KW ))
+            valid = false;
+        }
+      }
+
+      ecl_kw_free( ecl_kw );
+      fortio_fclose( fortio );
+    }
+  }
+  return valid;
+}
+
+
+/*
+  Will return the records of the sidecar index as a vector of blocks,
+  or NULL if the index does not exist or is not valid.
+*/
+
+static vector_type * ecl_rft_file_alloc_index( const char * rft_file_name ) {
+  char * index_file = ecl_rft_file_alloc_index_filename( rft_file_name );
+  vector_type * index = NULL;
+
+  if (util_file_exists( index_file ) && util_file_exists( rft_file_name )) {
+    FILE * stream = util_fopen( index_file , "r");
+    vector_type * records = vector_alloc_new();
+    long long file_size = -1;
+    long long mtime = -1;
+    bool valid = true;
+    char tag[16];
+
+    while (valid && fscanf( stream , "%15s" , tag ) == 1) {
+      if (strcmp( tag , "NODE" ) == 0) {
+        long long offset;
+        long long date;
+        char well_name[64];
+
+        if (fscanf( stream , "%lld %lld %63s" , &offset , &date , well_name ) == 3)
+          vector_append_owned_ref( records , ecl_rft_file_block_alloc_index( offset , date , well_name ) , ecl_rft_file_block_free__ );
+        else
+          valid = false;
+      } else if (strcmp( tag , "END" ) == 0) {
+        if (fscanf( stream , "%lld %lld" , &file_size , &mtime ) != 2)
+          valid = false;
+      } else
+        valid = false;
+    }
+    fclose( stream );
+
+    if (valid) {
+      if (file_size != (long long) util_file_size( rft_file_name ))
+        valid = false;
+      else if (mtime != (long long) util_file_mtime( rft_file_name ))
+        valid = false;
+      else if (vector_get_size( records ) > 0) {
+        const ecl_rft_file_block_type * last_record = vector_get_last_const( records );
+        valid = ecl_rft_file_check_last_block( rft_file_name , last_record->offset );
+      }
+    }
+
+    if (valid)
+      index = records;
+    else
+      vector_free( records );
+  }
+
+  free( index_file );
+  return index;
+}
 
 
 ecl_rft_file_type * ecl_rft_file_alloc(const char * filename) {
   ecl_rft_file_type * rft_vector = ecl_rft_file_alloc_empty( filename );
-  ecl_file_type * ecl_file       = ecl_file_open( filename , 0);
-  int global_index = 0;
-  int block_nr = 0;
-
-  while (true) {
-    ecl_file_view_type * rft_view = ecl_file_alloc_global_blockview(ecl_file, TIME_KW, block_nr);
-
-    if (rft_view) {
-      ecl_rft_node_type * rft_node = ecl_rft_node_alloc( rft_view );
-      if (rft_node != NULL) {
-        const char * well_name = ecl_rft_node_get_well_name( rft_node );
-        ecl_rft_file_add_node(rft_vector , rft_node);
-        if (!hash_has_key( rft_vector->well_index , well_name))
-          hash_insert_hash_owned_ref( rft_vector->well_index , well_name , int_vector_alloc( 0 , 0 ) , int_vector_free__);
-        {
-          int_vector_type * index_list = hash_get( rft_vector->well_index , well_name );
-          int_vector_append(index_list , global_index);
+  vector_type * block_list = vector_alloc_new();
+  bool * valid;
+  int num_blocks;
+
+  /* Split the keyword list in blocks starting with TIME - in one pass. */
+  {
+    ecl_file_type * ecl_file = ecl_file_open( filename , 0);
+    ecl_file_view_type * global_view = ecl_file_get_global_view( ecl_file );
+    ecl_rft_file_block_type * block = NULL;
+    int i;
+
+    for (i = 0; i < ecl_file_view_get_size( global_view ); i++) {
+      const ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( global_view , i );
+      if (strcmp( ecl_file_kw_get_header( file_kw ) , TIME_KW ) == 0) {
+        block = util_malloc( sizeof * block );
+        block->kw_list = vector_alloc_new();
+        block->offset = ecl_file_kw_get_offset( file_kw );
+        block->well_name = NULL;
+        block->date = -1;
+        block->node = NULL;
+        vector_append_ref( block_list , block );
+      }
+
+      if (block)
+        vector_append_owned_ref( block->kw_list , ecl_file_kw_alloc_copy( file_kw ) , ecl_file_kw_free__ );
+    }
+    ecl_file_close( ecl_file );
+  }
+
+  num_blocks = vector_get_size( block_list );
+  valid = util_calloc( util_int_max( 1 , num_blocks ) , sizeof * valid );
+
+  /* Take the well name and date from the sidecar index when possible. */
+  {
+    vector_type * index = ecl_rft_file_alloc_index( filename );
+    if (index) {
+      int index_nr = 0;
+      int block_nr;
+
+      for (block_nr = 0; block_nr < num_blocks; block_nr++) {
+        ecl_rft_file_block_type * block = vector_iget( block_list , block_nr );
+        while (index_nr < vector_get_size( index ) &&
+               ((const ecl_rft_file_block_type *) vector_iget_const( index , index_nr ))->offset < block->offset)
+          index_nr++;
+
+        if (index_nr < vector_get_size( index )) {
+          const ecl_rft_file_block_type * record = vector_iget_const( index , index_nr );
+          if (record->offset == block->offset) {
+            block->well_name = util_alloc_string_copy( record->well_name );
+            block->date = record->date;
+          }
         }
-        global_index++;
       }
-    } else
-      break;
+      vector_free( index );
+    }
+  }
+
+  if (num_blocks > 0) {
+    bool fmt_file;
+    if (!ecl_util_fmt_file( filename , &fmt_file ))
+      util_abort("%s: could not determine formatted/unformatted status of:%s \n",__func__ , filename);
 
-    block_nr++;
-    ecl_file_view_free( rft_view );
+#pragma omp parallel if (num_blocks > ECL_RFT_FILE_PARALLEL_SIZE)
+    {
+      fortio_type * fortio = fortio_open_reader( filename , fmt_file , ECL_ENDIAN_FLIP );
+      int block_nr;
+
+      if (fortio == NULL)
+        util_abort("%s: failed to open RFT file:%s \n",__func__ , filename);
+
+#pragma omp for schedule(dynamic, 16)
+      for (block_nr = 0; block_nr < num_blocks; block_nr++) {
+        ecl_rft_file_block_type * block = vector_iget( block_list , block_nr );
+        if (block->well_name)
+          valid[block_nr] = true;
+        else
+          valid[block_nr] = ecl_rft_file_block_load_header( block , fortio );
+      }
+
+      fortio_fclose( fortio );
+    }
   }
-  ecl_file_close( ecl_file );
+
+  {
+    int block_nr;
+    for (block_nr = 0; block_nr < num_blocks; block_nr++) {
+      ecl_rft_file_block_type * block = vector_iget( block_list , block_nr );
+      if (valid[block_nr]) {
+        int global_index = vector_append_owned_ref( rft_vector->data , block , ecl_rft_file_block_free__ );
+        ecl_rft_file_index_block( rft_vector , block , global_index );
+      } else {
+        fprintf(stderr,"%s: sorry SEGMENT PLT/RFT is not supported - file a complaint. \n",__func__);
+        ecl_rft_file_block_free__( block );
+      }
+    }
+  }
+  ecl_rft_file_build_time_index( rft_vector );
+
+  free( valid );
+  vector_free( block_list );
   return rft_vector;
 }
 
@@ -196,6 +587,9 @@ bool ecl_rft_file_case_has_rft( const char * case_input ) {
 void ecl_rft_file_free(ecl_rft_file_type * rft_vector) {
   vector_free(rft_vector->data);
   hash_free( rft_vector->well_index );
+  hash_free( rft_vector->time_index );
+  if (rft_vector->fortio)
+    fortio_fclose( rft_vector->fortio );
   free(rft_vector->filename);
   free(rft_vector);
 }
@@ -228,16 +622,16 @@ int ecl_rft_file_get_size__( const ecl_rft_file_type * rft_file, const char * we
     int match_count = 0;
     int i;
     for ( i=0; i < vector_get_size( rft_file->data ); i++) {
-      const ecl_rft_node_type * rft = vector_iget_const( rft_file->data , i);
+      const ecl_rft_file_block_type * block = vector_iget_const( rft_file->data , i);
 
       if (well_pattern) {
-        if (util_fnmatch( well_pattern , ecl_rft_node_get_well_name( rft )) != 0)
+        if (util_fnmatch( well_pattern , block->well_name ) != 0)
           continue;
       }
 
       /*OK - we either do not care about the well, or alternatively the well matches. */
       if (recording_time >= 0) {
-        if (recording_time != ecl_rft_node_get_date( rft ))
+        if (recording_time != block->date)
           continue;
       }
       match_count++;
@@ -274,7 +668,8 @@ const char * ecl_rft_file_get_filename( const ecl_rft_file_type * rft_file ) {
 */
 
 ecl_rft_node_type * ecl_rft_file_iget_node( const ecl_rft_file_type * rft_file , int index) {
-  return vector_iget( rft_file->data , index );
+  ecl_rft_file_block_type * block = vector_iget( rft_file->data , index );
+  return ecl_rft_file_block_get_node( (ecl_rft_file_type *) rft_file , block );
 }
 
 
@@ -311,24 +706,32 @@ ecl_rft_node_type * ecl_rft_file_iget_well_rft( const ecl_rft_file_type * rft_fi
 }
 
 
+/*
+  Binary search in the time index of the well; if the well has several
+  nodes with the same recording date the last in the file is returned,
+  i.e. nodes added with ecl_rft_file_append() supersede older nodes.
+*/
+
 static int ecl_rft_file_get_node_index_time_rft( const ecl_rft_file_type * rft_file , const char * well , time_t recording_time) {
   int global_index = -1;
-  if (hash_has_key( rft_file->well_index , well)) {
-    const int_vector_type * index_vector = hash_get(rft_file->well_index , well);
-    int well_index = 0;
-    while (true) {
-      if (well_index == int_vector_size( index_vector ))
-        break;
-
-      {
-        const ecl_rft_node_type * node = ecl_rft_file_iget_node( rft_file , int_vector_iget( index_vector , well_index ));
-        if (ecl_rft_node_get_date( node ) == recording_time) {
-          global_index = int_vector_iget( index_vector , well_index );
-          break;
-        }
-      }
+  if (hash_has_key( rft_file->time_index , well)) {
+    const int_vector_type * time_list = hash_get(rft_file->time_index , well);
+    int lower_index = 0;
+    int upper_index = int_vector_size( time_list );
+
+    while (lower_index < upper_index) {
+      int center_index = (lower_index + upper_index) / 2;
+      const ecl_rft_file_block_type * block = vector_iget_const( rft_file->data , int_vector_iget( time_list , center_index ));
+      if (block->date <= recording_time)
+        lower_index = center_index + 1;
+      else
+        upper_index = center_index;
+    }
 
-      well_index++;
+    if (lower_index > 0) {
+      const ecl_rft_file_block_type * block = vector_iget_const( rft_file->data , int_vector_iget( time_list , lower_index - 1 ));
+      if (block->date == recording_time)
+        global_index = int_vector_iget( time_list , lower_index - 1 );
     }
   }
   return global_index;
@@ -384,55 +787,213 @@ stringlist_type * ecl_rft_file_alloc_well_list(const ecl_rft_file_type * rft_fil
 
 
 
+/*
+  The new nodes are taken over by this function and freed when the
+  file has been written; a node in the file with the same well and
+  recording date as a new node is replaced.
+*/
+
 void ecl_rft_file_update(const char * rft_file_name, ecl_rft_node_type ** nodes,int num_nodes, ert_ecl_unit_enum unit_set){
-    ecl_rft_file_type * rft_file;
+    ecl_rft_file_type * rft_file = NULL;
+    vector_type * node_list = vector_alloc_new();
+    int node_index;
 
     if(util_file_exists(rft_file_name)){
-      int node_index;
       rft_file = ecl_rft_file_alloc( rft_file_name );
+      for(node_index = 0; node_index < ecl_rft_file_get_size( rft_file ); node_index++)
+        vector_append_ref( node_list , ecl_rft_file_iget_node( rft_file , node_index ));
+
       for(node_index = 0; node_index < num_nodes; node_index++) {
         ecl_rft_node_type * new_node = nodes[node_index];
         int storage_index = ecl_rft_file_get_node_index_time_rft(rft_file, ecl_rft_node_get_well_name(new_node), ecl_rft_node_get_date(new_node));
-        if (storage_index == -1) {
-          ecl_rft_file_add_node(rft_file, new_node);
-        } else {
-          vector_iset_owned_ref(rft_file->data, storage_index, new_node,ecl_rft_node_free__);
-        }
-      }
-    }else{
-      int node_index;
-      rft_file = ecl_rft_file_alloc_empty( rft_file_name );
-      for(node_index = 0; node_index < num_nodes; node_index++) {
-        ecl_rft_file_add_node(rft_file, nodes[node_index]);
+        if (storage_index == -1)
+          vector_append_ref( node_list , new_node );
+        else
+          vector_iset_ref( node_list , storage_index , new_node );
       }
+    } else {
+      for(node_index = 0; node_index < num_nodes; node_index++)
+        vector_append_ref( node_list , nodes[node_index] );
     }
 
     {
       bool fmt_file = false;
       fortio_type * fortio = fortio_open_writer( rft_file_name , fmt_file , ECL_ENDIAN_FLIP );
-      int node_index;
-
-      /**
-         The sorting here works directly on the internal node storage
-         rft_file->data; that might in principle ruin the indexing of
-         the ecl_file object - it is therefor absolutely essential
-         that this ecl_rft_file object does not live beyond this
-         function, and also that the ecl_rft_file api functions are
-         avoided for the rest of this function.
-      */
-
-      vector_sort(rft_file->data,(vector_cmp_ftype *) ecl_rft_node_cmp);
-      for(node_index=0; node_index < vector_get_size( rft_file->data ); node_index++) {
-        const ecl_rft_node_type *new_node = vector_iget_const(rft_file->data, node_index);
+
+      vector_sort(node_list,(vector_cmp_ftype *) ecl_rft_node_cmp);
+      for(node_index=0; node_index < vector_get_size( node_list ); node_index++) {
+        const ecl_rft_node_type *new_node = vector_iget_const(node_list, node_index);
         ecl_rft_node_fwrite(new_node, fortio, unit_set);
       }
 
       fortio_fclose( fortio );
     }
-    ecl_rft_file_free(rft_file);
+
+    {
+      char * index_file = ecl_rft_file_alloc_index_filename( rft_file_name );
+      util_unlink_existing( index_file );
+      free( index_file );
+    }
+
+    vector_free( node_list );
+    for(node_index = 0; node_index < num_nodes; node_index++)
+      ecl_rft_node_free( nodes[node_index] );
+
+    if (rft_file)
+      ecl_rft_file_free(rft_file);
 }
 
 
+/*
+  Will write all the nodes in @rft_file to the sidecar index; used to
+  (re)create the index for a file which does not have a valid index.
+*/
+
+static void ecl_rft_file_fwrite_index( const ecl_rft_file_type * rft_file ) {
+  char * index_file = ecl_rft_file_alloc_index_filename( rft_file->filename );
+  FILE * stream = util_fopen( index_file , "w");
+  int i;
+
+  for (i = 0; i < vector_get_size( rft_file->data ); i++) {
+    const ecl_rft_file_block_type * block = vector_iget_const( rft_file->data , i );
+    fprintf(stream , "NODE %lld %lld %s\n" , (long long) block->offset , (long long) block->date , block->well_name);
+  }
+  ecl_rft_file_fprintf_index_end( stream , rft_file->filename );
+
+  fclose( stream );
+  free( index_file );
+}
+
+
+/*
+  Will write the nodes in @nodes to @fortio, and the corresponding
+  NODE records to @index_stream. The DATE keyword only has day
+  resolution, so the date in the NODE record is normalized the same
+  way as when it is read back from the DATE keyword.
+*/
+
+static void ecl_rft_file_fwrite_nodes( fortio_type * fortio , FILE * index_stream , ecl_rft_node_type ** nodes , int num_nodes , ert_ecl_unit_enum unit_set) {
+  int node_index;
+  for (node_index = 0; node_index < num_nodes; node_index++) {
+    const ecl_rft_node_type * node = nodes[node_index];
+    offset_type offset = fortio_ftell( fortio );
+    time_t date;
+
+    {
+      int day , month , year;
+      ecl_util_set_date_values( ecl_rft_node_get_date( node ) , &day , &month , &year );
+      date = ecl_util_make_date( day , month , year );
+    }
+
+    ecl_rft_node_fwrite( node , fortio , unit_set );
+    fprintf(index_stream , "NODE %lld %lld %s\n" , (long long) offset , (long long) date , ecl_rft_node_get_well_name( node ));
+  }
+}
+
+
+/**
+   Will append the nodes in @nodes to the end of the RFT file
+   @rft_file_name, which is created if it does not exist. The existing
+   content of the file is not read or rewritten; the sidecar index is
+   updated with the new nodes, so the next ecl_rft_file_alloc() does
+   not have to read the headers of the new nodes.
+
+   The file is not sorted in time, and a node with the same well and
+   date as an existing node does not replace the old node in the file,
+   but will supersede it in ecl_rft_file_get_well_time_rft(). Use
+   ecl_rft_file_compact() to sort the file and remove the superseded
+   nodes.
+
+   In contrast to ecl_rft_file_update() the nodes are not taken over
+   by this function.
+*/
+
+void ecl_rft_file_append( const char * rft_file_name , ecl_rft_node_type ** nodes , int num_nodes , ert_ecl_unit_enum unit_set) {
+  char * index_file = ecl_rft_file_alloc_index_filename( rft_file_name );
+  bool fmt_file;
+  FILE * index_stream;
+
+  /* Works from the extension for a file which does not exist yet. */
+  if (!ecl_util_fmt_file( rft_file_name , &fmt_file ))
+    util_abort("%s: could not determine formatted/unformatted status of:%s \n",__func__ , rft_file_name);
+
+  if (util_file_exists( rft_file_name ) && util_file_size( rft_file_name ) > 0) {
+    vector_type * index = ecl_rft_file_alloc_index( rft_file_name );
+    if (index)
+      vector_free( index );
+    else {
+      ecl_rft_file_type * rft_file = ecl_rft_file_alloc( rft_file_name );
+      ecl_rft_file_fwrite_index( rft_file );
+      ecl_rft_file_free( rft_file );
+    }
+    index_stream = util_fopen( index_file , "a");
+  } else
+    index_stream = util_fopen( index_file , "w");
+
+  {
+    fortio_type * fortio = fortio_open_append( rft_file_name , fmt_file , ECL_ENDIAN_FLIP );
+    fortio_fseek( fortio , 0 , SEEK_END );
+    ecl_rft_file_fwrite_nodes( fortio , index_stream , nodes , num_nodes , unit_set );
+    fortio_fclose( fortio );
+  }
+
+  ecl_rft_file_fprintf_index_end( index_stream , rft_file_name );
+  fclose( index_stream );
+  free( index_file );
+}
+
+
+/**
+   Will rewrite the RFT file @rft_file_name sorted in time, and remove
+   nodes which have been superseded by a later node with the same well
+   and date. The sidecar index is recreated.
+*/
+
+void ecl_rft_file_compact( const char * rft_file_name , ert_ecl_unit_enum unit_set) {
+  ecl_rft_file_type * rft_file = ecl_rft_file_alloc( rft_file_name );
+  bool fmt_file;
+  const int size = ecl_rft_file_get_size( rft_file );
+  ecl_rft_file_time_node_type * time_nodes = util_calloc( util_int_max( 1 , size ) , sizeof * time_nodes );
+  ecl_rft_node_type ** nodes = util_calloc( util_int_max( 1 , size ) , sizeof * nodes );
+  int num_nodes = 0;
+  int i;
+
+  for (i = 0; i < size; i++) {
+    const ecl_rft_file_block_type * block = vector_iget_const( rft_file->data , i );
+    if (ecl_rft_file_get_node_index_time_rft( rft_file , block->well_name , block->date ) == i) {
+      ecl_rft_file_iget_node( rft_file , i );
+      time_nodes[num_nodes].date = block->date;
+      time_nodes[num_nodes].global_index = i;
+      num_nodes++;
+    }
+  }
+  qsort( time_nodes , num_nodes , sizeof * time_nodes , ecl_rft_file_time_node_cmp );
+  for (i = 0; i < num_nodes; i++)
+    nodes[i] = ecl_rft_file_iget_node( rft_file , time_nodes[i].global_index );
+
+  if (!ecl_util_fmt_file( rft_file_name , &fmt_file ))
+    util_abort("%s: could not determine formatted/unformatted status of:%s \n",__func__ , rft_file_name);
 
+  /* All the nodes are loaded; the file can be overwritten. */
+  if (rft_file->fortio) {
+    fortio_fclose( rft_file->fortio );
+    rft_file->fortio = NULL;
+  }
+
+  {
+    char * index_file = ecl_rft_file_alloc_index_filename( rft_file_name );
+    FILE * index_stream = util_fopen( index_file , "w");
+    fortio_type * fortio = fortio_open_writer( rft_file_name , fmt_file , ECL_ENDIAN_FLIP );
 
+    ecl_rft_file_fwrite_nodes( fortio , index_stream , nodes , num_nodes , unit_set );
+    fortio_fclose( fortio );
 
+    ecl_rft_file_fprintf_index_end( index_stream , rft_file_name );
+    fclose( index_stream );
+    free( index_file );
+  }
+
+  free( nodes );
+  free( time_nodes );
+  ecl_rft_file_free( rft_file );
+}
@@ -0,0 +1,502 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_rst_series.c' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/hash.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/time_t_vector.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_type.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_rsthead.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_rst_series.h>
+
+/*
+  The ecl_rst_series structure holds the values of a list of restart
+  keywords in a subset of the cells for all the report steps in a
+  restart file, i.e. the typical 'pressure history for these cells'
+  query. The values for each keyword are stored as a dense
+  [step x cell] array of doubles.
+
+  All the reads are planned up front from the index of the file,
+  without loading any of the restart keywords:
+
+    1. For each keyword a plan is made with the requested elements
+       sorted by their position in the keyword; elements which are
+       closer than ECL_RST_SERIES_MAX_GAP bytes on disk are coalesced
+       into one read, with at most ECL_RST_SERIES_MAX_RUN bytes in
+       one read. Since the layout of a keyword on disk depends
+       only on the size and type, the same plan is used for all the
+       report steps.
+
+    2. The (report step, keyword) pairs are then read in parallel,
+       every thread reads with its own FILE instance. For a case
+       opened with ecl_file_open_restart_case() the keywords come
+       from several files, and the reads are grouped by file.
+
+  Keywords which are missing in a report step get the value NAN in
+  that report step, and a keyword which is repeated in the keyword
+  list is only loaded once. Only unformatted files are supported.
+*/
+
+#define ECL_RST_SERIES_TYPE_ID  66158211
+
+/* Same as BLOCKSIZE_NUMERIC in ecl_kw.c */
+#define ECL_RST_SERIES_BLOCKSIZE  1000
+#define ECL_RST_SERIES_MAX_GAP    16384
+#define ECL_RST_SERIES_MAX_RUN    65536
+
+
+typedef struct {
+  int         element;
+  int         cell;
+} ecl_rst_series_element_type;
+
+
+typedef struct {
+  int                           element_count;
+  ecl_data_type                 data_type;
+  int                           element_size;
+  ecl_rst_series_element_type * elements;      /* Sorted on element. */
+  int                           num_runs;
+  int                         * run_start;     /* num_runs + 1 elements; run i is elements [run_start[i], run_start[i+1]). */
+  offset_type                   max_run_bytes;
+} ecl_rst_series_plan_type;
+
+
+typedef struct {
+  const char                     * filename;     /* The file the keyword comes from. */
+  offset_type                      data_offset;
+  const ecl_rst_series_plan_type * plan;
+  double                         * target;
+} ecl_rst_series_read_type;
+
+
+struct ecl_rst_series_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int                   num_steps;
+  int                   num_cells;
+  int_vector_type     * report_steps;
+  time_t_vector_type  * sim_time;
+  hash_type           * data;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_rst_series , ECL_RST_SERIES_TYPE_ID )
+
+
+/*
+  Offset of element @element relative to the start of the data
+  section of the keyword, i.e. the position right after the header.
+*/
+
+static offset_type ecl_rst_series_element_offset( int element , int element_size ) {
+  offset_type block = element / ECL_RST_SERIES_BLOCKSIZE;
+  offset_type block_bytes = (offset_type) ECL_RST_SERIES_BLOCKSIZE * element_size + 8;
+  return 4 + block * block_bytes + (offset_type) (element % ECL_RST_SERIES_BLOCKSIZE) * element_size;
+}
+
+
+static int ecl_rst_series_element_cmp( const void * arg1 , const void * arg2 ) {
+  const ecl_rst_series_element_type * e1 = arg1;
+  const ecl_rst_series_element_type * e2 = arg2;
+
+  if (e1->element != e2->element)
+    return (e1->element < e2->element) ? -1 : 1;
+  return e1->cell - e2->cell;
+}
+
+
+static ecl_rst_series_plan_type * ecl_rst_series_plan_alloc( const ecl_grid_type * grid , const int_vector_type * cells , bool global_cells ,
+                                                             const char * kw , int element_count , ecl_data_type data_type) {
+  const int num_cells = int_vector_size( cells );
+  const bool global_kw = (element_count == ecl_grid_get_global_size( grid ));
+  ecl_rst_series_plan_type * plan = util_malloc( sizeof * plan );
+  int i;
+
+  if (!global_kw && (element_count != ecl_grid_get_active_size( grid )))
+    util_abort("%s: keyword:%s has %d elements - grid has %d active and %d cells \n",__func__ , kw , element_count ,
+               ecl_grid_get_active_size( grid ) , ecl_grid_get_global_size( grid ));
+
+  if (!(ecl_type_is_float( data_type ) || ecl_type_is_double( data_type ) || ecl_type_is_int( data_type )))
+    util_abort("%s: keyword:%s is of type %s - only float, double and int keywords are supported \n",__func__ , kw ,
+               ecl_type_get_name( data_type ));
+
+  plan->element_count = element_count;
+  memcpy( &plan->data_type , &data_type , sizeof data_type );
+  plan->element_size  = ecl_type_get_sizeof_ctype( data_type );
+  plan->elements      = util_calloc( util_int_max( 1 , num_cells ) , sizeof * plan->elements );
+  plan->run_start     = util_calloc( num_cells + 1 , sizeof * plan->run_start );
+  plan->num_runs      = 0;
+  plan->max_run_bytes = 0;
+
+  for (i = 0; i < num_cells; i++) {
+    int index = int_vector_iget( cells , i );
+    int element;
+
+    if (global_cells) {
+      if (global_kw)
+        element = index;
+      else {
+        element = ecl_grid_get_active_index1( grid , index );
+        if (element < 0)
+          util_abort("%s: cell:%d is not active - can not be looked up in keyword:%s \n",__func__ , index , kw);
+      }
+    } else
+      element = global_kw ? ecl_grid_get_global_index1A( grid , index ) : index;
+
+    if ((element < 0) || (element >= element_count))
+      util_abort("%s: cell index:%d is out of range for keyword:%s \n",__func__ , index , kw);
+
+    plan->elements[i].element = element;
+    plan->elements[i].cell    = i;
+  }
+  qsort( plan->elements , num_cells , sizeof * plan->elements , ecl_rst_series_element_cmp );
+
+  {
+    offset_type run_offset = 0;
+    for (i = 0; i < num_cells; i++) {
+      offset_type offset = ecl_rst_series_element_offset( plan->elements[i].element , plan->element_size );
+      bool new_run = (i == 0);
+      if (!new_run) {
+        offset_type prev_end = ecl_rst_series_element_offset( plan->elements[i-1].element , plan->element_size ) + plan->element_size;
+        new_run = (offset - prev_end > ECL_RST_SERIES_MAX_GAP) || (offset + plan->element_size - run_offset > ECL_RST_SERIES_MAX_RUN);
+      }
+
+      if (new_run) {
+        run_offset = offset;
+        plan->run_start[ plan->num_runs ] = i;
+        plan->num_runs++;
+      }
+    }
+  }
+  plan->run_start[ plan->num_runs ] = num_cells;
+
+  for (i = 0; i < plan->num_runs; i++) {
+    int first = plan->elements[ plan->run_start[i] ].element;
+    int last  = plan->elements[ plan->run_start[i + 1] - 1 ].element;
+    offset_type run_bytes = ecl_rst_series_element_offset( last , plan->element_size ) + plan->element_size -
+                            ecl_rst_series_element_offset( first , plan->element_size );
+    if (run_bytes > plan->max_run_bytes)
+      plan->max_run_bytes = run_bytes;
+  }
+
+  return plan;
+}
+
+
+static void ecl_rst_series_plan_free( ecl_rst_series_plan_type * plan ) {
+  free( plan->elements );
+  free( plan->run_start );
+  free( plan );
+}
+
+
+static void ecl_rst_series_plan_free__( void * arg ) {
+  ecl_rst_series_plan_free( (ecl_rst_series_plan_type *) arg );
+}
+
+
+static double ecl_rst_series_get_value( const char * ptr , ecl_data_type data_type , int element_size ) {
+  char value[8];
+
+  memcpy( value , ptr , element_size );
+  if (ECL_ENDIAN_FLIP)
+    util_endian_flip_vector( value , element_size , 1 );
+
+  if (ecl_type_is_float( data_type ))
+    return *((float *) value);
+  else if (ecl_type_is_double( data_type ))
+    return *((double *) value);
+  else
+    return *((int *) value);
+}
+
+
+static int ecl_rst_series_read_cmp( const void * arg1 , const void * arg2 ) {
+  const ecl_rst_series_read_type * read1 = arg1;
+  const ecl_rst_series_read_type * read2 = arg2;
+  int cmp = strcmp( read1->filename , read2->filename );
+
+  if (cmp != 0)
+    return cmp;
+  else if (read1->data_offset < read2->data_offset)
+    return -1;
+  else if (read1->data_offset > read2->data_offset)
+    return 1;
+  else
+    return 0;
+}
+
+
+static void ecl_rst_series_read( const ecl_rst_series_read_type * read , FILE * stream , char * buffer ) {
+  const char * filename = read->filename;
+  const ecl_rst_series_plan_type * plan = read->plan;
+  int run;
+
+  for (run = 0; run < plan->num_runs; run++) {
+    const int first = plan->run_start[run];
+    const int last  = plan->run_start[run + 1] - 1;
+    const offset_type run_offset = ecl_rst_series_element_offset( plan->elements[first].element , plan->element_size );
+    const offset_type run_bytes  = ecl_rst_series_element_offset( plan->elements[last].element , plan->element_size ) + plan->element_size - run_offset;
+    int i;
+
+    if (util_fseek( stream , read->data_offset + run_offset , SEEK_SET ) != 0)
+      util_abort("%s: failed to seek in:%s \n",__func__ , filename);
+    util_fread( buffer , 1 , run_bytes , stream , __func__ );
+
+    for (i = first; i <= last; i++) {
+      const ecl_rst_series_element_type * element = &plan->elements[i];
+      offset_type pos = ecl_rst_series_element_offset( element->element , plan->element_size ) - run_offset;
+      read->target[ element->cell ] = ecl_rst_series_get_value( &buffer[pos] , plan->data_type , plan->element_size );
+    }
+  }
+}
+
+
+/*
+  Will go through the index of the file and find, for each report
+  step, the first occurence of the keywords in @kw_list. The result
+  is stored in @kw_index as [step * num_kw + kw] with -1 for missing
+  keywords. The report steps are delimited by the SEQNUM keyword; a
+  file without SEQNUM keywords is a non unified restart file with one
+  report step.
+*/
+
+static void ecl_rst_series_scan( ecl_rst_series_type * series , const ecl_file_view_type * view , const char * filename ,
+                                 const stringlist_type * kw_list , int_vector_type * kw_index) {
+  const int num_kw = stringlist_get_size( kw_list );
+  int step = -1;
+  int i;
+
+  if (!ecl_file_view_has_kw( view , SEQNUM_KW )) {
+    int_vector_append( series->report_steps , ecl_util_filename_report_nr( filename ));
+    time_t_vector_append( series->sim_time , -1 );
+    int_vector_resize( kw_index , num_kw );
+    step = 0;
+  }
+
+  for (i = 0; i < ecl_file_view_get_size( view ); i++) {
+    const char * header = ecl_file_view_iget_header( view , i );
+
+    if (strcmp( header , SEQNUM_KW ) == 0) {
+      const ecl_kw_type * seqnum_kw = ecl_file_view_iget_kw( view , i );
+      step++;
+      int_vector_append( series->report_steps , ecl_kw_iget_int( seqnum_kw , 0 ));
+      time_t_vector_append( series->sim_time , -1 );
+      int_vector_resize( kw_index , (step + 1) * num_kw );
+    } else if (step >= 0) {
+      if ((strcmp( header , INTEHEAD_KW ) == 0) && (time_t_vector_iget( series->sim_time , step ) == -1)) {
+        const ecl_kw_type * intehead_kw = ecl_file_view_iget_kw( view , i );
+        time_t_vector_iset( series->sim_time , step , ecl_rsthead_date( intehead_kw ));
+      } else {
+        int kw_nr = stringlist_find_first( kw_list , header );
+        if ((kw_nr >= 0) && (int_vector_iget( kw_index , step * num_kw + kw_nr ) < 0))
+          int_vector_iset( kw_index , step * num_kw + kw_nr , i );
+      }
+    }
+  }
+  series->num_steps = step + 1;
+}
+
+
+ecl_rst_series_type * ecl_rst_series_alloc( ecl_file_type * restart_file , const ecl_grid_type * grid , const stringlist_type * input_kw_list ,
+                                            const int_vector_type * cells , bool global_cells) {
+  const char * filename = ecl_file_get_src_file( restart_file );
+  const char * checked_file = NULL;
+  const ecl_file_view_type * view = ecl_file_get_global_view( restart_file );
+  stringlist_type * kw_list = stringlist_alloc_new( );
+  int num_kw;
+  ecl_rst_series_type * series = util_malloc( sizeof * series );
+  int_vector_type * kw_index = int_vector_alloc( 0 , -1 );
+  hash_type * plans = hash_alloc( );
+  ecl_rst_series_read_type * reads;
+  int num_reads = 0;
+  offset_type max_run_bytes = 0;
+
+  {
+    int i;
+    for (i = 0; i < stringlist_get_size( input_kw_list ); i++) {
+      const char * kw = stringlist_iget( input_kw_list , i );
+      if (!stringlist_contains( kw_list , kw ))
+        stringlist_append_copy( kw_list , kw );
+    }
+    num_kw = stringlist_get_size( kw_list );
+  }
+
+  UTIL_TYPE_ID_INIT( series , ECL_RST_SERIES_TYPE_ID );
+  series->num_cells    = int_vector_size( cells );
+  series->report_steps = int_vector_alloc( 0 , 0 );
+  series->sim_time     = time_t_vector_alloc( 0 , -1 );
+  series->data         = hash_alloc( );
+
+  ecl_rst_series_scan( series , view , filename , kw_list , kw_index );
+  reads = util_calloc( util_int_max( 1 , series->num_steps * num_kw ) , sizeof * reads );
+
+  {
+    int kw_nr;
+    for (kw_nr = 0; kw_nr < num_kw; kw_nr++) {
+      const char * kw = stringlist_iget( kw_list , kw_nr );
+      const size_t data_size = util_int_max( 1 , series->num_steps * series->num_cells );
+      double * data = util_calloc( data_size , sizeof * data );
+      ecl_rst_series_plan_type * plan = NULL;
+      int step;
+      size_t k;
+
+      for (k = 0; k < data_size; k++)
+        data[k] = NAN;
+
+      for (step = 0; step < series->num_steps; step++) {
+        int index = int_vector_iget( kw_index , step * num_kw + kw_nr );
+        if (index >= 0) {
+          const ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( view , index );
+          const int element_count = ecl_file_kw_get_size( file_kw );
+          const ecl_data_type data_type = ecl_file_kw_get_data_type( file_kw );
+
+          if (plan == NULL) {
+            plan = ecl_rst_series_plan_alloc( grid , cells , global_cells , kw , element_count , data_type );
+            hash_insert_hash_owned_ref( plans , kw , plan , ecl_rst_series_plan_free__ );
+            if (plan->max_run_bytes > max_run_bytes)
+              max_run_bytes = plan->max_run_bytes;
+          } else if ((plan->element_count != element_count) || !ecl_type_is_equal( plan->data_type , data_type ))
+            util_abort("%s: keyword:%s changes size or type between report steps \n",__func__ , kw);
+
+          reads[num_reads].filename    = ecl_file_view_iget_src_file( view , index );
+          reads[num_reads].data_offset = ecl_file_kw_get_offset( file_kw ) + ECL_KW_HEADER_FORTIO_SIZE;
+          if (!util_string_equal( checked_file , reads[num_reads].filename )) {
+            bool fmt_file;
+            checked_file = reads[num_reads].filename;
+            if (!ecl_util_fmt_file( checked_file , &fmt_file ) || fmt_file)
+              util_abort("%s: only unformatted restart files are supported - %s \n",__func__ , checked_file);
+          }
+          reads[num_reads].plan        = plan;
+          reads[num_reads].target      = &data[ (size_t) step * series->num_cells ];
+          num_reads++;
+        }
+      }
+      hash_insert_hash_owned_ref( series->data , kw , data , free );
+    }
+  }
+
+  /*
+    The reads are grouped by file, and every thread only reopens its
+    stream when it moves on to a read from another file; i.e. for a
+    case opened with ecl_file_open_restart_case() each thread opens
+    each file at most once.
+  */
+  if ((series->num_cells > 0) && (num_reads > 0)) {
+    qsort( reads , num_reads , sizeof * reads , ecl_rst_series_read_cmp );
+
+#pragma omp parallel
+    {
+      FILE * stream = NULL;
+      const char * stream_file = NULL;
+      char * buffer = util_malloc( util_int_max( 1 , max_run_bytes ));
+      int read_nr;
+
+#pragma omp for schedule(dynamic)
+      for (read_nr = 0; read_nr < num_reads; read_nr++) {
+        const ecl_rst_series_read_type * read = &reads[read_nr];
+        if (!util_string_equal( stream_file , read->filename )) {
+          if (stream)
+            fclose( stream );
+          stream = util_fopen( read->filename , "r" );
+          stream_file = read->filename;
+        }
+        ecl_rst_series_read( read , stream , buffer );
+      }
+
+      free( buffer );
+      if (stream)
+        fclose( stream );
+    }
+  }
+
+  free( reads );
+  hash_free( plans );
+  int_vector_free( kw_index );
+  stringlist_free( kw_list );
+  return series;
+}
+
+
+void ecl_rst_series_free( ecl_rst_series_type * series ) {
+  int_vector_free( series->report_steps );
+  time_t_vector_free( series->sim_time );
+  hash_free( series->data );
+  free( series );
+}
+
+
+int ecl_rst_series_get_num_steps( const ecl_rst_series_type * series ) {
+  return series->num_steps;
+}
+
+
+int ecl_rst_series_get_num_cells( const ecl_rst_series_type * series ) {
+  return series->num_cells;
+}
+
+
+int ecl_rst_series_iget_report_step( const ecl_rst_series_type * series , int step ) {
+  return int_vector_iget( series->report_steps , step );
+}
+
+
+time_t ecl_rst_series_iget_sim_time( const ecl_rst_series_type * series , int step ) {
+  return time_t_vector_iget( series->sim_time , step );
+}
+
+
+bool ecl_rst_series_has_kw( const ecl_rst_series_type * series , const char * kw ) {
+  return hash_has_key( series->data , kw );
+}
+
+
+/*
+  The values are stored as data[step * num_cells + cell], where cell
+  is the position in the cell list passed to ecl_rst_series_alloc().
+*/
+
+const double * ecl_rst_series_get_data( const ecl_rst_series_type * series , const char * kw ) {
+  return hash_get( series->data , kw );
+}
+
+
+double ecl_rst_series_iget( const ecl_rst_series_type * series , const char * kw , int step , int cell ) {
+  const double * data = ecl_rst_series_get_data( series , kw );
+
+  if ((step < 0) || (step >= series->num_steps) || (cell < 0) || (cell >= series->num_cells))
+    util_abort("%s: invalid step:%d / cell:%d \n",__func__ , step , cell);
+
+  return data[ (size_t) step * series->num_cells + cell ];
+}
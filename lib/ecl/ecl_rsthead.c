@@ -107,7 +107,23 @@ ecl_rsthead_type * ecl_rsthead_alloc_from_kw( int report_step , const ecl_kw_typ
 */
 
 
+/*
+  If the view has a SEQNUM keyword the header is copied from the
+  restart header table of the view, see ecl_file_view_iget_rsthead(),
+  so repeated calls for the same view do not inspect the header
+  keywords again. The table is only built here for a view with one
+  SEQNUM block; for a larger view which does not have the table yet
+  only the header keywords of the first block are read.
+*/
+
 ecl_rsthead_type * ecl_rsthead_alloc( const ecl_file_view_type * rst_view, int report_step) {
+  if (ecl_file_view_has_kw( rst_view , SEQNUM_KW) &&
+      (ecl_file_view_has_rsthead_table( rst_view ) || ecl_file_view_get_num_named_kw( rst_view , SEQNUM_KW ) == 1)) {
+    const ecl_rsthead_type * rsthead = ecl_file_view_iget_rsthead( rst_view , 0 );
+    if (rsthead)
+      return util_alloc_copy( rsthead , sizeof * rsthead );
+  }
+
   const ecl_kw_type * intehead_kw = ecl_file_view_iget_named_kw( rst_view , INTEHEAD_KW , 0);
   const ecl_kw_type * doubhead_kw = ecl_file_view_iget_named_kw( rst_view , DOUBHEAD_KW , 0);
   const ecl_kw_type * logihead_kw = NULL;
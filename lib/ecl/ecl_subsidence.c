@@ -26,6 +26,8 @@
 #include <ert/util/util.h>
 #include <ert/util/vector.h>
 
+#include <ert/geometry/geo_surface.h>
+
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_file.h>
@@ -35,6 +37,7 @@
 #include <ert/ecl/ecl_grid_cache.h>
 #include <ert/ecl/ecl_kw_magic.h>
 #include <ert/ecl/ecl_grav_common.h>
+#include <ert/ecl/ecl_grav_tree.h>
 
 
 /**
@@ -164,18 +167,20 @@ static double ecl_subsidence_survey_eval( const ecl_subsidence_survey_type * bas
 }
 
 
-static double ecl_subsidence_survey_eval_geertsma( const ecl_subsidence_survey_type * base_survey ,
-                                                   const ecl_subsidence_survey_type * monitor_survey,
-                                                   ecl_region_type * region ,
-                                                   double utm_x , double utm_y , double depth,
-                                                   double youngs_modulus, double poisson_ratio, double seabed) {
+/*
+  The weight of each cell in the Geertsma sum; this depends only on
+  the surveys and the elastic parameters and not on the station, so
+  it is computed once and reused for all stations.
+*/
 
+static double * ecl_subsidence_survey_alloc_geertsma_weight( const ecl_subsidence_survey_type * base_survey ,
+                                                             const ecl_subsidence_survey_type * monitor_survey,
+                                                             double youngs_modulus, double poisson_ratio) {
   const ecl_grid_cache_type * grid_cache = base_survey->grid_cache;
   const double * cell_volume = ecl_grid_cache_get_volume( grid_cache );
   const int size  = ecl_grid_cache_get_size( grid_cache );
   double scale_factor = 1e4 *(1 + poisson_ratio) * ( 1 - 2*poisson_ratio) / ( 4*M_PI*( 1 - poisson_ratio)  * youngs_modulus );
   double * weight = util_calloc( size , sizeof * weight );
-  double deltaz;
 
   for (int index = 0; index < size; index++) {
     if (monitor_survey) {
@@ -185,6 +190,20 @@ static double ecl_subsidence_survey_eval_geertsma( const ecl_subsidence_survey_t
     }
   }
 
+  return weight;
+}
+
+
+static double ecl_subsidence_survey_eval_geertsma( const ecl_subsidence_survey_type * base_survey ,
+                                                   const ecl_subsidence_survey_type * monitor_survey,
+                                                   ecl_region_type * region ,
+                                                   double utm_x , double utm_y , double depth,
+                                                   double youngs_modulus, double poisson_ratio, double seabed) {
+
+  const ecl_grid_cache_type * grid_cache = base_survey->grid_cache;
+  double * weight = ecl_subsidence_survey_alloc_geertsma_weight( base_survey , monitor_survey , youngs_modulus , poisson_ratio );
+  double deltaz;
+
   deltaz = ecl_grav_common_eval_geertsma( grid_cache , region , base_survey->aquifer_cell , weight , utm_x , utm_y , depth , poisson_ratio, seabed);
 
   free( weight );
@@ -192,6 +211,48 @@ static double ecl_subsidence_survey_eval_geertsma( const ecl_subsidence_survey_t
 }
 
 
+static void ecl_subsidence_survey_eval_geertsma_stations( const ecl_subsidence_survey_type * base_survey ,
+                                                          const ecl_subsidence_survey_type * monitor_survey,
+                                                          ecl_region_type * region ,
+                                                          int num_stations ,
+                                                          const double * utm_x , const double * utm_y , const double * depth,
+                                                          double youngs_modulus, double poisson_ratio, double seabed,
+                                                          double * deltaz) {
+
+  const ecl_grid_cache_type * grid_cache = base_survey->grid_cache;
+  double * weight = ecl_subsidence_survey_alloc_geertsma_weight( base_survey , monitor_survey , youngs_modulus , poisson_ratio );
+
+  ecl_grav_common_eval_geertsma_stations( grid_cache , region , base_survey->aquifer_cell , weight ,
+                                          num_stations , utm_x , utm_y , depth , poisson_ratio , seabed , deltaz );
+  free( weight );
+}
+
+
+static void ecl_subsidence_survey_eval_geertsma_stations_approx( const ecl_subsidence_survey_type * base_survey ,
+                                                                 const ecl_subsidence_survey_type * monitor_survey,
+                                                                 ecl_region_type * region ,
+                                                                 int num_stations ,
+                                                                 const double * utm_x , const double * utm_y , const double * depth,
+                                                                 double youngs_modulus, double poisson_ratio, double seabed,
+                                                                 double theta , double * deltaz , double * error_bound) {
+
+  double * weight = ecl_subsidence_survey_alloc_geertsma_weight( base_survey , monitor_survey , youngs_modulus , poisson_ratio );
+  ecl_grav_tree_type * tree = ecl_grav_tree_alloc( base_survey->grid_cache , region , base_survey->aquifer_cell , weight , ECL_GRAV_TREE_LEAF_SIZE );
+  int station;
+
+#pragma omp parallel for schedule(dynamic)
+  for (station = 0; station < num_stations; station++) {
+    double error;
+    deltaz[station] = ecl_grav_tree_eval_geertsma( tree , theta , utm_x[station] , utm_y[station] , depth[station] , poisson_ratio , seabed , &error );
+    if (error_bound)
+      error_bound[station] = error;
+  }
+
+  ecl_grav_tree_free( tree );
+  free( weight );
+}
+
+
 
 /*****************************************************************/
 /**
@@ -204,7 +265,8 @@ static double ecl_subsidence_survey_eval_geertsma( const ecl_subsidence_survey_t
 ecl_subsidence_type * ecl_subsidence_alloc( const ecl_grid_type * ecl_grid, const ecl_file_type * init_file) {
   ecl_subsidence_type * ecl_subsidence = util_malloc( sizeof * ecl_subsidence );
   ecl_subsidence->init_file      = init_file;
-  ecl_subsidence->grid_cache     = ecl_grid_cache_alloc( ecl_grid );
+  ecl_subsidence->grid_cache     = ecl_grid_get_cache( ecl_grid );
+  ecl_grid_cache_get_volume( ecl_subsidence->grid_cache );  /* The volumes need the grid; evaluate them while it is available. */
   ecl_subsidence->aquifer_cell   = ecl_grav_common_alloc_aquifer_cell( ecl_subsidence->grid_cache , init_file );
 
   ecl_subsidence->surveys        = hash_alloc();
@@ -253,6 +315,72 @@ double ecl_subsidence_eval_geertsma( const ecl_subsidence_type * subsidence , co
   return ecl_subsidence_survey_eval_geertsma( base_survey , monitor_survey , region , utm_x , utm_y , depth , youngs_modulus, poisson_ratio, seabed);
 }
 
+
+void ecl_subsidence_eval_geertsma_stations( const ecl_subsidence_type * subsidence , const char * base, const char * monitor , ecl_region_type * region ,
+                                            int num_stations , const double * utm_x, const double * utm_y , const double * depth,
+                                            double youngs_modulus, double poisson_ratio, double seabed,
+                                            double * deltaz) {
+  ecl_subsidence_survey_type * base_survey    = ecl_subsidence_get_survey( subsidence , base );
+  ecl_subsidence_survey_type * monitor_survey = ecl_subsidence_get_survey( subsidence , monitor );
+  ecl_subsidence_survey_eval_geertsma_stations( base_survey , monitor_survey , region , num_stations , utm_x , utm_y , depth ,
+                                                youngs_modulus , poisson_ratio , seabed , deltaz );
+}
+
+
+/**
+   Approximate version of ecl_subsidence_eval_geertsma_stations() based
+   on an octree over the cells, see ecl_grav_tree.c for the meaning of
+   @theta. If @error_bound is non NULL it should point to an array of
+   @num_stations elements which is filled with an upper bound for the
+   absolute error of each deltaz value.
+*/
+
+void ecl_subsidence_eval_geertsma_stations_approx( const ecl_subsidence_type * subsidence , const char * base, const char * monitor , ecl_region_type * region ,
+                                                   int num_stations , const double * utm_x, const double * utm_y , const double * depth,
+                                                   double youngs_modulus, double poisson_ratio, double seabed,
+                                                   double theta , double * deltaz , double * error_bound) {
+  ecl_subsidence_survey_type * base_survey    = ecl_subsidence_get_survey( subsidence , base );
+  ecl_subsidence_survey_type * monitor_survey = ecl_subsidence_get_survey( subsidence , monitor );
+  ecl_subsidence_survey_eval_geertsma_stations_approx( base_survey , monitor_survey , region , num_stations , utm_x , utm_y , depth ,
+                                                       youngs_modulus , poisson_ratio , seabed , theta , deltaz , error_bound );
+}
+
+
+/*
+  Will evaluate the Geertsma subsidence at all the nodes of @surface,
+  with the stations at the given depth, and store the result as the
+  z values of the surface; the surface can then be saved with
+  geo_surface_fprintf_irap().
+*/
+
+void ecl_subsidence_eval_geertsma_surface( const ecl_subsidence_type * subsidence , const char * base, const char * monitor , ecl_region_type * region ,
+                                           geo_surface_type * surface , double depth,
+                                           double youngs_modulus, double poisson_ratio, double seabed) {
+  const int num_stations = geo_surface_get_size( surface );
+  double * utm_x  = util_calloc( util_int_max( 1 , num_stations ) , sizeof * utm_x );
+  double * utm_y  = util_calloc( util_int_max( 1 , num_stations ) , sizeof * utm_y );
+  double * zdepth = util_calloc( util_int_max( 1 , num_stations ) , sizeof * zdepth );
+  double * deltaz = util_calloc( util_int_max( 1 , num_stations ) , sizeof * deltaz );
+  int i;
+
+  for (i = 0; i < num_stations; i++) {
+    geo_surface_iget_xy( surface , i , &utm_x[i] , &utm_y[i] );
+    zdepth[i] = depth;
+  }
+
+  ecl_subsidence_eval_geertsma_stations( subsidence , base , monitor , region , num_stations , utm_x , utm_y , zdepth ,
+                                         youngs_modulus , poisson_ratio , seabed , deltaz );
+
+  for (i = 0; i < num_stations; i++)
+    geo_surface_iset_zvalue( surface , i , deltaz[i] );
+
+  free( utm_x );
+  free( utm_y );
+  free( zdepth );
+  free( deltaz );
+}
+
+
 void ecl_subsidence_free( ecl_subsidence_type * ecl_subsidence ) {
   ecl_grid_cache_free( ecl_subsidence->grid_cache );
   free( ecl_subsidence->aquifer_cell );
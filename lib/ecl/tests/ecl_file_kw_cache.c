@@ -0,0 +1,218 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_file_kw_cache.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_rsthead.h>
+#include <ert/ecl/fortio.h>
+
+#include "well_test_restart.h"
+
+
+#define NUM_KW    10
+#define KW_SIZE 1000
+#define KW_BYTES (KW_SIZE * sizeof(float))
+
+
+static void write_file( const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  int i;
+  for (i = 0; i < NUM_KW; i++) {
+    ecl_kw_type * kw = ecl_kw_alloc( "DATA" , KW_SIZE , ECL_FLOAT );
+    ecl_kw_scalar_set_float( kw , i );
+    ecl_kw_fwrite( kw , fortio );
+    ecl_kw_free( kw );
+  }
+  fortio_fclose( fortio );
+}
+
+
+/* Probing with ecl_file_kw_get_kw_ptr() takes a reference which is released again. */
+
+static bool kw_loaded( ecl_file_type * ecl_file , int index ) {
+  ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( ecl_file_get_global_view( ecl_file ) , index );
+  ecl_kw_type * kw = ecl_file_kw_get_kw_ptr( file_kw );
+  if (kw) {
+    ecl_file_release_kw( ecl_file , kw );
+    return true;
+  } else
+    return false;
+}
+
+
+static void assert_loaded( ecl_file_type * ecl_file , int first , int last ) {
+  int i;
+  for (i = 0; i < NUM_KW; i++)
+    test_assert_bool_equal( (i >= first) && (i <= last) , kw_loaded( ecl_file , i ));
+}
+
+
+static void release_all( ecl_file_type * ecl_file , int count ) {
+  int i , n;
+  for (i = 0; i < NUM_KW; i++) {
+    ecl_kw_type * kw = ecl_file_iget_named_kw( ecl_file , "DATA" , i );
+    for (n = 0; n <= count; n++)
+      ecl_file_release_kw( ecl_file , kw );
+  }
+}
+
+
+static void test_budget( const char * filename ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , 0 );
+  ecl_file_view_type * view = ecl_file_get_global_view( ecl_file );
+  int i;
+
+  test_assert_size_t_equal( 0 , ecl_file_get_memory_budget( ecl_file ));
+  for (i = 0; i < NUM_KW; i++)
+    test_assert_float_equal( i , ecl_kw_iget_float( ecl_file_iget_named_kw( ecl_file , "DATA" , i ) , 0 ));
+  for (i = 0; i < NUM_KW; i++)
+    ecl_file_iget_named_kw( ecl_file , "DATA" , i );
+
+  test_assert_size_t_equal( NUM_KW , ecl_file_get_cache_misses( ecl_file ));
+  test_assert_size_t_equal( NUM_KW , ecl_file_get_cache_hits( ecl_file ));
+  test_assert_size_t_equal( NUM_KW * KW_BYTES , ecl_file_get_resident_bytes( ecl_file ));
+  test_assert_size_t_equal( 0 , ecl_file_get_cache_evictions( ecl_file ));
+
+  /* Keywords which have not been released are never evicted. */
+  ecl_file_set_memory_budget( ecl_file , 3 * KW_BYTES );
+  test_assert_size_t_equal( NUM_KW * KW_BYTES , ecl_file_get_resident_bytes( ecl_file ));
+  test_assert_size_t_equal( 0 , ecl_file_get_cache_evictions( ecl_file ));
+
+  /*
+    Each keyword has been fetched twice; release_all() fetches it a
+    third time and releases all three references. The released
+    keywords are evicted in LRU order until the budget is met.
+  */
+  release_all( ecl_file , 2 );
+  test_assert_size_t_equal( 3 * KW_BYTES , ecl_file_get_resident_bytes( ecl_file ));
+  test_assert_size_t_equal( NUM_KW - 3 , ecl_file_get_cache_evictions( ecl_file ));
+  assert_loaded( ecl_file , NUM_KW - 3 , NUM_KW - 1 );
+
+  /* A hit moves the keyword to the back of the LRU list; a load never evicts. */
+  ecl_file_iget_named_kw( ecl_file , "DATA" , NUM_KW - 3 );
+  {
+    ecl_kw_type * kw0 = ecl_file_iget_named_kw( ecl_file , "DATA" , 0 );
+    test_assert_size_t_equal( 4 * KW_BYTES , ecl_file_get_resident_bytes( ecl_file ));
+    test_assert_float_equal( 0 , ecl_kw_iget_float( kw0 , KW_SIZE - 1 ));
+    ecl_file_release_kw( ecl_file , kw0 );
+  }
+  test_assert_size_t_equal( NUM_KW + 1 , ecl_file_get_cache_misses( ecl_file ));
+  test_assert_size_t_equal( 3 * KW_BYTES , ecl_file_get_resident_bytes( ecl_file ));
+  test_assert_true( kw_loaded( ecl_file , NUM_KW - 3 ));
+  test_assert_false( kw_loaded( ecl_file , NUM_KW - 2 ));
+
+  /*
+    Keywords loaded in a transaction are dropped when it ends; a
+    keyword which was released, but still resident, when the
+    transaction started is kept.
+  */
+  {
+    ecl_kw_type * kw5 = ecl_file_iget_named_kw( ecl_file , "DATA" , 5 );
+    ecl_file_release_kw( ecl_file , kw5 );
+    test_assert_size_t_equal( 3 * KW_BYTES , ecl_file_get_resident_bytes( ecl_file ));
+    test_assert_true( kw_loaded( ecl_file , 5 ));
+  }
+  {
+    ecl_file_transaction_type * t = ecl_file_view_start_transaction( view );
+    for (i = 1; i < 6; i++)
+      test_assert_float_equal( i , ecl_kw_iget_float( ecl_file_view_iget_kw( view , i ) , 0 ));
+    test_assert_size_t_equal( 7 * KW_BYTES , ecl_file_get_resident_bytes( ecl_file ));
+    ecl_file_view_end_transaction( view , t );
+    test_assert_size_t_equal( 3 * KW_BYTES , ecl_file_get_resident_bytes( ecl_file ));
+    for (i = 1; i < 5; i++)
+      test_assert_false( kw_loaded( ecl_file , i ));
+    test_assert_true( kw_loaded( ecl_file , 5 ));
+
+    /* The released keyword can still be fetched and released through the inv_map. */
+    {
+      ecl_kw_type * kw5 = ecl_file_iget_named_kw( ecl_file , "DATA" , 5 );
+      test_assert_float_equal( 5 , ecl_kw_iget_float( kw5 , KW_SIZE - 1 ));
+      ecl_file_release_kw( ecl_file , kw5 );
+    }
+  }
+
+  /* Evicted keywords are reloaded with the right content. */
+  test_assert_true( ecl_file_load_all( ecl_file ));
+  test_assert_size_t_equal( NUM_KW * KW_BYTES , ecl_file_get_resident_bytes( ecl_file ));
+  for (i = 0; i < NUM_KW; i++)
+    test_assert_float_equal( i , ecl_kw_iget_float( ecl_file_iget_named_kw( ecl_file , "DATA" , i ) , KW_SIZE / 2 ));
+
+  /* Removing the budget stops the eviction. */
+  ecl_file_set_memory_budget( ecl_file , 0 );
+  release_all( ecl_file , 10 );
+  test_assert_size_t_equal( NUM_KW * KW_BYTES , ecl_file_get_resident_bytes( ecl_file ));
+  ecl_file_close( ecl_file );
+}
+
+
+static void write_restart( const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  int step;
+  for (step = 0; step < 4; step++) {
+    ecl_kw_type * intehead = well_test_alloc_intehead( ecl_util_make_date( 1 + step , 1 , 2010 ));
+    ecl_kw_iset_int( intehead , INTEHEAD_NX_INDEX , 10 + step );
+    well_test_fwrite_rsthead( fortio , step , intehead , false , step );
+    ecl_kw_free( intehead );
+  }
+  fortio_fclose( fortio );
+}
+
+
+/*
+  The library readers hold several ecl_kw pointers from the same file
+  at the same time; a tiny budget must not invalidate them.
+*/
+
+static void test_rsthead_tiny_budget( const char * filename ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , 0 );
+  int step;
+
+  ecl_file_set_memory_budget( ecl_file , 1000 );
+  for (step = 0; step < 4; step++) {
+    ecl_file_view_type * step_view = ecl_file_get_restart_view( ecl_file , step , -1 , -1 , -1 );
+    ecl_rsthead_type * rsthead = ecl_rsthead_alloc( step_view , step );
+
+    test_assert_int_equal( 10 + step , rsthead->nx );
+    test_assert_time_t_equal( ecl_util_make_date( 1 + step , 1 , 2010 ) , rsthead->sim_time );
+    test_assert_time_t_equal( rsthead->sim_time , ecl_file_iget_restart_sim_date( ecl_file , step ));
+    ecl_rsthead_free( rsthead );
+  }
+  ecl_file_close( ecl_file );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_kw_cache");
+  write_file( "DATA_FILE" );
+  test_budget( "DATA_FILE" );
+  write_restart( "CASE.UNRST" );
+  test_rsthead_tiny_budget( "CASE.UNRST" );
+  test_work_area_free( work_area );
+  exit(0);
+}
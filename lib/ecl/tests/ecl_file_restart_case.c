@@ -0,0 +1,127 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_file_restart_case.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/fortio.h>
+
+#include "well_test_restart.h"
+
+
+#define NUM_BLOCKS   12
+#define MAX_OPEN     3
+
+
+static int step_report( int step ) {
+  return 2 * step;
+}
+
+
+static time_t step_time( int step ) {
+  return ecl_util_make_date( 1 + step , 1 , 2010 );
+}
+
+
+/*
+  Writes one non-unified restart file; like the files written by the
+  simulator there is no SEQNUM keyword.
+*/
+
+static void fwrite_step( const char * base , bool fmt_file , int step ) {
+  char * filename = ecl_util_alloc_filename( NULL , base , ECL_RESTART_FILE , fmt_file , step_report( step ));
+  fortio_type * fortio = fortio_open_writer( filename , fmt_file , ECL_ENDIAN_FLIP );
+  ecl_kw_type * intehead = well_test_alloc_intehead( step_time( step ));
+
+  well_test_fwrite_rsthead( fortio , -1 , intehead , false , step );
+  well_test_fwrite_pressure( fortio , 100 , 100 + step );
+
+  ecl_kw_free( intehead );
+  fortio_fclose( fortio );
+  free( filename );
+}
+
+
+static void test_case( const char * base , bool fmt_file ) {
+  ecl_file_type * rst_file;
+  int step;
+
+  for (step = 0; step < NUM_BLOCKS; step++)
+    fwrite_step( base , fmt_file , step );
+
+  rst_file = ecl_file_open_restart_case( base , MAX_OPEN , 0 );
+  test_assert_not_NULL( rst_file );
+  test_assert_int_equal( NUM_BLOCKS , ecl_file_get_num_named_kw( rst_file , SEQNUM_KW ));
+  test_assert_int_equal( 0 , ecl_file_get_num_open_streams( rst_file ));
+
+  /* Access the steps in reverse order to cycle through the streams. */
+  for (step = NUM_BLOCKS - 1; step >= 0; step--) {
+    ecl_file_view_type * step_view;
+    test_assert_true( ecl_file_has_report_step( rst_file , step_report( step )));
+    test_assert_true( ecl_file_has_sim_time( rst_file , step_time( step )));
+    test_assert_time_t_equal( step_time( step ) , ecl_file_iget_restart_sim_date( rst_file , step ));
+
+    step_view = ecl_file_get_restart_view( rst_file , -1 , step_report( step ) , -1 , -1 );
+    test_assert_not_NULL( step_view );
+    test_assert_int_equal( step_report( step ) , ecl_kw_iget_int( ecl_file_view_iget_named_kw( step_view , SEQNUM_KW , 0 ) , 0 ));
+    test_assert_float_equal( 100 + step , ecl_kw_iget_float( ecl_file_view_iget_named_kw( step_view , "PRESSURE" , 0 ) , 50 ));
+    {
+      char * filename = ecl_util_alloc_filename( NULL , base , ECL_RESTART_FILE , fmt_file , step_report( step ));
+      test_assert_string_equal( filename , ecl_file_view_get_src_file( step_view ));
+      free( filename );
+    }
+    test_assert_true( ecl_file_get_num_open_streams( rst_file ) <= MAX_OPEN );
+  }
+  test_assert_false( ecl_file_has_report_step( rst_file , 1 ));
+
+  test_assert_true( ecl_file_load_all( rst_file ));
+  test_assert_true( ecl_file_get_num_open_streams( rst_file ) <= MAX_OPEN );
+  ecl_file_close_fortio_stream( rst_file );
+  test_assert_int_equal( 0 , ecl_file_get_num_open_streams( rst_file ));
+  test_assert_false( ecl_file_write_index( rst_file , "CASE.INDEX" ));
+  ecl_file_close( rst_file );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_restart_case");
+
+  test_case( "CASE" , false );
+  test_case( "FMT_CASE" , true );
+  test_assert_NULL( ecl_file_open_restart_case( "NO_CASE" , MAX_OPEN , 0 ));
+
+  /* A truncated file invalidates the whole case. */
+  {
+    FILE * stream = util_fopen( "CASE.X0004" , "w" );
+    fprintf( stream , "Garbage" );
+    fclose( stream );
+    test_assert_NULL( ecl_file_open_restart_case( "CASE" , MAX_OPEN , 0 ));
+  }
+
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,251 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_file_rstblock.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/fortio.h>
+
+#include "well_test_restart.h"
+
+
+#define NUM_BLOCKS 20
+
+
+static int step_report( int step ) {
+  return 5 * step;
+}
+
+
+static time_t step_time( int step ) {
+  return ecl_util_make_date( 1 + step , 3 , 2011 );
+}
+
+
+/*
+  The blocks have a different number of keywords, and keywords of
+  different size.
+*/
+
+static void fwrite_step( fortio_type * fortio , int step ) {
+  ecl_kw_type * intehead = well_test_alloc_intehead( step_time( step ));
+  int i;
+
+  well_test_fwrite_rsthead( fortio , step_report( step ) , intehead , false , step );
+  well_test_fwrite_pressure( fortio , 1000 + 100 * step , step );
+  for (i = 0; i < step % 4; i++) {
+    ecl_kw_type * iwel = ecl_kw_alloc( IWEL_KW , 10 * step , ECL_INT );
+    ecl_kw_scalar_set_int( iwel , i );
+    ecl_kw_fwrite( iwel , fortio );
+    ecl_kw_free( iwel );
+  }
+  ecl_kw_free( intehead );
+}
+
+
+static void write_file( const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  int step;
+  for (step = 0; step < NUM_BLOCKS; step++)
+    fwrite_step( fortio , step );
+  fortio_fclose( fortio );
+}
+
+
+static void assert_block( ecl_file_type * ecl_file , int step ) {
+  test_assert_not_NULL( ecl_file );
+  test_assert_int_equal( 5 + step % 4 , ecl_file_get_size( ecl_file ));
+  test_assert_int_equal( 5 + step % 4 , ecl_file_view_get_size( ecl_file_get_global_view( ecl_file )));
+  test_assert_int_equal( 1 , ecl_file_get_num_named_kw( ecl_file , SEQNUM_KW ));
+  test_assert_int_equal( step % 4 , ecl_file_get_num_named_kw( ecl_file , IWEL_KW ));
+  test_assert_true( ecl_file_has_report_step( ecl_file , step_report( step )));
+  test_assert_time_t_equal( step_time( step ) , ecl_file_iget_restart_sim_date( ecl_file , 0 ));
+  {
+    ecl_kw_type * pressure = ecl_file_iget_named_kw( ecl_file , "PRESSURE" , 0 );
+    test_assert_int_equal( 1000 + 100 * step , ecl_kw_get_size( pressure ));
+    test_assert_float_equal( step , ecl_kw_iget_float( pressure , 0 ));
+  }
+  ecl_file_close( ecl_file );
+}
+
+
+static void test_open_block( const char * filename , int flags) {
+  int step;
+  for (step = 0; step < NUM_BLOCKS; step++) {
+    assert_block( ecl_file_iopen_rstblock( filename , step , flags ) , step );
+    assert_block( ecl_file_open_rstblock_report_step( filename , step_report( step ) , flags ) , step );
+    assert_block( ecl_file_open_rstblock_sim_time( filename , step_time( step ) , flags ) , step );
+  }
+
+  test_assert_NULL( ecl_file_iopen_rstblock( filename , NUM_BLOCKS , flags ));
+  test_assert_NULL( ecl_file_open_rstblock_report_step( filename , 1 , flags ));
+  test_assert_NULL( ecl_file_open_rstblock_sim_time( filename , step_time( NUM_BLOCKS ) , flags ));
+}
+
+
+/*
+  The headers after the selected block are never read; a file with
+  garbage at the end can not be opened with ecl_file_open(), but the
+  blocks before the garbage can be opened.
+*/
+
+static void test_truncated( ) {
+  write_file( "TRUNC.UNRST" );
+  {
+    FILE * stream = util_fopen( "TRUNC.UNRST" , "ab");
+    int garbage[4] = {-1 , -1 , -1 , -1};
+    fwrite( garbage , sizeof garbage , 1 , stream );
+    fclose( stream );
+  }
+
+  test_assert_NULL( ecl_file_open( "TRUNC.UNRST" , 0 ));
+  assert_block( ecl_file_iopen_rstblock( "TRUNC.UNRST" , 3 , 0 ) , 3 );
+  assert_block( ecl_file_open_rstblock_report_step( "TRUNC.UNRST" , step_report( NUM_BLOCKS - 2 ) , 0 ) , NUM_BLOCKS - 2 );
+  test_assert_NULL( ecl_file_iopen_rstblock( "TRUNC.UNRST" , NUM_BLOCKS - 1 , 0 ));
+}
+
+
+/*
+  With a valid SEQNUM index the headers before the selected block are
+  not read either; the first block is corrupted after the index has
+  been written, and the last block can still be opened.
+*/
+
+static void test_index( ) {
+  offset_type pressure_offset;
+
+  write_file( "CASE.UNRST" );
+  test_assert_true( ecl_file_write_rstblock_index( "CASE.UNRST" ));
+  test_assert_true( util_file_exists( "CASE.UNRST.seqnum_index" ));
+  test_open_block( "CASE.UNRST" , 0 );
+
+  {
+    ecl_file_type * ecl_file = ecl_file_open( "CASE.UNRST" , 0 );
+    pressure_offset = ecl_file_kw_get_offset( ecl_file_view_iget_named_file_kw( ecl_file_get_global_view( ecl_file ) , "PRESSURE" , 0 ));
+    ecl_file_close( ecl_file );
+  }
+
+  {
+    FILE * stream = util_fopen( "CASE.UNRST" , "r+b");
+    int garbage = -1;
+    util_fseek( stream , pressure_offset , SEEK_SET );
+    fwrite( &garbage , sizeof garbage , 1 , stream );
+    fclose( stream );
+  }
+  test_assert_NULL( ecl_file_open( "CASE.UNRST" , 0 ));
+  test_assert_true( ecl_file_write_rstblock_index( "CASE.UNRST" ) == false );
+
+  /* Rewrite the index with the old content; it is then newer than the restart file. */
+  write_file( "CASE2.UNRST" );
+  test_assert_true( ecl_file_write_rstblock_index( "CASE2.UNRST" ));
+  {
+    FILE * src = util_fopen( "CASE2.UNRST.seqnum_index" , "rb");
+    FILE * target = util_fopen( "CASE.UNRST.seqnum_index" , "wb");
+    int c;
+    /* The index starts with the name of the restart file. */
+    util_fwrite_string( "CASE.UNRST" , target );
+    free( util_fread_alloc_string( src ));
+    while ((c = fgetc( src )) != EOF)
+      fputc( c , target );
+    fclose( src );
+    fclose( target );
+  }
+
+  assert_block( ecl_file_iopen_rstblock( "CASE.UNRST" , NUM_BLOCKS - 1 , 0 ) , NUM_BLOCKS - 1 );
+  assert_block( ecl_file_open_rstblock_report_step( "CASE.UNRST" , step_report( 10 ) , 0 ) , 10 );
+  test_assert_NULL( ecl_file_iopen_rstblock( "CASE.UNRST" , 0 , 0 ));
+  test_assert_NULL( ecl_file_iopen_rstblock( "CASE.UNRST" , NUM_BLOCKS , 0 ));
+
+  /*
+    The size of CASE.UNRST is changed; the index is no longer valid, and
+    the file is scanned from the start - hitting the corrupt block.
+  */
+  {
+    FILE * stream = util_fopen( "CASE.UNRST" , "ab");
+    fputc( 0 , stream );
+    fclose( stream );
+  }
+  test_assert_NULL( ecl_file_iopen_rstblock( "CASE.UNRST" , NUM_BLOCKS - 1 , 0 ));
+}
+
+
+/*
+  The SEQNUM keyword of a block is changed in place after the index
+  has been written, and the index is made newer than the file again.
+  The index entry does not match the keyword at the indexed offset;
+  the file is then scanned instead.
+*/
+
+static void test_index_mismatch( ) {
+  offset_type seqnum_offset;
+
+  write_file( "MISMATCH.UNRST" );
+  test_assert_true( ecl_file_write_rstblock_index( "MISMATCH.UNRST" ));
+  {
+    ecl_file_type * ecl_file = ecl_file_open( "MISMATCH.UNRST" , 0 );
+    seqnum_offset = ecl_file_kw_get_offset( ecl_file_view_iget_named_file_kw( ecl_file_get_global_view( ecl_file ) , SEQNUM_KW , 5 ));
+    ecl_file_close( ecl_file );
+  }
+
+  {
+    fortio_type * fortio = fortio_open_readwrite( "MISMATCH.UNRST" , false , ECL_ENDIAN_FLIP );
+    ecl_kw_type * seqnum = ecl_kw_alloc( SEQNUM_KW , 1 , ECL_INT );
+    ecl_kw_iset_int( seqnum , 0 , step_report( 5 ) + 1 );
+    fortio_fseek( fortio , seqnum_offset , SEEK_SET );
+    ecl_kw_fwrite( seqnum , fortio );
+    ecl_kw_free( seqnum );
+    fortio_fclose( fortio );
+  }
+  test_assert_true( util_copy_file( "MISMATCH.UNRST.seqnum_index" , "MISMATCH.tmp" ));
+  test_assert_true( util_copy_file( "MISMATCH.tmp" , "MISMATCH.UNRST.seqnum_index" ));
+
+  test_assert_NULL( ecl_file_open_rstblock_report_step( "MISMATCH.UNRST" , step_report( 5 ) , 0 ));
+  {
+    ecl_file_type * ecl_file = ecl_file_iopen_rstblock( "MISMATCH.UNRST" , 5 , 0 );
+    test_assert_not_NULL( ecl_file );
+    test_assert_true( ecl_file_has_report_step( ecl_file , step_report( 5 ) + 1 ));
+    ecl_file_close( ecl_file );
+  }
+  assert_block( ecl_file_iopen_rstblock( "MISMATCH.UNRST" , 7 , 0 ) , 7 );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_rstblock");
+
+  write_file( "NOINDEX.UNRST" );
+  test_open_block( "NOINDEX.UNRST" , 0 );
+  test_open_block( "NOINDEX.UNRST" , ECL_FILE_CLOSE_STREAM );
+  test_truncated( );
+  test_index( );
+  test_index_mismatch( );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
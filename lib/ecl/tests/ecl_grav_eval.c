@@ -0,0 +1,137 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grav_eval.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region.h>
+#include <ert/ecl/ecl_grav.h>
+
+#include "survey_test_case.h"
+
+
+#define NUM_STATIONS 29
+#define PHASES       SURVEY_TEST_PHASES
+#define TOLERANCE    1e-9
+
+
+static void init_stations( double * utm_x , double * utm_y , double * depth ) {
+  int i;
+  for (i = 0; i < NUM_STATIONS; i++) {
+    utm_x[i] = -100 + 41.3 * i;
+    utm_y[i] = 700 - 27.9 * i;
+    depth[i] = -1.0 * (i % 5);
+  }
+}
+
+
+static void test_stations( const ecl_grav_type * grav , ecl_region_type * region , const char * monitor , int phase_mask ) {
+  double utm_x[NUM_STATIONS];
+  double utm_y[NUM_STATIONS];
+  double depth[NUM_STATIONS];
+  double deltag[NUM_STATIONS];
+  int i;
+
+  init_stations( utm_x , utm_y , depth );
+  ecl_grav_eval_stations( grav , "BASE" , monitor , region , NUM_STATIONS , utm_x , utm_y , depth , phase_mask , deltag );
+  for (i = 0; i < NUM_STATIONS; i++) {
+    double expected = ecl_grav_eval( grav , "BASE" , monitor , region , utm_x[i] , utm_y[i] , depth[i] , phase_mask );
+    survey_test_assert_close( expected , deltag[i] , TOLERANCE );
+  }
+}
+
+
+/*
+  With theta == 0 the octree is opened down to the cells and the result
+  is exact up to rounding; otherwise the error is within the returned
+  bound.
+*/
+
+static void test_stations_approx( const ecl_grav_type * grav , ecl_region_type * region , const char * monitor , int phase_mask ) {
+  double utm_x[NUM_STATIONS];
+  double utm_y[NUM_STATIONS];
+  double depth[NUM_STATIONS];
+  double deltag[NUM_STATIONS];
+  double exact_deltag[NUM_STATIONS];
+  double error_bound[NUM_STATIONS];
+  int i;
+
+  init_stations( utm_x , utm_y , depth );
+  ecl_grav_eval_stations( grav , "BASE" , monitor , region , NUM_STATIONS , utm_x , utm_y , depth , phase_mask , exact_deltag );
+
+  ecl_grav_eval_stations_approx( grav , "BASE" , monitor , region , NUM_STATIONS , utm_x , utm_y , depth , phase_mask , 0 , deltag , error_bound );
+  for (i = 0; i < NUM_STATIONS; i++) {
+    double expected = ecl_grav_eval( grav , "BASE" , monitor , region , utm_x[i] , utm_y[i] , depth[i] , phase_mask );
+    survey_test_assert_close( expected , deltag[i] , TOLERANCE );
+    test_assert_double_equal( 0 , error_bound[i] );
+  }
+
+  ecl_grav_eval_stations_approx( grav , "BASE" , monitor , region , NUM_STATIONS , utm_x , utm_y , depth , phase_mask , 0.5 , deltag , NULL );
+  ecl_grav_eval_stations_approx( grav , "BASE" , monitor , region , NUM_STATIONS , utm_x , utm_y , depth , phase_mask , 0.5 , deltag , error_bound );
+  for (i = 0; i < NUM_STATIONS; i++) {
+    double rounding = TOLERANCE * util_double_max( 1.0 , fabs( exact_deltag[i] ));
+    if (fabs( exact_deltag[i] - deltag[i] ) > error_bound[i] + rounding)
+      test_error_exit("Approximation:%g differs from exact:%g by more than the bound:%g \n", deltag[i] , exact_deltag[i] , error_bound[i]);
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_grav_eval");
+  ecl_grid_type * grid = survey_test_alloc_grid();
+
+  survey_test_fwrite_init( grid , "CASE.INIT" );
+  survey_test_fwrite_restart( grid , "CASE.X0000" , 0 );
+  survey_test_fwrite_restart( grid , "CASE.X0001" , 1 );
+  {
+    ecl_file_type * init_file = ecl_file_open( "CASE.INIT" , 0 );
+    ecl_file_type * base_file = ecl_file_open( "CASE.X0000" , 0 );
+    ecl_file_type * monitor_file = ecl_file_open( "CASE.X0001" , 0 );
+    ecl_grav_type * grav = ecl_grav_alloc( grid , init_file );
+    ecl_region_type * region = ecl_region_alloc( grid , false );
+
+    ecl_grav_add_survey_PORMOD( grav , "BASE" , ecl_file_get_global_view( base_file ));
+    ecl_grav_add_survey_PORMOD( grav , "MONITOR" , ecl_file_get_global_view( monitor_file ));
+    ecl_region_select_k1k2( region , 1 , 3 );
+
+    test_stations( grav , NULL , "MONITOR" , PHASES );
+    test_stations( grav , NULL , "MONITOR" , ECL_WATER_PHASE );
+    test_stations( grav , NULL , NULL , PHASES );
+    test_stations( grav , region , "MONITOR" , PHASES );
+    test_stations_approx( grav , NULL , "MONITOR" , PHASES );
+    test_stations_approx( grav , NULL , NULL , ECL_OIL_PHASE );
+    test_stations_approx( grav , region , "MONITOR" , PHASES );
+
+    ecl_region_free( region );
+    ecl_grav_free( grav );
+    ecl_file_close( monitor_file );
+    ecl_file_close( base_file );
+    ecl_file_close( init_file );
+  }
+
+  ecl_grid_free( grid );
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,104 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grav_stations.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_grid_cache.h>
+#include <ert/ecl/ecl_region.h>
+#include <ert/ecl/ecl_grav_common.h>
+
+
+#define NUM_STATIONS 37
+
+
+static void assert_close( double expected , double value ) {
+  double tolerance = 1e-10 * util_double_max( 1.0 , fabs( expected ));
+  if (fabs( expected - value ) > tolerance)
+    test_error_exit("Batch result:%g differs from scalar result:%g \n", value , expected);
+}
+
+
+static void test_stations( const ecl_grid_type * grid , ecl_region_type * region) {
+  ecl_grid_cache_type * grid_cache = ecl_grid_cache_alloc( grid );
+  const int size = ecl_grid_cache_get_size( grid_cache );
+  double * weight  = util_malloc( size * sizeof * weight );
+  bool   * aquifer = util_malloc( size * sizeof * aquifer );
+  double utm_x[NUM_STATIONS];
+  double utm_y[NUM_STATIONS];
+  double depth[NUM_STATIONS];
+  double result[NUM_STATIONS];
+  int i;
+
+  for (i = 0; i < size; i++) {
+    weight[i]  = 1000 * sin( 0.37 * i );
+    aquifer[i] = (i % 11 == 0);
+  }
+
+  for (i = 0; i < NUM_STATIONS; i++) {
+    utm_x[i] = -50 + 13.7 * i;
+    utm_y[i] = 200 - 7.1 * i;
+    depth[i] = -1.0 * (i % 3);
+  }
+
+  ecl_grav_common_eval_biot_savart_stations( grid_cache , region , aquifer , weight , NUM_STATIONS , utm_x , utm_y , depth , result );
+  for (i = 0; i < NUM_STATIONS; i++) {
+    double expected = ecl_grav_common_eval_biot_savart( grid_cache , region , aquifer , weight , utm_x[i] , utm_y[i] , depth[i]);
+    assert_close( expected , result[i] );
+  }
+
+  ecl_grav_common_eval_geertsma_stations( grid_cache , region , aquifer , weight , NUM_STATIONS , utm_x , utm_y , depth , 0.25 , 5 , result );
+  for (i = 0; i < NUM_STATIONS; i++) {
+    double expected = ecl_grav_common_eval_geertsma( grid_cache , region , aquifer , weight , utm_x[i] , utm_y[i] , depth[i] , 0.25 , 5);
+    assert_close( expected , result[i] );
+  }
+
+  free( weight );
+  free( aquifer );
+  ecl_grid_cache_free( grid_cache );
+}
+
+
+int main(int argc , char ** argv) {
+  const int nx = 40;
+  const int ny = 30;
+  const int nz = 10;
+  int * actnum = util_malloc( nx*ny*nz * sizeof * actnum );
+  ecl_grid_type * grid;
+  int g;
+
+  for (g = 0; g < nx*ny*nz; g++)
+    actnum[g] = (g % 13 == 0) ? 0 : 1;
+  grid = ecl_grid_alloc_rectangular( nx , ny , nz , 10 , 10 , 5 , actnum );
+
+  test_stations( grid , NULL );
+  {
+    ecl_region_type * region = ecl_region_alloc( grid , false );
+    ecl_region_select_k1k2( region , 2 , 6 );
+    test_stations( grid , region );
+    ecl_region_free( region );
+  }
+
+  ecl_grid_free( grid );
+  free( actnum );
+  exit(0);
+}
@@ -0,0 +1,123 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grav_tree.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_grid_cache.h>
+#include <ert/ecl/ecl_region.h>
+#include <ert/ecl/ecl_grav_common.h>
+#include <ert/ecl/ecl_grav_tree.h>
+
+
+#define NUM_STATIONS 25
+
+
+static void assert_within_bound( double exact , double approx , double bound ) {
+  double rounding = 1e-9 * util_double_max( 1.0 , fabs( exact ));
+  if (fabs( exact - approx ) > bound + rounding)
+    test_error_exit("Approximation:%g differs from exact:%g by more than the bound:%g \n", approx , exact , bound);
+}
+
+
+static void test_tree( const ecl_grid_type * grid , ecl_region_type * region) {
+  ecl_grid_cache_type * grid_cache = ecl_grid_cache_alloc( grid );
+  const int size = ecl_grid_cache_get_size( grid_cache );
+  double * weight  = util_malloc( size * sizeof * weight );
+  bool   * aquifer = util_malloc( size * sizeof * aquifer );
+  ecl_grav_tree_type * tree;
+  int num_approximated = 0;
+  int i;
+
+  for (i = 0; i < size; i++) {
+    weight[i]  = 1000 * (1.5 + sin( 0.37 * i ));
+    aquifer[i] = (i % 17 == 0);
+  }
+
+  tree = ecl_grav_tree_alloc( grid_cache , region , aquifer , weight , 8 );
+  test_assert_true( ecl_grav_tree_is_instance( tree ));
+  test_assert_true( ecl_grav_tree_get_num_nodes( tree ) > 1 );
+
+  for (i = 0; i < NUM_STATIONS; i++) {
+    double utm_x = -500 + 97.3 * i;
+    double utm_y = 300 - 41.1 * i;
+    double depth = -10.0 * (i % 3);
+    double exact_grav = ecl_grav_common_eval_biot_savart( grid_cache , region , aquifer , weight , utm_x , utm_y , depth );
+    double exact_subs = ecl_grav_common_eval_geertsma( grid_cache , region , aquifer , weight , utm_x , utm_y , depth , 0.25 , 5 );
+    double bound;
+    double value;
+
+    value = ecl_grav_tree_eval_biot_savart( tree , 0 , utm_x , utm_y , depth , &bound );
+    test_assert_double_equal( 0 , bound );
+    assert_within_bound( exact_grav , value , 0 );
+
+    value = ecl_grav_tree_eval_geertsma( tree , 0 , utm_x , utm_y , depth , 0.25 , 5 , &bound );
+    test_assert_double_equal( 0 , bound );
+    assert_within_bound( exact_subs , value , 0 );
+
+    {
+      const double theta[3] = { 0.25 , 0.5 , 1.0 };
+      int it;
+      for (it = 0; it < 3; it++) {
+        value = ecl_grav_tree_eval_biot_savart( tree , theta[it] , utm_x , utm_y , depth , &bound );
+        assert_within_bound( exact_grav , value , bound );
+        if (bound > 0)
+          num_approximated++;
+
+        value = ecl_grav_tree_eval_geertsma( tree , theta[it] , utm_x , utm_y , depth , 0.25 , 5 , &bound );
+        assert_within_bound( exact_subs , value , bound );
+      }
+    }
+  }
+
+  test_assert_true( num_approximated > 0 );
+  ecl_grav_tree_free( tree );
+  free( weight );
+  free( aquifer );
+  ecl_grid_cache_free( grid_cache );
+}
+
+
+int main(int argc , char ** argv) {
+  const int nx = 30;
+  const int ny = 20;
+  const int nz = 8;
+  int * actnum = util_malloc( nx*ny*nz * sizeof * actnum );
+  ecl_grid_type * grid;
+  int g;
+
+  for (g = 0; g < nx*ny*nz; g++)
+    actnum[g] = (g % 11 == 0) ? 0 : 1;
+  grid = ecl_grid_alloc_rectangular( nx , ny , nz , 50 , 50 , 10 , actnum );
+
+  test_tree( grid , NULL );
+  {
+    ecl_region_type * region = ecl_region_alloc( grid , false );
+    ecl_region_select_k1k2( region , 1 , 4 );
+    test_tree( grid , region );
+    ecl_region_free( region );
+  }
+
+  ecl_grid_free( grid );
+  free( actnum );
+  exit(0);
+}
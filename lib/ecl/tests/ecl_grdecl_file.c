@@ -0,0 +1,180 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grdecl_file.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_type.h>
+#include <ert/ecl/ecl_kw_grdecl.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_grdecl_file.h>
+
+
+static void write_text( const char * filename , const char * text ) {
+  FILE * stream = util_fopen( filename , "w");
+  fprintf(stream , "%s" , text);
+  fclose( stream );
+}
+
+
+static void test_parse( void ) {
+  write_text( "SMALL.grdecl" ,
+              "-- A comment line with PORO 1 2 3 /\n"
+              "SPECGRID\n"
+              "  10 10 5 1 F /\n"
+              "\n"
+              "PORO\n"
+              "  0.25 3*0.5 --Comment after values\n"
+              "  1.0D-01 -2.5e+02 1e40/\n"
+              "NOECHO\n"
+              "PERMX_LONG_HEADER\n"
+              " 2*100 200 300\n"
+              " 400 /\n"
+              "PORO\n"
+              " 7 /\n");
+  {
+    ecl_grdecl_file_type * grdecl_file = ecl_grdecl_file_open( "SMALL.grdecl" );
+    test_assert_true( ecl_grdecl_file_is_instance( grdecl_file ));
+    test_assert_int_equal( 5 , ecl_grdecl_file_get_size( grdecl_file ));
+    test_assert_string_equal( "SPECGRID" , ecl_grdecl_file_iget_header( grdecl_file , 0 ));
+    test_assert_string_equal( "NOECHO" , ecl_grdecl_file_iget_header( grdecl_file , 2 ));
+    test_assert_int_equal( 2 , ecl_grdecl_file_get_num_named_kw( grdecl_file , "PORO" ));
+    test_assert_int_equal( 4 , ecl_grdecl_file_get_global_index( grdecl_file , "PORO" , 1 ));
+    test_assert_int_equal( -1 , ecl_grdecl_file_get_global_index( grdecl_file , "PORO" , 2 ));
+    test_assert_false( ecl_grdecl_file_has_kw( grdecl_file , "PERMX" ));
+
+    {
+      ecl_kw_type * specgrid = ecl_grdecl_file_iget_kw__( grdecl_file , 0 , false , 0 , ECL_INT );
+      test_assert_int_equal( 4 , ecl_kw_get_size( specgrid ));
+      test_assert_int_equal( 5 , ecl_kw_iget_int( specgrid , 2 ));
+      ecl_kw_free( specgrid );
+    }
+
+    {
+      ecl_kw_type * poro = ecl_grdecl_file_iget_named_kw( grdecl_file , "PORO" , 0 , 7 , ECL_DOUBLE );
+      test_assert_string_equal( "PORO" , ecl_kw_get_header( poro ));
+      test_assert_double_equal( 0.25 , ecl_kw_iget_double( poro , 0 ));
+      test_assert_double_equal( 0.5 , ecl_kw_iget_double( poro , 3 ));
+      test_assert_double_equal( 0.1 , ecl_kw_iget_double( poro , 4 ));
+      test_assert_double_equal( -250 , ecl_kw_iget_double( poro , 5 ));
+      test_assert_double_equal( 1e40 , ecl_kw_iget_double( poro , 6 ));
+      ecl_kw_free( poro );
+    }
+
+    {
+      ecl_kw_type * noecho = ecl_grdecl_file_iget_kw( grdecl_file , 2 , ECL_INT );
+      test_assert_int_equal( 0 , ecl_kw_get_size( noecho ));
+      ecl_kw_free( noecho );
+    }
+
+    {
+      ecl_kw_type * permx = ecl_grdecl_file_iget_named_kw( grdecl_file , "PERMX_LONG_HEADER" , 0 , 0 , ECL_FLOAT );
+      test_assert_int_equal( 5 , ecl_kw_get_size( permx ));
+      test_assert_float_equal( 100 , ecl_kw_iget_float( permx , 1 ));
+      test_assert_float_equal( 400 , ecl_kw_iget_float( permx , 4 ));
+      ecl_kw_free( permx );
+    }
+
+    {
+      ecl_kw_type * poro = ecl_grdecl_file_iget_named_kw( grdecl_file , "PORO" , 1 , 1 , ECL_INT );
+      test_assert_int_equal( 7 , ecl_kw_iget_int( poro , 0 ));
+      ecl_kw_free( poro );
+    }
+
+    test_assert_NULL( ecl_grdecl_file_iget_named_kw( grdecl_file , "PORO" , 2 , 0 , ECL_FLOAT ));
+    ecl_grdecl_file_close( grdecl_file );
+  }
+}
+
+
+/*
+  The keyword is big enough to be parsed in parallel chunks; the
+  result should be identical to the FILE based reader.
+*/
+
+static void test_large_kw( void ) {
+  const int size = 700000;
+  ecl_kw_type * kw = ecl_kw_alloc( "PRESSURE" , size , ECL_FLOAT );
+  int i;
+
+  for (i = 0; i < size; i++)
+    ecl_kw_iset_float( kw , i , (i % 1000 == 0) ? 1.5 : 100 + 0.37 * i );
+
+  {
+    FILE * stream = util_fopen( "LARGE.grdecl" , "w");
+    ecl_kw_fprintf_grdecl( kw , stream );
+    fclose( stream );
+  }
+
+  {
+    ecl_grdecl_file_type * grdecl_file = ecl_grdecl_file_open( "LARGE.grdecl" );
+    ecl_kw_type * kw1 = ecl_grdecl_file_iget_named_kw( grdecl_file , "PRESSURE" , 0 , size , ECL_FLOAT );
+    FILE * stream = util_fopen( "LARGE.grdecl" , "r");
+    ecl_kw_type * kw2 = ecl_kw_fscanf_alloc_grdecl( stream , "PRESSURE" , size , ECL_FLOAT );
+
+    test_assert_true( ecl_kw_equal( kw1 , kw2 ));
+    fclose( stream );
+    ecl_kw_free( kw1 );
+    ecl_kw_free( kw2 );
+    ecl_grdecl_file_close( grdecl_file );
+  }
+  ecl_kw_free( kw );
+}
+
+
+static void test_grid( void ) {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 12 , 8 , 5 , 1 , 2 , 3 , NULL );
+  {
+    FILE * stream = util_fopen( "GRID.grdecl" , "w");
+    ecl_grid_fprintf_grdecl( grid , stream );
+    fclose( stream );
+  }
+
+  {
+    ecl_grdecl_file_type * grdecl_file = ecl_grdecl_file_open( "GRID.grdecl" );
+    ecl_grid_type * grid2 = ecl_grdecl_file_alloc_grid( grdecl_file );
+
+    test_assert_not_NULL( grid2 );
+    test_assert_true( ecl_grid_compare( grid , grid2 , false , false , true ));
+    ecl_grid_free( grid2 );
+    ecl_grdecl_file_close( grdecl_file );
+  }
+
+  {
+    ecl_grdecl_file_type * grdecl_file = ecl_grdecl_file_open( "SMALL.grdecl" );
+    test_assert_NULL( ecl_grdecl_file_alloc_grid( grdecl_file ));
+    ecl_grdecl_file_close( grdecl_file );
+  }
+  ecl_grid_free( grid );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_grdecl_file");
+  test_parse();
+  test_large_kw();
+  test_grid();
+  test_assert_NULL( ecl_grdecl_file_open( "DOES_NOT_EXIST.grdecl" ));
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -131,10 +131,88 @@ void list_test() {
 }
 
 
+void csr_test() {
+  ecl_grid_type * grid0 = ecl_grid_alloc_rectangular( 10 , 10 , 10 , 1 , 1, 1, NULL );
+  const int * offset;
+  const int * grid_index;
+  const int * nnc_index;
+
+  test_assert_int_equal( 0 , ecl_grid_get_num_nnc_csr( grid0 ));
+  ecl_grid_add_self_nnc( grid0 , 8 , 9 , 2 );
+  ecl_grid_add_self_nnc( grid0 , 5 , 6 , 0 );
+
+  test_assert_int_equal( 1 , ecl_grid_get_num_nnc_csr( grid0 ));
+  test_assert_int_equal( 0 , ecl_grid_iget_nnc_csr( grid0 , 0 , &offset , &grid_index , &nnc_index ));
+  test_assert_int_equal( 0 , offset[5] );
+  test_assert_int_equal( 1 , offset[6] );
+  test_assert_int_equal( 2 , offset[1000] );
+  test_assert_int_equal( 6 , grid_index[0] );
+  test_assert_int_equal( 9 , grid_index[1] );
+  test_assert_int_equal( 2 , nnc_index[1] );
+  test_assert_NULL( ecl_grid_get_cell_nnc_info1( grid0 , 7 ));
+  test_assert_not_NULL( ecl_grid_get_cell_nnc_info1( grid0 , 5 ));
+
+  /* Connections added after the arrays are built are appended to the rows. */
+  ecl_grid_add_self_nnc( grid0 , 5 , 7 , 1 );
+  ecl_grid_iget_nnc_csr( grid0 , 0 , &offset , &grid_index , &nnc_index );
+  test_assert_int_equal( 3 , offset[1000] );
+  test_assert_int_equal( 3 , ecl_grid_get_num_nnc( grid0 ));
+  verify_simple_nnc( grid0 );
+
+  {
+    ecl_grid_type * copy = ecl_grid_alloc_copy( grid0 );
+    verify_simple_nnc( copy );
+    test_assert_true( ecl_grid_compare( grid0 , copy , false , true , false ));
+
+    ecl_grid_add_self_nnc( copy , 5 , 8 , 3 );
+    test_assert_false( ecl_grid_compare( grid0 , copy , false , true , false ));
+    ecl_grid_free( copy );
+  }
+  ecl_grid_free( grid0 );
+}
+
+
+
+/*
+  The nnc_info instance handed out by the grid is rebuilt from the CSR
+  arrays on each call; a new call sees the connections added since the
+  previous call.
+*/
+
+void view_test() {
+  ecl_grid_type * grid0 = ecl_grid_alloc_rectangular( 10 , 10 , 10 , 1 , 1, 1, NULL );
+  const nnc_info_type * nnc_info;
+
+  ecl_grid_add_self_nnc( grid0 , 5 , 6 , 0 );
+  nnc_info = ecl_grid_get_cell_nnc_info1( grid0 , 5 );
+  test_assert_int_equal( 1 , nnc_vector_get_size( nnc_info_iget_vector( nnc_info , 0 )));
+
+  ecl_grid_add_self_nnc( grid0 , 5 , 7 , 1 );
+  ecl_grid_add_self_nnc( grid0 , 8 , 9 , 2 );
+  nnc_info = ecl_grid_get_cell_nnc_info1( grid0 , 5 );
+  test_assert_int_equal( 2 , nnc_vector_get_size( nnc_info_iget_vector( nnc_info , 0 )));
+  test_assert_int_equal( 7 , nnc_vector_iget_grid_index( nnc_info_iget_vector( nnc_info , 0 ) , 1 ));
+  verify_simple_nnc( grid0 );
+
+  ecl_grid_add_self_nnc( grid0 , 8 , 5 , 3 );
+  nnc_info = ecl_grid_get_cell_nnc_info1( grid0 , 8 );
+  test_assert_int_equal( 2 , nnc_vector_get_size( nnc_info_iget_vector( nnc_info , 0 )));
+  test_assert_int_equal( 5 , nnc_vector_iget_grid_index( nnc_info_iget_vector( nnc_info , 0 ) , 1 ));
+  test_assert_int_equal( 3 , nnc_vector_iget_nnc_index( nnc_info_iget_vector( nnc_info , 0 ) , 1 ));
+
+  test_assert_NULL( ecl_grid_get_cell_nnc_info1( grid0 , 7 ));
+  nnc_info = ecl_grid_get_cell_nnc_info1( grid0 , 5 );
+  test_assert_int_equal( 2 , nnc_vector_get_size( nnc_info_iget_vector( nnc_info , 0 )));
+  ecl_grid_free( grid0 );
+}
+
+
 
 int main( int argc , char ** argv) {
   simple_test();
   list_test();
   overwrite_test();
+  csr_test();
+  view_test();
   exit(0);
 }
@@ -0,0 +1,181 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grid_cache.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_grid_cache.h>
+
+
+static ecl_grid_type * alloc_grid( int nx , int ny , int nz ) {
+  int * actnum = util_malloc( nx*ny*nz * sizeof * actnum );
+  ecl_grid_type * grid;
+  int g;
+  for (g = 0; g < nx*ny*nz; g++)
+    actnum[g] = (g % 7 == 3) ? 0 : 1;
+  grid = ecl_grid_alloc_rectangular( nx , ny , nz , 10 , 20 , 5 , actnum );
+  free( actnum );
+  return grid;
+}
+
+
+static void assert_cache_equal( const ecl_grid_type * grid , const ecl_grid_cache_type * cache ) {
+  const double * xpos   = ecl_grid_cache_get_xpos( cache );
+  const double * ypos   = ecl_grid_cache_get_ypos( cache );
+  const double * zpos   = ecl_grid_cache_get_zpos( cache );
+  const double * volume = ecl_grid_cache_get_volume( cache );
+  int a;
+
+  test_assert_int_equal( ecl_grid_get_active_size( grid ) , ecl_grid_cache_get_size( cache ));
+  for (a = 0; a < ecl_grid_cache_get_size( cache ); a++) {
+    int global_index = ecl_grid_get_global_index1A( grid , a );
+    double x,y,z;
+
+    ecl_grid_get_xyz1( grid , global_index , &x , &y , &z );
+    test_assert_int_equal( global_index , ecl_grid_cache_iget_global_index( cache , a ));
+    test_assert_double_equal( x , xpos[a] );
+    test_assert_double_equal( y , ypos[a] );
+    test_assert_double_equal( z , zpos[a] );
+    test_assert_double_equal( ecl_grid_get_cell_volume1( grid , global_index ) , volume[a] );
+  }
+}
+
+
+static void test_shared( ) {
+  ecl_grid_type * grid = alloc_grid( 20 , 15 , 10 );
+  ecl_grid_cache_type * cache1 = ecl_grid_get_cache( grid );
+  ecl_grid_cache_type * cache2 = ecl_grid_get_cache( grid );
+  const int active_size = ecl_grid_get_active_size( grid );
+
+  test_assert_ptr_equal( cache1 , cache2 );
+  test_assert_int_equal( 3 , ecl_grid_cache_get_refcount( cache1 ));
+  assert_cache_equal( grid , cache1 );
+
+  ecl_grid_cache_free( cache2 );
+  test_assert_int_equal( 2 , ecl_grid_cache_get_refcount( cache1 ));
+
+  /* The cache outlives the grid as long as there are references to it. */
+  ecl_grid_free( grid );
+  test_assert_int_equal( 1 , ecl_grid_cache_get_refcount( cache1 ));
+  test_assert_int_equal( active_size , ecl_grid_cache_get_size( cache1 ));
+  test_assert_double_equal( 10 * 20 * 5 , ecl_grid_cache_get_volume( cache1 )[0] );
+  ecl_grid_cache_free( cache1 );
+}
+
+
+static void test_reset_actnum( ) {
+  ecl_grid_type * grid = alloc_grid( 20 , 15 , 10 );
+  ecl_grid_cache_type * cache1 = ecl_grid_get_cache( grid );
+  const int active_size = ecl_grid_get_active_size( grid );
+  int * actnum = util_malloc( ecl_grid_get_global_size( grid ) * sizeof * actnum );
+  int g;
+
+  for (g = 0; g < ecl_grid_get_global_size( grid ); g++)
+    actnum[g] = (g % 5 == 1) ? 0 : 1;
+  ecl_grid_reset_actnum( grid , actnum );
+  free( actnum );
+
+  /* The old reference is detached and keeps the old active cells. */
+  test_assert_int_equal( 1 , ecl_grid_cache_get_refcount( cache1 ));
+  test_assert_int_equal( active_size , ecl_grid_cache_get_size( cache1 ));
+  test_assert_int_equal( 4 , ecl_grid_cache_iget_global_index( cache1 , 3 ));
+  test_assert_double_equal( 10 * 20 * 5 , ecl_grid_cache_get_volume( cache1 )[0] );
+  {
+    ecl_grid_cache_type * cache2 = ecl_grid_get_cache( grid );
+    test_assert_true( cache1 != cache2 );
+    assert_cache_equal( grid , cache2 );
+    ecl_grid_cache_free( cache2 );
+  }
+
+  ecl_grid_free( grid );
+  ecl_grid_cache_free( cache1 );
+}
+
+
+static void test_persist( ) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_grid_cache");
+  ecl_grid_type * grid  = alloc_grid( 12 , 10 , 8 );
+  ecl_grid_type * grid2 = alloc_grid( 12 , 10 , 9 );
+  ecl_grid_cache_type * cache = ecl_grid_cache_alloc( grid );
+
+  test_assert_NULL( ecl_grid_cache_fread_alloc( grid , "CASE.GCACHE" ));
+  ecl_grid_cache_fwrite( cache , "CASE.GCACHE" );
+  {
+    ecl_grid_cache_type * loaded = ecl_grid_cache_fread_alloc( grid , "CASE.GCACHE" );
+    test_assert_not_NULL( loaded );
+    assert_cache_equal( grid , loaded );
+    ecl_grid_cache_free( loaded );
+  }
+  test_assert_NULL( ecl_grid_cache_fread_alloc( grid2 , "CASE.GCACHE" ));
+
+  {
+    char * filename = ecl_grid_cache_alloc_filename( "path/CASE.EGRID" );
+    test_assert_string_equal( "path/CASE.GCACHE" , filename );
+    free( filename );
+  }
+
+  ecl_grid_fwrite_EGRID2( grid , "CASE.EGRID" , ECL_METRIC_UNITS );
+  {
+    ecl_grid_type * file_grid = ecl_grid_alloc( "CASE.EGRID" );
+    ecl_grid_cache_type * file_cache = ecl_grid_get_cache( file_grid );
+    assert_cache_equal( file_grid , file_cache );
+    ecl_grid_cache_fwrite( file_cache , "CASE.GCACHE" );
+    ecl_grid_cache_free( file_cache );
+    ecl_grid_free( file_grid );
+  }
+
+  /*
+    The volume of the first cell is modified in CASE.GCACHE; the
+    modified value shows that the cache is loaded from the file.
+  */
+  {
+    ecl_file_type * cache_file = ecl_file_open( "CASE.GCACHE" , ECL_FILE_WRITABLE );
+    ecl_kw_type * volume_kw = ecl_file_iget_named_kw( cache_file , "GCVOLUME" , 0 );
+    ecl_kw_iset_double( volume_kw , 0 , 12345 );
+    test_assert_true( ecl_file_save_kw( cache_file , volume_kw ));
+    ecl_file_close( cache_file );
+  }
+  {
+    ecl_grid_type * file_grid = ecl_grid_alloc( "CASE.EGRID" );
+    ecl_grid_cache_type * file_cache = ecl_grid_get_cache( file_grid );
+    const double * volume = ecl_grid_cache_get_volume( file_cache );
+    test_assert_double_equal( 12345 , volume[0] );
+    test_assert_double_equal( ecl_grid_get_cell_volume1( file_grid , ecl_grid_get_global_index1A( file_grid , 1 )) , volume[1] );
+    ecl_grid_cache_free( file_cache );
+    ecl_grid_free( file_grid );
+  }
+
+  ecl_grid_cache_free( cache );
+  ecl_grid_free( grid );
+  ecl_grid_free( grid2 );
+  test_work_area_free( work_area );
+}
+
+
+int main(int argc , char ** argv) {
+  test_shared( );
+  test_reset_actnum( );
+  test_persist( );
+  exit(0);
+}
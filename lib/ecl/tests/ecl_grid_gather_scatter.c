@@ -0,0 +1,164 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grid_gather_scatter.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_grid.h>
+
+
+static ecl_grid_type * alloc_grid( int nx , int ny , int nz ) {
+  int * actnum = util_malloc( nx*ny*nz * sizeof * actnum );
+  ecl_grid_type * grid;
+  int g;
+  for (g = 0; g < nx*ny*nz; g++)
+    actnum[g] = (g % 7 == 3 || g % 5 == 0) ? 0 : 1;
+  grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1 , 1 , 1 , actnum );
+  free( actnum );
+  return grid;
+}
+
+
+static void test_arrays( const ecl_grid_type * grid ) {
+  const int size    = ecl_grid_get_global_size( grid );
+  const int nactive = ecl_grid_get_active_size( grid );
+  double * global_data = util_malloc( size * sizeof * global_data );
+  double * active_data = util_malloc( nactive * sizeof * active_data );
+  bool   * global_bool = util_malloc( size * sizeof * global_bool );
+  bool   * active_bool = util_malloc( nactive * sizeof * active_bool );
+  int g,a;
+
+  for (g = 0; g < size; g++) {
+    global_data[g] = g * 0.5;
+    global_bool[g] = (g % 3 == 0);
+  }
+
+  ecl_grid_gather_double( grid , global_data , active_data );
+  ecl_grid_gather_bool( grid , global_bool , active_bool );
+  for (a = 0; a < nactive; a++) {
+    int global_index = ecl_grid_get_global_index1A( grid , a );
+    test_assert_double_equal( global_index * 0.5 , active_data[a] );
+    test_assert_bool_equal( global_index % 3 == 0 , active_bool[a] );
+  }
+
+  for (a = 0; a < nactive; a++)
+    active_data[a] = -active_data[a];
+
+  ecl_grid_scatter_double( grid , active_data , global_data , NULL );
+  for (g = 0; g < size; g++) {
+    if (ecl_grid_cell_active1( grid , g ))
+      test_assert_double_equal( -g * 0.5 , global_data[g] );
+    else
+      test_assert_double_equal( g * 0.5 , global_data[g] );
+  }
+
+  {
+    const double def = 99;
+    ecl_grid_scatter_double( grid , active_data , global_data , &def );
+    for (g = 0; g < size; g++) {
+      if (ecl_grid_cell_active1( grid , g ))
+        test_assert_double_equal( -g * 0.5 , global_data[g] );
+      else
+        test_assert_double_equal( def , global_data[g] );
+    }
+  }
+
+  free( global_data );
+  free( active_data );
+  free( global_bool );
+  free( active_bool );
+}
+
+
+static void test_kw( const ecl_grid_type * grid ) {
+  const int size    = ecl_grid_get_global_size( grid );
+  const int nactive = ecl_grid_get_active_size( grid );
+  ecl_kw_type * global_int   = ecl_kw_alloc( "FIPNUM" , size , ECL_INT );
+  ecl_kw_type * active_int   = ecl_kw_alloc( "FIPNUM" , nactive , ECL_INT );
+  ecl_kw_type * global_float = ecl_kw_alloc( "PORO" , size , ECL_FLOAT );
+  ecl_kw_type * active_float = ecl_kw_alloc( "PORO" , nactive , ECL_FLOAT );
+  ecl_kw_type * global_bool  = ecl_kw_alloc( "FLAG" , size , ECL_BOOL );
+  ecl_kw_type * active_bool  = ecl_kw_alloc( "FLAG" , nactive , ECL_BOOL );
+  ecl_kw_type * global_char  = ecl_kw_alloc( "NAMES" , size , ECL_CHAR );
+  ecl_kw_type * active_char  = ecl_kw_alloc( "NAMES" , nactive , ECL_CHAR );
+  int g,a;
+
+  for (g = 0; g < size; g++) {
+    ecl_kw_iset_int( global_int , g , g );
+    ecl_kw_iset_float( global_float , g , g * 0.25 );
+    ecl_kw_iset_bool( global_bool , g , g % 2 == 0 );
+    ecl_kw_iset_string8( global_char , g , (g % 2 == 0) ? "EVEN" : "ODD" );
+  }
+
+  ecl_grid_gather_kw( grid , global_int , active_int );
+  ecl_grid_compressed_kw_copy( grid , active_float , global_float );
+  ecl_grid_gather_kw( grid , global_bool , active_bool );
+  ecl_grid_gather_kw( grid , global_char , active_char );
+  for (a = 0; a < nactive; a++) {
+    int global_index = ecl_grid_get_global_index1A( grid , a );
+    test_assert_int_equal( global_index , ecl_kw_iget_int( active_int , a ));
+    test_assert_float_equal( global_index * 0.25 , ecl_kw_iget_float( active_float , a ));
+    test_assert_bool_equal( global_index % 2 == 0 , ecl_kw_iget_bool( active_bool , a ));
+    test_assert_string_equal( (global_index % 2 == 0) ? "EVEN    " : "ODD     " , ecl_kw_iget_char_ptr( active_char , a ));
+  }
+
+  {
+    const int def = -1;
+    ecl_kw_scalar_set_int( active_int , 7 );
+    ecl_grid_scatter_kw( grid , active_int , global_int , &def );
+    ecl_kw_scalar_set_float( active_float , 1 );
+    ecl_grid_global_kw_copy( grid , global_float , active_float );
+    for (g = 0; g < size; g++) {
+      if (ecl_grid_cell_active1( grid , g )) {
+        test_assert_int_equal( 7 , ecl_kw_iget_int( global_int , g ));
+        test_assert_float_equal( 1 , ecl_kw_iget_float( global_float , g ));
+      } else {
+        test_assert_int_equal( def , ecl_kw_iget_int( global_int , g ));
+        test_assert_float_equal( g * 0.25 , ecl_kw_iget_float( global_float , g ));
+      }
+    }
+  }
+
+  ecl_kw_free( global_int );
+  ecl_kw_free( active_int );
+  ecl_kw_free( global_float );
+  ecl_kw_free( active_float );
+  ecl_kw_free( global_bool );
+  ecl_kw_free( active_bool );
+  ecl_kw_free( global_char );
+  ecl_kw_free( active_char );
+}
+
+
+int main(int argc , char ** argv) {
+  {
+    ecl_grid_type * grid = alloc_grid( 10 , 11 , 12 );
+    test_arrays( grid );
+    test_kw( grid );
+    ecl_grid_free( grid );
+  }
+  {
+    ecl_grid_type * grid = alloc_grid( 100 , 50 , 40 );
+    test_arrays( grid );
+    ecl_grid_free( grid );
+  }
+  exit(0);
+}
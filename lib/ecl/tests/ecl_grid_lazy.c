@@ -0,0 +1,156 @@
+/*
+   Copyright (C) 2018  Statoil ASA, Norway.
+
+   The file 'ecl_grid_lazy.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_grid.h>
+
+
+ecl_grid_type * alloc_test_grid( int nx , int ny , int nz ) {
+  int * actnum = util_malloc( nx*ny*nz * sizeof * actnum );
+  for (int g = 0; g < nx*ny*nz; g++)
+    actnum[g] = (g % 7) ? 1 : 0;
+
+  {
+    ecl_grid_type * rect_grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1 , 2 , 3 , actnum );
+    int zcorn_size = ecl_grid_get_zcorn_size( rect_grid );
+    float * zcorn_float = ecl_grid_alloc_zcorn_data( rect_grid );
+    double * zcorn = util_malloc( zcorn_size * sizeof * zcorn );
+    ecl_grid_type * grid;
+
+    for (int i = 0; i < zcorn_size; i++)
+      zcorn[i] = zcorn_float[i] + 0.25 * (i % 3);
+
+    grid = ecl_grid_alloc_processed_copy( rect_grid , zcorn , actnum );
+    ecl_grid_add_self_nnc( grid , 0 , 10 , 0 );
+    ecl_grid_add_self_nnc( grid , 0 , 20 , 1 );
+    ecl_grid_add_self_nnc( grid , 5 , 30 , 2 );
+
+    free( zcorn );
+    free( zcorn_float );
+    free( actnum );
+    ecl_grid_free( rect_grid );
+    return grid;
+  }
+}
+
+
+void assert_cell_equal( const ecl_grid_type * grid , const ecl_grid_type * lazy_grid , int g) {
+  double x1,y1,z1;
+  double x2,y2,z2;
+
+  test_assert_int_equal( ecl_grid_get_active_index1( grid , g ) , ecl_grid_get_active_index1( lazy_grid , g ));
+  test_assert_bool_equal( ecl_grid_cell_active1( grid , g ) , ecl_grid_cell_active1( lazy_grid , g ));
+  test_assert_bool_equal( ecl_grid_cell_invalid1( grid , g ) , ecl_grid_cell_invalid1( lazy_grid , g ));
+
+  ecl_grid_get_xyz1( grid , g , &x1 , &y1 , &z1 );
+  ecl_grid_get_xyz1( lazy_grid , g , &x2 , &y2 , &z2 );
+  test_assert_double_equal( x1 , x2 );
+  test_assert_double_equal( y1 , y2 );
+  test_assert_double_equal( z1 , z2 );
+
+  for (int c = 0; c < 8; c++) {
+    ecl_grid_get_cell_corner_xyz1( grid , g , c , &x1 , &y1 , &z1 );
+    ecl_grid_get_cell_corner_xyz1( lazy_grid , g , c , &x2 , &y2 , &z2 );
+    test_assert_double_equal( x1 , x2 );
+    test_assert_double_equal( y1 , y2 );
+    test_assert_double_equal( z1 , z2 );
+  }
+
+  test_assert_double_equal( ecl_grid_get_cell_volume1( grid , g ) , ecl_grid_get_cell_volume1( lazy_grid , g ));
+  test_assert_double_equal( ecl_grid_get_cell_dz1( grid , g ) , ecl_grid_get_cell_dz1( lazy_grid , g ));
+}
+
+
+void test_lazy_load( const ecl_grid_type * grid ) {
+  ecl_grid_type * lazy_grid = ecl_grid_alloc_EGRID_lazy( "TEST.EGRID" , true , 0 );
+  int global_size = ecl_grid_get_global_size( grid );
+
+  test_assert_true( ecl_grid_is_lazy( lazy_grid ));
+  test_assert_int_equal( ecl_grid_get_nactive( grid ) , ecl_grid_get_nactive( lazy_grid ));
+  test_assert_int_equal( ecl_grid_get_global_size( grid ) , global_size );
+
+  /* Sequential access in both directions and strided access - will evict from the cache. */
+  for (int g = 0; g < global_size; g++)
+    assert_cell_equal( grid , lazy_grid , g );
+
+  for (int g = global_size - 1; g >= 0; g -= 3)
+    assert_cell_equal( grid , lazy_grid , g );
+
+  for (int a = 0; a < ecl_grid_get_nactive( grid ); a++)
+    test_assert_int_equal( ecl_grid_get_global_index1A( grid , a ) , ecl_grid_get_global_index1A( lazy_grid , a ));
+
+  test_assert_int_equal( 3 , ecl_grid_get_num_nnc( lazy_grid ));
+  test_assert_true( nnc_info_equal( ecl_grid_get_cell_nnc_info1( grid , 0 ) , ecl_grid_get_cell_nnc_info1( lazy_grid , 0 )));
+  test_assert_NULL( ecl_grid_get_cell_nnc_info1( lazy_grid , 1 ));
+
+  test_assert_true( ecl_grid_compare( grid , lazy_grid , true , true , true ));
+  {
+    ecl_grid_type * copy = ecl_grid_alloc_copy( lazy_grid );
+    test_assert_false( ecl_grid_is_lazy( copy ));
+    test_assert_true( ecl_grid_compare( grid , copy , true , true , true ));
+    ecl_grid_free( copy );
+  }
+
+  ecl_grid_free( lazy_grid );
+}
+
+
+void test_reset_actnum( ecl_grid_type * grid ) {
+  ecl_grid_type * lazy_grid = ecl_grid_alloc_EGRID_lazy( "TEST.EGRID" , true , 16 );
+  int global_size = ecl_grid_get_global_size( grid );
+  int * actnum = util_malloc( global_size * sizeof * actnum );
+
+  for (int g = 0; g < global_size; g++)
+    actnum[g] = (g % 2);
+
+  /* Populate the cache before the active flags change. */
+  for (int g = 0; g < 16; g++)
+    assert_cell_equal( grid , lazy_grid , g );
+
+  ecl_grid_reset_actnum( grid , actnum );
+  ecl_grid_reset_actnum( lazy_grid , actnum );
+  test_assert_int_equal( global_size / 2 , ecl_grid_get_nactive( lazy_grid ));
+  for (int g = 0; g < global_size; g++)
+    assert_cell_equal( grid , lazy_grid , g );
+
+  ecl_grid_reset_actnum( lazy_grid , NULL );
+  test_assert_int_equal( global_size , ecl_grid_get_nactive( lazy_grid ));
+  test_assert_true( ecl_grid_cell_active1( lazy_grid , 0 ));
+
+  free( actnum );
+  ecl_grid_free( lazy_grid );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * test_area = test_work_area_alloc("ecl_grid_lazy");
+  ecl_grid_type * grid = alloc_test_grid( 6 , 7 , 8 );
+
+  ecl_grid_fwrite_EGRID2( grid , "TEST.EGRID" , ECL_METRIC_UNITS );
+  test_lazy_load( grid );
+  test_reset_actnum( grid );
+
+  ecl_grid_free( grid );
+  test_work_area_free( test_area );
+  exit(0);
+}
@@ -0,0 +1,234 @@
+/*
+   Copyright (C) 2018  Statoil ASA, Norway.
+
+   The file 'ecl_grid_snapshot.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/fortio.h>
+
+
+ecl_grid_type * alloc_test_grid( int nx , int ny , int nz ) {
+  int * actnum = util_malloc( nx*ny*nz * sizeof * actnum );
+  for (int g = 0; g < nx*ny*nz; g++)
+    actnum[g] = (g % 5) ? 1 : 0;
+
+  {
+    ecl_grid_type * rect_grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1 , 2 , 3 , actnum );
+    int zcorn_size = ecl_grid_get_zcorn_size( rect_grid );
+    float * zcorn_float = ecl_grid_alloc_zcorn_data( rect_grid );
+    double * zcorn = util_malloc( zcorn_size * sizeof * zcorn );
+    ecl_grid_type * grid;
+
+    for (int i = 0; i < zcorn_size; i++)
+      zcorn[i] = zcorn_float[i] + 0.10 * (i % 4);
+
+    grid = ecl_grid_alloc_processed_copy( rect_grid , zcorn , actnum );
+    ecl_grid_add_self_nnc( grid , 0 , 10 , 0 );
+    ecl_grid_add_self_nnc( grid , 0 , 20 , 1 );
+    ecl_grid_add_self_nnc( grid , 7 , 30 , 2 );
+
+    free( zcorn );
+    free( zcorn_float );
+    free( actnum );
+    ecl_grid_free( rect_grid );
+    return grid;
+  }
+}
+
+
+void assert_grid_equal( const ecl_grid_type * grid1 , const ecl_grid_type * grid2) {
+  test_assert_true( ecl_grid_compare( grid1 , grid2 , true , true , true ));
+  test_assert_int_equal( ecl_grid_get_nactive( grid1 ) , ecl_grid_get_nactive( grid2 ));
+  for (int g = 0; g < ecl_grid_get_global_size( grid1 ); g++) {
+    double x1,y1,z1;
+    double x2,y2,z2;
+
+    ecl_grid_get_xyz1( grid1 , g , &x1 , &y1 , &z1 );
+    ecl_grid_get_xyz1( grid2 , g , &x2 , &y2 , &z2 );
+    test_assert_double_equal( x1 , x2 );
+    test_assert_double_equal( y1 , y2 );
+    test_assert_double_equal( z1 , z2 );
+    test_assert_double_equal( ecl_grid_get_cell_volume1( grid1 , g ) , ecl_grid_get_cell_volume1( grid2 , g ));
+    test_assert_int_equal( ecl_grid_get_active_index1( grid1 , g ) , ecl_grid_get_active_index1( grid2 , g ));
+    {
+      const ecl_grid_type * lgr1 = ecl_grid_get_cell_lgr1( grid1 , g );
+      const ecl_grid_type * lgr2 = ecl_grid_get_cell_lgr1( grid2 , g );
+      if (lgr1)
+        test_assert_string_equal( ecl_grid_get_name( lgr1 ) , ecl_grid_get_name( lgr2 ));
+      else
+        test_assert_NULL( lgr2 );
+    }
+  }
+
+  for (int a = 0; a < ecl_grid_get_nactive( grid1 ); a++)
+    test_assert_int_equal( ecl_grid_get_global_index1A( grid1 , a ) , ecl_grid_get_global_index1A( grid2 , a ));
+
+  test_assert_int_equal( ecl_grid_get_num_lgr( grid1 ) , ecl_grid_get_num_lgr( grid2 ));
+}
+
+
+/*
+  Appends an LGR refining the host cells i = 1..2, j = 1..2, k = 2 of
+  an 8x7x6 grid 2x2x2 to an existing EGRID file.
+*/
+
+void fwrite_lgr( const char * egrid_file ) {
+  const int nx = 4;
+  const int ny = 4;
+  const int nz = 2;
+  ecl_grid_type * lgr_grid = ecl_grid_alloc_rectangular( nx , ny , nz , 0.5 , 1 , 1.5 , NULL );
+  ecl_grid_fwrite_EGRID2( lgr_grid , "LGR.EGRID" , ECL_METRIC_UNITS );
+  {
+    ecl_file_type * lgr_file = ecl_file_open( "LGR.EGRID" , 0 );
+    fortio_type * fortio = fortio_open_append( egrid_file , false , ECL_ENDIAN_FLIP );
+    ecl_kw_type * lgr_kw = ecl_kw_alloc( LGR_KW , 1 , ECL_CHAR );
+    ecl_kw_type * parent_kw = ecl_kw_alloc( LGR_PARENT_KW , 1 , ECL_CHAR );
+    ecl_kw_type * gridhead_kw = ecl_file_iget_named_kw( lgr_file , GRIDHEAD_KW , 0 );
+    ecl_kw_type * hostnum_kw = ecl_kw_alloc( HOSTNUM_KW , nx*ny*nz , ECL_INT );
+    ecl_kw_type * endgrid_kw = ecl_kw_alloc( ENDGRID_KW , 0 , ECL_INT );
+    ecl_kw_type * endlgr_kw = ecl_kw_alloc( ENDLGR_KW , 0 , ECL_INT );
+
+    ecl_kw_iset_string8( lgr_kw , 0 , "LGR1" );
+    ecl_kw_iset_string8( parent_kw , 0 , "" );
+    ecl_kw_iset_int( gridhead_kw , GRIDHEAD_LGR_INDEX , 1 );
+    for (int k = 0; k < nz; k++)
+      for (int j = 0; j < ny; j++)
+        for (int i = 0; i < nx; i++)
+          ecl_kw_iset_int( hostnum_kw , i + j*nx + k*nx*ny , 1 + (1 + i/2) + (1 + j/2)*8 + 2*8*7 );
+
+    ecl_kw_fwrite( lgr_kw , fortio );
+    ecl_kw_fwrite( parent_kw , fortio );
+    ecl_kw_fwrite( gridhead_kw , fortio );
+    ecl_kw_fwrite( ecl_file_iget_named_kw( lgr_file , COORD_KW , 0 ) , fortio );
+    ecl_kw_fwrite( ecl_file_iget_named_kw( lgr_file , ZCORN_KW , 0 ) , fortio );
+    ecl_kw_fwrite( ecl_file_iget_named_kw( lgr_file , ACTNUM_KW , 0 ) , fortio );
+    ecl_kw_fwrite( hostnum_kw , fortio );
+    ecl_kw_fwrite( endgrid_kw , fortio );
+    ecl_kw_fwrite( endlgr_kw , fortio );
+
+    ecl_kw_free( lgr_kw );
+    ecl_kw_free( parent_kw );
+    ecl_kw_free( hostnum_kw );
+    ecl_kw_free( endgrid_kw );
+    ecl_kw_free( endlgr_kw );
+    fortio_fclose( fortio );
+    ecl_file_close( lgr_file );
+  }
+  ecl_grid_free( lgr_grid );
+}
+
+
+void test_snapshot( ecl_grid_type * grid ) {
+  ecl_grid_fwrite_snapshot( grid , "TEST.SNAPSHOT" );
+  {
+    ecl_grid_type * snapshot_grid = ecl_grid_alloc_snapshot( "TEST.SNAPSHOT" );
+    test_assert_not_NULL( snapshot_grid );
+    assert_grid_equal( grid , snapshot_grid );
+
+    /* The snapshot grid can be written as a normal EGRID file. */
+    ecl_grid_fwrite_EGRID2( snapshot_grid , "SNAPSHOT.EGRID" , ECL_METRIC_UNITS );
+    {
+      ecl_grid_type * egrid = ecl_grid_alloc_EGRID( "SNAPSHOT.EGRID" , true );
+      test_assert_true( ecl_grid_compare( snapshot_grid , egrid , true , false , true ));
+      ecl_grid_free( egrid );
+    }
+
+    /* Modifying the snapshot grid must not affect the snapshot. */
+    {
+      int global_size = ecl_grid_get_global_size( grid );
+      int * actnum = util_malloc( global_size * sizeof * actnum );
+      for (int g = 0; g < global_size; g++)
+        actnum[g] = (g % 3) ? 1 : 0;
+
+      ecl_grid_reset_actnum( snapshot_grid , actnum );
+      test_assert_false( ecl_grid_compare( grid , snapshot_grid , true , false , false ));
+      {
+        ecl_grid_type * snapshot_grid2 = ecl_grid_alloc_snapshot( "TEST.SNAPSHOT" );
+        assert_grid_equal( grid , snapshot_grid2 );
+        ecl_grid_free( snapshot_grid2 );
+      }
+
+      ecl_grid_reset_actnum( grid , actnum );
+      assert_grid_equal( grid , snapshot_grid );
+      free( actnum );
+    }
+    ecl_grid_free( snapshot_grid );
+  }
+}
+
+
+/* The lgr references are resolved without writing to the mapped cells. */
+
+void test_lgr_snapshot( ecl_grid_type * grid ) {
+  test_assert_int_equal( 1 , ecl_grid_get_num_lgr( grid ));
+  test_assert_not_NULL( ecl_grid_get_cell_lgr3( grid , 2 , 1 , 2 ));
+  test_assert_NULL( ecl_grid_get_cell_lgr3( grid , 3 , 1 , 2 ));
+
+  ecl_grid_fwrite_snapshot( grid , "LGR.SNAPSHOT" );
+  {
+    ecl_grid_type * snapshot_grid = ecl_grid_alloc_snapshot( "LGR.SNAPSHOT" );
+    assert_grid_equal( grid , snapshot_grid );
+    test_assert_ptr_equal( ecl_grid_get_lgr( snapshot_grid , "LGR1" ) , ecl_grid_get_cell_lgr3( snapshot_grid , 1 , 2 , 2 ));
+    test_assert_NULL( ecl_grid_get_cell_lgr3( snapshot_grid , 1 , 3 , 2 ));
+    ecl_grid_free( snapshot_grid );
+  }
+  ecl_grid_free( grid );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * test_area = test_work_area_alloc("ecl_grid_snapshot");
+  test_assert_NULL( ecl_grid_alloc_snapshot( "DOES_NOT_EXIST.SNAPSHOT" ));
+
+  if (argc > 1) {
+    ecl_grid_type * grid = ecl_grid_alloc( argv[1] );
+    test_snapshot( grid );
+    ecl_grid_free( grid );
+  } else {
+    ecl_grid_type * grid = alloc_test_grid( 8 , 7 , 6 );
+    test_snapshot( grid );
+
+    ecl_grid_fwrite_EGRID2( grid , "TEST.EGRID" , ECL_METRIC_UNITS );
+    {
+      ecl_grid_type * lazy_grid = ecl_grid_alloc_EGRID_lazy( "TEST.EGRID" , true , 0 );
+      ecl_grid_fwrite_snapshot( lazy_grid , "LAZY.SNAPSHOT" );
+      {
+        ecl_grid_type * snapshot_grid = ecl_grid_alloc_snapshot( "LAZY.SNAPSHOT" );
+        assert_grid_equal( lazy_grid , snapshot_grid );
+        ecl_grid_free( snapshot_grid );
+      }
+      ecl_grid_free( lazy_grid );
+    }
+
+    fwrite_lgr( "TEST.EGRID" );
+    test_lgr_snapshot( ecl_grid_alloc_EGRID( "TEST.EGRID" , true ));
+    test_lgr_snapshot( ecl_grid_alloc_EGRID_lazy( "TEST.EGRID" , true , 0 ));
+    ecl_grid_free( grid );
+  }
+
+  test_work_area_free( test_area );
+  exit(0);
+}
@@ -0,0 +1,184 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_kw_arithmetic.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/int_vector.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_type.h>
+
+
+static ecl_kw_type * alloc_double_kw( int size , double phase ) {
+  ecl_kw_type * kw = ecl_kw_alloc( "DOUBLE" , size , ECL_DOUBLE );
+  int i;
+  for (i = 0; i < size; i++)
+    ecl_kw_iset_double( kw , i , 2.0 + sin( phase + 0.001 * i ));
+  return kw;
+}
+
+
+static void test_binary( int size ) {
+  ecl_kw_type * kw1 = alloc_double_kw( size , 0.0 );
+  ecl_kw_type * kw2 = alloc_double_kw( size , 1.0 );
+  ecl_kw_type * target = ecl_kw_alloc_copy( kw1 );
+  int i;
+
+  ecl_kw_inplace_add( target , kw2 );
+  for (i = 0; i < size; i++)
+    test_assert_double_equal( ecl_kw_iget_double( kw1 , i ) + ecl_kw_iget_double( kw2 , i ) , ecl_kw_iget_double( target , i ));
+
+  ecl_kw_inplace_mul( target , kw2 );
+  ecl_kw_inplace_div( target , kw2 );
+  ecl_kw_inplace_sub( target , kw2 );
+  for (i = 0; i < size; i++)
+    test_assert_double_equal( ecl_kw_iget_double( kw1 , i ) , ecl_kw_iget_double( target , i ));
+
+  ecl_kw_scale_double( target , 3 );
+  ecl_kw_shift_double( target , -1 );
+  for (i = 0; i < size; i++)
+    test_assert_double_equal( 3 * ecl_kw_iget_double( kw1 , i ) - 1 , ecl_kw_iget_double( target , i ));
+
+  ecl_kw_free( target );
+  ecl_kw_free( kw2 );
+  ecl_kw_free( kw1 );
+}
+
+
+static void test_indexed( int size ) {
+  ecl_kw_type * kw1 = alloc_double_kw( size , 0.0 );
+  ecl_kw_type * kw2 = alloc_double_kw( size , 1.0 );
+  ecl_kw_type * target = ecl_kw_alloc_copy( kw1 );
+  int_vector_type * index_list = int_vector_alloc( 0 , 0 );
+  int i;
+
+  for (i = 0; i < size; i += 3)
+    int_vector_append( index_list , i );
+
+  ecl_kw_inplace_mul_indexed( target , index_list , kw2 );
+  for (i = 0; i < size; i++) {
+    double expected = ecl_kw_iget_double( kw1 , i );
+    if ((i % 3) == 0)
+      expected *= ecl_kw_iget_double( kw2 , i );
+    test_assert_double_equal( expected , ecl_kw_iget_double( target , i ));
+  }
+
+  ecl_kw_inplace_div_indexed( target , index_list , kw2 );
+  for (i = 0; i < size; i++)
+    test_assert_double_equal( ecl_kw_iget_double( kw1 , i ) , ecl_kw_iget_double( target , i ));
+
+  {
+    double sum;
+    double expected = 0;
+    for (i = 0; i < size; i += 3)
+      expected += ecl_kw_iget_double( kw1 , i );
+
+    ecl_kw_element_sum_indexed( kw1 , index_list , &sum );
+    test_assert_double_equal( expected , sum );
+    test_assert_double_equal( expected , ecl_kw_element_sum_indexed_kahan( kw1 , index_list ));
+  }
+
+  int_vector_free( index_list );
+  ecl_kw_free( target );
+  ecl_kw_free( kw2 );
+  ecl_kw_free( kw1 );
+}
+
+
+static void test_max_min( int size ) {
+  ecl_kw_type * kw = ecl_kw_alloc( "INT" , size , ECL_INT );
+  int max , min;
+  int i;
+
+  for (i = 0; i < size; i++)
+    ecl_kw_iset_int( kw , i , (i * 7919) % 10007 - 5000 );
+
+  ecl_kw_iset_int( kw , size - 1 , 123456 );
+  ecl_kw_iset_int( kw , size / 2 , -123456 );
+  ecl_kw_max_min_int( kw , &max , &min );
+  test_assert_int_equal( 123456 , max );
+  test_assert_int_equal( -123456 , min );
+
+  max = min = 0;
+  ecl_kw_max_min( kw , &max , &min );
+  test_assert_int_equal( 123456 , max );
+  test_assert_int_equal( -123456 , min );
+  ecl_kw_free( kw );
+}
+
+
+static void test_max_min_nan( int size ) {
+  ecl_kw_type * kw = ecl_kw_alloc( "FLOAT" , size , ECL_FLOAT );
+  float max , min;
+  int i;
+
+  for (i = 0; i < size; i++)
+    ecl_kw_iset_float( kw , i , i );
+
+  ecl_kw_iset_float( kw , size - 1 , NAN );
+  ecl_kw_max_min_float( kw , &max , &min );
+  test_assert_float_equal( size - 2 , max );
+  test_assert_float_equal( 0 , min );
+  ecl_kw_free( kw );
+}
+
+
+static void test_sum( int size ) {
+  ecl_kw_type * kw = ecl_kw_alloc( "FLOAT" , size , ECL_FLOAT );
+  double exact = 0;
+  int i;
+
+  for (i = 0; i < size; i++) {
+    float value = 1.0 + 0.1 * (i % 10);
+    ecl_kw_iset_float( kw , i , value );
+    exact += value;
+  }
+
+  test_assert_double_equal( exact , ecl_kw_element_sum_kahan( kw ));
+  test_assert_true( fabs( ecl_kw_element_sum_float( kw ) - exact ) < 1e-5 * exact );
+  ecl_kw_free( kw );
+
+  kw = ecl_kw_alloc( "INT" , size , ECL_INT );
+  for (i = 0; i < size; i++)
+    ecl_kw_iset_int( kw , i , i % 100 );
+  {
+    int expected = 0;
+    for (i = 0; i < size; i++)
+      expected += i % 100;
+    test_assert_int_equal( expected , ecl_kw_element_sum_int( kw ));
+  }
+  ecl_kw_free( kw );
+}
+
+
+int main(int argc , char ** argv) {
+  const int sizes[3] = { 17 , 20000 , 250003 };
+  int is;
+
+  for (is = 0; is < 3; is++) {
+    test_binary( sizes[is] );
+    test_indexed( sizes[is] );
+    test_max_min( sizes[is] );
+    test_max_min_nan( sizes[is] );
+    test_sum( sizes[is] );
+  }
+  exit(0);
+}
@@ -0,0 +1,175 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_kw_benchmark.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+/*
+  Timing of the ecl_kw arithmetic functions against the plain serial
+  loops they replaced. This is not part of the test suite, run it
+  manually as:
+
+     ecl_kw_benchmark [size] [repeat]
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_type.h>
+
+
+static double wall_time( void ) {
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC , &ts );
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+
+static void report( const char * name , double t_ref , double t_new ) {
+  printf("%-12s  reference: %8.3f ms   ecl_kw: %8.3f ms   speedup: %6.2f\n", name , 1000 * t_ref , 1000 * t_new , t_ref / t_new );
+}
+
+
+/* The reference implementations; same loops as the original ecl_kw code. */
+
+static void ref_add( float * target , const float * add , int size ) {
+  int i;
+  for (i = 0; i < size; i++)
+    target[i] += add[i];
+}
+
+static void ref_scale( float * data , float factor , int size ) {
+  int i;
+  for (i = 0; i < size; i++)
+    data[i] *= factor;
+}
+
+static void ref_max_min( const float * data , int size , float * max , float * min) {
+  int i;
+  *max = data[0];
+  *min = data[0];
+  for (i = 1; i < size; i++)
+    util_update_float_max_min( data[i] , max , min );
+}
+
+static float ref_sum( const float * data , int size ) {
+  float sum = 0;
+  int i;
+  for (i = 0; i < size; i++)
+    sum += data[i];
+  return sum;
+}
+
+
+int main(int argc , char ** argv) {
+  int size   = 10000000;
+  int repeat = 10;
+  ecl_kw_type * kw1;
+  ecl_kw_type * kw2;
+  float * data1;
+  float * data2;
+  int i, r;
+
+  if (argc > 1)
+    util_sscanf_int( argv[1] , &size );
+  if (argc > 2)
+    util_sscanf_int( argv[2] , &repeat );
+
+  kw1 = ecl_kw_alloc( "KW1" , size , ECL_FLOAT );
+  kw2 = ecl_kw_alloc( "KW2" , size , ECL_FLOAT );
+  data1 = ecl_kw_get_float_ptr( kw1 );
+  data2 = ecl_kw_get_float_ptr( kw2 );
+  for (i = 0; i < size; i++) {
+    data1[i] = 1.0 + 0.001 * (i % 1000);
+    data2[i] = 0.5 + 0.002 * (i % 500);
+  }
+  printf("size: %d  repeat: %d\n", size , repeat);
+
+  {
+    double t0 = wall_time();
+    double t_ref, t_new;
+    for (r = 0; r < repeat; r++)
+      ref_add( data1 , data2 , size );
+    t_ref = wall_time() - t0;
+
+    t0 = wall_time();
+    for (r = 0; r < repeat; r++)
+      ecl_kw_inplace_add( kw1 , kw2 );
+    t_new = wall_time() - t0;
+    report( "inplace_add" , t_ref , t_new );
+  }
+
+  {
+    double t0 = wall_time();
+    double t_ref, t_new;
+    for (r = 0; r < repeat; r++)
+      ref_scale( data1 , 0.999 , size );
+    t_ref = wall_time() - t0;
+
+    t0 = wall_time();
+    for (r = 0; r < repeat; r++)
+      ecl_kw_scale_float( kw1 , 1.001 );
+    t_new = wall_time() - t0;
+    report( "scale" , t_ref , t_new );
+  }
+
+  {
+    float max , min;
+    double t0 = wall_time();
+    double t_ref, t_new;
+    for (r = 0; r < repeat; r++)
+      ref_max_min( data1 , size , &max , &min );
+    t_ref = wall_time() - t0;
+
+    t0 = wall_time();
+    for (r = 0; r < repeat; r++)
+      ecl_kw_max_min_float( kw1 , &max , &min );
+    t_new = wall_time() - t0;
+    report( "max_min" , t_ref , t_new );
+  }
+
+  {
+    float ref = 0;
+    double sum = 0;
+    double kahan = 0;
+    double t0 = wall_time();
+    double t_ref, t_new, t_kahan;
+    for (r = 0; r < repeat; r++)
+      ref = ref_sum( data1 , size );
+    t_ref = wall_time() - t0;
+
+    t0 = wall_time();
+    for (r = 0; r < repeat; r++)
+      sum = ecl_kw_element_sum_float( kw1 );
+    t_new = wall_time() - t0;
+
+    t0 = wall_time();
+    for (r = 0; r < repeat; r++)
+      kahan = ecl_kw_element_sum_kahan( kw1 );
+    t_kahan = wall_time() - t0;
+
+    report( "sum" , t_ref , t_new );
+    report( "sum_kahan" , t_ref , t_kahan );
+    printf("sum reference: %.8g  ecl_kw: %.8g  kahan: %.8g\n", ref , sum , kahan );
+  }
+
+  ecl_kw_free( kw1 );
+  ecl_kw_free( kw2 );
+  exit(0);
+}
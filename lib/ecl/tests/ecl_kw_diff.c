@@ -0,0 +1,248 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_kw_diff.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_type.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_kw_diff.h>
+
+
+#define SIZE 50000
+
+
+static ecl_kw_type * alloc_pressure( float shift , int shift_index ) {
+  ecl_kw_type * kw = ecl_kw_alloc( "PRESSURE" , SIZE , ECL_FLOAT );
+  int i;
+  for (i = 0; i < SIZE; i++)
+    ecl_kw_iset_float( kw , i , 100 + 0.01 * i + ((i >= shift_index) ? shift : 0));
+  return kw;
+}
+
+
+static void test_kw_diff( void ) {
+  ecl_kw_type * kw1 = alloc_pressure( 0 , 0 );
+  ecl_kw_type * kw2 = alloc_pressure( 0.5 , 30000 );
+
+  {
+    ecl_kw_diff_type * diff = ecl_kw_diff_alloc( kw1 , kw1 , 0 , 0 );
+    test_assert_true( ecl_kw_diff_is_instance( diff ));
+    test_assert_true( ecl_kw_diff_equal( diff ));
+    test_assert_int_equal( 0 , ecl_kw_diff_get_count( diff ));
+    test_assert_int_equal( -1 , ecl_kw_diff_get_first_index( diff ));
+    ecl_kw_diff_free( diff );
+  }
+
+  {
+    ecl_kw_diff_type * diff = ecl_kw_diff_alloc( kw1 , kw2 , 0 , 0 );
+    test_assert_int_equal( ECL_KW_DIFF_VALUES , ecl_kw_diff_get_status( diff ));
+    test_assert_int_equal( SIZE - 30000 , ecl_kw_diff_get_count( diff ));
+    test_assert_int_equal( 30000 , ecl_kw_diff_get_first_index( diff ));
+    test_assert_true( fabs( ecl_kw_diff_get_max_abs_diff( diff ) - 0.5 ) < 1e-3 );
+    ecl_kw_diff_free( diff );
+  }
+
+  {
+    ecl_kw_diff_type * diff = ecl_kw_diff_alloc( kw1 , kw2 , 1.0 , 0 );
+    test_assert_true( ecl_kw_diff_equal( diff ));
+    test_assert_true( fabs( ecl_kw_diff_get_max_abs_diff( diff ) - 0.5 ) < 1e-3 );
+    ecl_kw_diff_free( diff );
+  }
+
+  {
+    ecl_kw_diff_type * diff = ecl_kw_diff_alloc( kw1 , NULL , 0 , 0 );
+    test_assert_int_equal( ECL_KW_DIFF_MISSING2 , ecl_kw_diff_get_status( diff ));
+    test_assert_string_equal( "PRESSURE" , ecl_kw_diff_get_header( diff ));
+    ecl_kw_diff_free( diff );
+  }
+
+  {
+    ecl_kw_type * int_kw = ecl_kw_alloc( "PRESSURE" , SIZE , ECL_INT );
+    ecl_kw_type * short_kw = ecl_kw_alloc( "PRESSURE" , 10 , ECL_FLOAT );
+    ecl_kw_diff_type * diff;
+
+    ecl_kw_scalar_set_int( int_kw , 0 );
+    ecl_kw_scalar_set_float( short_kw , 0 );
+    diff = ecl_kw_diff_alloc( kw1 , int_kw , 0 , 0 );
+    test_assert_int_equal( ECL_KW_DIFF_TYPE_MISMATCH , ecl_kw_diff_get_status( diff ));
+    ecl_kw_diff_free( diff );
+
+    diff = ecl_kw_diff_alloc( kw1 , short_kw , 0 , 0 );
+    test_assert_int_equal( ECL_KW_DIFF_SIZE_MISMATCH , ecl_kw_diff_get_status( diff ));
+    ecl_kw_diff_free( diff );
+
+    ecl_kw_free( short_kw );
+    ecl_kw_free( int_kw );
+  }
+
+  {
+    ecl_kw_type * kw3 = ecl_kw_alloc_copy( kw1 );
+    ecl_kw_diff_type * diff;
+
+    ecl_kw_iset_float( kw3 , 17 , NAN );
+    diff = ecl_kw_diff_alloc( kw1 , kw3 , 1.0 , 0 );
+    test_assert_int_equal( 1 , ecl_kw_diff_get_count( diff ));
+    test_assert_int_equal( 17 , ecl_kw_diff_get_first_index( diff ));
+    ecl_kw_diff_free( diff );
+
+    diff = ecl_kw_diff_alloc( kw3 , kw3 , 1.0 , 0 );
+    test_assert_true( ecl_kw_diff_equal( diff ));
+    ecl_kw_diff_free( diff );
+    ecl_kw_free( kw3 );
+  }
+
+  ecl_kw_free( kw1 );
+  ecl_kw_free( kw2 );
+}
+
+
+/* The non unified restart files written by the simulator have no SEQNUM keyword. */
+
+static void fwrite_step( fortio_type * fortio , int step , bool modified , bool unified ) {
+  ecl_kw_type * seqnum = ecl_kw_alloc( "SEQNUM" , 1 , ECL_INT );
+  ecl_kw_type * pressure = alloc_pressure( (modified && step == 2) ? 1.0 : 0 , 100 );
+  ecl_kw_type * names = ecl_kw_alloc( "NAMES" , 2 , ECL_CHAR );
+
+  ecl_kw_iset_int( seqnum , 0 , step );
+  ecl_kw_iset_char_ptr( names , 0 , "WELL1" );
+  ecl_kw_iset_char_ptr( names , 1 , (modified && step == 1) ? "WELL3" : "WELL2" );
+
+  if (unified)
+    ecl_kw_fwrite( seqnum , fortio );
+  ecl_kw_fwrite( pressure , fortio );
+  ecl_kw_fwrite( names , fortio );
+
+  ecl_kw_free( seqnum );
+  ecl_kw_free( pressure );
+  ecl_kw_free( names );
+}
+
+
+static void write_split( const char * base ) {
+  int step;
+  for (step = 0; step < 3; step++) {
+    char * filename = ecl_util_alloc_filename( NULL , base , ECL_RESTART_FILE , false , step );
+    fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+    fwrite_step( fortio , step , false , false );
+    fortio_fclose( fortio );
+    free( filename );
+  }
+}
+
+
+static void write_file( const char * filename , bool modified ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  int step;
+
+  for (step = 0; step < 3; step++)
+    fwrite_step( fortio , step , modified , true );
+
+  if (modified) {
+    ecl_kw_type * extra = ecl_kw_alloc( "EXTRA" , 5 , ECL_DOUBLE );
+    ecl_kw_scalar_set_double( extra , 1 );
+    ecl_kw_fwrite( extra , fortio );
+    ecl_kw_free( extra );
+  }
+  fortio_fclose( fortio );
+}
+
+
+static void test_file_diff( void ) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_kw_diff");
+  write_file( "CASE1.UNRST" , false );
+  write_file( "CASE2.UNRST" , true );
+  {
+    ecl_file_type * file1 = ecl_file_open( "CASE1.UNRST" , 0 );
+    ecl_file_type * file2 = ecl_file_open( "CASE2.UNRST" , 0 );
+
+    {
+      ecl_file_diff_type * diff = ecl_file_diff_alloc( file1 , file1 , 0 , 0 );
+      test_assert_true( ecl_file_diff_is_instance( diff ));
+      test_assert_true( ecl_file_diff_equal( diff ));
+      test_assert_int_equal( 9 , ecl_file_diff_get_size( diff ));
+      ecl_file_diff_free( diff );
+    }
+
+    {
+      ecl_file_diff_type * diff = ecl_file_diff_alloc( file1 , file2 , 0 , 0 );
+      const ecl_kw_diff_type * kw_diff;
+
+      test_assert_false( ecl_file_diff_equal( diff ));
+      test_assert_int_equal( 10 , ecl_file_diff_get_size( diff ));
+      test_assert_int_equal( 3 , ecl_file_diff_get_num_different( diff ));
+
+      kw_diff = ecl_file_diff_iget( diff , 5 );
+      test_assert_string_equal( "NAMES" , ecl_kw_diff_get_header( kw_diff ));
+      test_assert_int_equal( 1 , ecl_kw_diff_get_occurence( kw_diff ));
+      test_assert_int_equal( 1 , ecl_kw_diff_get_count( kw_diff ));
+      test_assert_int_equal( 1 , ecl_kw_diff_get_first_index( kw_diff ));
+
+      kw_diff = ecl_file_diff_iget( diff , 7 );
+      test_assert_string_equal( "PRESSURE" , ecl_kw_diff_get_header( kw_diff ));
+      test_assert_int_equal( 2 , ecl_kw_diff_get_occurence( kw_diff ));
+      test_assert_int_equal( SIZE - 100 , ecl_kw_diff_get_count( kw_diff ));
+      test_assert_int_equal( 100 , ecl_kw_diff_get_first_index( kw_diff ));
+
+      kw_diff = ecl_file_diff_iget( diff , 9 );
+      test_assert_string_equal( "EXTRA" , ecl_kw_diff_get_header( kw_diff ));
+      test_assert_int_equal( ECL_KW_DIFF_MISSING1 , ecl_kw_diff_get_status( kw_diff ));
+      ecl_file_diff_free( diff );
+    }
+
+    {
+      ecl_file_diff_type * diff = ecl_file_diff_alloc( file1 , file2 , 0 , 0.01 );
+      test_assert_int_equal( 2 , ecl_file_diff_get_num_different( diff ));
+      ecl_file_diff_free( diff );
+    }
+
+    /* The keywords of a restart case come from several files, the SEQNUM keywords from memory. */
+    write_split( "SPLIT" );
+    {
+      ecl_file_type * split_file = ecl_file_open_restart_case( "SPLIT" , 2 , 0 );
+      ecl_file_diff_type * diff = ecl_file_diff_alloc( split_file , file1 , 0 , 0 );
+      test_assert_true( ecl_file_diff_equal( diff ));
+      test_assert_int_equal( 9 , ecl_file_diff_get_size( diff ));
+      ecl_file_diff_free( diff );
+
+      diff = ecl_file_diff_alloc( file2 , split_file , 0 , 0 );
+      test_assert_int_equal( 3 , ecl_file_diff_get_num_different( diff ));
+      ecl_file_diff_free( diff );
+      ecl_file_close( split_file );
+    }
+
+    ecl_file_close( file1 );
+    ecl_file_close( file2 );
+  }
+  test_work_area_free( work_area );
+}
+
+
+int main(int argc , char ** argv) {
+  test_kw_diff();
+  test_file_diff();
+  exit(0);
+}
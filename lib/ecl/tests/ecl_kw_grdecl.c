@@ -23,6 +23,97 @@
 #include <ert/util/test_work_area.h>
 
 #include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_grdecl.h>
+#include <ert/ecl/ecl_grid.h>
+
+
+static ecl_kw_type * fprintf_fscanf( const ecl_kw_type * ecl_kw ) {
+  ecl_kw_type * ecl_kw2;
+  FILE * stream = util_fopen( "ROUND_TRIP.grdecl" , "w");
+  ecl_kw_fprintf_grdecl( ecl_kw , stream );
+  fclose( stream );
+
+  stream = util_fopen( "ROUND_TRIP.grdecl" , "r");
+  ecl_kw2 = ecl_kw_fscanf_alloc_grdecl( stream , ecl_kw_get_header( ecl_kw ) , ecl_kw_get_size( ecl_kw ) , ecl_kw_get_data_type( ecl_kw ));
+  fclose( stream );
+  return ecl_kw2;
+}
+
+
+static void test_compressed( void ) {
+  ecl_kw_type * poro = ecl_kw_alloc( "PORO" , 10 , ECL_FLOAT );
+  ecl_kw_type * ecl_kw2;
+  int i;
+
+  for (i = 0; i < 10; i++)
+    ecl_kw_iset_float( poro , i , (i < 6) ? 0.25 : 0.1 * i );
+
+  ecl_kw2 = fprintf_fscanf( poro );
+  test_assert_true( ecl_kw_equal( poro , ecl_kw2 ));
+  ecl_kw_free( ecl_kw2 );
+  {
+    char * content = util_fread_alloc_file_content( "ROUND_TRIP.grdecl" , NULL );
+    test_assert_string_equal( "PORO\n 6*0.25 0.6 0.7 0.8 0.9\n/\n" , content );
+    free( content );
+  }
+  ecl_kw_free( poro );
+}
+
+
+static void test_large( ecl_data_type data_type ) {
+  const int size = 250000;
+  ecl_kw_type * ecl_kw = ecl_kw_alloc( "LARGE" , size , data_type );
+  ecl_kw_type * ecl_kw2;
+  int i;
+
+  for (i = 0; i < size; i++) {
+    double value = (i % 100 < 10) ? 1.0 / 3 : 1e-7 * i * i - 17.0;
+    if (ecl_type_is_int( data_type ))
+      ecl_kw_iset_int( ecl_kw , i , (int) (value * 10));
+    else if (ecl_type_is_float( data_type ))
+      ecl_kw_iset_float( ecl_kw , i , value );
+    else
+      ecl_kw_iset_double( ecl_kw , i , value );
+  }
+
+  ecl_kw2 = fprintf_fscanf( ecl_kw );
+  test_assert_true( ecl_kw_equal( ecl_kw , ecl_kw2 ));
+  ecl_kw_free( ecl_kw2 );
+  ecl_kw_free( ecl_kw );
+}
+
+
+static void test_grid( void ) {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 60 , 50 , 40 , 1 , 2 , 3 , NULL );
+  {
+    FILE * stream = util_fopen( "GRID.grdecl" , "w");
+    ecl_grid_fprintf_grdecl( grid , stream );
+    fclose( stream );
+  }
+  {
+    FILE * stream = util_fopen( "GRID.grdecl" , "r");
+    ecl_kw_type * zcorn = ecl_kw_fscanf_alloc_grdecl( stream , "ZCORN" , 8 * ecl_grid_get_global_size( grid ) , ECL_FLOAT );
+    ecl_kw_type * coord = ecl_kw_fscanf_alloc_grdecl( stream , "COORD" , ecl_grid_get_coord_size( grid ) , ECL_FLOAT );
+    ecl_kw_type * actnum = ecl_kw_fscanf_alloc_grdecl( stream , "ACTNUM" , ecl_grid_get_global_size( grid ) , ECL_INT );
+    ecl_grid_type * grid2 = ecl_grid_alloc_GRDECL_kw( 60 , 50 , 40 , zcorn , coord , actnum , NULL );
+
+    test_assert_true( ecl_grid_compare( grid , grid2 , false , false , true ));
+    ecl_grid_free( grid2 );
+    ecl_kw_free( zcorn );
+    ecl_kw_free( coord );
+    ecl_kw_free( actnum );
+    fclose( stream );
+  }
+
+  ecl_grid_fwrite_EGRID2( grid , "GRID.EGRID" , ECL_METRIC_UNITS );
+  {
+    ecl_grid_type * grid2 = ecl_grid_alloc( "GRID.EGRID" );
+    test_assert_true( ecl_grid_compare( grid , grid2 , false , false , true ));
+    ecl_grid_free( grid2 );
+  }
+  ecl_grid_free( grid );
+}
+
 
 int main(int argc , char ** argv) {  
   int i;
@@ -65,6 +156,12 @@ int main(int argc , char ** argv) {
       ecl_kw_free( ecl_kw2 );
     }
     fclose( stream );
+
+    test_compressed();
+    test_large( ECL_INT );
+    test_large( ECL_FLOAT );
+    test_large( ECL_DOUBLE );
+    test_grid();
     test_work_area_free( work_area );
   }
   ecl_kw_free( ecl_kw );
@@ -0,0 +1,264 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_region_bitset.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/int_vector.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region.h>
+
+/*
+  The grid has 7*5*3 = 105 cells, i.e. the bitset in the region does
+  not fill a whole number of words, and every third cell is inactive.
+*/
+
+#define NX 7
+#define NY 5
+#define NZ 3
+
+
+static ecl_grid_type * alloc_grid( ) {
+  int actnum[NX*NY*NZ];
+  int g;
+  for (g = 0; g < NX*NY*NZ; g++)
+    actnum[g] = (g % 3) ? 1 : 0;
+  return ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , actnum );
+}
+
+
+static void assert_region( ecl_region_type * region , const ecl_grid_type * grid , const bool * expected ) {
+  const int_vector_type * global_list = ecl_region_get_global_list( region );
+  const int_vector_type * active_list = ecl_region_get_active_list( region );
+  const int_vector_type * global_active_list = ecl_region_get_global_active_list( region );
+  int global_pos = 0;
+  int active_pos = 0;
+  int g;
+
+  for (g = 0; g < ecl_grid_get_global_size( grid ); g++) {
+    test_assert_bool_equal( expected[g] , ecl_region_contains_global( region , g ));
+    if (expected[g]) {
+      int active_index = ecl_grid_get_active_index1( grid , g );
+      test_assert_int_equal( g , int_vector_iget( global_list , global_pos ));
+      global_pos++;
+
+      if (active_index >= 0) {
+        test_assert_int_equal( active_index , int_vector_iget( active_list , active_pos ));
+        test_assert_int_equal( g , int_vector_iget( global_active_list , active_pos ));
+        active_pos++;
+      }
+    }
+  }
+  test_assert_int_equal( global_pos , int_vector_size( global_list ));
+  test_assert_int_equal( active_pos , int_vector_size( active_list ));
+  test_assert_int_equal( active_pos , int_vector_size( global_active_list ));
+}
+
+
+static void test_reset_invert( const ecl_grid_type * grid ) {
+  ecl_region_type * region = ecl_region_alloc( grid , true );
+  bool expected[NX*NY*NZ];
+  int g;
+
+  for (g = 0; g < NX*NY*NZ; g++)
+    expected[g] = true;
+  assert_region( region , grid , expected );
+
+  ecl_region_invert_selection( region );
+  for (g = 0; g < NX*NY*NZ; g++)
+    expected[g] = false;
+  assert_region( region , grid , expected );
+
+  ecl_region_select_global_index( region , NX*NY*NZ - 1 );
+  ecl_region_invert_selection( region );
+  for (g = 0; g < NX*NY*NZ; g++)
+    expected[g] = (g != NX*NY*NZ - 1);
+  assert_region( region , grid , expected );
+
+  ecl_region_free( region );
+}
+
+
+static void test_select_float( const ecl_grid_type * grid ) {
+  const int nactive = ecl_grid_get_active_size( grid );
+  ecl_kw_type * global_kw = ecl_kw_alloc( "PORO" , NX*NY*NZ , ECL_FLOAT );
+  ecl_kw_type * active_kw = ecl_kw_alloc( "PORO" , nactive , ECL_FLOAT );
+  ecl_kw_type * other_kw  = ecl_kw_alloc( "PORV" , NX*NY*NZ , ECL_FLOAT );
+  bool expected[NX*NY*NZ];
+  int g;
+
+  for (g = 0; g < NX*NY*NZ; g++) {
+    ecl_kw_iset_float( global_kw , g , (g % 10) * 0.1 );
+    ecl_kw_iset_float( other_kw , g , 0.45 );
+  }
+  for (g = 0; g < nactive; g++)
+    ecl_kw_iset_float( active_kw , g , (g % 10) * 0.1 );
+
+  {
+    ecl_region_type * region = ecl_region_alloc( grid , false );
+    ecl_region_select_in_interval( region , global_kw , 0.25 , 0.75 );
+    for (g = 0; g < NX*NY*NZ; g++) {
+      float value = ecl_kw_iget_float( global_kw , g );
+      expected[g] = (value >= 0.25) && (value < 0.75);
+    }
+    assert_region( region , grid , expected );
+
+    ecl_region_deselect_smaller( region , global_kw , 0.45 );
+    for (g = 0; g < NX*NY*NZ; g++)
+      if (ecl_kw_iget_float( global_kw , g ) < 0.45)
+        expected[g] = false;
+    assert_region( region , grid , expected );
+
+    ecl_region_cmp_select_less( region , global_kw , other_kw );
+    for (g = 0; g < NX*NY*NZ; g++)
+      if (ecl_kw_iget_float( global_kw , g ) < 0.45)
+        expected[g] = true;
+    assert_region( region , grid , expected );
+    ecl_region_free( region );
+  }
+
+  {
+    ecl_region_type * region = ecl_region_alloc( grid , false );
+    ecl_region_select_larger( region , active_kw , 0.55 );
+    for (g = 0; g < NX*NY*NZ; g++) {
+      int active_index = ecl_grid_get_active_index1( grid , g );
+      expected[g] = (active_index >= 0) && (ecl_kw_iget_float( active_kw , active_index ) >= 0.55);
+    }
+    assert_region( region , grid , expected );
+    ecl_region_free( region );
+  }
+
+  ecl_kw_free( global_kw );
+  ecl_kw_free( active_kw );
+  ecl_kw_free( other_kw );
+}
+
+
+static void test_select_int( const ecl_grid_type * grid ) {
+  ecl_kw_type * fipnum = ecl_kw_alloc( "FIPNUM" , NX*NY*NZ , ECL_INT );
+  ecl_region_type * region = ecl_region_alloc( grid , false );
+  bool expected[NX*NY*NZ];
+  int g;
+
+  for (g = 0; g < NX*NY*NZ; g++)
+    ecl_kw_iset_int( fipnum , g , g % 4 );
+
+  ecl_region_select_equal( region , fipnum , 2 );
+  for (g = 0; g < NX*NY*NZ; g++)
+    expected[g] = (g % 4 == 2);
+  assert_region( region , grid , expected );
+
+  ecl_region_select_larger( region , fipnum , 2 );
+  for (g = 0; g < NX*NY*NZ; g++)
+    expected[g] = (g % 4 >= 2);
+  assert_region( region , grid , expected );
+
+  ecl_region_free( region );
+  ecl_kw_free( fipnum );
+}
+
+
+static void test_slices( const ecl_grid_type * grid ) {
+  ecl_region_type * region = ecl_region_alloc( grid , false );
+  bool expected[NX*NY*NZ];
+  int i,j,k;
+
+  ecl_region_select_k1k2( region , 1 , 1 );
+  ecl_region_select_j1j2( region , 2 , 3 );
+  ecl_region_deselect_i1i2( region , 0 , 1 );
+  for (k = 0; k < NZ; k++)
+    for (j = 0; j < NY; j++)
+      for (i = 0; i < NX; i++)
+        expected[ i + j*NX + k*NX*NY ] = ((k == 1) || (j >= 2 && j <= 3)) && (i > 1);
+  assert_region( region , grid , expected );
+
+  ecl_region_free( region );
+}
+
+
+static void test_set_operations( const ecl_grid_type * grid ) {
+  ecl_region_type * region1 = ecl_region_alloc( grid , false );
+  ecl_region_type * region2 = ecl_region_alloc( grid , false );
+  bool expected[NX*NY*NZ];
+  int g;
+
+  ecl_region_select_k1k2( region1 , 0 , 1 );
+  ecl_region_select_k1k2( region2 , 1 , 2 );
+
+  {
+    ecl_region_type * region = ecl_region_alloc_copy( region1 );
+    ecl_region_intersection( region , region2 );
+    for (g = 0; g < NX*NY*NZ; g++)
+      expected[g] = (g / (NX*NY) == 1);
+    assert_region( region , grid , expected );
+    ecl_region_free( region );
+  }
+
+  {
+    ecl_region_type * region = ecl_region_alloc_copy( region1 );
+    ecl_region_union( region , region2 );
+    for (g = 0; g < NX*NY*NZ; g++)
+      expected[g] = true;
+    assert_region( region , grid , expected );
+    ecl_region_free( region );
+  }
+
+  {
+    ecl_region_type * region = ecl_region_alloc_copy( region1 );
+    ecl_region_subtract( region , region2 );
+    for (g = 0; g < NX*NY*NZ; g++)
+      expected[g] = (g / (NX*NY) == 0);
+    assert_region( region , grid , expected );
+    ecl_region_free( region );
+  }
+
+  {
+    ecl_region_type * region = ecl_region_alloc_copy( region1 );
+
+    /* ecl_region_xor() has always computed A ^= !B. */
+    ecl_region_xor( region , region2 );
+    for (g = 0; g < NX*NY*NZ; g++)
+      expected[g] = (g / (NX*NY) == 1);
+    assert_region( region , grid , expected );
+
+    ecl_region_invert_selection( region );
+    for (g = 0; g < NX*NY*NZ; g++)
+      expected[g] = (g / (NX*NY) != 1);
+    assert_region( region , grid , expected );
+    ecl_region_free( region );
+  }
+
+  ecl_region_free( region1 );
+  ecl_region_free( region2 );
+}
+
+
+int main(int argc , char ** argv) {
+  ecl_grid_type * grid = alloc_grid( );
+
+  test_reset_invert( grid );
+  test_select_float( grid );
+  test_select_int( grid );
+  test_slices( grid );
+  test_set_operations( grid );
+
+  ecl_grid_free( grid );
+  exit(0);
+}
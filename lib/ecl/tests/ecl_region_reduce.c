@@ -0,0 +1,272 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_region_reduce.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region_reduce.h>
+
+
+#define NUM_REGIONS 7
+#define NUM_STEPS   4
+
+
+static void assert_close( double expected , double value ) {
+  double tolerance = 1e-10 * util_double_max( 1.0 , fabs( expected ));
+  if (fabs( expected - value ) > tolerance)
+    test_error_exit("Reduced value:%.15g differs from expected:%.15g \n", value , expected);
+}
+
+
+/*
+  Brute force evaluation of the statistics for one region.
+*/
+
+static void check_region( const ecl_grid_type * grid , const ecl_region_reduce_type * reducer , int field ,
+                          const ecl_kw_type * region_kw , const ecl_kw_type * field_kw , const ecl_kw_type * weight_kw , int region) {
+  double sum = 0;
+  double weight = 0;
+  double min = INFINITY;
+  double max = -INFINITY;
+  int count = 0;
+  int a;
+
+  for (a = 0; a < ecl_kw_get_size( region_kw ); a++) {
+    if (ecl_kw_iget_int( region_kw , a ) == region) {
+      double x = ecl_kw_iget_as_double( field_kw , a );
+      double w = 1;
+      if (weight_kw) {
+        if (ecl_kw_get_size( weight_kw ) == ecl_kw_get_size( region_kw ))
+          w = ecl_kw_iget_as_double( weight_kw , a );
+        else
+          w = ecl_kw_iget_as_double( weight_kw , ecl_grid_get_global_index1A( grid , a ));
+      }
+      sum += w * x;
+      weight += w;
+      min = util_double_min( min , x );
+      max = util_double_max( max , x );
+      count++;
+    }
+  }
+
+  test_assert_int_equal( count , ecl_region_reduce_iget_count( reducer , region ));
+  if (count > 0) {
+    assert_close( sum , ecl_region_reduce_iget_sum( reducer , field , region ));
+    assert_close( weight , ecl_region_reduce_iget_weight( reducer , field , region ));
+    assert_close( sum / weight , ecl_region_reduce_iget_mean( reducer , field , region ));
+    test_assert_double_equal( min , ecl_region_reduce_iget_min( reducer , field , region ));
+    test_assert_double_equal( max , ecl_region_reduce_iget_max( reducer , field , region ));
+  } else {
+    test_assert_true( isnan( ecl_region_reduce_iget_mean( reducer , field , region )));
+    test_assert_true( isnan( ecl_region_reduce_iget_min( reducer , field , region )));
+  }
+}
+
+
+static ecl_kw_type * alloc_field( const char * kw , int size , ecl_data_type data_type , int step ) {
+  ecl_kw_type * ecl_kw = ecl_kw_alloc( kw , size , data_type );
+  int i;
+  for (i = 0; i < size; i++) {
+    double value = 100 + step + 10 * sin( 0.01 * i * (step + 1));
+    if (ecl_type_is_float( data_type ))
+      ecl_kw_iset_float( ecl_kw , i , value );
+    else
+      ecl_kw_iset_double( ecl_kw , i , value );
+  }
+  return ecl_kw;
+}
+
+
+static ecl_kw_type * alloc_fipnum( int size ) {
+  ecl_kw_type * fipnum = ecl_kw_alloc( "FIPNUM" , size , ECL_INT );
+  int i;
+  /* Region 5 is left empty, and some cells are not in any region. */
+  for (i = 0; i < size; i++) {
+    int region = (i / 1000) % NUM_REGIONS;
+    ecl_kw_iset_int( fipnum , i , (region == 5) ? 0 : region );
+  }
+  return fipnum;
+}
+
+
+static void test_eval( const ecl_grid_type * grid ) {
+  const int nactive = ecl_grid_get_active_size( grid );
+  ecl_kw_type * fipnum   = alloc_fipnum( nactive );
+  ecl_kw_type * pressure = alloc_field( "PRESSURE" , nactive , ECL_FLOAT , 0 );
+  ecl_kw_type * soil     = alloc_field( "SOIL" , nactive , ECL_DOUBLE , 1 );
+  ecl_kw_type * porv     = alloc_field( "PORV" , ecl_grid_get_global_size( grid ) , ECL_FLOAT , 2 );
+  ecl_region_reduce_type * reducer = ecl_region_reduce_alloc( grid , fipnum );
+  const ecl_kw_type * fields[3]  = { pressure , soil , pressure };
+  const ecl_kw_type * weights[3] = { porv , porv , NULL };
+  int r;
+
+  test_assert_true( ecl_region_reduce_is_instance( reducer ));
+  test_assert_int_equal( NUM_REGIONS - 1 , ecl_region_reduce_get_max_region( reducer ));
+
+  ecl_region_reduce_eval( reducer , 3 , fields , weights );
+  test_assert_int_equal( 3 , ecl_region_reduce_get_num_fields( reducer ));
+  for (r = 1; r < NUM_REGIONS; r++) {
+    check_region( grid , reducer , 0 , fipnum , pressure , porv , r );
+    check_region( grid , reducer , 1 , fipnum , soil , porv , r );
+    check_region( grid , reducer , 2 , fipnum , pressure , NULL , r );
+  }
+  test_assert_int_equal( 0 , ecl_region_reduce_iget_count( reducer , 5 ));
+
+  ecl_region_reduce_free( reducer );
+  ecl_kw_free( fipnum );
+  ecl_kw_free( pressure );
+  ecl_kw_free( soil );
+  ecl_kw_free( porv );
+}
+
+
+typedef struct {
+  const ecl_grid_type * grid;
+  const ecl_kw_type   * fipnum;
+  const ecl_kw_type   * porv;
+  int                   num_calls;
+} step_context_type;
+
+
+static void step_callback( const ecl_region_reduce_type * reducer , int report_step , void * arg ) {
+  step_context_type * context = arg;
+  const int nactive = ecl_grid_get_active_size( context->grid );
+  int step = report_step / 10;
+  ecl_kw_type * pressure = alloc_field( "PRESSURE" , nactive , ECL_FLOAT , step );
+  ecl_kw_type * rporv    = alloc_field( "RPORV" , nactive , ECL_DOUBLE , step );
+  const ecl_kw_type * weight = (step % 2 == 0) ? rporv : context->porv;
+  int r;
+
+  test_assert_int_equal( context->num_calls * 10 , report_step );
+  for (r = 1; r < NUM_REGIONS; r++)
+    check_region( context->grid , reducer , 0 , context->fipnum , pressure , weight , r );
+
+  ecl_kw_free( pressure );
+  ecl_kw_free( rporv );
+  context->num_calls++;
+}
+
+
+static void fwrite_step( fortio_type * fortio , int nactive , int step ) {
+  ecl_kw_type * pressure = alloc_field( "PRESSURE" , nactive , ECL_FLOAT , step );
+
+  ecl_kw_fwrite( pressure , fortio );
+  if (step % 2 == 0) {
+    ecl_kw_type * rporv = alloc_field( "RPORV" , nactive , ECL_DOUBLE , step );
+    ecl_kw_fwrite( rporv , fortio );
+    ecl_kw_free( rporv );
+  }
+  ecl_kw_free( pressure );
+}
+
+
+/*
+  Writes the report steps both as the unified file CASE.UNRST and as
+  the non unified files SPLIT.Xnnnn, which have no SEQNUM keyword.
+*/
+
+static void write_restart( int nactive ) {
+  fortio_type * fortio = fortio_open_writer( "CASE.UNRST" , false , ECL_ENDIAN_FLIP );
+  int step;
+  for (step = 0; step < NUM_STEPS; step++) {
+    ecl_kw_type * seqnum = ecl_kw_alloc( SEQNUM_KW , 1 , ECL_INT );
+    ecl_kw_iset_int( seqnum , 0 , 10 * step );
+    ecl_kw_fwrite( seqnum , fortio );
+    ecl_kw_free( seqnum );
+    fwrite_step( fortio , nactive , step );
+
+    {
+      char * filename = ecl_util_alloc_filename( NULL , "SPLIT" , ECL_RESTART_FILE , false , 10 * step );
+      fortio_type * split_fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+      fwrite_step( split_fortio , nactive , step );
+      fortio_fclose( split_fortio );
+      free( filename );
+    }
+  }
+  fortio_fclose( fortio );
+}
+
+
+static void test_restart_file( const ecl_grid_type * grid , ecl_file_type * rst_file , const ecl_kw_type * fipnum , const ecl_kw_type * porv ) {
+  ecl_region_reduce_type * reducer = ecl_region_reduce_alloc( grid , fipnum );
+  stringlist_type * fields = stringlist_alloc_new( );
+  step_context_type context = { grid , fipnum , porv , 0 };
+
+  stringlist_append_copy( fields , "PRESSURE" );
+  ecl_region_reduce_eval_restart( reducer , rst_file , fields , porv , "RPORV" , step_callback , &context );
+  test_assert_int_equal( NUM_STEPS , context.num_calls );
+
+  stringlist_free( fields );
+  ecl_region_reduce_free( reducer );
+}
+
+
+static void test_restart( const ecl_grid_type * grid ) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_region_reduce");
+  const int nactive = ecl_grid_get_active_size( grid );
+  ecl_kw_type * fipnum = alloc_fipnum( nactive );
+  ecl_kw_type * porv   = alloc_field( "PORV" , ecl_grid_get_global_size( grid ) , ECL_FLOAT , 7 );
+
+  write_restart( nactive );
+  {
+    ecl_file_type * rst_file = ecl_file_open( "CASE.UNRST" , 0 );
+    test_restart_file( grid , rst_file , fipnum , porv );
+    ecl_file_close( rst_file );
+  }
+  {
+    ecl_file_type * rst_file = ecl_file_open_restart_case( "SPLIT" , 2 , 0 );
+    test_assert_not_NULL( rst_file );
+    test_restart_file( grid , rst_file , fipnum , porv );
+    ecl_file_close( rst_file );
+  }
+  ecl_kw_free( fipnum );
+  ecl_kw_free( porv );
+  test_work_area_free( work_area );
+}
+
+
+int main(int argc , char ** argv) {
+  const int nx = 50;
+  const int ny = 40;
+  const int nz = 30;
+  int * actnum = util_malloc( nx*ny*nz * sizeof * actnum );
+  ecl_grid_type * grid;
+  int g;
+
+  for (g = 0; g < nx*ny*nz; g++)
+    actnum[g] = (g % 6 == 1) ? 0 : 1;
+  grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1 , 1 , 1 , actnum );
+
+  test_eval( grid );
+  test_restart( grid );
+
+  ecl_grid_free( grid );
+  free( actnum );
+  exit(0);
+}
@@ -0,0 +1,307 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_rft_file_append.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <utime.h>
+
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_rft_file.h>
+#include <ert/ecl/ecl_rft_node.h>
+#include <ert/ecl/ecl_rft_cell.h>
+
+
+#define NUM_WELLS   4
+#define NUM_DATES  10
+
+
+static time_t node_date( int date_nr ) {
+  return ecl_util_make_date( 1 + date_nr , 1 , 2010 );
+}
+
+
+static ecl_rft_node_type * alloc_node( int well_nr , int date_nr , double pressure) {
+  char * well_name = util_alloc_sprintf("W%d" , well_nr);
+  ecl_rft_node_type * node = ecl_rft_node_alloc_new( well_name , "R" , node_date( date_nr ) , date_nr );
+
+  ecl_rft_node_append_cell( node , ecl_rft_cell_alloc_RFT( well_nr , date_nr , 0 , 1000 , pressure , 0.25 , 0.5 ));
+  free( well_name );
+  return node;
+}
+
+
+/*
+  Appends one node for each well at @date_nr.
+*/
+
+static void append_date( const char * filename , int date_nr , double pressure) {
+  ecl_rft_node_type ** nodes = util_calloc( NUM_WELLS , sizeof * nodes );
+  int well_nr;
+
+  for (well_nr = 0; well_nr < NUM_WELLS; well_nr++)
+    nodes[well_nr] = alloc_node( well_nr , date_nr , pressure );
+
+  ecl_rft_file_append( filename , nodes , NUM_WELLS , ECL_METRIC_UNITS );
+
+  for (well_nr = 0; well_nr < NUM_WELLS; well_nr++)
+    ecl_rft_node_free( nodes[well_nr] );
+  free( nodes );
+}
+
+
+static void assert_pressure( const ecl_rft_file_type * rft_file , const char * well_name , int date_nr , double pressure) {
+  const ecl_rft_node_type * node = ecl_rft_file_get_well_time_rft( rft_file , well_name , node_date( date_nr ));
+  test_assert_not_NULL( node );
+  test_assert_double_equal( pressure , ecl_rft_node_iget_pressure( node , 0 ));
+}
+
+
+static void test_append( const char * filename ) {
+  int date_nr;
+
+  /* The dates are appended in reverse order. */
+  for (date_nr = NUM_DATES - 1; date_nr >= 0; date_nr--)
+    append_date( filename , date_nr , date_nr );
+  test_assert_true( util_file_exists( "CASE.RFT.index" ));
+
+  /* A new version of the date 3 nodes supersedes the old ones. */
+  append_date( filename , 3 , 1000 );
+
+  {
+    ecl_rft_file_type * rft_file = ecl_rft_file_alloc( filename );
+    test_assert_int_equal( NUM_WELLS * (NUM_DATES + 1) , ecl_rft_file_get_size( rft_file ));
+    test_assert_int_equal( NUM_WELLS , ecl_rft_file_get_num_wells( rft_file ));
+    test_assert_int_equal( NUM_DATES + 1 , ecl_rft_file_get_well_occurences( rft_file , "W2" ));
+
+    for (date_nr = 0; date_nr < NUM_DATES; date_nr++)
+      assert_pressure( rft_file , "W2" , date_nr , (date_nr == 3) ? 1000 : date_nr );
+    test_assert_NULL( ecl_rft_file_get_well_time_rft( rft_file , "W2" , node_date( NUM_DATES )));
+
+    ecl_rft_file_free( rft_file );
+  }
+}
+
+
+/*
+  The file is extended without updating the index; the index is not
+  used when loading the file, and it is rebuilt by the next append.
+*/
+
+static void test_stale_index( const char * filename ) {
+  {
+    fortio_type * fortio = fortio_open_append( filename , false , ECL_ENDIAN_FLIP );
+    ecl_rft_node_type * node = alloc_node( NUM_WELLS , 0 , 77 );
+    ecl_rft_node_fwrite( node , fortio , ECL_METRIC_UNITS );
+    ecl_rft_node_free( node );
+    fortio_fclose( fortio );
+  }
+
+  {
+    ecl_rft_file_type * rft_file = ecl_rft_file_alloc( filename );
+    test_assert_int_equal( NUM_WELLS + 1 , ecl_rft_file_get_num_wells( rft_file ));
+    assert_pressure( rft_file , "W4" , 0 , 77 );
+    ecl_rft_file_free( rft_file );
+  }
+
+  append_date( filename , 5 , 500 );
+  {
+    ecl_rft_file_type * rft_file = ecl_rft_file_alloc( filename );
+    test_assert_int_equal( NUM_WELLS * (NUM_DATES + 2) + 1 , ecl_rft_file_get_size( rft_file ));
+    assert_pressure( rft_file , "W0" , 5 , 500 );
+    assert_pressure( rft_file , "W4" , 0 , 77 );
+    ecl_rft_file_free( rft_file );
+  }
+}
+
+
+/*
+  Writes the index @lines back with the well of the first NODE record
+  renamed to XWELL, and line @skip_line left out.
+*/
+
+static void write_index( const stringlist_type * lines , int skip_line ) {
+  FILE * stream = util_fopen( "CASE.RFT.index" , "w");
+  int i;
+
+  for (i = 0; i < stringlist_get_size( lines ); i++) {
+    const char * line = stringlist_iget( lines , i );
+    if (i == 0) {
+      long long offset , date;
+      test_assert_int_equal( 2 , sscanf( line , "NODE %lld %lld" , &offset , &date ));
+      fprintf(stream , "NODE %lld %lld XWELL\n" , offset , date );
+    } else if (i != skip_line)
+      fputs( line , stream );
+  }
+  fclose( stream );
+}
+
+
+static void assert_xwell( const char * filename , bool has_xwell ) {
+  ecl_rft_file_type * rft_file = ecl_rft_file_alloc( filename );
+  test_assert_bool_equal( has_xwell , ecl_rft_file_has_well( rft_file , "XWELL" ));
+  test_assert_int_equal( NUM_WELLS * (NUM_DATES + 2) + 1 , ecl_rft_file_get_size( rft_file ));
+  ecl_rft_file_free( rft_file );
+}
+
+
+static void set_mtime( const char * filename , time_t mtime ) {
+  struct utimbuf times;
+  times.actime = mtime;
+  times.modtime = mtime;
+  test_assert_int_equal( 0 , utime( filename , &times ));
+}
+
+
+/*
+  The index is used in place of the WELLETC and DATE keywords; a
+  valid index naming a different well is trusted. The index is not
+  used when the modification time of the file has changed, or when
+  the last NODE record is not the last block of the file.
+*/
+
+static void test_index_used( const char * filename ) {
+  stringlist_type * lines = stringlist_alloc_new();
+  time_t mtime = util_file_mtime( filename );
+  int num_lines;
+
+  {
+    FILE * stream = util_fopen( "CASE.RFT.index" , "r");
+    char line[256];
+    while (fgets( line , sizeof line , stream ))
+      stringlist_append_copy( lines , line );
+    fclose( stream );
+  }
+  num_lines = stringlist_get_size( lines );
+  test_assert_true( num_lines > 2 );
+
+  write_index( lines , -1 );
+  assert_xwell( filename , true );
+
+  set_mtime( filename , mtime + 10 );
+  assert_xwell( filename , false );
+  set_mtime( filename , mtime );
+  assert_xwell( filename , true );
+
+  /* Line num_lines - 1 is the END line. */
+  write_index( lines , num_lines - 2 );
+  assert_xwell( filename , false );
+
+  stringlist_free( lines );
+  util_unlink_existing( "CASE.RFT.index" );
+}
+
+
+static void test_compact( const char * filename ) {
+  offset_type size = util_file_size( filename );
+  ecl_rft_file_compact( filename , ECL_METRIC_UNITS );
+  test_assert_true( util_file_size( filename ) < size );
+  test_assert_true( util_file_exists( "CASE.RFT.index" ));
+
+  {
+    ecl_rft_file_type * rft_file = ecl_rft_file_alloc( filename );
+    int i;
+
+    test_assert_int_equal( NUM_WELLS * NUM_DATES + 1 , ecl_rft_file_get_size( rft_file ));
+    for (i = 1; i < ecl_rft_file_get_size( rft_file ); i++) {
+      const ecl_rft_node_type * node1 = ecl_rft_file_iget_node( rft_file , i - 1 );
+      const ecl_rft_node_type * node2 = ecl_rft_file_iget_node( rft_file , i );
+      test_assert_true( ecl_rft_node_get_date( node1 ) <= ecl_rft_node_get_date( node2 ));
+    }
+    assert_pressure( rft_file , "W1" , 3 , 1000 );
+    assert_pressure( rft_file , "W1" , 5 , 500 );
+    assert_pressure( rft_file , "W1" , 7 , 7 );
+    assert_pressure( rft_file , "W4" , 0 , 77 );
+    ecl_rft_file_free( rft_file );
+  }
+}
+
+
+/*
+  The formatted/unformatted status follows the extension, also when
+  the file is created by the append.
+*/
+
+static void test_formatted( const char * filename ) {
+  bool fmt_file;
+  int date_nr;
+
+  for (date_nr = 0; date_nr < 3; date_nr++)
+    append_date( filename , date_nr , date_nr );
+  append_date( filename , 1 , 100 );
+  test_assert_true( util_fmt_bit8( filename ));
+
+  ecl_rft_file_compact( filename , ECL_METRIC_UNITS );
+  test_assert_true( util_fmt_bit8( filename ));
+  test_assert_true( ecl_util_fmt_file( filename , &fmt_file ));
+  test_assert_true( fmt_file );
+
+  {
+    ecl_rft_file_type * rft_file = ecl_rft_file_alloc( filename );
+    test_assert_int_equal( NUM_WELLS * 3 , ecl_rft_file_get_size( rft_file ));
+    assert_pressure( rft_file , "W0" , 0 , 0 );
+    assert_pressure( rft_file , "W0" , 1 , 100 );
+    assert_pressure( rft_file , "W3" , 2 , 2 );
+    ecl_rft_file_free( rft_file );
+  }
+}
+
+
+/*
+  The DATE keyword only stores the day; a node date with a time of day
+  must be found at the same date with and without the index.
+*/
+
+static void test_time_of_day( const char * filename ) {
+  char * index_file = util_alloc_sprintf("%s.index" , filename);
+  ecl_rft_node_type * node = ecl_rft_node_alloc_new( "W0" , "R" , node_date( 0 ) + 12 * 3600 , 0 );
+  int i;
+
+  ecl_rft_node_append_cell( node , ecl_rft_cell_alloc_RFT( 0 , 0 , 0 , 1000 , 123 , 0.25 , 0.5 ));
+  ecl_rft_file_append( filename , &node , 1 , ECL_METRIC_UNITS );
+  ecl_rft_node_free( node );
+  test_assert_true( util_file_exists( index_file ));
+
+  for (i = 0; i < 2; i++) {
+    ecl_rft_file_type * rft_file = ecl_rft_file_alloc( filename );
+    assert_pressure( rft_file , "W0" , 0 , 123 );
+    test_assert_time_t_equal( node_date( 0 ) , ecl_rft_node_get_date( ecl_rft_file_iget_node( rft_file , 0 )));
+    ecl_rft_file_free( rft_file );
+
+    util_unlink_existing( index_file );
+  }
+  free( index_file );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_rft_file_append");
+  test_append( "CASE.RFT" );
+  test_stale_index( "CASE.RFT" );
+  test_index_used( "CASE.RFT" );
+  test_compact( "CASE.RFT" );
+  test_formatted( "CASE.FRFT" );
+  test_time_of_day( "TIME.RFT" );
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,146 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_rft_file_index.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_rft_file.h>
+#include <ert/ecl/ecl_rft_node.h>
+#include <ert/ecl/ecl_rft_cell.h>
+
+
+#define NUM_WELLS   7
+#define NUM_DATES  40
+
+
+static time_t node_date( int date_nr ) {
+  return ecl_util_make_date( 1 + date_nr % 28 , 1 + date_nr / 28 , 2010 );
+}
+
+
+static ecl_rft_node_type * alloc_node( int well_nr , int date_nr ) {
+  char * well_name = util_alloc_sprintf("W%d" , well_nr);
+  ecl_rft_node_type * node = ecl_rft_node_alloc_new( well_name , "R" , node_date( date_nr ) , date_nr );
+  int c;
+
+  for (c = 0; c <= well_nr; c++)
+    ecl_rft_node_append_cell( node , ecl_rft_cell_alloc_RFT( well_nr , date_nr , c , 1000 + c , 100 * well_nr + date_nr , 0.25 , 0.5 ));
+
+  free( well_name );
+  return node;
+}
+
+
+/*
+  The file is written with the dates in reverse order for the odd
+  wells, so the time index is different from the file order.
+*/
+
+static void write_file( const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  int n;
+  for (n = 0; n < NUM_DATES; n++) {
+    int well_nr;
+    for (well_nr = 0; well_nr < NUM_WELLS; well_nr++) {
+      int date_nr = (well_nr % 2) ? NUM_DATES - 1 - n : n;
+      ecl_rft_node_type * node = alloc_node( well_nr , date_nr );
+      ecl_rft_node_fwrite( node , fortio , ECL_METRIC_UNITS );
+      ecl_rft_node_free( node );
+    }
+  }
+  fortio_fclose( fortio );
+}
+
+
+static void test_index( const char * filename ) {
+  ecl_rft_file_type * rft_file = ecl_rft_file_alloc( filename );
+  int well_nr;
+
+  test_assert_true( ecl_rft_file_is_instance( rft_file ));
+  test_assert_int_equal( NUM_WELLS * NUM_DATES , ecl_rft_file_get_size( rft_file ));
+  test_assert_int_equal( NUM_WELLS , ecl_rft_file_get_num_wells( rft_file ));
+  test_assert_int_equal( NUM_DATES , ecl_rft_file_get_size__( rft_file , "W1" , -1 ));
+  test_assert_int_equal( NUM_WELLS , ecl_rft_file_get_size__( rft_file , NULL , node_date( 3 )));
+  test_assert_int_equal( 1 , ecl_rft_file_get_size__( rft_file , "W3" , node_date( 3 )));
+
+  for (well_nr = 0; well_nr < NUM_WELLS; well_nr++) {
+    char * well_name = util_alloc_sprintf("W%d" , well_nr);
+    int date_nr;
+
+    test_assert_true( ecl_rft_file_has_well( rft_file , well_name ));
+    test_assert_int_equal( NUM_DATES , ecl_rft_file_get_well_occurences( rft_file , well_name ));
+    for (date_nr = 0; date_nr < NUM_DATES; date_nr++) {
+      const ecl_rft_node_type * node = ecl_rft_file_get_well_time_rft( rft_file , well_name , node_date( date_nr ));
+      test_assert_not_NULL( node );
+      test_assert_string_equal( well_name , ecl_rft_node_get_well_name( node ));
+      test_assert_time_t_equal( node_date( date_nr ) , ecl_rft_node_get_date( node ));
+      test_assert_int_equal( well_nr + 1 , ecl_rft_node_get_size( node ));
+      test_assert_double_equal( 100 * well_nr + date_nr , ecl_rft_node_iget_pressure( node , 0 ));
+    }
+
+    {
+      /* iget_well_rft() is in file order. */
+      const ecl_rft_node_type * node = ecl_rft_file_iget_well_rft( rft_file , well_name , 0 );
+      test_assert_time_t_equal( node_date( (well_nr % 2) ? NUM_DATES - 1 : 0 ) , ecl_rft_node_get_date( node ));
+      test_assert_ptr_equal( node , ecl_rft_file_get_well_time_rft( rft_file , well_name , ecl_rft_node_get_date( node )));
+    }
+
+    test_assert_NULL( ecl_rft_file_get_well_time_rft( rft_file , well_name , node_date( NUM_DATES )));
+    test_assert_NULL( ecl_rft_file_get_well_time_rft( rft_file , well_name , node_date( 0 ) - 1));
+    free( well_name );
+  }
+  test_assert_NULL( ecl_rft_file_get_well_time_rft( rft_file , "NO_WELL" , node_date( 0 )));
+  ecl_rft_file_free( rft_file );
+}
+
+
+static void test_update( const char * filename ) {
+  ecl_rft_node_type ** nodes = util_calloc( 2 , sizeof * nodes );
+  ecl_rft_node_type * new_node = alloc_node( 2 , 5 );
+
+  ecl_rft_node_append_cell( new_node , ecl_rft_cell_alloc_RFT( 0 , 0 , 9 , 2000 , 1 , 0.25 , 0.5 ));
+  nodes[0] = new_node;
+  nodes[1] = alloc_node( NUM_WELLS , 0 );
+  ecl_rft_file_update( filename , nodes , 2 , ECL_METRIC_UNITS );
+
+  {
+    ecl_rft_file_type * rft_file = ecl_rft_file_alloc( filename );
+    test_assert_int_equal( NUM_WELLS * NUM_DATES + 1 , ecl_rft_file_get_size( rft_file ));
+    test_assert_int_equal( 4 , ecl_rft_node_get_size( ecl_rft_file_get_well_time_rft( rft_file , "W2" , node_date( 5 ))));
+    test_assert_int_equal( 3 , ecl_rft_node_get_size( ecl_rft_file_get_well_time_rft( rft_file , "W2" , node_date( 6 ))));
+    test_assert_true( ecl_rft_file_has_well( rft_file , "W7" ));
+    ecl_rft_file_free( rft_file );
+  }
+  free( nodes );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_rft_file_index");
+  write_file( "CASE.RFT" );
+  test_index( "CASE.RFT" );
+  test_update( "CASE.RFT" );
+  test_work_area_free( work_area );
+  exit(0);
+}
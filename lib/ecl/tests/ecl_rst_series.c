@@ -0,0 +1,235 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_rst_series.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/int_vector.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_rst_series.h>
+
+
+#define NUM_STEPS 6
+
+
+static float pressure_value( int step , int active_index ) {
+  return 100 * step + 0.5 * active_index;
+}
+
+static double global_value( int step , int global_index ) {
+  return -1000.0 * step - global_index;
+}
+
+
+static void write_kw( fortio_type * fortio , ecl_kw_type * ecl_kw ) {
+  ecl_kw_fwrite( ecl_kw , fortio );
+  ecl_kw_free( ecl_kw );
+}
+
+
+/*
+  With @unified == false one CASE.Xnnnn file without SEQNUM is written
+  for each report step, as the simulator does.
+*/
+
+static void write_restart( const ecl_grid_type * grid , const char * base , bool unified ) {
+  const int nactive = ecl_grid_get_active_size( grid );
+  const int size    = ecl_grid_get_global_size( grid );
+  fortio_type * fortio = NULL;
+  int step;
+
+  if (unified) {
+    char * filename = ecl_util_alloc_filename( NULL , base , ECL_UNIFIED_RESTART_FILE , false , 0 );
+    fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+    free( filename );
+  }
+
+  for (step = 0; step < NUM_STEPS; step++) {
+    ecl_kw_type * seqnum   = ecl_kw_alloc( SEQNUM_KW , 1 , ECL_INT );
+    ecl_kw_type * intehead = ecl_kw_alloc( INTEHEAD_KW , INTEHEAD_RESTART_SIZE , ECL_INT );
+    ecl_kw_type * pressure = ecl_kw_alloc( "PRESSURE" , nactive , ECL_FLOAT );
+    ecl_kw_type * swat     = ecl_kw_alloc( "SWAT" , nactive , ECL_INT );
+    ecl_kw_type * globkw   = ecl_kw_alloc( "GLOBKW" , size , ECL_DOUBLE );
+    int i;
+
+    ecl_kw_iset_int( seqnum , 0 , 10 * step );
+    ecl_kw_scalar_set_int( intehead , 0 );
+    ecl_kw_iset_int( intehead , INTEHEAD_DAY_INDEX , 1 + step );
+    ecl_kw_iset_int( intehead , INTEHEAD_MONTH_INDEX , 1 );
+    ecl_kw_iset_int( intehead , INTEHEAD_YEAR_INDEX , 2000 );
+
+    for (i = 0; i < nactive; i++) {
+      ecl_kw_iset_float( pressure , i , pressure_value( step , i ));
+      ecl_kw_iset_int( swat , i , step + i );
+    }
+    for (i = 0; i < size; i++)
+      ecl_kw_iset_double( globkw , i , global_value( step , i ));
+
+    if (!unified) {
+      char * filename = ecl_util_alloc_filename( NULL , base , ECL_RESTART_FILE , false , 10 * step );
+      fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+      free( filename );
+      ecl_kw_free( seqnum );
+    } else
+      write_kw( fortio , seqnum );
+
+    write_kw( fortio , intehead );
+    write_kw( fortio , pressure );
+    if (step != 2)
+      write_kw( fortio , swat );
+    else
+      ecl_kw_free( swat );
+    write_kw( fortio , globkw );
+    if (!unified)
+      fortio_fclose( fortio );
+  }
+  if (unified)
+    fortio_fclose( fortio );
+}
+
+
+static void test_series( const ecl_grid_type * grid , ecl_file_type * rst_file , bool global_cells ) {
+  stringlist_type * kw_list = stringlist_alloc_new( );
+  int_vector_type * cells = int_vector_alloc( 0 , 0 );
+  const int limit = global_cells ? ecl_grid_get_global_size( grid ) : ecl_grid_get_active_size( grid );
+  ecl_rst_series_type * series;
+  int i, step;
+
+  stringlist_append_copy( kw_list , "PRESSURE" );
+  stringlist_append_copy( kw_list , "SWAT" );
+  stringlist_append_copy( kw_list , "GLOBKW" );
+  stringlist_append_copy( kw_list , "MISSING" );
+  stringlist_append_copy( kw_list , "PRESSURE" );
+
+  /* Scattered cells, a dense cluster and a duplicate - in random order. */
+  for (i = 0; i < limit; i += 997) {
+    int index = (limit - 1) - i;
+    if (!global_cells || ecl_grid_cell_active1( grid , index ))
+      int_vector_append( cells , index );
+  }
+  for (i = 500; i < 540; i++) {
+    if (!global_cells || ecl_grid_cell_active1( grid , i ))
+      int_vector_append( cells , i );
+  }
+  int_vector_append( cells , int_vector_iget( cells , 0 ));
+
+  series = ecl_rst_series_alloc( rst_file , grid , kw_list , cells , global_cells );
+  test_assert_true( ecl_rst_series_is_instance( series ));
+  test_assert_int_equal( NUM_STEPS , ecl_rst_series_get_num_steps( series ));
+  test_assert_int_equal( int_vector_size( cells ) , ecl_rst_series_get_num_cells( series ));
+  test_assert_true( ecl_rst_series_has_kw( series , "MISSING" ));
+
+  for (step = 0; step < NUM_STEPS; step++) {
+    test_assert_int_equal( 10 * step , ecl_rst_series_iget_report_step( series , step ));
+    test_assert_time_t_equal( ecl_util_make_date( 1 + step , 1 , 2000 ) , ecl_rst_series_iget_sim_time( series , step ));
+
+    for (i = 0; i < int_vector_size( cells ); i++) {
+      int index = int_vector_iget( cells , i );
+      int active_index = global_cells ? ecl_grid_get_active_index1( grid , index ) : index;
+      int global_index = global_cells ? index : ecl_grid_get_global_index1A( grid , index );
+
+      test_assert_double_equal( pressure_value( step , active_index ) , ecl_rst_series_iget( series , "PRESSURE" , step , i ));
+      test_assert_double_equal( global_value( step , global_index ) , ecl_rst_series_iget( series , "GLOBKW" , step , i ));
+      test_assert_true( isnan( ecl_rst_series_iget( series , "MISSING" , step , i )));
+      if (step == 2)
+        test_assert_true( isnan( ecl_rst_series_iget( series , "SWAT" , step , i )));
+      else
+        test_assert_double_equal( step + active_index , ecl_rst_series_iget( series , "SWAT" , step , i ));
+    }
+  }
+
+  ecl_rst_series_free( series );
+  int_vector_free( cells );
+  stringlist_free( kw_list );
+}
+
+
+/*
+  All the cells; the reads of the global keyword are longer than the
+  maximum length of one read and are split.
+*/
+
+static void test_dense_series( const ecl_grid_type * grid , ecl_file_type * rst_file ) {
+  stringlist_type * kw_list = stringlist_alloc_new( );
+  int_vector_type * cells = int_vector_alloc( 0 , 0 );
+  ecl_rst_series_type * series;
+  int i, step;
+
+  stringlist_append_copy( kw_list , "GLOBKW" );
+  stringlist_append_copy( kw_list , "GLOBKW" );
+  for (i = 0; i < ecl_grid_get_global_size( grid ); i++)
+    int_vector_append( cells , i );
+
+  series = ecl_rst_series_alloc( rst_file , grid , kw_list , cells , true );
+  for (step = 0; step < NUM_STEPS; step++)
+    for (i = 0; i < int_vector_size( cells ); i++)
+      test_assert_double_equal( global_value( step , i ) , ecl_rst_series_iget( series , "GLOBKW" , step , i ));
+
+  ecl_rst_series_free( series );
+  int_vector_free( cells );
+  stringlist_free( kw_list );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_rst_series");
+  const int nx = 40;
+  const int ny = 30;
+  const int nz = 20;
+  int * actnum = util_malloc( nx*ny*nz * sizeof * actnum );
+  ecl_grid_type * grid;
+  int g;
+
+  for (g = 0; g < nx*ny*nz; g++)
+    actnum[g] = (g % 9 == 4) ? 0 : 1;
+  grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1 , 1 , 1 , actnum );
+  write_restart( grid , "CASE" , true );
+  {
+    ecl_file_type * rst_file = ecl_file_open( "CASE.UNRST" , 0 );
+    test_series( grid , rst_file , false );
+    test_series( grid , rst_file , true );
+    test_dense_series( grid , rst_file );
+    ecl_file_close( rst_file );
+  }
+
+  /* The keywords come from several files. */
+  write_restart( grid , "SPLIT" , false );
+  {
+    ecl_file_type * rst_file = ecl_file_open_restart_case( "SPLIT" , 2 , 0 );
+    test_assert_not_NULL( rst_file );
+    test_series( grid , rst_file , false );
+    test_series( grid , rst_file , true );
+    test_dense_series( grid , rst_file );
+    ecl_file_close( rst_file );
+  }
+
+  ecl_grid_free( grid );
+  free( actnum );
+  test_work_area_free( work_area );
+  exit(0);
+}
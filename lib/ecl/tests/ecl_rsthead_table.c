@@ -0,0 +1,214 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_rsthead_table.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_rsthead.h>
+#include <ert/ecl/fortio.h>
+
+#include "well_test_restart.h"
+
+
+#define NUM_BLOCKS 50
+
+
+static int step_report( int step ) {
+  return 2 * step;
+}
+
+
+static time_t step_time( int step ) {
+  return ecl_util_make_date( 1 + step % 28 , 1 + step / 28 , 2010 );
+}
+
+
+static double step_days( int step ) {
+  return 1.5 * step;
+}
+
+
+/*
+  Writes one restart block; with @num_lgr > 0 an extra INTEHEAD is
+  written for each LGR, as in a restart file from a model with LGRs.
+*/
+
+static void fwrite_step( fortio_type * fortio , int step , int num_lgr) {
+  ecl_kw_type * intehead = well_test_alloc_intehead( step_time( step ));
+  int lgr;
+
+  ecl_kw_iset_int( intehead , INTEHEAD_NX_INDEX , 10 );
+  ecl_kw_iset_int( intehead , INTEHEAD_NWELLS_INDEX , step % 5 );
+  well_test_fwrite_rsthead( fortio , step_report( step ) , intehead , (step % 2) == 1 , step_days( step ));
+  well_test_fwrite_pressure( fortio , 1000 , step );
+  for (lgr = 0; lgr < num_lgr; lgr++) {
+    ecl_kw_fwrite( intehead , fortio );
+    well_test_fwrite_pressure( fortio , 1000 , step );
+  }
+  ecl_kw_free( intehead );
+}
+
+
+static void write_file( const char * filename , const int * steps , int num_steps , int num_lgr) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  int i;
+  for (i = 0; i < num_steps; i++)
+    fwrite_step( fortio , steps[i] , num_lgr );
+  fortio_fclose( fortio );
+}
+
+
+/*
+  The file contains the steps in @steps; the lookups are checked for
+  all steps in [0, NUM_BLOCKS] and for values between the steps.
+*/
+
+static void test_lookup( const char * filename , const int * steps , int num_steps , int flags) {
+  ecl_file_type * rst_file = ecl_file_open( filename , flags );
+  ecl_file_view_type * global_view = ecl_file_get_global_view( rst_file );
+  int step;
+
+  /* The header of the first block is read without building the table. */
+  {
+    ecl_rsthead_type * header = ecl_rsthead_alloc( global_view , -1 );
+    test_assert_false( ecl_file_view_has_rsthead_table( global_view ));
+    test_assert_int_equal( step_report( steps[0] ) , ecl_rsthead_get_report_step( header ));
+    test_assert_time_t_equal( step_time( steps[0] ) , ecl_rsthead_get_sim_time( header ));
+    ecl_rsthead_free( header );
+  }
+
+  test_assert_NULL( ecl_file_view_iget_rsthead( global_view , -1 ));
+  test_assert_true( ecl_file_view_has_rsthead_table( global_view ));
+  test_assert_NULL( ecl_file_view_iget_rsthead( global_view , num_steps ));
+  test_assert_time_t_equal( -1 , ecl_file_iget_restart_sim_date( rst_file , num_steps ));
+
+  for (step = 0; step <= NUM_BLOCKS; step++) {
+    int seqnum_index = -1;
+    int i;
+
+    for (i = 0; i < num_steps; i++)
+      if (steps[i] == step) {
+        seqnum_index = i;
+        break;
+      }
+
+    test_assert_bool_equal( seqnum_index >= 0 , ecl_file_has_report_step( rst_file , step_report( step )));
+    test_assert_bool_equal( seqnum_index >= 0 , ecl_file_has_sim_time( rst_file , step_time( step )));
+    test_assert_bool_equal( seqnum_index >= 0 , ecl_file_view_has_sim_days( global_view , step_days( step )));
+    test_assert_false( ecl_file_has_report_step( rst_file , step_report( step ) + 1 ));
+    test_assert_false( ecl_file_view_has_sim_days( global_view , step_days( step ) + 0.5 ));
+    test_assert_false( ecl_file_has_sim_time( rst_file , step_time( step ) + 1 ));
+
+    test_assert_int_equal( seqnum_index , ecl_file_view_seqnum_index_from_sim_time( global_view , step_time( step )));
+    test_assert_int_equal( seqnum_index , ecl_file_get_restart_index( rst_file , step_time( step )));
+
+    if (seqnum_index >= 0) {
+      const ecl_rsthead_type * rsthead = ecl_file_view_iget_rsthead( global_view , seqnum_index );
+
+      test_assert_int_equal( step_report( step ) , ecl_rsthead_get_report_step( rsthead ));
+      test_assert_time_t_equal( step_time( step ) , ecl_rsthead_get_sim_time( rsthead ));
+      test_assert_double_equal( step_days( step ) , ecl_rsthead_get_sim_days( rsthead ));
+      test_assert_int_equal( 10 , rsthead->nx );
+      test_assert_int_equal( step % 5 , rsthead->nwells );
+      test_assert_bool_equal( (step % 2) == 1 , rsthead->dualp );
+      test_assert_time_t_equal( step_time( step ) , ecl_file_iget_restart_sim_date( rst_file , seqnum_index ));
+      test_assert_double_equal( step_days( step ) , ecl_file_iget_restart_sim_days( rst_file , seqnum_index ));
+
+      {
+        ecl_file_view_type * view1 = ecl_file_get_restart_view( rst_file , -1 , step_report( step ) , -1 , -1 );
+        ecl_file_view_type * view2 = ecl_file_get_restart_view( rst_file , -1 , -1 , step_time( step ) , -1 );
+        ecl_file_view_type * view3 = ecl_file_get_restart_view( rst_file , -1 , -1 , -1 , step_days( step ));
+        ecl_rsthead_type * header = ecl_rsthead_alloc( view1 , -1 );
+
+        test_assert_not_NULL( view1 );
+        test_assert_float_equal( step , ecl_kw_iget_float( ecl_file_view_iget_named_kw( view1 , "PRESSURE" , 0 ) , 0 ));
+        test_assert_float_equal( step , ecl_kw_iget_float( ecl_file_view_iget_named_kw( view2 , "PRESSURE" , 0 ) , 0 ));
+        test_assert_float_equal( step , ecl_kw_iget_float( ecl_file_view_iget_named_kw( view3 , "PRESSURE" , 0 ) , 0 ));
+        test_assert_true( ecl_rsthead_equal( header , rsthead ));
+        test_assert_int_equal( step_report( step ) , ecl_rsthead_get_report_step( header ));
+        ecl_rsthead_free( header );
+      }
+    } else {
+      test_assert_NULL( ecl_file_get_restart_view( rst_file , -1 , step_report( step ) , -1 , -1 ));
+      test_assert_NULL( ecl_file_get_restart_view( rst_file , -1 , -1 , step_time( step ) , -1 ));
+    }
+  }
+  ecl_file_close( rst_file );
+}
+
+
+static void test_sorted( ) {
+  int * steps = util_malloc( NUM_BLOCKS * sizeof * steps );
+  int num_steps = 0;
+  int step;
+
+  for (step = 0; step < NUM_BLOCKS; step++)
+    if ((step % 3) != 1)
+      steps[num_steps++] = step;
+
+  write_file( "SORTED.UNRST" , steps , num_steps , 0 );
+  test_lookup( "SORTED.UNRST" , steps , num_steps , 0 );
+  test_lookup( "SORTED.UNRST" , steps , num_steps , ECL_FILE_CLOSE_STREAM );
+  free( steps );
+}
+
+
+static void test_unsorted( ) {
+  int steps[] = {4 , 0 , 7 , 3 , 9 , 8};
+  write_file( "UNSORTED.UNRST" , steps , 6 , 0 );
+  test_lookup( "UNSORTED.UNRST" , steps , 6 , 0 );
+}
+
+
+/*
+  With LGRs ecl_file_get_restart_index() returns the INTEHEAD
+  occurence.
+*/
+
+static void test_lgr( ) {
+  int steps[] = {0 , 1 , 2 , 3};
+  write_file( "LGR.UNRST" , steps , 4 , 1 );
+  {
+    ecl_file_type * rst_file = ecl_file_open( "LGR.UNRST" , 0 );
+    test_assert_int_equal( 4 , ecl_file_get_restart_index( rst_file , step_time( 2 )));
+    test_assert_int_equal( 2 , ecl_file_view_seqnum_index_from_sim_time( ecl_file_get_global_view( rst_file ) , step_time( 2 )));
+    test_assert_true( ecl_file_select_rstblock_sim_time( rst_file , step_time( 3 )));
+    test_assert_int_equal( 0 , ecl_file_get_restart_index( rst_file , step_time( 3 )));
+    test_assert_time_t_equal( step_time( 3 ) , ecl_file_iget_restart_sim_date( rst_file , 0 ));
+    ecl_file_close( rst_file );
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_rsthead_table");
+  test_sorted( );
+  test_unsorted( );
+  test_lgr( );
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,167 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_subsidence_stations.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/geometry/geo_surface.h>
+
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region.h>
+#include <ert/ecl/ecl_subsidence.h>
+
+#include "survey_test_case.h"
+
+
+#define NUM_STATIONS 23
+
+#define YOUNGS_MODULUS 5e8
+#define POISSON_RATIO  0.3
+#define SEABED         10
+#define TOLERANCE      1e-10
+
+
+static void init_stations( double * utm_x , double * utm_y , double * depth ) {
+  int i;
+  for (i = 0; i < NUM_STATIONS; i++) {
+    utm_x[i] = -100 + 53.7 * i;
+    utm_y[i] = 600 - 23.1 * i;
+    depth[i] = -1.0 * (i % 4);
+  }
+}
+
+
+static void test_stations( const ecl_subsidence_type * subsidence , ecl_region_type * region , const char * monitor ) {
+  double utm_x[NUM_STATIONS];
+  double utm_y[NUM_STATIONS];
+  double depth[NUM_STATIONS];
+  double deltaz[NUM_STATIONS];
+  int i;
+
+  init_stations( utm_x , utm_y , depth );
+
+  ecl_subsidence_eval_geertsma_stations( subsidence , "BASE" , monitor , region , NUM_STATIONS , utm_x , utm_y , depth ,
+                                         YOUNGS_MODULUS , POISSON_RATIO , SEABED , deltaz );
+  for (i = 0; i < NUM_STATIONS; i++) {
+    double expected = ecl_subsidence_eval_geertsma( subsidence , "BASE" , monitor , region , utm_x[i] , utm_y[i] , depth[i] ,
+                                                    YOUNGS_MODULUS , POISSON_RATIO , SEABED );
+    survey_test_assert_close( expected , deltaz[i] , TOLERANCE );
+  }
+}
+
+
+/*
+  With theta == 0 the octree is opened down to the cells and the result
+  equals ecl_subsidence_eval_geertsma() up to rounding; otherwise the
+  error is within the returned bound.
+*/
+
+static void test_stations_approx( const ecl_subsidence_type * subsidence , ecl_region_type * region , const char * monitor ) {
+  double utm_x[NUM_STATIONS];
+  double utm_y[NUM_STATIONS];
+  double depth[NUM_STATIONS];
+  double deltaz[NUM_STATIONS];
+  double error_bound[NUM_STATIONS];
+  int i;
+
+  init_stations( utm_x , utm_y , depth );
+  ecl_subsidence_eval_geertsma_stations_approx( subsidence , "BASE" , monitor , region , NUM_STATIONS , utm_x , utm_y , depth ,
+                                                YOUNGS_MODULUS , POISSON_RATIO , SEABED , 0 , deltaz , error_bound );
+  for (i = 0; i < NUM_STATIONS; i++) {
+    double expected = ecl_subsidence_eval_geertsma( subsidence , "BASE" , monitor , region , utm_x[i] , utm_y[i] , depth[i] ,
+                                                    YOUNGS_MODULUS , POISSON_RATIO , SEABED );
+    survey_test_assert_close( expected , deltaz[i] , TOLERANCE );
+    test_assert_double_equal( 0 , error_bound[i] );
+  }
+
+  ecl_subsidence_eval_geertsma_stations_approx( subsidence , "BASE" , monitor , region , NUM_STATIONS , utm_x , utm_y , depth ,
+                                                YOUNGS_MODULUS , POISSON_RATIO , SEABED , 0.5 , deltaz , NULL );
+  ecl_subsidence_eval_geertsma_stations_approx( subsidence , "BASE" , monitor , region , NUM_STATIONS , utm_x , utm_y , depth ,
+                                                YOUNGS_MODULUS , POISSON_RATIO , SEABED , 0.5 , deltaz , error_bound );
+  for (i = 0; i < NUM_STATIONS; i++) {
+    double expected = ecl_subsidence_eval_geertsma( subsidence , "BASE" , monitor , region , utm_x[i] , utm_y[i] , depth[i] ,
+                                                    YOUNGS_MODULUS , POISSON_RATIO , SEABED );
+    double rounding = TOLERANCE * util_double_max( 1.0 , fabs( expected ));
+    if (fabs( expected - deltaz[i] ) > error_bound[i] + rounding)
+      test_error_exit("Approximation:%g differs from exact:%g by more than the bound:%g \n", deltaz[i] , expected , error_bound[i]);
+  }
+}
+
+
+static void test_surface( const ecl_subsidence_type * subsidence , ecl_region_type * region ) {
+  geo_surface_type * surface = geo_surface_alloc_new( 9 , 7 , 125 , 110 , -50 , -25 , 0 );
+  const double depth = 2;
+  int i;
+
+  ecl_subsidence_eval_geertsma_surface( subsidence , "BASE" , "MONITOR" , region , surface , depth ,
+                                        YOUNGS_MODULUS , POISSON_RATIO , SEABED );
+  test_assert_int_equal( 63 , geo_surface_get_size( surface ));
+  for (i = 0; i < geo_surface_get_size( surface ); i++) {
+    double x , y , expected;
+    geo_surface_iget_xy( surface , i , &x , &y );
+    expected = ecl_subsidence_eval_geertsma( subsidence , "BASE" , "MONITOR" , region , x , y , depth ,
+                                             YOUNGS_MODULUS , POISSON_RATIO , SEABED );
+    survey_test_assert_close( expected , geo_surface_iget_zvalue( surface , i ) , TOLERANCE );
+  }
+  geo_surface_free( surface );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_subsidence_stations");
+  ecl_grid_type * grid = survey_test_alloc_grid();
+
+  survey_test_fwrite_init( grid , "CASE.INIT" );
+  survey_test_fwrite_restart( grid , "CASE.X0000" , 0 );
+  survey_test_fwrite_restart( grid , "CASE.X0001" , 1 );
+  {
+    ecl_file_type * init_file = ecl_file_open( "CASE.INIT" , 0 );
+    ecl_file_type * base_file = ecl_file_open( "CASE.X0000" , 0 );
+    ecl_file_type * monitor_file = ecl_file_open( "CASE.X0001" , 0 );
+    ecl_subsidence_type * subsidence = ecl_subsidence_alloc( grid , init_file );
+    ecl_region_type * region = ecl_region_alloc( grid , false );
+
+    ecl_subsidence_add_survey_PRESSURE( subsidence , "BASE" , ecl_file_get_global_view( base_file ));
+    ecl_subsidence_add_survey_PRESSURE( subsidence , "MONITOR" , ecl_file_get_global_view( monitor_file ));
+    ecl_region_select_k1k2( region , 1 , 3 );
+
+    test_stations( subsidence , NULL , "MONITOR" );
+    test_stations( subsidence , NULL , NULL );
+    test_stations( subsidence , region , "MONITOR" );
+    test_stations_approx( subsidence , NULL , "MONITOR" );
+    test_stations_approx( subsidence , NULL , NULL );
+    test_stations_approx( subsidence , region , "MONITOR" );
+    test_surface( subsidence , NULL );
+    test_surface( subsidence , region );
+
+    ecl_region_free( region );
+    ecl_subsidence_free( subsidence );
+    ecl_file_close( monitor_file );
+    ecl_file_close( base_file );
+    ecl_file_close( init_file );
+  }
+
+  ecl_grid_free( grid );
+  test_work_area_free( work_area );
+  exit(0);
+}
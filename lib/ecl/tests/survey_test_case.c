@@ -0,0 +1,119 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'survey_test_case.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+#include "survey_test_case.h"
+
+
+#define NX 20
+#define NY 15
+#define NZ  6
+
+
+ecl_grid_type * survey_test_alloc_grid( void ) {
+  int * actnum = util_malloc( NX*NY*NZ * sizeof * actnum );
+  ecl_grid_type * grid;
+  int g;
+
+  for (g = 0; g < NX*NY*NZ; g++)
+    actnum[g] = (g % 7 == 3) ? 0 : 1;
+  grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 50 , 50 , 10 , actnum );
+
+  free( actnum );
+  return grid;
+}
+
+
+void survey_test_assert_close( double expected , double value , double rel_tolerance ) {
+  double tolerance = rel_tolerance * util_double_max( 1.0 , fabs( expected ));
+  if (fabs( expected - value ) > tolerance)
+    test_error_exit("Batch result:%g differs from scalar result:%g \n", value , expected);
+}
+
+
+void survey_test_fwrite_init( const ecl_grid_type * grid , const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  ecl_kw_type * intehead_kw = ecl_kw_alloc( INTEHEAD_KW , 411 , ECL_INT );
+  ecl_kw_type * porv_kw     = ecl_kw_alloc( PORV_KW , ecl_grid_get_global_size( grid ) , ECL_FLOAT );
+  ecl_kw_type * aquifer_kw  = ecl_kw_alloc( AQUIFER_KW , ecl_grid_get_active_size( grid ) , ECL_INT );
+  int i;
+
+  ecl_kw_scalar_set_int( intehead_kw , 0 );
+  ecl_kw_iset_int( intehead_kw , INTEHEAD_PHASE_INDEX , SURVEY_TEST_PHASES );
+  ecl_kw_iset_int( intehead_kw , INTEHEAD_IPROG_INDEX , INTEHEAD_ECLIPSE100_VALUE );
+
+  for (i = 0; i < ecl_grid_get_global_size( grid ); i++)
+    ecl_kw_iset_float( porv_kw , i , 1000 + (i % 13));
+
+  for (i = 0; i < ecl_grid_get_active_size( grid ); i++)
+    ecl_kw_iset_int( aquifer_kw , i , (i % 31 == 0) ? -1 : 0 );
+
+  ecl_kw_fwrite( intehead_kw , fortio );
+  ecl_kw_fwrite( porv_kw , fortio );
+  ecl_kw_fwrite( aquifer_kw , fortio );
+  ecl_kw_free( intehead_kw );
+  ecl_kw_free( porv_kw );
+  ecl_kw_free( aquifer_kw );
+  fortio_fclose( fortio );
+}
+
+
+/*
+  SOIL is not in the restart files, so the oil saturation is 1 - SWAT.
+*/
+
+void survey_test_fwrite_restart( const ecl_grid_type * grid , const char * filename , int step ) {
+  const int size = ecl_grid_get_active_size( grid );
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  ecl_kw_type * pormod_kw   = ecl_kw_alloc( PORMOD_KW , size , ECL_FLOAT );
+  ecl_kw_type * swat_kw     = ecl_kw_alloc( "SWAT" , size , ECL_FLOAT );
+  ecl_kw_type * oil_den_kw  = ecl_kw_alloc( ECLIPSE100_OIL_DEN_KW , size , ECL_FLOAT );
+  ecl_kw_type * wat_den_kw  = ecl_kw_alloc( ECLIPSE100_WATER_DEN_KW , size , ECL_FLOAT );
+  ecl_kw_type * pressure_kw = ecl_kw_alloc( PRESSURE_KW , size , ECL_FLOAT );
+  int i;
+
+  for (i = 0; i < size; i++) {
+    ecl_kw_iset_float( pormod_kw , i , 1 - 0.01 * step );
+    ecl_kw_iset_float( swat_kw , i , 0.2 + 0.1 * step * (1 + sin( 0.17 * i )));
+    ecl_kw_iset_float( oil_den_kw , i , 800 + step );
+    ecl_kw_iset_float( wat_den_kw , i , 1000 + 2 * step );
+    ecl_kw_iset_float( pressure_kw , i , 250 - 10 * step * (1.5 + sin( 0.13 * i )));
+  }
+
+  ecl_kw_fwrite( pormod_kw , fortio );
+  ecl_kw_fwrite( swat_kw , fortio );
+  ecl_kw_fwrite( oil_den_kw , fortio );
+  ecl_kw_fwrite( wat_den_kw , fortio );
+  ecl_kw_fwrite( pressure_kw , fortio );
+  ecl_kw_free( pormod_kw );
+  ecl_kw_free( swat_kw );
+  ecl_kw_free( oil_den_kw );
+  ecl_kw_free( wat_den_kw );
+  ecl_kw_free( pressure_kw );
+  fortio_fclose( fortio );
+}
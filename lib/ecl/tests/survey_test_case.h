@@ -0,0 +1,38 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'survey_test_case.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#ifndef ERT_SURVEY_TEST_CASE_H
+#define ERT_SURVEY_TEST_CASE_H
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_util.h>
+
+/*
+  Synthetic oil/water case shared by the gravity and subsidence
+  tests: a 20 x 15 x 6 rectangular grid with every seventh cell
+  inactive, an INIT file and restart files with the keywords needed
+  for PORMOD gravity surveys and PRESSURE subsidence surveys.
+*/
+
+#define SURVEY_TEST_PHASES (ECL_OIL_PHASE + ECL_WATER_PHASE)
+
+ecl_grid_type * survey_test_alloc_grid( void );
+void            survey_test_fwrite_init( const ecl_grid_type * grid , const char * filename );
+void            survey_test_fwrite_restart( const ecl_grid_type * grid , const char * filename , int step );
+void            survey_test_assert_close( double expected , double value , double rel_tolerance );
+
+#endif
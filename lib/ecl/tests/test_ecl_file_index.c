@@ -18,6 +18,7 @@
 
 #include <stdio.h>
 #include <utime.h>
+#include <unistd.h>
 
 #include <ert/util/test_util.h>
 #include <ert/util/util.h>
@@ -97,6 +98,10 @@ void test_create_and_load_index_file() {
       ecl_kw_free(kw1);
       ecl_kw_free(kw2);
       ecl_file_close( ecl_file_index );
+
+      //a truncated index file is rejected without crashing
+      test_assert_int_equal( 0 , truncate( index_file_name , util_file_size( index_file_name ) - 10 ));
+      test_assert_NULL( ecl_file_fast_open( file_name, index_file_name , 0) );
    }
    test_work_area_free( work_area );
 }
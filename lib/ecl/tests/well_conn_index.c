@@ -0,0 +1,215 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'well_conn_index.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region.h>
+
+#include <ert/ecl_well/well_conn.h>
+#include <ert/ecl_well/well_conn_collection.h>
+#include <ert/ecl_well/well_state.h>
+#include <ert/ecl_well/well_ts.h>
+#include <ert/ecl_well/well_info.h>
+#include <ert/ecl_well/well_conn_index.h>
+
+#include "well_test_restart.h"
+
+
+/*
+  Brute force: count the connections in cell (i,j,k) by going through
+  all the states of all the wells; if @report_step >= 0 only the state
+  valid at that report step is considered.
+*/
+
+static int count_conn( const well_info_type * well_info , int report_step , int i , int j , int k) {
+  int count = 0;
+  int iwell;
+  for (iwell = 0; iwell < well_info_get_num_wells( well_info ); iwell++) {
+    const char * well_name = well_info_iget_well_name( well_info , iwell );
+    const well_ts_type * well_ts = well_info_get_ts( well_info , well_name );
+    int t;
+    for (t = 0; t < well_ts_get_size( well_ts ); t++) {
+      const well_state_type * well_state = well_ts_iget_state( well_ts , t );
+      if (report_step >= 0 && well_state != well_ts_get_state_from_report( well_ts , report_step ))
+        continue;
+      {
+        const well_conn_collection_type * connections = well_state_get_global_connections( well_state );
+        int c;
+        for (c = 0; c < well_conn_collection_get_size( connections ); c++) {
+          const well_conn_type * conn = well_conn_collection_iget_const( connections , c );
+          if (well_conn_get_i( conn ) == i && well_conn_get_j( conn ) == j && well_conn_get_k( conn ) == k)
+            count++;
+        }
+      }
+    }
+  }
+  return count;
+}
+
+
+static void test_index( const well_info_type * well_info , const ecl_grid_type * grid , int report_step ) {
+  well_conn_index_type * index;
+  int total = 0;
+  int i,j,k;
+
+  if (report_step < 0)
+    index = well_conn_index_alloc( well_info , grid );
+  else
+    index = well_conn_index_alloc_report( well_info , grid , report_step );
+
+  test_assert_true( well_conn_index_is_instance( index ));
+  test_assert_int_equal( MAX_WELLS , well_conn_index_get_num_wells( index ));
+  for (k = 0; k < NZ; k++)
+    for (j = 0; j < NY; j++)
+      for (i = 0; i < NX; i++) {
+        int global_index = ecl_grid_get_global_index3( grid , i , j , k );
+        int size = well_conn_index_get_size( index , global_index );
+        int c;
+
+        test_assert_int_equal( count_conn( well_info , report_step , i , j , k ) , size );
+        test_assert_int_equal( size , well_conn_index_get_size3( index , i , j , k ));
+        test_assert_bool_equal( size > 0 , well_conn_index_has_conn( index , global_index ));
+        for (c = 0; c < size; c++) {
+          const well_conn_type * conn = well_conn_index_iget_conn( index , global_index , c );
+          const char * well_name = well_conn_index_iget_well( index , global_index , c );
+          int report_nr = well_conn_index_iget_report_nr( index , global_index , c );
+
+          test_assert_int_equal( i , well_conn_get_i( conn ));
+          test_assert_int_equal( j , well_conn_get_j( conn ));
+          test_assert_int_equal( k , well_conn_get_k( conn ));
+          test_assert_int_equal( i , well_conn_index_iget_well_index( index , global_index , c ));
+          test_assert_string_equal( well_name , well_conn_index_iget_well_name( index , i ));
+          if (report_step >= 0)
+            test_assert_true( report_nr <= report_step );
+        }
+        total += size;
+      }
+  test_assert_int_equal( total , well_conn_index_get_total_size( index ));
+
+  {
+    ecl_region_type * region = ecl_region_alloc( grid , false );
+    stringlist_type * wells;
+    int_vector_type * cells;
+    int region_size = 0;
+
+    ecl_region_select_i1i2( region , 1 , 2 );
+    ecl_region_select_k1k2( region , 0 , 0 );
+    wells = well_conn_index_alloc_region_wells( index , region );
+    cells = well_conn_index_alloc_region_cells( index , region );
+
+    for (i = 0; i < int_vector_size( cells ); i++)
+      region_size += well_conn_index_get_size( index , int_vector_iget( cells , i ));
+    test_assert_int_equal( region_size , well_conn_index_get_region_size( index , region ));
+
+    for (k = 0; k < NZ; k++)
+      for (j = 0; j < NY; j++)
+        for (i = 0; i < NX; i++) {
+          if (i == 1 || i == 2 || k == 0) {
+            int global_index = ecl_grid_get_global_index3( grid , i , j , k );
+            test_assert_bool_equal( well_conn_index_has_conn( index , global_index ) ,
+                                    int_vector_contains( cells , global_index ));
+          }
+        }
+
+    /* All the wells are perforated in layer 0; when the full index is used. */
+    if (report_step < 0)
+      test_assert_int_equal( MAX_WELLS , stringlist_get_size( wells ));
+    else
+      test_assert_int_equal( well_test_num_wells( report_step / 2 ) , stringlist_get_size( wells ));
+
+    int_vector_free( cells );
+    stringlist_free( wells );
+    ecl_region_free( region );
+  }
+
+  well_conn_index_free( index );
+}
+
+
+typedef struct {
+  const well_conn_index_type * index;
+  ecl_region_type            * region;
+} region_arg_type;
+
+
+static void region_size_mismatch( void * arg ) {
+  region_arg_type * region_arg = arg;
+  well_conn_index_get_region_size( region_arg->index , region_arg->region );
+}
+
+
+static void region_cells_mismatch( void * arg ) {
+  region_arg_type * region_arg = arg;
+  int_vector_free( well_conn_index_alloc_region_cells( region_arg->index , region_arg->region ));
+}
+
+
+static void region_wells_mismatch( void * arg ) {
+  region_arg_type * region_arg = arg;
+  stringlist_free( well_conn_index_alloc_region_wells( region_arg->index , region_arg->region ));
+}
+
+
+static void test_region_mismatch( const well_info_type * well_info , const ecl_grid_type * grid ) {
+  ecl_grid_type * other_grid = ecl_grid_alloc_rectangular( NX , NY , NZ + 1 , 1 , 1 , 1 , NULL );
+  well_conn_index_type * index = well_conn_index_alloc( well_info , grid );
+  region_arg_type region_arg;
+
+  region_arg.index = index;
+  region_arg.region = ecl_region_alloc( other_grid , true );
+
+  test_assert_util_abort( "well_conn_index_assert_region" , region_size_mismatch , &region_arg );
+  test_assert_util_abort( "well_conn_index_assert_region" , region_cells_mismatch , &region_arg );
+  test_assert_util_abort( "well_conn_index_assert_region" , region_wells_mismatch , &region_arg );
+
+  ecl_region_free( region_arg.region );
+  well_conn_index_free( index );
+  ecl_grid_free( other_grid );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("well_conn_index");
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , NULL );
+
+  well_test_fwrite_unrst( "CASE.UNRST" );
+
+  {
+    well_info_type * well_info = well_info_alloc( grid );
+    well_info_load_rstfile( well_info , "CASE.UNRST" , false );
+
+    test_index( well_info , grid , -1 );
+    test_index( well_info , grid , 0 );
+    test_index( well_info , grid , 2 * 7 );
+    test_index( well_info , grid , 2 * 7 + 1 );
+    test_index( well_info , grid , 2 * NUM_STEPS );
+    test_region_mismatch( well_info , grid );
+
+    well_info_free( well_info );
+  }
+
+  ecl_grid_free( grid );
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,118 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'well_conn_table.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+
+#include <ert/ecl_well/well_conn.h>
+#include <ert/ecl_well/well_conn_collection.h>
+#include <ert/ecl_well/well_state.h>
+#include <ert/ecl_well/well_ts.h>
+#include <ert/ecl_well/well_info.h>
+#include <ert/ecl_well/well_conn_table.h>
+
+#include "well_test_restart.h"
+
+
+static void assert_equal_table( const well_conn_table_type * table , const well_info_type * well_info , int step ) {
+  int well_nr;
+
+  test_assert_int_equal( 2 * step , well_conn_table_get_report_nr( table ));
+  test_assert_int_equal( well_test_num_wells( step ) , well_conn_table_get_num_wells( table ));
+  for (well_nr = 0; well_nr < well_conn_table_get_num_wells( table ); well_nr++) {
+    const char * well_name = well_conn_table_iget_well_name( table , well_nr );
+    const well_state_type * well_state = well_info_get_state_from_report( well_info , well_name , 2 * step );
+    const well_conn_collection_type * connections = well_state_get_global_connections( well_state );
+    const int offset = well_conn_table_iget_well_offset( table , well_nr );
+    int c;
+
+    test_assert_int_equal( well_nr , well_conn_table_get_well_nr( table , well_name ));
+    test_assert_time_t_equal( well_state_get_sim_time( well_state ) , well_conn_table_get_sim_time( table ));
+    test_assert_int_equal( well_test_num_connections( step , well_nr ) , well_conn_table_iget_well_size( table , well_nr ));
+    test_assert_int_equal( well_conn_collection_get_size( connections ) , well_conn_table_iget_well_size( table , well_nr ));
+
+    for (c = 0; c < well_conn_collection_get_size( connections ); c++) {
+      const well_conn_type * conn = well_conn_collection_iget_const( connections , c );
+      const int row = offset + c;
+
+      test_assert_int_equal( well_nr , well_conn_table_iget_well( table , row ));
+      test_assert_int_equal( well_conn_get_i( conn ) , well_conn_table_iget_i( table , row ));
+      test_assert_int_equal( well_conn_get_j( conn ) , well_conn_table_iget_j( table , row ));
+      test_assert_int_equal( well_conn_get_k( conn ) , well_conn_table_iget_k( table , row ));
+      test_assert_int_equal( well_conn_get_segment_id( conn ) , well_conn_table_iget_segment_id( table , row ));
+      test_assert_int_equal( well_conn_get_dir( conn ) , well_conn_table_iget_dir( table , row ));
+      test_assert_bool_equal( well_conn_open( conn ) , well_conn_table_iget_open( table , row ));
+      test_assert_bool_equal( well_conn_matrix_connection( conn ) , well_conn_table_iget_matrix_connection( table , row ));
+      test_assert_double_equal( well_conn_get_connection_factor( conn ) , well_conn_table_iget_connection_factor( table , row ));
+      test_assert_double_equal( well_conn_get_oil_rate( conn ) , well_conn_table_iget_oil_rate( table , row ));
+      test_assert_double_equal( well_conn_get_gas_rate( conn ) , well_conn_table_iget_gas_rate( table , row ));
+      test_assert_double_equal( well_conn_get_water_rate( conn ) , well_conn_table_iget_water_rate( table , row ));
+      test_assert_double_equal( well_conn_get_volume_rate( conn ) , well_conn_table_iget_volume_rate( table , row ));
+
+      test_assert_int_equal( well_conn_get_i( conn ) , well_conn_table_get_i_ptr( table )[row] );
+      test_assert_double_equal( 100 * step + c , well_conn_table_get_oil_rate_ptr( table )[row] );
+    }
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("well_conn_table");
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , NULL );
+
+  well_test_fwrite_unrst( "CASE.UNRST" );
+
+  {
+    ecl_file_type * rst_file = ecl_file_open( "CASE.UNRST" , 0 );
+    well_info_type * well_info = well_info_alloc( grid );
+    int step;
+
+    well_info_add_UNRST_wells( well_info , rst_file , true );
+    for (step = 0; step < NUM_STEPS; step++) {
+      well_conn_table_type * table = well_conn_table_alloc_from_file( rst_file , 2 * step );
+      int size = 0;
+      int well_nr;
+
+      test_assert_true( well_conn_table_is_instance( table ));
+      for (well_nr = 0; well_nr < well_test_num_wells( step ); well_nr++)
+        size += well_test_num_connections( step , well_nr );
+      test_assert_int_equal( size , well_conn_table_get_size( table ));
+      assert_equal_table( table , well_info , step );
+      well_conn_table_free( table );
+    }
+
+    test_assert_NULL( well_conn_table_alloc_from_file( rst_file , 1 ));
+    {
+      well_conn_table_type * table = well_conn_table_alloc_from_file( rst_file , 0 );
+      test_assert_int_equal( -1 , well_conn_table_get_well_nr( table , "WELL5" ));
+      well_conn_table_free( table );
+    }
+    well_info_free( well_info );
+    ecl_file_close( rst_file );
+  }
+
+  ecl_grid_free( grid );
+  test_work_area_free( work_area );
+  exit(0);
+}
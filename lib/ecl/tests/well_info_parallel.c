@@ -0,0 +1,109 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'well_info_parallel.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+
+#include <ert/ecl_well/well_conn.h>
+#include <ert/ecl_well/well_conn_collection.h>
+#include <ert/ecl_well/well_state.h>
+#include <ert/ecl_well/well_ts.h>
+#include <ert/ecl_well/well_info.h>
+
+#include "well_test_restart.h"
+
+
+static void assert_equal_states( const well_state_type * state1 , const well_state_type * state2 ) {
+  const well_conn_collection_type * conn1 = well_state_get_global_connections( state1 );
+  const well_conn_collection_type * conn2 = well_state_get_global_connections( state2 );
+  int i;
+
+  test_assert_string_equal( well_state_get_name( state1 ) , well_state_get_name( state2 ));
+  test_assert_int_equal( well_state_get_report_nr( state1 ) , well_state_get_report_nr( state2 ));
+  test_assert_time_t_equal( well_state_get_sim_time( state1 ) , well_state_get_sim_time( state2 ));
+  test_assert_bool_equal( well_state_is_open( state1 ) , well_state_is_open( state2 ));
+  test_assert_int_equal( well_state_get_well_nr( state1 ) , well_state_get_well_nr( state2 ));
+  test_assert_int_equal( well_conn_collection_get_size( conn1 ) , well_conn_collection_get_size( conn2 ));
+
+  for (i = 0; i < well_conn_collection_get_size( conn1 ); i++) {
+    const well_conn_type * c1 = well_conn_collection_iget_const( conn1 , i );
+    const well_conn_type * c2 = well_conn_collection_iget_const( conn2 , i );
+    test_assert_int_equal( well_conn_get_i( c1 ) , well_conn_get_i( c2 ));
+    test_assert_int_equal( well_conn_get_j( c1 ) , well_conn_get_j( c2 ));
+    test_assert_int_equal( well_conn_get_k( c1 ) , well_conn_get_k( c2 ));
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("well_info_parallel");
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , NULL );
+
+  well_test_fwrite_unrst( "CASE.UNRST" );
+
+  {
+    ecl_file_type * rst_file = ecl_file_open( "CASE.UNRST" , 0 );
+    well_info_type * serial = well_info_alloc( grid );
+    well_info_type * parallel = well_info_alloc( grid );
+    int iwell;
+
+    well_info_add_UNRST_wells( serial , rst_file , true );
+    well_info_add_UNRST_wells_parallel( parallel , rst_file , true );
+
+    test_assert_int_equal( MAX_WELLS , well_info_get_num_wells( serial ));
+    test_assert_int_equal( well_info_get_num_wells( serial ) , well_info_get_num_wells( parallel ));
+    for (iwell = 0; iwell < well_info_get_num_wells( serial ); iwell++) {
+      const char * well_name = well_info_iget_well_name( serial , iwell );
+      well_ts_type * ts1 = well_info_get_ts( serial , well_name );
+      well_ts_type * ts2 = well_info_get_ts( parallel , well_name );
+      int t;
+
+      test_assert_string_equal( well_name , well_info_iget_well_name( parallel , iwell ));
+      test_assert_int_equal( well_ts_get_size( ts1 ) , well_ts_get_size( ts2 ));
+      for (t = 0; t < well_ts_get_size( ts1 ); t++)
+        assert_equal_states( well_ts_iget_state( ts1 , t ) , well_ts_iget_state( ts2 , t ));
+    }
+
+    {
+      well_state_type * state = well_info_get_state_from_report( parallel , "WELL4" , 2 * 7 );
+      test_assert_int_equal( well_test_num_connections( 7 , 4 ) , well_conn_collection_get_size( well_state_get_global_connections( state )));
+      test_assert_int_equal( NUM_STEPS - 5 , well_ts_get_size( well_info_get_ts( parallel , "WELL4" )));
+    }
+
+    well_info_free( serial );
+    well_info_free( parallel );
+    ecl_file_close( rst_file );
+  }
+
+  {
+    well_info_type * well_info = well_info_alloc( grid );
+    well_info_load_rstfile( well_info , "CASE.UNRST" , false );
+    test_assert_int_equal( NUM_STEPS , well_ts_get_size( well_info_get_ts( well_info , "WELL0" )));
+    well_info_free( well_info );
+  }
+
+  ecl_grid_free( grid );
+  test_work_area_free( work_area );
+  exit(0);
+}
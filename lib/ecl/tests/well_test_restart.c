@@ -0,0 +1,192 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'well_test_restart.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+#include <ert/ecl_well/well_const.h>
+
+#include "well_test_restart.h"
+
+
+#define NIWELZ    100
+#define NZWELZ      3
+#define NICONZ     25
+#define NSCONZ     40
+#define NXCONZ     58
+
+
+int well_test_num_wells( int step ) {
+  return (step < 5) ? 3 : MAX_WELLS;
+}
+
+
+int well_test_num_connections( int step , int well_nr ) {
+  return 1 + (step + well_nr) % NCWMAX;
+}
+
+
+ecl_kw_type * well_test_alloc_intehead( time_t sim_time ) {
+  ecl_kw_type * intehead = ecl_kw_alloc( INTEHEAD_KW , 411 , ECL_INT );
+  int mday , month , year;
+
+  ecl_util_set_date_values( sim_time , &mday , &month , &year );
+  ecl_kw_scalar_set_int( intehead , 0 );
+  ecl_kw_iset_int( intehead , INTEHEAD_DAY_INDEX , mday );
+  ecl_kw_iset_int( intehead , INTEHEAD_MONTH_INDEX , month );
+  ecl_kw_iset_int( intehead , INTEHEAD_YEAR_INDEX , year );
+  return intehead;
+}
+
+
+void well_test_fwrite_rsthead( fortio_type * fortio , int report_step , const ecl_kw_type * intehead , bool dualp , double sim_days ) {
+  ecl_kw_type * logihead = ecl_kw_alloc( LOGIHEAD_KW , 121 , ECL_BOOL );
+  ecl_kw_type * doubhead = ecl_kw_alloc( DOUBHEAD_KW , 229 , ECL_DOUBLE );
+
+  ecl_kw_scalar_set_bool( logihead , false );
+  ecl_kw_iset_bool( logihead , LOGIHEAD_DUALP_INDEX , dualp );
+  ecl_kw_scalar_set_double( doubhead , 0 );
+  ecl_kw_iset_double( doubhead , DOUBHEAD_DAYS_INDEX , sim_days );
+
+  if (report_step >= 0) {
+    ecl_kw_type * seqnum = ecl_kw_alloc( SEQNUM_KW , 1 , ECL_INT );
+    ecl_kw_iset_int( seqnum , 0 , report_step );
+    ecl_kw_fwrite( seqnum , fortio );
+    ecl_kw_free( seqnum );
+  }
+  ecl_kw_fwrite( intehead , fortio );
+  ecl_kw_fwrite( logihead , fortio );
+  ecl_kw_fwrite( doubhead , fortio );
+
+  ecl_kw_free( logihead );
+  ecl_kw_free( doubhead );
+}
+
+
+void well_test_fwrite_pressure( fortio_type * fortio , int size , float value ) {
+  ecl_kw_type * pressure = ecl_kw_alloc( PRESSURE_KW , size , ECL_FLOAT );
+  ecl_kw_scalar_set_float( pressure , value );
+  ecl_kw_fwrite( pressure , fortio );
+  ecl_kw_free( pressure );
+}
+
+
+static void well_test_fwrite_step( fortio_type * fortio , int step ) {
+  const int nwells = well_test_num_wells( step );
+  ecl_kw_type * intehead = well_test_alloc_intehead( ecl_util_make_date( 1 + step , 1 , 2000 ));
+  ecl_kw_type * iwel     = ecl_kw_alloc( IWEL_KW , nwells * NIWELZ , ECL_INT );
+  ecl_kw_type * zwel     = ecl_kw_alloc( ZWEL_KW , nwells * NZWELZ , ECL_CHAR );
+  ecl_kw_type * icon     = ecl_kw_alloc( ICON_KW , nwells * NCWMAX * NICONZ , ECL_INT );
+  ecl_kw_type * scon     = ecl_kw_alloc( SCON_KW , nwells * NCWMAX * NSCONZ , ECL_FLOAT );
+  ecl_kw_type * xcon     = ecl_kw_alloc( XCON_KW , nwells * NCWMAX * NXCONZ , ECL_DOUBLE );
+  int well_nr;
+
+  ecl_kw_iset_int( intehead , INTEHEAD_NX_INDEX , NX );
+  ecl_kw_iset_int( intehead , INTEHEAD_NY_INDEX , NY );
+  ecl_kw_iset_int( intehead , INTEHEAD_NZ_INDEX , NZ );
+  ecl_kw_iset_int( intehead , INTEHEAD_NACTIVE_INDEX , NX * NY * NZ );
+  ecl_kw_iset_int( intehead , INTEHEAD_NWELLS_INDEX , nwells );
+  ecl_kw_iset_int( intehead , INTEHEAD_NIWELZ_INDEX , NIWELZ );
+  ecl_kw_iset_int( intehead , INTEHEAD_NZWELZ_INDEX , NZWELZ );
+  ecl_kw_iset_int( intehead , INTEHEAD_NICONZ_INDEX , NICONZ );
+  ecl_kw_iset_int( intehead , INTEHEAD_NCWMAX_INDEX , NCWMAX );
+  ecl_kw_iset_int( intehead , INTEHEAD_NSCONZ_INDEX , NSCONZ );
+  ecl_kw_iset_int( intehead , INTEHEAD_NXCONZ_INDEX , NXCONZ );
+  ecl_kw_scalar_set_int( iwel , 0 );
+  ecl_kw_scalar_set_int( icon , 0 );
+  ecl_kw_scalar_set_float( scon , 0 );
+  ecl_kw_scalar_set_double( xcon , 0 );
+
+  for (well_nr = 0; well_nr < nwells; well_nr++) {
+    const int iwel_offset = well_nr * NIWELZ;
+    const int i = 1 + well_nr;
+    const int j = 1 + (well_nr + step) % NY;
+    int conn_nr;
+
+    ecl_kw_iset_int( iwel , iwel_offset + IWEL_HEADI_INDEX , i );
+    ecl_kw_iset_int( iwel , iwel_offset + IWEL_HEADJ_INDEX , j );
+    ecl_kw_iset_int( iwel , iwel_offset + IWEL_HEADK_INDEX , 1 );
+    ecl_kw_iset_int( iwel , iwel_offset + IWEL_CONNECTIONS_INDEX , well_test_num_connections( step , well_nr ));
+    ecl_kw_iset_int( iwel , iwel_offset + IWEL_TYPE_INDEX , IWEL_PRODUCER );
+    ecl_kw_iset_int( iwel , iwel_offset + IWEL_STATUS_INDEX , (step + well_nr) % 3 == 0 ? 0 : 1 );
+    ecl_kw_iset_int( iwel , iwel_offset + IWEL_SEGMENTED_WELL_NR_INDEX , IWEL_SEGMENTED_WELL_NR_NORMAL_VALUE );
+
+    {
+      char * name = util_alloc_sprintf("WELL%d" , well_nr);
+      ecl_kw_iset_string8( zwel , well_nr * NZWELZ , name );
+      ecl_kw_iset_string8( zwel , well_nr * NZWELZ + 1 , "" );
+      ecl_kw_iset_string8( zwel , well_nr * NZWELZ + 2 , "" );
+      free( name );
+    }
+
+    for (conn_nr = 0; conn_nr < well_test_num_connections( step , well_nr ); conn_nr++) {
+      const int icon_offset = NICONZ * (NCWMAX * well_nr + conn_nr);
+      ecl_kw_iset_int( icon , icon_offset + ICON_IC_INDEX , conn_nr + 1 );
+      ecl_kw_iset_int( icon , icon_offset + ICON_I_INDEX , i );
+      ecl_kw_iset_int( icon , icon_offset + ICON_J_INDEX , j );
+      ecl_kw_iset_int( icon , icon_offset + ICON_K_INDEX , conn_nr + 1 );
+      ecl_kw_iset_int( icon , icon_offset + ICON_STATUS_INDEX , 1 );
+      ecl_kw_iset_int( icon , icon_offset + ICON_DIRECTION_INDEX , (conn_nr % 2) ? ICON_DIRX : ICON_DIRZ );
+      ecl_kw_iset_int( icon , icon_offset + ICON_SEGMENT_INDEX , (well_nr == 1) ? conn_nr + 1 : 0 );
+      {
+        const int scon_offset = NSCONZ * (NCWMAX * well_nr + conn_nr);
+        const int xcon_offset = NXCONZ * (NCWMAX * well_nr + conn_nr);
+        ecl_kw_iset_float( scon , scon_offset + SCON_CF_INDEX , 0.5 * (conn_nr + 1));
+        ecl_kw_iset_double( xcon , xcon_offset + XCON_ORAT_INDEX , 100 * step + conn_nr );
+        ecl_kw_iset_double( xcon , xcon_offset + XCON_WRAT_INDEX , 10 * well_nr + conn_nr );
+        ecl_kw_iset_double( xcon , xcon_offset + XCON_GRAT_INDEX , 1000 + conn_nr );
+        ecl_kw_iset_double( xcon , xcon_offset + XCON_QR_INDEX , -conn_nr );
+      }
+    }
+  }
+
+  well_test_fwrite_rsthead( fortio , 2 * step , intehead , false , step );
+  ecl_kw_fwrite( iwel , fortio );
+  ecl_kw_fwrite( zwel , fortio );
+  ecl_kw_fwrite( icon , fortio );
+  ecl_kw_fwrite( scon , fortio );
+  ecl_kw_fwrite( xcon , fortio );
+
+  ecl_kw_free( intehead );
+  ecl_kw_free( iwel );
+  ecl_kw_free( zwel );
+  ecl_kw_free( icon );
+  ecl_kw_free( scon );
+  ecl_kw_free( xcon );
+}
+
+
+/*
+  Writes NUM_STEPS report steps to the unified restart file
+  @filename; report step 2*step has well_test_num_wells( step ) wells.
+*/
+
+void well_test_fwrite_unrst( const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  int step;
+  for (step = 0; step < NUM_STEPS; step++)
+    well_test_fwrite_step( fortio , step );
+  fortio_fclose( fortio );
+}
@@ -0,0 +1,56 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'well_test_restart.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#ifndef ERT_WELL_TEST_RESTART_H
+#define ERT_WELL_TEST_RESTART_H
+
+#include <stdbool.h>
+#include <time.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/fortio.h>
+
+/*
+  Synthetic restart file with wells and connections, shared by the
+  well tests. The wells are on a NX x NY x NZ grid with all cells
+  active.
+*/
+
+#define NX 10
+#define NY 10
+#define NZ 5
+
+#define NUM_STEPS  24
+#define MAX_WELLS   6
+#define NCWMAX      NZ
+
+int  well_test_num_wells( int step );
+int  well_test_num_connections( int step , int well_nr );
+void well_test_fwrite_unrst( const char * filename );
+
+/*
+  Building blocks for restart files in the other tests: the INTEHEAD
+  keyword can be modified before it is written, and a negative
+  @report_step writes the block without SEQNUM, as in a non-unified
+  restart file.
+*/
+
+ecl_kw_type * well_test_alloc_intehead( time_t sim_time );
+void          well_test_fwrite_rsthead( fortio_type * fortio , int report_step , const ecl_kw_type * intehead , bool dualp , double sim_days );
+void          well_test_fwrite_pressure( fortio_type * fortio , int size , float value );
+
+#endif
@@ -29,7 +29,6 @@
 #include <ert/ecl_well/well_conn.h>
 
 
-#define WELL_CONN_NORMAL_WELL_SEGMENT_ID -999
 //#define ECLIPSE_NORMAL_WELL_SEGMENT_ID     -1
 
 /*
@@ -145,6 +144,40 @@ well_conn_type * well_conn_alloc_fracture_MSW( int i , int j , int k , double co
 
 
 
+/*
+  Will translate the direction value found in the ICON keyword to
+  well_conn_dir_enum.
+*/
+
+well_conn_dir_enum well_conn_translate_icon_dir( int int_direction ) {
+  well_conn_dir_enum dir = well_conn_fracX;
+
+  if (int_direction == ICON_DEFAULT_DIR_VALUE)
+    int_direction = ICON_DEFAULT_DIR_TARGET;
+
+  switch (int_direction) {
+  case(ICON_DIRX):
+    dir = well_conn_dirX;
+    break;
+  case(ICON_DIRY):
+    dir = well_conn_dirY;
+    break;
+  case(ICON_DIRZ):
+    dir = well_conn_dirZ;
+    break;
+  case(ICON_FRACX):
+    dir = well_conn_fracX;
+    break;
+  case(ICON_FRACY):
+    dir = well_conn_fracY;
+    break;
+  default:
+    util_abort("%s: icon direction value:%d not recognized\n",__func__ , int_direction);
+  }
+  return dir;
+}
+
+
 /*
   Observe that the (ijk) and branch values are shifted to zero offset to be
   aligned with the rest of the ert libraries.
@@ -166,7 +199,7 @@ well_conn_type * well_conn_alloc_from_kw( const ecl_kw_type * icon_kw ,
     double connection_factor = -1;
     bool matrix_connection = true;
     bool open;
-    well_conn_dir_enum dir = well_conn_fracX;
+    well_conn_dir_enum dir;
 
     /* Set the status */
     {
@@ -191,31 +224,7 @@ well_conn_type * well_conn_alloc_from_kw( const ecl_kw_type * icon_kw ,
 
 
     /* Set the direction flag */
-    {
-      int int_direction = ecl_kw_iget_int( icon_kw , icon_offset + ICON_DIRECTION_INDEX );
-      if (int_direction == ICON_DEFAULT_DIR_VALUE)
-        int_direction = ICON_DEFAULT_DIR_TARGET;
-
-      switch (int_direction) {
-      case(ICON_DIRX):
-        dir = well_conn_dirX;
-        break;
-      case(ICON_DIRY):
-        dir = well_conn_dirY;
-        break;
-      case(ICON_DIRZ):
-        dir = well_conn_dirZ;
-        break;
-      case(ICON_FRACX):
-        dir = well_conn_fracX;
-        break;
-      case(ICON_FRACY):
-        dir = well_conn_fracY;
-        break;
-      default:
-        util_abort("%s: icon direction value:%d not recognized\n",__func__ , int_direction);
-      }
-    }
+    dir = well_conn_translate_icon_dir( ecl_kw_iget_int( icon_kw , icon_offset + ICON_DIRECTION_INDEX ));
 
     if (scon_kw) {
       const int scon_offset = header->nsconz * ( header->ncwmax * well_nr + conn_nr );
@@ -0,0 +1,386 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'well_conn_index.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <ert/util/util.h>
+#include <ert/util/type_macros.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/vector.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region.h>
+
+#include <ert/ecl_well/well_conn.h>
+#include <ert/ecl_well/well_conn_collection.h>
+#include <ert/ecl_well/well_state.h>
+#include <ert/ecl_well/well_ts.h>
+#include <ert/ecl_well/well_info.h>
+#include <ert/ecl_well/well_conn_index.h>
+
+
+/*
+  The well_conn_index is a reverse index from global cell index to the
+  well connections which perforate the cell. The index is built from
+  the well states in a well_info instance, either from all the report
+  steps or from the states which are valid at one report step, and is
+  stored in compressed row format:
+
+     offset[g] ... offset[g+1] - 1 : The connections in cell g.
+
+  For each connection the well (index into well_names), the report
+  step and a pointer to the well_conn instance are stored in three
+  parallel arrays. Within one cell the connections are ordered by well
+  (in the well_info order), then by time.
+
+  Observe the following:
+
+   1. Only the connections in the global grid are indexed; LGR
+      connections and connections outside the grid, e.g. fracture
+      connections in a dual porosity model, are ignored.
+
+   2. The well_conn pointers are owned by the well states in the
+      well_info instance; the well_info instance must outlive the
+      index. For a lazy well_info instance the full time series of all
+      the wells are loaded when the index is built.
+
+   3. The index is not updated if more restart data is added to the
+      well_info instance afterwards.
+*/
+
+
+#define WELL_CONN_INDEX_TYPE_ID 70431581
+
+struct well_conn_index_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  const ecl_grid_type   * grid;
+  stringlist_type       * well_names;
+  int                     global_size;
+  int                     size;             /* Total number of indexed connections. */
+  int                   * offset;           /* global_size + 1 elements. */
+  int                   * well_index;
+  int                   * report_nr;
+  const well_conn_type ** conn_list;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( well_conn_index , WELL_CONN_INDEX_TYPE_ID )
+
+
+static int well_conn_index_get_global_index( const ecl_grid_type * grid , const well_conn_type * conn ) {
+  int i = well_conn_get_i( conn );
+  int j = well_conn_get_j( conn );
+  int k = well_conn_get_k( conn );
+
+  if (ecl_grid_ijk_valid( grid , i , j , k ))
+    return ecl_grid_get_global_index3( grid , i , j , k );
+  else
+    return -1;
+}
+
+
+/*
+  Will collect the well_state instances which should be indexed in
+  @state_list, with the corresponding well index in @well_list. If
+  @report_step < 0 all the states are collected, otherwise the state
+  of each well at @report_step.
+*/
+
+static void well_conn_index_collect_states( well_conn_index_type * index , const well_info_type * well_info , int report_step , vector_type * state_list , int_vector_type * well_list) {
+  int well_nr;
+  for (well_nr = 0; well_nr < well_info_get_num_wells( well_info ); well_nr++) {
+    const char * well_name = well_info_iget_well_name( well_info , well_nr );
+    const well_ts_type * well_ts = well_info_get_ts( well_info , well_name );
+
+    stringlist_append_copy( index->well_names , well_name );
+    if (report_step < 0) {
+      int t;
+      for (t = 0; t < well_ts_get_size( well_ts ); t++) {
+        vector_append_ref( state_list , well_ts_iget_state( well_ts , t ));
+        int_vector_append( well_list , well_nr );
+      }
+    } else {
+      const well_state_type * well_state = well_ts_get_state_from_report( well_ts , report_step );
+      if (well_state) {
+        vector_append_ref( state_list , well_state );
+        int_vector_append( well_list , well_nr );
+      }
+    }
+  }
+}
+
+
+static well_conn_index_type * well_conn_index_alloc__( const well_info_type * well_info , const ecl_grid_type * grid , int report_step ) {
+  well_conn_index_type * index = util_malloc( sizeof * index );
+  vector_type * state_list = vector_alloc_new();
+  int_vector_type * well_list = int_vector_alloc( 0 , 0 );
+  int * pos;
+  int g , s;
+
+  UTIL_TYPE_ID_INIT( index , WELL_CONN_INDEX_TYPE_ID );
+  index->grid = grid;
+  index->well_names = stringlist_alloc_new();
+  index->global_size = ecl_grid_get_global_size( grid );
+  index->offset = util_calloc( index->global_size + 1 , sizeof * index->offset );
+  for (g = 0; g <= index->global_size; g++)
+    index->offset[g] = 0;
+
+  well_conn_index_collect_states( index , well_info , report_step , state_list , well_list );
+
+  /* First pass: count the connections in each cell. */
+  for (s = 0; s < vector_get_size( state_list ); s++) {
+    const well_conn_collection_type * connections = well_state_get_global_connections( vector_iget_const( state_list , s ));
+    if (connections) {
+      int c;
+      for (c = 0; c < well_conn_collection_get_size( connections ); c++) {
+        int global_index = well_conn_index_get_global_index( grid , well_conn_collection_iget_const( connections , c ));
+        if (global_index >= 0)
+          index->offset[global_index + 1]++;
+      }
+    }
+  }
+
+  for (g = 0; g < index->global_size; g++)
+    index->offset[g + 1] += index->offset[g];
+  index->size = index->offset[index->global_size];
+
+  index->well_index = util_calloc( util_int_max( 1 , index->size ) , sizeof * index->well_index );
+  index->report_nr  = util_calloc( util_int_max( 1 , index->size ) , sizeof * index->report_nr );
+  index->conn_list  = util_calloc( util_int_max( 1 , index->size ) , sizeof * index->conn_list );
+
+  /* Second pass: fill in the connections. */
+  pos = util_calloc( index->global_size , sizeof * pos );
+  for (g = 0; g < index->global_size; g++)
+    pos[g] = index->offset[g];
+
+  for (s = 0; s < vector_get_size( state_list ); s++) {
+    const well_state_type * well_state = vector_iget_const( state_list , s );
+    const well_conn_collection_type * connections = well_state_get_global_connections( well_state );
+    if (connections) {
+      int c;
+      for (c = 0; c < well_conn_collection_get_size( connections ); c++) {
+        const well_conn_type * conn = well_conn_collection_iget_const( connections , c );
+        int global_index = well_conn_index_get_global_index( grid , conn );
+        if (global_index >= 0) {
+          int p = pos[global_index]++;
+          index->well_index[p] = int_vector_iget( well_list , s );
+          index->report_nr[p]  = well_state_get_report_nr( well_state );
+          index->conn_list[p]  = conn;
+        }
+      }
+    }
+  }
+
+  free( pos );
+  int_vector_free( well_list );
+  vector_free( state_list );
+  return index;
+}
+
+
+/**
+   Will create an index of the connections in all the report steps
+   loaded in @well_info.
+*/
+
+well_conn_index_type * well_conn_index_alloc( const well_info_type * well_info , const ecl_grid_type * grid ) {
+  return well_conn_index_alloc__( well_info , grid , -1 );
+}
+
+
+/**
+   Will create an index of the connections of the well states which
+   are valid at report step @report_step, i.e. the same states as
+   well_info_get_state_from_report() would return.
+*/
+
+well_conn_index_type * well_conn_index_alloc_report( const well_info_type * well_info , const ecl_grid_type * grid , int report_step ) {
+  if (report_step < 0)
+    util_abort("%s: invalid report step:%d \n",__func__ , report_step);
+
+  return well_conn_index_alloc__( well_info , grid , report_step );
+}
+
+
+void well_conn_index_free( well_conn_index_type * index ) {
+  stringlist_free( index->well_names );
+  free( index->offset );
+  free( index->well_index );
+  free( index->report_nr );
+  free( index->conn_list );
+  free( index );
+}
+
+/*****************************************************************/
+
+int well_conn_index_get_num_wells( const well_conn_index_type * index ) {
+  return stringlist_get_size( index->well_names );
+}
+
+
+const char * well_conn_index_iget_well_name( const well_conn_index_type * index , int well_index) {
+  return stringlist_iget( index->well_names , well_index );
+}
+
+
+int well_conn_index_get_total_size( const well_conn_index_type * index ) {
+  return index->size;
+}
+
+
+static void well_conn_index_assert_global_index( const well_conn_index_type * index , int global_index ) {
+  if (global_index < 0 || global_index >= index->global_size)
+    util_abort("%s: invalid global index:%d  valid range: [0,%d) \n",__func__ , global_index , index->global_size);
+}
+
+
+static int well_conn_index_get_pos( const well_conn_index_type * index , int global_index , int conn_nr ) {
+  well_conn_index_assert_global_index( index , global_index );
+  {
+    int size = index->offset[global_index + 1] - index->offset[global_index];
+    if (conn_nr < 0 || conn_nr >= size)
+      util_abort("%s: invalid connection number:%d  cell:%d has %d connections \n",__func__ , conn_nr , global_index , size);
+  }
+  return index->offset[global_index] + conn_nr;
+}
+
+
+int well_conn_index_get_size( const well_conn_index_type * index , int global_index ) {
+  well_conn_index_assert_global_index( index , global_index );
+  return index->offset[global_index + 1] - index->offset[global_index];
+}
+
+
+int well_conn_index_get_size3( const well_conn_index_type * index , int i , int j , int k ) {
+  return well_conn_index_get_size( index , ecl_grid_get_global_index3( index->grid , i , j , k ));
+}
+
+
+bool well_conn_index_has_conn( const well_conn_index_type * index , int global_index ) {
+  return (well_conn_index_get_size( index , global_index ) > 0);
+}
+
+
+int well_conn_index_iget_well_index( const well_conn_index_type * index , int global_index , int conn_nr ) {
+  return index->well_index[ well_conn_index_get_pos( index , global_index , conn_nr ) ];
+}
+
+
+const char * well_conn_index_iget_well( const well_conn_index_type * index , int global_index , int conn_nr ) {
+  return stringlist_iget( index->well_names , well_conn_index_iget_well_index( index , global_index , conn_nr ));
+}
+
+
+int well_conn_index_iget_report_nr( const well_conn_index_type * index , int global_index , int conn_nr ) {
+  return index->report_nr[ well_conn_index_get_pos( index , global_index , conn_nr ) ];
+}
+
+
+const well_conn_type * well_conn_index_iget_conn( const well_conn_index_type * index , int global_index , int conn_nr ) {
+  return index->conn_list[ well_conn_index_get_pos( index , global_index , conn_nr ) ];
+}
+
+/*****************************************************************/
+
+/*
+  The region queries only consult the offset array, and the well
+  index for the cells with connections; the cost is proportional to
+  the number of cells in the region.
+*/
+
+static void well_conn_index_assert_region( const well_conn_index_type * index , const ecl_region_type * region ) {
+  if (ecl_region_get_grid_global_size( region ) != index->global_size)
+    util_abort("%s: size mismatch: the region grid has %d cells - the index grid has %d \n",__func__ ,
+               ecl_region_get_grid_global_size( region ) , index->global_size );
+}
+
+
+int well_conn_index_get_region_size( const well_conn_index_type * index , ecl_region_type * region ) {
+  const int_vector_type * global_list = ecl_region_get_global_list( region );
+  const int * cells = int_vector_get_const_ptr( global_list );
+  const int num_cells = int_vector_size( global_list );
+  int size = 0;
+  int i;
+
+  well_conn_index_assert_region( index , region );
+
+  for (i = 0; i < num_cells; i++)
+    size += index->offset[cells[i] + 1] - index->offset[cells[i]];
+
+  return size;
+}
+
+
+/**
+   Will return the global index of the cells in @region which have at
+   least one connection; the cells are in the order of the region.
+*/
+
+int_vector_type * well_conn_index_alloc_region_cells( const well_conn_index_type * index , ecl_region_type * region ) {
+  const int_vector_type * global_list = ecl_region_get_global_list( region );
+  const int * cells = int_vector_get_const_ptr( global_list );
+  const int num_cells = int_vector_size( global_list );
+  int_vector_type * cell_list = int_vector_alloc( 0 , 0 );
+  int i;
+
+  well_conn_index_assert_region( index , region );
+
+  for (i = 0; i < num_cells; i++) {
+    if (index->offset[cells[i] + 1] > index->offset[cells[i]])
+      int_vector_append( cell_list , cells[i] );
+  }
+
+  return cell_list;
+}
+
+
+/**
+   Will return the names of the wells with at least one connection in
+   @region; the wells are in the well_info order.
+*/
+
+stringlist_type * well_conn_index_alloc_region_wells( const well_conn_index_type * index , ecl_region_type * region ) {
+  const int num_wells = stringlist_get_size( index->well_names );
+  const int_vector_type * global_list = ecl_region_get_global_list( region );
+  const int * cells = int_vector_get_const_ptr( global_list );
+  const int num_cells = int_vector_size( global_list );
+  stringlist_type * well_list = stringlist_alloc_new();
+  bool * has_well = util_calloc( util_int_max( 1 , num_wells ) , sizeof * has_well );
+  int i;
+
+  well_conn_index_assert_region( index , region );
+
+  for (i = 0; i < num_wells; i++)
+    has_well[i] = false;
+
+  for (i = 0; i < num_cells; i++) {
+    int p;
+    for (p = index->offset[cells[i]]; p < index->offset[cells[i] + 1]; p++)
+      has_well[ index->well_index[p] ] = true;
+  }
+
+  for (i = 0; i < num_wells; i++) {
+    if (has_well[i])
+      stringlist_append_copy( well_list , stringlist_iget( index->well_names , i ));
+  }
+
+  free( has_well );
+  return well_list;
+}
@@ -0,0 +1,374 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'well_conn_table.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <ert/util/util.h>
+#include <ert/util/type_macros.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_rsthead.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_view.h>
+
+#include <ert/ecl_well/well_const.h>
+#include <ert/ecl_well/well_conn.h>
+#include <ert/ecl_well/well_conn_table.h>
+
+
+/*
+  The well_conn_table holds all the connections in the global grid for
+  one report step in columnar form, i.e. one contiguous array for each
+  of the connection properties. The table is loaded directly from the
+  IWEL, ZWEL, ICON, SCON and XCON keywords, without creating
+  well_state or well_conn instances; for large models this is much
+  more compact than the well_state -> well_conn_collection ->
+  well_conn structure.
+
+  The connections of one well are stored in the rows:
+
+      well_offset[well_nr] ... well_offset[well_nr + 1] - 1
+
+  in the same order as in the ICON keyword. The values in the table
+  are the same as the corresponding well_conn_get_xxx() functions
+  return, i.e. (i,j,k) are zero offset, fracture connections have
+  matrix_connection == false and the segment_id of a normal well is
+  WELL_CONN_NORMAL_WELL_SEGMENT_ID. The rates are zero when the XCON
+  keyword is not present.
+
+  The well_conn_table_get_xxx_ptr() functions give direct access to
+  the columns, e.g. for export to numpy.
+*/
+
+
+#define WELL_CONN_TABLE_TYPE_ID 61199037
+
+struct well_conn_table_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int                  report_nr;
+  time_t               sim_time;
+  int                  size;
+  stringlist_type    * well_names;
+  int                * well_offset;         /* num_wells + 1 elements. */
+
+  int                * well;
+  int                * i;
+  int                * j;
+  int                * k;
+  int                * segment_id;
+  well_conn_dir_enum * dir;
+  bool               * open;
+  bool               * matrix_connection;
+  double             * connection_factor;
+  double             * oil_rate;
+  double             * gas_rate;
+  double             * water_rate;
+  double             * volume_rate;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( well_conn_table , WELL_CONN_TABLE_TYPE_ID )
+static UTIL_SAFE_CAST_FUNCTION( well_conn_table , WELL_CONN_TABLE_TYPE_ID )
+
+
+static void well_conn_table_alloc_columns( well_conn_table_type * table , int size ) {
+  int alloc_size = util_int_max( 1 , size );
+
+  table->size              = size;
+  table->well              = util_calloc( alloc_size , sizeof * table->well );
+  table->i                 = util_calloc( alloc_size , sizeof * table->i );
+  table->j                 = util_calloc( alloc_size , sizeof * table->j );
+  table->k                 = util_calloc( alloc_size , sizeof * table->k );
+  table->segment_id        = util_calloc( alloc_size , sizeof * table->segment_id );
+  table->dir               = util_calloc( alloc_size , sizeof * table->dir );
+  table->open              = util_calloc( alloc_size , sizeof * table->open );
+  table->matrix_connection = util_calloc( alloc_size , sizeof * table->matrix_connection );
+  table->connection_factor = util_calloc( alloc_size , sizeof * table->connection_factor );
+  table->oil_rate          = util_calloc( alloc_size , sizeof * table->oil_rate );
+  table->gas_rate          = util_calloc( alloc_size , sizeof * table->gas_rate );
+  table->water_rate        = util_calloc( alloc_size , sizeof * table->water_rate );
+  table->volume_rate       = util_calloc( alloc_size , sizeof * table->volume_rate );
+}
+
+
+/*
+  Will load row @row from connection @conn_nr of well @well_nr; the
+  decoding is the same as in well_conn_alloc_from_kw().
+*/
+
+static void well_conn_table_load_row( well_conn_table_type * table ,
+                                      int row ,
+                                      const ecl_kw_type * icon_kw ,
+                                      const ecl_kw_type * scon_kw ,
+                                      const ecl_kw_type * xcon_kw ,
+                                      const ecl_rsthead_type * header ,
+                                      int well_nr ,
+                                      int conn_nr ) {
+
+  const int icon_offset = header->niconz * ( header->ncwmax * well_nr + conn_nr );
+  int k = ecl_kw_iget_int( icon_kw , icon_offset + ICON_K_INDEX ) - 1;
+  bool matrix_connection = true;
+
+  if (header->dualp) {
+    int geometric_nz = header->nz / 2;
+    if (k >= geometric_nz) {
+      k -= geometric_nz;
+      matrix_connection = false;
+    }
+  }
+
+  table->well[row]              = well_nr;
+  table->i[row]                 = ecl_kw_iget_int( icon_kw , icon_offset + ICON_I_INDEX ) - 1;
+  table->j[row]                 = ecl_kw_iget_int( icon_kw , icon_offset + ICON_J_INDEX ) - 1;
+  table->k[row]                 = k;
+  table->matrix_connection[row] = matrix_connection;
+  table->open[row]              = (ecl_kw_iget_int( icon_kw , icon_offset + ICON_STATUS_INDEX ) > 0);
+  table->dir[row]               = well_conn_translate_icon_dir( ecl_kw_iget_int( icon_kw , icon_offset + ICON_DIRECTION_INDEX ));
+
+  {
+    int segment_id = ecl_kw_iget_int( icon_kw , icon_offset + ICON_SEGMENT_INDEX ) - ECLIPSE_WELL_SEGMENT_OFFSET + WELL_SEGMENT_OFFSET;
+    if (segment_id == CONN_NORMAL_WELL_SEGMENT_VALUE)
+      table->segment_id[row] = WELL_CONN_NORMAL_WELL_SEGMENT_ID;
+    else
+      table->segment_id[row] = segment_id;
+  }
+
+  if (scon_kw) {
+    const int scon_offset = header->nsconz * ( header->ncwmax * well_nr + conn_nr );
+    table->connection_factor[row] = ecl_kw_iget_as_double( scon_kw , scon_offset + SCON_CF_INDEX );
+  } else
+    table->connection_factor[row] = -1;
+
+  if (xcon_kw) {
+    const int xcon_offset = header->nxconz * ( header->ncwmax * well_nr + conn_nr );
+    table->water_rate[row]  = ecl_kw_iget_as_double( xcon_kw , xcon_offset + XCON_WRAT_INDEX );
+    table->gas_rate[row]    = ecl_kw_iget_as_double( xcon_kw , xcon_offset + XCON_GRAT_INDEX );
+    table->oil_rate[row]    = ecl_kw_iget_as_double( xcon_kw , xcon_offset + XCON_ORAT_INDEX );
+    table->volume_rate[row] = ecl_kw_iget_as_double( xcon_kw , xcon_offset + XCON_QR_INDEX );
+  } else {
+    table->water_rate[row]  = 0;
+    table->gas_rate[row]    = 0;
+    table->oil_rate[row]    = 0;
+    table->volume_rate[row] = 0;
+  }
+}
+
+
+static bool well_conn_table_global_conn( const ecl_kw_type * icon_kw , const ecl_rsthead_type * header , int well_nr , int conn_nr ) {
+  const int icon_offset = header->niconz * ( header->ncwmax * well_nr + conn_nr );
+  return (ecl_kw_iget_int( icon_kw , icon_offset + ICON_IC_INDEX ) > 0);
+}
+
+
+/**
+   Will load the connection table from @rst_view, which should be
+   restricted to one report step. If the report step does not have
+   any wells, i.e. no IWEL keyword, the table will be empty. If the
+   view contains a SEQNUM keyword that will be used as report number,
+   otherwise @report_nr is used.
+*/
+
+well_conn_table_type * well_conn_table_alloc_from_view( const ecl_file_view_type * rst_view , int report_nr ) {
+  well_conn_table_type * table = util_malloc( sizeof * table );
+  ecl_rsthead_type * header = ecl_rsthead_alloc( rst_view , report_nr );
+
+  UTIL_TYPE_ID_INIT( table , WELL_CONN_TABLE_TYPE_ID );
+  table->report_nr  = header->report_step;
+  table->sim_time   = header->sim_time;
+  table->well_names = stringlist_alloc_new();
+
+  if (ecl_file_view_has_kw( rst_view , IWEL_KW )) {
+    const ecl_kw_type * iwel_kw = ecl_file_view_iget_named_kw( rst_view , IWEL_KW , 0 );
+    const ecl_kw_type * zwel_kw = ecl_file_view_iget_named_kw( rst_view , ZWEL_KW , 0 );
+    const ecl_kw_type * icon_kw = ecl_file_view_iget_named_kw( rst_view , ICON_KW , 0 );
+    const ecl_kw_type * scon_kw = NULL;
+    const ecl_kw_type * xcon_kw = NULL;
+    int size = 0;
+    int well_nr;
+
+    if (ecl_file_view_has_kw( rst_view , SCON_KW ))
+      scon_kw = ecl_file_view_iget_named_kw( rst_view , SCON_KW , 0 );
+
+    if (ecl_file_view_has_kw( rst_view , XCON_KW ))
+      xcon_kw = ecl_file_view_iget_named_kw( rst_view , XCON_KW , 0 );
+
+    table->well_offset = util_calloc( header->nwells + 1 , sizeof * table->well_offset );
+    table->well_offset[0] = 0;
+    for (well_nr = 0; well_nr < header->nwells; well_nr++) {
+      int num_connections = ecl_kw_iget_int( iwel_kw , header->niwelz * well_nr + IWEL_CONNECTIONS_INDEX );
+      int conn_nr;
+      for (conn_nr = 0; conn_nr < num_connections; conn_nr++) {
+        if (well_conn_table_global_conn( icon_kw , header , well_nr , conn_nr ))
+          size++;
+      }
+      table->well_offset[well_nr + 1] = size;
+      stringlist_append_owned_ref( table->well_names , util_alloc_strip_copy( ecl_kw_iget_ptr( zwel_kw , header->nzwelz * well_nr )));
+    }
+
+    well_conn_table_alloc_columns( table , size );
+    for (well_nr = 0; well_nr < header->nwells; well_nr++) {
+      int num_connections = ecl_kw_iget_int( iwel_kw , header->niwelz * well_nr + IWEL_CONNECTIONS_INDEX );
+      int row = table->well_offset[well_nr];
+      int conn_nr;
+      for (conn_nr = 0; conn_nr < num_connections; conn_nr++) {
+        if (well_conn_table_global_conn( icon_kw , header , well_nr , conn_nr )) {
+          well_conn_table_load_row( table , row , icon_kw , scon_kw , xcon_kw , header , well_nr , conn_nr );
+          row++;
+        }
+      }
+    }
+  } else {
+    table->well_offset = util_calloc( 1 , sizeof * table->well_offset );
+    table->well_offset[0] = 0;
+    well_conn_table_alloc_columns( table , 0 );
+  }
+
+  ecl_rsthead_free( header );
+  return table;
+}
+
+
+/**
+   For a unified restart file the report step @report_nr is located
+   with the SEQNUM keyword, and NULL is returned if the file does not
+   contain @report_nr. For a non-unified restart file the active view
+   of @rst_file is used.
+*/
+
+well_conn_table_type * well_conn_table_alloc_from_file( ecl_file_type * rst_file , int report_nr ) {
+  if (ecl_file_has_kw( rst_file , SEQNUM_KW )) {
+    ecl_file_view_type * rst_view = ecl_file_get_restart_view( rst_file , -1 , report_nr , -1 , -1 );
+    if (rst_view)
+      return well_conn_table_alloc_from_view( rst_view , report_nr );
+    else
+      return NULL;
+  } else
+    return well_conn_table_alloc_from_view( ecl_file_get_active_view( rst_file ) , report_nr );
+}
+
+
+void well_conn_table_free( well_conn_table_type * table ) {
+  stringlist_free( table->well_names );
+  free( table->well_offset );
+  free( table->well );
+  free( table->i );
+  free( table->j );
+  free( table->k );
+  free( table->segment_id );
+  free( table->dir );
+  free( table->open );
+  free( table->matrix_connection );
+  free( table->connection_factor );
+  free( table->oil_rate );
+  free( table->gas_rate );
+  free( table->water_rate );
+  free( table->volume_rate );
+  free( table );
+}
+
+
+void well_conn_table_free__( void * arg ) {
+  well_conn_table_type * table = well_conn_table_safe_cast( arg );
+  well_conn_table_free( table );
+}
+
+/*****************************************************************/
+
+int well_conn_table_get_report_nr( const well_conn_table_type * table ) {
+  return table->report_nr;
+}
+
+
+time_t well_conn_table_get_sim_time( const well_conn_table_type * table ) {
+  return table->sim_time;
+}
+
+
+int well_conn_table_get_size( const well_conn_table_type * table ) {
+  return table->size;
+}
+
+
+int well_conn_table_get_num_wells( const well_conn_table_type * table ) {
+  return stringlist_get_size( table->well_names );
+}
+
+
+const char * well_conn_table_iget_well_name( const well_conn_table_type * table , int well_nr ) {
+  return stringlist_iget( table->well_names , well_nr );
+}
+
+
+/*
+  Returns -1 if the table does not contain a well with name @well_name.
+*/
+
+int well_conn_table_get_well_nr( const well_conn_table_type * table , const char * well_name ) {
+  return stringlist_find_first( table->well_names , well_name );
+}
+
+
+static void well_conn_table_assert_well_nr( const well_conn_table_type * table , int well_nr ) {
+  if (well_nr < 0 || well_nr >= stringlist_get_size( table->well_names ))
+    util_abort("%s: invalid well_nr:%d  valid range: [0,%d) \n",__func__ , well_nr , stringlist_get_size( table->well_names ));
+}
+
+
+int well_conn_table_iget_well_offset( const well_conn_table_type * table , int well_nr ) {
+  well_conn_table_assert_well_nr( table , well_nr );
+  return table->well_offset[well_nr];
+}
+
+
+int well_conn_table_iget_well_size( const well_conn_table_type * table , int well_nr ) {
+  well_conn_table_assert_well_nr( table , well_nr );
+  return table->well_offset[well_nr + 1] - table->well_offset[well_nr];
+}
+
+/*****************************************************************/
+
+#define WELL_CONN_TABLE_COLUMN( ctype , column )                                                       \
+ctype well_conn_table_iget_ ## column( const well_conn_table_type * table , int row ) {               \
+  if (row < 0 || row >= table->size)                                                                   \
+    util_abort("%s: invalid row:%d  valid range: [0,%d) \n",__func__ , row , table->size);            \
+  return table->column[row];                                                                           \
+}                                                                                                      \
+                                                                                                       \
+const ctype * well_conn_table_get_ ## column ## _ptr( const well_conn_table_type * table ) {          \
+  return table->column;                                                                                \
+}
+
+WELL_CONN_TABLE_COLUMN( int , well )
+WELL_CONN_TABLE_COLUMN( int , i )
+WELL_CONN_TABLE_COLUMN( int , j )
+WELL_CONN_TABLE_COLUMN( int , k )
+WELL_CONN_TABLE_COLUMN( int , segment_id )
+WELL_CONN_TABLE_COLUMN( well_conn_dir_enum , dir )
+WELL_CONN_TABLE_COLUMN( bool , open )
+WELL_CONN_TABLE_COLUMN( bool , matrix_connection )
+WELL_CONN_TABLE_COLUMN( double , connection_factor )
+WELL_CONN_TABLE_COLUMN( double , oil_rate )
+WELL_CONN_TABLE_COLUMN( double , gas_rate )
+WELL_CONN_TABLE_COLUMN( double , water_rate )
+WELL_CONN_TABLE_COLUMN( double , volume_rate )
+
+#undef WELL_CONN_TABLE_COLUMN
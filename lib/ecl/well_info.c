@@ -23,10 +23,14 @@
 #include <ert/util/hash.h>
 #include <ert/util/int_vector.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/vector.h>
 
 #include <ert/ecl/ecl_rsthead.h>
 #include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_kw.h>
 #include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_kw_magic.h>
 #include <ert/ecl/ecl_util.h>
@@ -158,6 +162,11 @@
        - well_info_add_UNRST_wells() - ecl_file: Many report steps
        - well_info_load_rstfile()    - Restart file name; single file or unified
 
+     The well_info_add_UNRST_wells_parallel() function gives the same
+     result as well_info_add_UNRST_wells(), but loads the report
+     steps in parallel; it is used by well_info_load_rstfile() for
+     unified restart files.
+
      There are more details about this in a comment section above the
      well_info_add_wells() function.
 
@@ -171,6 +180,10 @@
       - well_info_iget_state()
       - well_info_iiget_state()
 
+     With a lazy instance, created with well_info_alloc_lazy(), the
+     well states are loaded from the restart file when they are
+     queried; see the comment about lazy instances below.
+
   4. well_info_free() before you go home.
 
 */
@@ -179,10 +192,354 @@
 #define WELL_INFO_TYPE_ID 91777451
 
 
+/*
+  Lazy well_info instances
+  ------------------------
+
+  A well_info instance created with well_info_alloc_lazy() will not
+  create any well_state instances when restart data is added. Instead
+  the add functions record where the keywords of each report step are
+  located in the restart file, and the well_nr of each well in that
+  report step. The well_state for one (well, report step) pair is
+  created from the restart file when it is queried, and stored in a
+  cache with room for at most cache_size well_state instances; when
+  the cache is full the least recently used well_state is freed.
+
+  Observe the following:
+
+   1. A well_state pointer returned from a lazy instance is only
+      valid until cache_size other well states have been loaded.
+
+   2. well_info_get_ts() will load all the states of the well into a
+      well_ts instance which lives as long as the well_info instance;
+      these states are not part of the cache.
+
+   3. The restart files must be available, and unchanged, as long as
+      the well_info instance is in use.
+
+   4. The cache is updated by the const query functions, i.e. a lazy
+      well_info instance can not be queried from several threads.
+*/
+
+#define WELL_INFO_LAZY_MIN_CACHE_SIZE 4
+
+typedef struct well_info_node_struct well_info_node_type;
+
+typedef struct {
+  int             file_nr;
+  int             report_nr;
+  bool            load_segment_information;
+  vector_type   * kw_list;                  /* Copies of the ecl_file_kw instances of the report step. */
+} well_info_step_type;
+
+
+struct well_info_node_struct {
+  int                   step_nr;
+  int                   well_nr;
+  int                   report_nr;
+  time_t                sim_time;
+  well_state_type     * well_state;         /* NULL when the state is not in the cache. */
+  well_info_node_type * lru_prev;
+  well_info_node_type * lru_next;
+};
+
+
+typedef struct {
+  vector_type * nodes;                      /* well_info_node instances for one well. */
+  bool          sorted;                     /* Are the nodes sorted in time? */
+} well_info_lazy_well_type;
+
+
+typedef struct {
+  int                   cache_size;
+  int                   num_cached;
+  well_info_node_type * lru_head;           /* Most recently used well state. */
+  well_info_node_type * lru_tail;           /* Least recently used well state - will be evicted first. */
+  stringlist_type     * file_list;
+  fortio_type        ** fortio_list;        /* One fortio per file in file_list; opened on first use. */
+  vector_type         * step_list;
+  hash_type           * wells;              /* Hash table of well_info_lazy_well instances; indexed by well name. */
+} well_info_lazy_type;
+
+
+static void well_info_step_free__( void * arg ) {
+  well_info_step_type * step = (well_info_step_type *) arg;
+  vector_free( step->kw_list );
+  free( step );
+}
+
+
+static void well_info_node_free__( void * arg ) {
+  well_info_node_type * node = (well_info_node_type *) arg;
+  if (node->well_state)
+    well_state_free( node->well_state );
+  free( node );
+}
+
+
+static int well_info_node_time_cmp( const void * arg1 , const void * arg2) {
+  const well_info_node_type * node1 = (const well_info_node_type *) arg1;
+  const well_info_node_type * node2 = (const well_info_node_type *) arg2;
+
+  if (node1->sim_time < node2->sim_time)
+    return -1;
+  else if (node1->sim_time == node2->sim_time)
+    return 0;
+  else
+    return 1;
+}
+
+
+static void well_info_lazy_well_free__( void * arg ) {
+  well_info_lazy_well_type * lazy_well = (well_info_lazy_well_type *) arg;
+  vector_free( lazy_well->nodes );
+  free( lazy_well );
+}
+
+
+static well_info_lazy_type * well_info_lazy_alloc( int cache_size ) {
+  well_info_lazy_type * lazy = util_malloc( sizeof * lazy );
+  lazy->cache_size  = util_int_max( cache_size , WELL_INFO_LAZY_MIN_CACHE_SIZE );
+  lazy->num_cached  = 0;
+  lazy->lru_head    = NULL;
+  lazy->lru_tail    = NULL;
+  lazy->file_list   = stringlist_alloc_new();
+  lazy->fortio_list = NULL;
+  lazy->step_list   = vector_alloc_new();
+  lazy->wells       = hash_alloc();
+  return lazy;
+}
+
+
+static void well_info_lazy_free( well_info_lazy_type * lazy ) {
+  int file_nr;
+  for (file_nr = 0; file_nr < stringlist_get_size( lazy->file_list ); file_nr++) {
+    if (lazy->fortio_list[file_nr])
+      fortio_fclose( lazy->fortio_list[file_nr] );
+  }
+  free( lazy->fortio_list );
+  stringlist_free( lazy->file_list );
+  hash_free( lazy->wells );
+  vector_free( lazy->step_list );
+  free( lazy );
+}
+
+
+static int well_info_lazy_get_file_nr( well_info_lazy_type * lazy , const char * filename ) {
+  int file_nr = stringlist_find_first( lazy->file_list , filename );
+  if (file_nr < 0) {
+    file_nr = stringlist_get_size( lazy->file_list );
+    stringlist_append_copy( lazy->file_list , filename );
+    lazy->fortio_list = util_realloc( lazy->fortio_list , (file_nr + 1) * sizeof * lazy->fortio_list );
+    lazy->fortio_list[file_nr] = NULL;
+  }
+  return file_nr;
+}
+
+
+static fortio_type * well_info_lazy_get_fortio( well_info_lazy_type * lazy , int file_nr ) {
+  if (lazy->fortio_list[file_nr] == NULL) {
+    const char * filename = stringlist_iget( lazy->file_list , file_nr );
+    bool fmt_file;
+
+    if (!ecl_util_fmt_file( filename , &fmt_file ))
+      util_abort("%s: could not determine formatted/unformatted status of:%s \n",__func__ , filename);
+
+    lazy->fortio_list[file_nr] = fortio_open_reader( filename , fmt_file , ECL_ENDIAN_FLIP );
+    if (lazy->fortio_list[file_nr] == NULL)
+      util_abort("%s: failed to open restart file:%s \n",__func__ , filename);
+  }
+  return lazy->fortio_list[file_nr];
+}
+
+
+/*
+  Will record the location of the keywords in @step_view, and add one
+  node for each of the wells in the report step; no well_state
+  instances are created.
+*/
+
+static void well_info_lazy_add_step( well_info_lazy_type * lazy , stringlist_type * well_names , ecl_file_view_type * step_view , int report_nr , bool load_segment_information) {
+  if (!ecl_file_view_has_kw( step_view , IWEL_KW ))
+    return;
+
+  {
+    ecl_rsthead_type * global_header = ecl_rsthead_alloc( step_view , report_nr );
+    const ecl_kw_type * zwel_kw = ecl_file_view_iget_named_kw( step_view , ZWEL_KW , 0 );
+    well_info_step_type * step = util_malloc( sizeof * step );
+    int step_nr = vector_get_size( lazy->step_list );
+    int well_nr;
+    int i;
+
+    step->file_nr = well_info_lazy_get_file_nr( lazy , ecl_file_view_get_src_file( step_view ));
+    step->report_nr = report_nr;
+    step->load_segment_information = load_segment_information;
+    step->kw_list = vector_alloc_new();
+    for (i = 0; i < ecl_file_view_get_size( step_view ); i++)
+      vector_append_owned_ref( step->kw_list , ecl_file_kw_alloc_copy( ecl_file_view_iget_file_kw( step_view , i )) , ecl_file_kw_free__ );
+    vector_append_owned_ref( lazy->step_list , step , well_info_step_free__ );
+
+    for (well_nr = 0; well_nr < global_header->nwells; well_nr++) {
+      char * well_name = util_alloc_strip_copy( ecl_kw_iget_ptr( zwel_kw , global_header->nzwelz * well_nr ));
+      well_info_node_type * node = util_malloc( sizeof * node );
+      well_info_lazy_well_type * lazy_well;
+
+      if (!hash_has_key( lazy->wells , well_name )) {
+        lazy_well = util_malloc( sizeof * lazy_well );
+        lazy_well->nodes = vector_alloc_new();
+        lazy_well->sorted = true;
+        hash_insert_hash_owned_ref( lazy->wells , well_name , lazy_well , well_info_lazy_well_free__ );
+        stringlist_append_copy( well_names , well_name );
+      } else
+        lazy_well = hash_get( lazy->wells , well_name );
+
+      node->step_nr    = step_nr;
+      node->well_nr    = well_nr;
+      node->report_nr  = report_nr;
+      node->sim_time   = global_header->sim_time;
+      node->well_state = NULL;
+      node->lru_prev   = NULL;
+      node->lru_next   = NULL;
+
+      if (vector_get_size( lazy_well->nodes ) > 0) {
+        const well_info_node_type * last_node = vector_get_last_const( lazy_well->nodes );
+        if (node->sim_time < last_node->sim_time)
+          lazy_well->sorted = false;
+      }
+      vector_append_owned_ref( lazy_well->nodes , node , well_info_node_free__ );
+      free( well_name );
+    }
+    ecl_rsthead_free( global_header );
+  }
+}
+
+
+static well_info_lazy_well_type * well_info_lazy_get_well( const well_info_lazy_type * lazy , const char * well_name ) {
+  well_info_lazy_well_type * lazy_well = hash_get( lazy->wells , well_name );
+  if (!lazy_well->sorted) {
+    vector_sort( lazy_well->nodes , well_info_node_time_cmp );
+    lazy_well->sorted = true;
+  }
+  return lazy_well;
+}
+
+
+/*
+  Will return the index of the last node with report_nr (sim_time)
+  less than or equal to @report_step (@sim_time), or -1 if the query
+  is before the first node; i.e. the same semantics as well_ts.
+*/
+
+static int well_info_lazy_well_get_index( const well_info_lazy_well_type * lazy_well , int report_step , time_t sim_time , bool use_report) {
+  int lower_index = 0;
+  int upper_index = vector_get_size( lazy_well->nodes );
+
+  while (lower_index < upper_index) {
+    int center_index = (lower_index + upper_index) / 2;
+    const well_info_node_type * center_node = vector_iget_const( lazy_well->nodes , center_index );
+    bool before;
+
+    if (use_report)
+      before = (center_node->report_nr <= report_step);
+    else
+      before = (center_node->sim_time <= sim_time);
+
+    if (before)
+      lower_index = center_index + 1;
+    else
+      upper_index = center_index;
+  }
+  return lower_index - 1;
+}
+
+
+static well_state_type * well_info_lazy_alloc_state( well_info_lazy_type * lazy , const ecl_grid_type * grid , const well_info_node_type * node ) {
+  const well_info_step_type * step = vector_iget_const( lazy->step_list , node->step_nr );
+  fortio_type * fortio = well_info_lazy_get_fortio( lazy , step->file_nr );
+  int flags = 0;
+  inv_map_type * inv_map = inv_map_alloc();
+  ecl_file_view_type * private_view = ecl_file_view_alloc( fortio , &flags , inv_map , true );
+  well_state_type * well_state;
+  int i;
+
+  for (i = 0; i < vector_get_size( step->kw_list ); i++)
+    ecl_file_view_add_kw( private_view , ecl_file_kw_alloc_copy( vector_iget_const( step->kw_list , i )));
+  ecl_file_view_make_index( private_view );
+
+  well_state = well_state_alloc_from_file2( private_view , grid , step->report_nr , node->well_nr , step->load_segment_information );
+
+  ecl_file_view_free( private_view );
+  inv_map_free( inv_map );
+  return well_state;
+}
+
+
+static void well_info_lazy_lru_unlink( well_info_lazy_type * lazy , well_info_node_type * node ) {
+  if (node->lru_prev)
+    node->lru_prev->lru_next = node->lru_next;
+  else
+    lazy->lru_head = node->lru_next;
+
+  if (node->lru_next)
+    node->lru_next->lru_prev = node->lru_prev;
+  else
+    lazy->lru_tail = node->lru_prev;
+
+  node->lru_prev = NULL;
+  node->lru_next = NULL;
+}
+
+
+static void well_info_lazy_lru_push_front( well_info_lazy_type * lazy , well_info_node_type * node ) {
+  node->lru_prev = NULL;
+  node->lru_next = lazy->lru_head;
+  if (lazy->lru_head)
+    lazy->lru_head->lru_prev = node;
+  else
+    lazy->lru_tail = node;
+  lazy->lru_head = node;
+}
+
+
+/*
+  Will return the well_state of node @index of @lazy_well, loading it
+  from the restart file if it is not already in the cache. The node
+  is moved to the front of the LRU list, and the least recently used
+  well states are freed if the cache has grown beyond cache_size.
+*/
+
+static well_state_type * well_info_lazy_iget_state( well_info_lazy_type * lazy , const ecl_grid_type * grid , const well_info_lazy_well_type * lazy_well , int index ) {
+  if (index < 0)
+    return NULL;
+  else {
+    well_info_node_type * node = vector_iget( lazy_well->nodes , index );
+
+    if (node->well_state)
+      well_info_lazy_lru_unlink( lazy , node );
+    else {
+      node->well_state = well_info_lazy_alloc_state( lazy , grid , node );
+      lazy->num_cached++;
+    }
+    well_info_lazy_lru_push_front( lazy , node );
+
+    while (lazy->num_cached > lazy->cache_size) {
+      well_info_node_type * lru_node = lazy->lru_tail;
+      well_info_lazy_lru_unlink( lazy , lru_node );
+      well_state_free( lru_node->well_state );
+      lru_node->well_state = NULL;
+      lazy->num_cached--;
+    }
+
+    return node->well_state;
+  }
+}
+
+
 struct well_info_struct {
   hash_type           * wells;                /* Hash table of well_ts_type instances; indexed by well name. */
   stringlist_type     * well_names;           /* A list of all the well names. */
   const ecl_grid_type * grid;
+  well_info_lazy_type * lazy;                 /* NULL unless the instance has been created with well_info_alloc_lazy(). */
 };
 
 
@@ -196,15 +553,56 @@ well_info_type * well_info_alloc( const ecl_grid_type * grid) {
   well_info->wells      = hash_alloc();
   well_info->well_names = stringlist_alloc_new();
   well_info->grid       = grid;
+  well_info->lazy       = NULL;
+  return well_info;
+}
+
+
+/**
+   Will create a lazy well_info instance, where the well states are
+   loaded from the restart files on demand and at most @cache_size
+   well states are kept in memory; see the comment about lazy
+   instances above.
+*/
+
+well_info_type * well_info_alloc_lazy( const ecl_grid_type * grid , int cache_size) {
+  well_info_type * well_info = well_info_alloc( grid );
+  well_info->lazy = well_info_lazy_alloc( cache_size );
   return well_info;
 }
 
 
+bool well_info_is_lazy( const well_info_type * well_info ) {
+  return (well_info->lazy != NULL);
+}
+
+
 bool well_info_has_well( well_info_type * well_info , const char * well_name ) {
-  return hash_has_key( well_info->wells , well_name );
+  if (well_info->lazy)
+    return hash_has_key( well_info->lazy->wells , well_name );
+  else
+    return hash_has_key( well_info->wells , well_name );
 }
 
+
+/*
+  For a lazy instance the full time series of the well is loaded the
+  first time the well_ts is requested; the well_ts is not part of the
+  cache and lives as long as the well_info instance.
+*/
+
 well_ts_type * well_info_get_ts( const well_info_type * well_info , const char *well_name) {
+  if (well_info->lazy && !hash_has_key( well_info->wells , well_name )) {
+    const well_info_lazy_well_type * lazy_well = well_info_lazy_get_well( well_info->lazy , well_name );
+    well_ts_type * well_ts = well_ts_alloc( well_name );
+    int index;
+
+    for (index = 0; index < vector_get_size( lazy_well->nodes ); index++) {
+      const well_info_node_type * node = vector_iget_const( lazy_well->nodes , index );
+      well_ts_add_well( well_ts , well_info_lazy_alloc_state( well_info->lazy , well_info->grid , node ));
+    }
+    hash_insert_hash_owned_ref( well_info->wells , well_name , well_ts , well_ts_free__);
+  }
   return hash_get( well_info->wells , well_name );
 }
 
@@ -277,14 +675,18 @@ static void well_info_add_state( well_info_type * well_info , well_state_type *
 
 void well_info_add_wells2( well_info_type * well_info , ecl_file_view_type * rst_view , int report_nr, bool load_segment_information) {
   bool close_stream = ecl_file_view_drop_flag( rst_view , ECL_FILE_CLOSE_STREAM );
-  ecl_rsthead_type * global_header = ecl_rsthead_alloc( rst_view , report_nr );
-  int well_nr;
-  for (well_nr = 0; well_nr < global_header->nwells; well_nr++) {
-    well_state_type * well_state = well_state_alloc_from_file2( rst_view , well_info->grid , report_nr , well_nr , load_segment_information );
-    if (well_state != NULL)
-      well_info_add_state( well_info , well_state );
+  if (well_info->lazy)
+    well_info_lazy_add_step( well_info->lazy , well_info->well_names , rst_view , report_nr , load_segment_information );
+  else {
+    ecl_rsthead_type * global_header = ecl_rsthead_alloc( rst_view , report_nr );
+    int well_nr;
+    for (well_nr = 0; well_nr < global_header->nwells; well_nr++) {
+      well_state_type * well_state = well_state_alloc_from_file2( rst_view , well_info->grid , report_nr , well_nr , load_segment_information );
+      if (well_state != NULL)
+        well_info_add_state( well_info , well_state );
+    }
+    ecl_rsthead_free( global_header );
   }
-  ecl_rsthead_free( global_header );
   if (close_stream)
     ecl_file_view_add_flag(rst_view, ECL_FILE_CLOSE_STREAM);
 }
@@ -322,6 +724,117 @@ void well_info_add_UNRST_wells( well_info_type * well_info , ecl_file_type * rst
 }
 
 
+/*
+  The parallel version of well_info_add_UNRST_wells2(). The report
+  steps are distributed between OpenMP threads; each thread opens its
+  own fortio instance to the restart file and creates a private
+  ecl_file_view with copies of the ecl_file_kw instances for the
+  report step. The keywords are read through the private view and
+  freed when the report step is complete, i.e. the shared rst_view is
+  only used to locate the report steps. If the report steps come from
+  different files, see ecl_file_open_restart_case(), the thread will
+  reopen its fortio instance when the source file changes. The well states from each
+  report step are collected in a vector, and added to the well_ts
+  instances in the original order when all the report steps have
+  been loaded; the result is identical to well_info_add_UNRST_wells2().
+*/
+
+static fortio_type * well_info_fortio_open_reader( const char * filename ) {
+  bool fmt_file;
+  if (!ecl_util_fmt_file( filename , &fmt_file ))
+    util_abort("%s: could not determine formatted/unformatted status of:%s \n",__func__ , filename);
+
+  return fortio_open_reader( filename , fmt_file , ECL_ENDIAN_FLIP );
+}
+
+
+static vector_type * well_info_alloc_step_states( const well_info_type * well_info , const ecl_file_view_type * step_view , fortio_type * fortio , int report_nr , bool load_segment_information) {
+  vector_type * states = vector_alloc_new();
+  int flags = 0;
+  inv_map_type * inv_map = inv_map_alloc();
+  ecl_file_view_type * private_view = ecl_file_view_alloc( fortio , &flags , inv_map , true );
+  int i;
+
+  for (i = 0; i < ecl_file_view_get_size( step_view ); i++)
+    ecl_file_view_add_kw( private_view , ecl_file_kw_alloc_copy( ecl_file_view_iget_file_kw( step_view , i )));
+  ecl_file_view_make_index( private_view );
+
+  {
+    ecl_rsthead_type * global_header = ecl_rsthead_alloc( private_view , report_nr );
+    int well_nr;
+    for (well_nr = 0; well_nr < global_header->nwells; well_nr++) {
+      well_state_type * well_state = well_state_alloc_from_file2( private_view , well_info->grid , report_nr , well_nr , load_segment_information );
+      if (well_state != NULL)
+        vector_append_ref( states , well_state );
+    }
+    ecl_rsthead_free( global_header );
+  }
+
+  ecl_file_view_free( private_view );
+  inv_map_free( inv_map );
+  return states;
+}
+
+
+void well_info_add_UNRST_wells_parallel2( well_info_type * well_info , ecl_file_view_type * rst_view, bool load_segment_information) {
+  if (well_info->lazy) {
+    /* Only the index is built for a lazy instance; nothing to gain from threads. */
+    well_info_add_UNRST_wells2( well_info , rst_view , load_segment_information );
+  } else {
+    int num_blocks = ecl_file_view_get_num_named_kw( rst_view , SEQNUM_KW );
+    ecl_file_view_type ** step_views = util_calloc( util_int_max( 1 , num_blocks ) , sizeof * step_views );
+    vector_type ** step_states = util_calloc( util_int_max( 1 , num_blocks ) , sizeof * step_states );
+    int * report_list = util_calloc( util_int_max( 1 , num_blocks ) , sizeof * report_list );
+    int block_nr;
+
+    for (block_nr = 0; block_nr < num_blocks; block_nr++) {
+      step_views[block_nr] = ecl_file_view_add_restart_view( rst_view , block_nr , -1 , -1 , -1 );
+      {
+        const ecl_kw_type * seqnum_kw = ecl_file_view_iget_named_kw( step_views[block_nr] , SEQNUM_KW , 0);
+        report_list[block_nr] = ecl_kw_iget_int( seqnum_kw , 0 );
+      }
+    }
+
+#pragma omp parallel if (num_blocks > 1)
+    {
+      fortio_type * fortio = NULL;
+      int step;
+
+#pragma omp for schedule(dynamic)
+      for (step = 0; step < num_blocks; step++) {
+        const char * filename = ecl_file_view_get_src_file( step_views[step] );
+        if (!fortio || !util_string_equal( filename , fortio_filename_ref( fortio ))) {
+          if (fortio)
+            fortio_fclose( fortio );
+          fortio = well_info_fortio_open_reader( filename );
+        }
+        step_states[step] = well_info_alloc_step_states( well_info , step_views[step] , fortio , report_list[step] , load_segment_information );
+      }
+
+      if (fortio)
+        fortio_fclose( fortio );
+    }
+
+    for (block_nr = 0; block_nr < num_blocks; block_nr++) {
+      vector_type * states = step_states[block_nr];
+      int i;
+      for (i = 0; i < vector_get_size( states ); i++)
+        well_info_add_state( well_info , vector_iget( states , i ));
+      vector_free( states );
+    }
+
+    free( report_list );
+    free( step_states );
+    free( step_views );
+  }
+}
+
+
+void well_info_add_UNRST_wells_parallel( well_info_type * well_info , ecl_file_type * rst_file, bool load_segment_information) {
+  well_info_add_UNRST_wells_parallel2( well_info , ecl_file_get_global_view( rst_file ) , load_segment_information);
+}
+
+
 /**
    The @filename argument should be the name of a restart file; in
    unified or not-unified format - if that is not the case we will
@@ -341,10 +854,11 @@ void well_info_load_rst_eclfile( well_info_type * well_info , ecl_file_type * ec
   ecl_file_enum file_type = ecl_util_get_file_type( filename , NULL , &report_nr);
   if ((file_type == ECL_RESTART_FILE) || (file_type == ECL_UNIFIED_RESTART_FILE))
   {
-    if (file_type == ECL_RESTART_FILE)
+    /* A multi file restart case is opened with the first non-unified file as source. */
+    if ((file_type == ECL_RESTART_FILE) && (ecl_file_get_num_named_kw( ecl_file , SEQNUM_KW ) <= 1))
       well_info_add_wells( well_info , ecl_file , report_nr , load_segment_information );
     else
-      well_info_add_UNRST_wells( well_info , ecl_file , load_segment_information );
+      well_info_add_UNRST_wells_parallel( well_info , ecl_file , load_segment_information );
 
   } else
     util_abort("%s: invalid file type: %s - must be a restart file\n", __func__ , filename);
@@ -352,32 +866,58 @@ void well_info_load_rst_eclfile( well_info_type * well_info , ecl_file_type * ec
 }
 
 void well_info_free( well_info_type * well_info ) {
+  if (well_info->lazy)
+    well_info_lazy_free( well_info->lazy );
   hash_free( well_info->wells );
   stringlist_free( well_info->well_names );
   free( well_info );
 }
 
 int well_info_get_well_size( const well_info_type * well_info , const char * well_name ) {
-  well_ts_type * well_ts = well_info_get_ts( well_info , well_name );
-  return well_ts_get_size( well_ts );
+  if (well_info->lazy) {
+    const well_info_lazy_well_type * lazy_well = hash_get( well_info->lazy->wells , well_name );
+    return vector_get_size( lazy_well->nodes );
+  } else {
+    well_ts_type * well_ts = well_info_get_ts( well_info , well_name );
+    return well_ts_get_size( well_ts );
+  }
 }
 
 /*****************************************************************/
 
 well_state_type * well_info_get_state_from_time( const well_info_type * well_info , const char * well_name , time_t sim_time) {
-  well_ts_type * well_ts = well_info_get_ts( well_info , well_name );
-  return well_ts_get_state_from_sim_time( well_ts , sim_time );
+  if (well_info->lazy) {
+    const well_info_lazy_well_type * lazy_well = well_info_lazy_get_well( well_info->lazy , well_name );
+    int index = well_info_lazy_well_get_index( lazy_well , -1 , sim_time , false );
+    return well_info_lazy_iget_state( well_info->lazy , well_info->grid , lazy_well , index );
+  } else {
+    well_ts_type * well_ts = well_info_get_ts( well_info , well_name );
+    return well_ts_get_state_from_sim_time( well_ts , sim_time );
+  }
 }
 
 
 well_state_type * well_info_get_state_from_report( const well_info_type * well_info , const char * well_name , int report_step ) {
-  well_ts_type * well_ts = well_info_get_ts( well_info , well_name );
-  return well_ts_get_state_from_report( well_ts , report_step);
+  if (well_info->lazy) {
+    const well_info_lazy_well_type * lazy_well = well_info_lazy_get_well( well_info->lazy , well_name );
+    int index = well_info_lazy_well_get_index( lazy_well , report_step , -1 , true );
+    return well_info_lazy_iget_state( well_info->lazy , well_info->grid , lazy_well , index );
+  } else {
+    well_ts_type * well_ts = well_info_get_ts( well_info , well_name );
+    return well_ts_get_state_from_report( well_ts , report_step);
+  }
 }
 
 well_state_type * well_info_iget_state( const well_info_type * well_info , const char * well_name , int time_index) {
-  well_ts_type * well_ts = well_info_get_ts( well_info , well_name );
-  return well_ts_iget_state( well_ts , time_index);
+  if (well_info->lazy) {
+    const well_info_lazy_well_type * lazy_well = well_info_lazy_get_well( well_info->lazy , well_name );
+    if (time_index < 0 || time_index >= vector_get_size( lazy_well->nodes ))
+      util_abort("%s: invalid time_index:%d for well:%s \n",__func__ , time_index , well_name);
+    return well_info_lazy_iget_state( well_info->lazy , well_info->grid , lazy_well , time_index );
+  } else {
+    well_ts_type * well_ts = well_info_get_ts( well_info , well_name );
+    return well_ts_iget_state( well_ts , time_index);
+  }
 }
 
 well_state_type * well_info_iiget_state( const well_info_type * well_info , int well_index , int time_index) {
@@ -221,7 +221,7 @@ static int well_ts_get_index( const well_ts_type * well_ts , int report_step , t
   // Inline check that the index is correct
   {
     bool OK = true;
-    const well_node_type * node = vector_iget_const( well_ts->ts , index );
+    const well_node_type * node = vector_iget_const( well_ts->ts , util_int_max( 0 , index ));  // index == -1: Compare with the first node.
     well_node_type * next_node = NULL;
 
     if (index < (vector_get_size( well_ts->ts ) - 1))
@@ -129,6 +129,17 @@ extern "C" {
   ecl_file_type      * ecl_file_open_rstblock_report_step( const char * filename , int report_step , int flags);
   ecl_file_type      * ecl_file_open_rstblock_sim_time( const char * filename , time_t sim_time , int flags);
   ecl_file_type      * ecl_file_iopen_rstblock( const char * filename , int seqnum_index , int flags);
+  bool                 ecl_file_write_rstblock_index( const char * filename );
+  ecl_file_type      * ecl_file_open_restart_case( const char * case_input , int max_open_streams , int flags);
+  int                  ecl_file_get_num_open_streams( const ecl_file_type * ecl_file );
+
+  void                 ecl_file_set_memory_budget( ecl_file_type * ecl_file , size_t budget);
+  void                 ecl_file_release_kw( ecl_file_type * ecl_file , const ecl_kw_type * ecl_kw);
+  size_t               ecl_file_get_memory_budget( const ecl_file_type * ecl_file );
+  size_t               ecl_file_get_resident_bytes( const ecl_file_type * ecl_file );
+  size_t               ecl_file_get_cache_hits( const ecl_file_type * ecl_file );
+  size_t               ecl_file_get_cache_misses( const ecl_file_type * ecl_file );
+  size_t               ecl_file_get_cache_evictions( const ecl_file_type * ecl_file );
 
 
 #ifdef __cplusplus
@@ -32,10 +32,24 @@ extern "C" {
 
 typedef struct ecl_file_kw_struct ecl_file_kw_type;
 typedef struct inv_map_struct inv_map_type;
+typedef struct ecl_file_kw_cache_struct ecl_file_kw_cache_type;
 
   inv_map_type     * inv_map_alloc(void);
   ecl_file_kw_type * inv_map_get_file_kw( inv_map_type * inv_map , const ecl_kw_type * ecl_kw );
   void               inv_map_free( inv_map_type * map );
+  ecl_file_kw_cache_type * ecl_file_kw_cache_alloc( inv_map_type * inv_map );
+  void                     ecl_file_kw_cache_free( ecl_file_kw_cache_type * cache );
+  void                     ecl_file_kw_cache_touch( ecl_file_kw_cache_type * cache , ecl_file_kw_type * file_kw , bool loaded);
+  void                     ecl_file_kw_cache_release( ecl_file_kw_cache_type * cache , ecl_file_kw_type * file_kw );
+  void                     ecl_file_kw_cache_set_budget( ecl_file_kw_cache_type * cache , size_t budget);
+  size_t                   ecl_file_kw_cache_get_budget( const ecl_file_kw_cache_type * cache );
+  size_t                   ecl_file_kw_cache_get_resident_bytes( const ecl_file_kw_cache_type * cache );
+  size_t                   ecl_file_kw_cache_get_hits( const ecl_file_kw_cache_type * cache );
+  size_t                   ecl_file_kw_cache_get_misses( const ecl_file_kw_cache_type * cache );
+  size_t                   ecl_file_kw_cache_get_evictions( const ecl_file_kw_cache_type * cache );
+  void                     ecl_file_kw_cache_start_transaction( ecl_file_kw_cache_type * cache );
+  void                     ecl_file_kw_cache_end_transaction( ecl_file_kw_cache_type * cache );
+
   bool               ecl_file_kw_equal( const ecl_file_kw_type * kw1 , const ecl_file_kw_type * kw2);
   ecl_file_kw_type * ecl_file_kw_alloc( const ecl_kw_type * ecl_kw , offset_type offset);
   ecl_file_kw_type * ecl_file_kw_alloc0( const char * header , ecl_data_type data_type , int size , offset_type offset);
@@ -44,10 +58,15 @@ typedef struct inv_map_struct inv_map_type;
   ecl_kw_type      * ecl_file_kw_get_kw( ecl_file_kw_type * file_kw , fortio_type * fortio, inv_map_type * inv_map);
   ecl_kw_type      * ecl_file_kw_get_kw_ptr( ecl_file_kw_type * file_kw );
   ecl_file_kw_type * ecl_file_kw_alloc_copy( const ecl_file_kw_type * src );
+  ecl_file_kw_type * ecl_file_kw_alloc_memory( ecl_kw_type * ecl_kw );
+  void               ecl_file_kw_set_fortio( ecl_file_kw_type * file_kw , fortio_type * fortio );
+  fortio_type      * ecl_file_kw_get_fortio( const ecl_file_kw_type * file_kw );
+  bool               ecl_file_kw_is_memory( const ecl_file_kw_type * file_kw );
   const char       * ecl_file_kw_get_header( const ecl_file_kw_type * file_kw );
   int                ecl_file_kw_get_size( const ecl_file_kw_type * file_kw );
   ecl_data_type      ecl_file_kw_get_data_type(const ecl_file_kw_type *);
   offset_type        ecl_file_kw_get_offset(const ecl_file_kw_type * file_kw);
+  ecl_kw_type      * ecl_file_kw_fread_alloc_copy( const ecl_file_kw_type * file_kw , fortio_type * fortio );
   bool               ecl_file_kw_ptr_eq( const ecl_file_kw_type * file_kw , const ecl_kw_type * ecl_kw);
   void               ecl_file_kw_replace_kw( ecl_file_kw_type * file_kw , fortio_type * target , ecl_kw_type * new_kw );
   bool               ecl_file_kw_fskip_data( const ecl_file_kw_type * file_kw , fortio_type * fortio);
@@ -57,8 +76,8 @@ typedef struct inv_map_struct inv_map_type;
   ecl_file_kw_type ** ecl_file_kw_fread_alloc_multiple( FILE * stream , int num);
   ecl_file_kw_type *  ecl_file_kw_fread_alloc( FILE * stream );
 
-  void                ecl_file_kw_start_transaction(const ecl_file_kw_type * file_kw, int * ref_count);
-  void                ecl_file_kw_end_transaction(ecl_file_kw_type * file_kw, int ref_count);
+  void                ecl_file_kw_start_transaction(const ecl_file_kw_type * file_kw, int * ref_count, bool * resident);
+  void                ecl_file_kw_end_transaction(ecl_file_kw_type * file_kw, inv_map_type * inv_map , int ref_count, bool resident);
 
 #ifdef __cplusplus
 }
@@ -49,18 +49,32 @@ typedef enum {
 
 typedef struct ecl_file_view_struct ecl_file_view_type;
 typedef struct ecl_file_transaction_struct ecl_file_transaction_type;
+typedef struct ecl_file_stream_pool_struct ecl_file_stream_pool_type;
 
+/* The restart header type is defined in ecl_rsthead.h, which includes this header. */
+struct ecl_rsthead_struct;
+
+
+  ecl_file_stream_pool_type * ecl_file_stream_pool_alloc( int max_open );
+  void                        ecl_file_stream_pool_free( ecl_file_stream_pool_type * pool );
+  int                         ecl_file_stream_pool_get_num_open( const ecl_file_stream_pool_type * pool );
+  bool                        ecl_file_stream_pool_assert_open( ecl_file_stream_pool_type * pool , fortio_type * fortio );
 
   bool ecl_file_view_flags_set( const ecl_file_view_type * file_view, int query_flags);
   bool ecl_file_view_check_flags( int state_flags , int query_flags);
 
   ecl_file_view_type      * ecl_file_view_alloc( fortio_type * fortio , int * flags , inv_map_type * inv_map , bool owner );
+  void                      ecl_file_view_set_stream_pool( ecl_file_view_type * ecl_file_view , ecl_file_stream_pool_type * stream_pool );
+  void                      ecl_file_view_set_kw_cache( ecl_file_view_type * ecl_file_view , ecl_file_kw_cache_type * kw_cache );
+  void                      ecl_file_view_release_kw( ecl_file_view_type * ecl_file_view , const ecl_kw_type * ecl_kw);
   int                       ecl_file_view_get_global_index( const ecl_file_view_type * ecl_file_view , const char * kw , int ith);
   void                      ecl_file_view_make_index( ecl_file_view_type * ecl_file_view );
   bool                      ecl_file_view_has_kw( const ecl_file_view_type * ecl_file_view, const char * kw);
   ecl_file_kw_type        * ecl_file_view_iget_file_kw( const ecl_file_view_type * ecl_file_view , int global_index);
   ecl_file_kw_type        * ecl_file_view_iget_named_file_kw( const ecl_file_view_type * ecl_file_view , const char * kw, int ith);
   ecl_kw_type             * ecl_file_view_iget_kw( const ecl_file_view_type * ecl_file_view , int index);
+  ecl_kw_type             * ecl_file_view_iget_kw_copy( const ecl_file_view_type * ecl_file_view , int index , fortio_type ** fortio);
+  const char              * ecl_file_view_iget_src_file( const ecl_file_view_type * ecl_file_view , int index);
   void                      ecl_file_view_index_fload_kw(const ecl_file_view_type * ecl_file_view, const char* kw, int index, const int_vector_type * index_map, char* buffer);
   int                       ecl_file_view_find_kw_value( const ecl_file_view_type * ecl_file_view , const char * kw , const void * value);
   const char              * ecl_file_view_iget_distinct_kw( const ecl_file_view_type * ecl_file_view , int index);
@@ -92,12 +106,17 @@ typedef struct ecl_file_transaction_struct ecl_file_transaction_type;
   void ecl_file_view_add_flag( ecl_file_view_type * file_view , int flag);
 
   int    ecl_file_view_seqnum_index_from_sim_time( ecl_file_view_type * parent_map , time_t sim_time);
+  int    ecl_file_view_seqnum_index_from_sim_days( ecl_file_view_type * file_view , double sim_days);
   bool   ecl_file_view_has_sim_time( const ecl_file_view_type * ecl_file_view , time_t sim_time);
+  bool   ecl_file_view_has_sim_days( const ecl_file_view_type * ecl_file_view , double sim_days);
   int    ecl_file_view_find_sim_time(const ecl_file_view_type * ecl_file_view , time_t sim_time);
   double ecl_file_view_iget_restart_sim_days(const ecl_file_view_type * ecl_file_view , int seqnum_index);
   time_t ecl_file_view_iget_restart_sim_date(const ecl_file_view_type * ecl_file_view , int seqnum_index);
   bool   ecl_file_view_has_report_step( const ecl_file_view_type * ecl_file_view , int report_step);
 
+  const struct ecl_rsthead_struct * ecl_file_view_iget_rsthead( const ecl_file_view_type * ecl_file_view , int seqnum_index);
+  bool                              ecl_file_view_has_rsthead_table( const ecl_file_view_type * ecl_file_view );
+
   ecl_file_view_type * ecl_file_view_add_summary_view( ecl_file_view_type * file_view , int report_step );
   const char *         ecl_file_view_get_src_file( const ecl_file_view_type * file_view );
   void                 ecl_file_view_fclose_stream( ecl_file_view_type * file_view );
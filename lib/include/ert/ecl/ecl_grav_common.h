@@ -39,6 +39,16 @@ double ecl_grav_common_eval_biot_savart(const ecl_grid_cache_type * grid_cache,
                                         double utm_y,
                                         double depth);
 
+void ecl_grav_common_eval_biot_savart_stations(const ecl_grid_cache_type * grid_cache,
+                                               ecl_region_type * region,
+                                               const bool * aquifer,
+                                               const double * weight,
+                                               int num_stations,
+                                               const double * utm_x,
+                                               const double * utm_y,
+                                               const double * depth,
+                                               double * result);
+
 double ecl_grav_common_eval_geertsma(const ecl_grid_cache_type * grid_cache,
                                      ecl_region_type * region,
                                      const bool * aquifer,
@@ -49,6 +59,27 @@ double ecl_grav_common_eval_geertsma(const ecl_grid_cache_type * grid_cache,
                                      double poisson_ratio,
                                      double seabed);
 
+void ecl_grav_common_eval_geertsma_stations(const ecl_grid_cache_type * grid_cache,
+                                            ecl_region_type * region,
+                                            const bool * aquifer,
+                                            const double * weight,
+                                            int num_stations,
+                                            const double * utm_x,
+                                            const double * utm_y,
+                                            const double * depth,
+                                            double poisson_ratio,
+                                            double seabed,
+                                            double * result);
+
+double ecl_grav_common_geertsma_displacement(double x,
+                                             double y,
+                                             double z,
+                                             double utm_x,
+                                             double utm_y,
+                                             double depth,
+                                             double poisson_ratio,
+                                             double seabed);
+
 #ifdef __cplusplus
 }
 
@@ -0,0 +1,68 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grav_tree.h' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_GRAV_TREE_H
+#define ERT_ECL_GRAV_TREE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdbool.h>
+
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_grid_cache.h>
+#include <ert/ecl/ecl_region.h>
+
+#define ECL_GRAV_TREE_LEAF_SIZE 32
+
+typedef struct ecl_grav_tree_struct ecl_grav_tree_type;
+
+ecl_grav_tree_type * ecl_grav_tree_alloc(const ecl_grid_cache_type * grid_cache,
+                                         ecl_region_type * region,
+                                         const bool * aquifer,
+                                         const double * weight,
+                                         int leaf_size);
+
+void ecl_grav_tree_free(ecl_grav_tree_type * tree);
+int  ecl_grav_tree_get_size(const ecl_grav_tree_type * tree);
+int  ecl_grav_tree_get_num_nodes(const ecl_grav_tree_type * tree);
+
+double ecl_grav_tree_eval_biot_savart(const ecl_grav_tree_type * tree,
+                                      double theta,
+                                      double utm_x,
+                                      double utm_y,
+                                      double depth,
+                                      double * error_bound);
+
+double ecl_grav_tree_eval_geertsma(const ecl_grav_tree_type * tree,
+                                   double theta,
+                                   double utm_x,
+                                   double utm_y,
+                                   double depth,
+                                   double poisson_ratio,
+                                   double seabed,
+                                   double * error_bound);
+
+UTIL_IS_INSTANCE_HEADER( ecl_grav_tree );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,56 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_grdecl_file.h' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_GRDECL_FILE_H
+#define ERT_ECL_GRDECL_FILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdbool.h>
+
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_type.h>
+#include <ert/ecl/ecl_grid.h>
+
+typedef struct ecl_grdecl_file_struct ecl_grdecl_file_type;
+
+ecl_grdecl_file_type * ecl_grdecl_file_open(const char * filename);
+void                   ecl_grdecl_file_close(ecl_grdecl_file_type * grdecl_file);
+const char           * ecl_grdecl_file_get_src_file(const ecl_grdecl_file_type * grdecl_file);
+int                    ecl_grdecl_file_get_size(const ecl_grdecl_file_type * grdecl_file);
+const char           * ecl_grdecl_file_iget_header(const ecl_grdecl_file_type * grdecl_file, int index);
+bool                   ecl_grdecl_file_has_kw(const ecl_grdecl_file_type * grdecl_file, const char * kw);
+int                    ecl_grdecl_file_get_num_named_kw(const ecl_grdecl_file_type * grdecl_file, const char * kw);
+int                    ecl_grdecl_file_get_global_index(const ecl_grdecl_file_type * grdecl_file, const char * kw, int occurence);
+
+ecl_kw_type * ecl_grdecl_file_iget_kw__(const ecl_grdecl_file_type * grdecl_file, int index, bool strict, int size, ecl_data_type data_type);
+ecl_kw_type * ecl_grdecl_file_iget_kw(const ecl_grdecl_file_type * grdecl_file, int index, ecl_data_type data_type);
+ecl_kw_type * ecl_grdecl_file_iget_named_kw(const ecl_grdecl_file_type * grdecl_file, const char * kw, int occurence, int size, ecl_data_type data_type);
+
+ecl_grid_type * ecl_grdecl_file_alloc_grid(const ecl_grdecl_file_type * grdecl_file);
+
+UTIL_IS_INSTANCE_HEADER( ecl_grdecl_file );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -105,6 +105,8 @@ extern "C" {
 
   const nnc_info_type * ecl_grid_get_cell_nnc_info3( const ecl_grid_type * grid , int i , int j , int k);
   const nnc_info_type * ecl_grid_get_cell_nnc_info1( const ecl_grid_type * grid , int global_index);
+  int                   ecl_grid_get_num_nnc_csr( const ecl_grid_type * grid );
+  int                   ecl_grid_iget_nnc_csr( const ecl_grid_type * grid , int index , const int ** offset , const int ** grid_index , const int ** nnc_index);
   void                  ecl_grid_add_self_nnc( ecl_grid_type * grid1, int g1, int g2, int nnc_index);
   void                  ecl_grid_add_self_nnc_list( ecl_grid_type * grid, const int * g1_list , const int * g2_list , int num_nnc );
 
@@ -220,6 +222,10 @@ extern "C" {
   int              ecl_grid_zcorn_index__(int nx, int ny , int i, int j , int k , int c);
   int              ecl_grid_zcorn_index(const ecl_grid_type * grid , int i, int j , int k , int c);
   ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes );
+  ecl_grid_type * ecl_grid_alloc_EGRID_lazy(const char * grid_file, bool apply_mapaxes, int cache_size );
+  bool            ecl_grid_is_lazy( const ecl_grid_type * grid );
+  ecl_grid_type * ecl_grid_alloc_snapshot( const char * filename );
+  void            ecl_grid_fwrite_snapshot( const ecl_grid_type * grid , const char * filename );
   ecl_grid_type * ecl_grid_alloc_GRID(const char * grid_file, bool apply_mapaxes );
 
   float          * ecl_grid_alloc_zcorn_data( const ecl_grid_type * grid );
@@ -255,6 +261,17 @@ extern "C" {
   void ecl_grid_compressed_kw_copy( const ecl_grid_type * grid , ecl_kw_type * target_kw , const ecl_kw_type * src_kw);
   void ecl_grid_global_kw_copy( const ecl_grid_type * grid , ecl_kw_type * target_kw , const ecl_kw_type * src_kw);
 
+  void ecl_grid_gather_int( const ecl_grid_type * grid , const int * global_data , int * active_data);
+  void ecl_grid_gather_float( const ecl_grid_type * grid , const float * global_data , float * active_data);
+  void ecl_grid_gather_double( const ecl_grid_type * grid , const double * global_data , double * active_data);
+  void ecl_grid_gather_bool( const ecl_grid_type * grid , const bool * global_data , bool * active_data);
+  void ecl_grid_scatter_int( const ecl_grid_type * grid , const int * active_data , int * global_data , const int * default_value);
+  void ecl_grid_scatter_float( const ecl_grid_type * grid , const float * active_data , float * global_data , const float * default_value);
+  void ecl_grid_scatter_double( const ecl_grid_type * grid , const double * active_data , double * global_data , const double * default_value);
+  void ecl_grid_scatter_bool( const ecl_grid_type * grid , const bool * active_data , bool * global_data , const bool * default_value);
+  void ecl_grid_gather_kw( const ecl_grid_type * grid , const ecl_kw_type * global_kw , ecl_kw_type * active_kw);
+  void ecl_grid_scatter_kw( const ecl_grid_type * grid , const ecl_kw_type * active_kw , ecl_kw_type * global_kw , const void * default_value);
+
   UTIL_IS_INSTANCE_HEADER( ecl_grid );
   UTIL_SAFE_CAST_HEADER( ecl_grid );
 
@@ -30,6 +30,11 @@ extern "C" {
 
 
   ecl_grid_cache_type  * ecl_grid_cache_alloc( const ecl_grid_type * grid );
+  ecl_grid_cache_type  * ecl_grid_cache_fread_alloc( const ecl_grid_type * grid , const char * filename );
+  void                   ecl_grid_cache_fwrite( const ecl_grid_cache_type * grid_cache , const char * filename );
+  char                 * ecl_grid_cache_alloc_filename( const char * grid_file );
+  void                   ecl_grid_cache_incref( ecl_grid_cache_type * grid_cache );
+  int                    ecl_grid_cache_get_refcount( const ecl_grid_cache_type * grid_cache );
   int                    ecl_grid_cache_get_size( const ecl_grid_cache_type * grid_cache );
   int                    ecl_grid_cache_iget_global_index( const ecl_grid_cache_type * grid_cache , int active_index);
   const int            * ecl_grid_cache_get_global_index( const ecl_grid_cache_type * grid_cache );
@@ -38,6 +43,9 @@ extern "C" {
   const double         * ecl_grid_cache_get_zpos( const ecl_grid_cache_type * grid_cache );
   const double         * ecl_grid_cache_get_volume( const ecl_grid_cache_type * grid_cache );
   void                   ecl_grid_cache_free( ecl_grid_cache_type * grid_cache );
+  void                   ecl_grid_cache_detach( ecl_grid_cache_type * grid_cache );
+
+  ecl_grid_cache_type  * ecl_grid_get_cache( const ecl_grid_type * grid );
 
 
 #ifdef __cplusplus
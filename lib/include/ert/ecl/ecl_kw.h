@@ -146,6 +146,8 @@ extern "C" {
 
   int        ecl_kw_element_sum_int( const ecl_kw_type * ecl_kw );
   double     ecl_kw_element_sum_float( const ecl_kw_type * ecl_kw );
+  double     ecl_kw_element_sum_kahan( const ecl_kw_type * ecl_kw );
+  double     ecl_kw_element_sum_indexed_kahan( const ecl_kw_type * ecl_kw , const int_vector_type * index_list);
   void       ecl_kw_inplace_inv(ecl_kw_type * my_kw);
   void       ecl_kw_element_sum(const ecl_kw_type * , void * );
   void ecl_kw_element_sum_indexed(const ecl_kw_type * ecl_kw , const int_vector_type * index_list, void * _sum);
@@ -0,0 +1,74 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_kw_diff.h' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_KW_DIFF_H
+#define ERT_ECL_KW_DIFF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+
+typedef enum {
+  ECL_KW_DIFF_EQUAL         = 0,
+  ECL_KW_DIFF_VALUES        = 1,   /* Same type and size - but some values differ. */
+  ECL_KW_DIFF_TYPE_MISMATCH = 2,
+  ECL_KW_DIFF_SIZE_MISMATCH = 3,
+  ECL_KW_DIFF_MISSING1      = 4,   /* The keyword is only present in the second file. */
+  ECL_KW_DIFF_MISSING2      = 5    /* The keyword is only present in the first file. */
+} ecl_kw_diff_status_enum;
+
+
+typedef struct ecl_kw_diff_struct   ecl_kw_diff_type;
+typedef struct ecl_file_diff_struct ecl_file_diff_type;
+
+ecl_kw_diff_type * ecl_kw_diff_alloc(const ecl_kw_type * kw1, const ecl_kw_type * kw2, double abs_epsilon, double rel_epsilon);
+void               ecl_kw_diff_free(ecl_kw_diff_type * diff);
+const char       * ecl_kw_diff_get_header(const ecl_kw_diff_type * diff);
+int                ecl_kw_diff_get_occurence(const ecl_kw_diff_type * diff);
+ecl_kw_diff_status_enum ecl_kw_diff_get_status(const ecl_kw_diff_type * diff);
+bool               ecl_kw_diff_equal(const ecl_kw_diff_type * diff);
+int                ecl_kw_diff_get_size(const ecl_kw_diff_type * diff);
+int                ecl_kw_diff_get_count(const ecl_kw_diff_type * diff);
+int                ecl_kw_diff_get_first_index(const ecl_kw_diff_type * diff);
+double             ecl_kw_diff_get_max_abs_diff(const ecl_kw_diff_type * diff);
+double             ecl_kw_diff_get_max_rel_diff(const ecl_kw_diff_type * diff);
+void               ecl_kw_diff_fprintf(const ecl_kw_diff_type * diff, FILE * stream);
+
+ecl_file_diff_type     * ecl_file_diff_alloc(ecl_file_type * file1, ecl_file_type * file2, double abs_epsilon, double rel_epsilon);
+void                     ecl_file_diff_free(ecl_file_diff_type * diff);
+int                      ecl_file_diff_get_size(const ecl_file_diff_type * diff);
+const ecl_kw_diff_type * ecl_file_diff_iget(const ecl_file_diff_type * diff, int index);
+int                      ecl_file_diff_get_num_different(const ecl_file_diff_type * diff);
+bool                     ecl_file_diff_equal(const ecl_file_diff_type * diff);
+void                     ecl_file_diff_fprintf(const ecl_file_diff_type * diff, FILE * stream, bool print_equal);
+
+UTIL_IS_INSTANCE_HEADER( ecl_kw_diff );
+UTIL_IS_INSTANCE_HEADER( ecl_file_diff );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
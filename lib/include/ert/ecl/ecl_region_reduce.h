@@ -0,0 +1,69 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_region_reduce.h' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_REGION_REDUCE_H
+#define ERT_ECL_REGION_REDUCE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdbool.h>
+
+#include <ert/util/type_macros.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+
+typedef struct ecl_region_reduce_struct ecl_region_reduce_type;
+
+typedef void (ecl_region_reduce_step_ftype) (const ecl_region_reduce_type * reducer, int report_step, void * arg);
+
+ecl_region_reduce_type * ecl_region_reduce_alloc(const ecl_grid_type * grid, const ecl_kw_type * region_kw);
+void   ecl_region_reduce_free(ecl_region_reduce_type * reducer);
+
+void   ecl_region_reduce_eval(ecl_region_reduce_type * reducer,
+                              int num_fields,
+                              const ecl_kw_type ** field_kw,
+                              const ecl_kw_type ** weight_kw);
+
+void   ecl_region_reduce_eval_restart(ecl_region_reduce_type * reducer,
+                                      ecl_file_type * restart_file,
+                                      const stringlist_type * fields,
+                                      const ecl_kw_type * weight_kw,
+                                      const char * restart_weight_kw,
+                                      ecl_region_reduce_step_ftype * step_callback,
+                                      void * arg);
+
+int    ecl_region_reduce_get_num_fields(const ecl_region_reduce_type * reducer);
+int    ecl_region_reduce_get_max_region(const ecl_region_reduce_type * reducer);
+int    ecl_region_reduce_iget_count(const ecl_region_reduce_type * reducer, int region);
+double ecl_region_reduce_iget_sum(const ecl_region_reduce_type * reducer, int field, int region);
+double ecl_region_reduce_iget_weight(const ecl_region_reduce_type * reducer, int field, int region);
+double ecl_region_reduce_iget_mean(const ecl_region_reduce_type * reducer, int field, int region);
+double ecl_region_reduce_iget_min(const ecl_region_reduce_type * reducer, int field, int region);
+double ecl_region_reduce_iget_max(const ecl_region_reduce_type * reducer, int field, int region);
+
+UTIL_IS_INSTANCE_HEADER( ecl_region_reduce );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -24,6 +24,7 @@ extern "C" {
 #include <stdbool.h>
 
 #include <ert/util/stringlist.h>
+#include <ert/util/type_macros.h>
 
 #include <ert/ecl/ecl_rft_node.h>
 #include <ert/util/vector.h>
@@ -53,6 +54,10 @@ stringlist_type         * ecl_rft_file_alloc_well_list(const ecl_rft_file_type *
 int                       ecl_rft_file_get_num_wells( const ecl_rft_file_type * rft_file );
 void                      ecl_rft_file_free__( void * arg);
 void                      ecl_rft_file_update(const char * rft_file_name,  ecl_rft_node_type ** nodes,int num_nodes, ert_ecl_unit_enum unit_set);
+void                      ecl_rft_file_append(const char * rft_file_name,  ecl_rft_node_type ** nodes,int num_nodes, ert_ecl_unit_enum unit_set);
+void                      ecl_rft_file_compact(const char * rft_file_name, ert_ecl_unit_enum unit_set);
+
+UTIL_IS_INSTANCE_HEADER( ecl_rft_file );
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,58 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'ecl_rst_series.h' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_RST_SERIES_H
+#define ERT_ECL_RST_SERIES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdbool.h>
+#include <time.h>
+
+#include <ert/util/type_macros.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/int_vector.h>
+
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+
+typedef struct ecl_rst_series_struct ecl_rst_series_type;
+
+ecl_rst_series_type * ecl_rst_series_alloc(ecl_file_type * restart_file,
+                                           const ecl_grid_type * grid,
+                                           const stringlist_type * kw_list,
+                                           const int_vector_type * cells,
+                                           bool global_cells);
+
+void           ecl_rst_series_free(ecl_rst_series_type * series);
+int            ecl_rst_series_get_num_steps(const ecl_rst_series_type * series);
+int            ecl_rst_series_get_num_cells(const ecl_rst_series_type * series);
+int            ecl_rst_series_iget_report_step(const ecl_rst_series_type * series, int step);
+time_t         ecl_rst_series_iget_sim_time(const ecl_rst_series_type * series, int step);
+bool           ecl_rst_series_has_kw(const ecl_rst_series_type * series, const char * kw);
+const double * ecl_rst_series_get_data(const ecl_rst_series_type * series, const char * kw);
+double         ecl_rst_series_iget(const ecl_rst_series_type * series, const char * kw, int step, int cell);
+
+UTIL_IS_INSTANCE_HEADER( ecl_rst_series );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -30,7 +30,7 @@ extern "C" {
 #include <ert/ecl/ecl_kw.h>
 
 
-  typedef struct {
+  typedef struct ecl_rsthead_struct {
     // The report step is from the SEQNUM keyword for unified files,
     // and inferred from the filename for non unified files.
     int    report_step;
@@ -28,6 +28,8 @@ extern "C" {
 #include <ert/ecl/ecl_grid.h>
 #include <ert/ecl/ecl_region.h>
 
+#include <ert/geometry/geo_surface.h>
+
   typedef struct ecl_subsidence_struct            ecl_subsidence_type;
   typedef struct ecl_subsidence_survey_struct     ecl_subsidence_survey_type;
   
@@ -43,6 +45,34 @@ extern "C" {
                                                     ecl_region_type * region , 
                                                     double utm_x, double utm_y , double depth, double compressibility, double poisson_ratio);
 
+  double                       ecl_subsidence_eval_geertsma( const ecl_subsidence_type * subsidence ,
+                                                             const char * base, const char * monitor ,
+                                                             ecl_region_type * region ,
+                                                             double utm_x, double utm_y , double depth,
+                                                             double youngs_modulus, double poisson_ratio, double seabed);
+
+  void                         ecl_subsidence_eval_geertsma_stations( const ecl_subsidence_type * subsidence ,
+                                                                      const char * base, const char * monitor ,
+                                                                      ecl_region_type * region ,
+                                                                      int num_stations ,
+                                                                      const double * utm_x, const double * utm_y , const double * depth,
+                                                                      double youngs_modulus, double poisson_ratio, double seabed,
+                                                                      double * deltaz);
+
+  void                         ecl_subsidence_eval_geertsma_stations_approx( const ecl_subsidence_type * subsidence ,
+                                                                             const char * base, const char * monitor ,
+                                                                             ecl_region_type * region ,
+                                                                             int num_stations ,
+                                                                             const double * utm_x, const double * utm_y , const double * depth,
+                                                                             double youngs_modulus, double poisson_ratio, double seabed,
+                                                                             double theta , double * deltaz , double * error_bound);
+
+  void                         ecl_subsidence_eval_geertsma_surface( const ecl_subsidence_type * subsidence ,
+                                                                     const char * base, const char * monitor ,
+                                                                     ecl_region_type * region ,
+                                                                     geo_surface_type * surface , double depth,
+                                                                     double youngs_modulus, double poisson_ratio, double seabed);
+
 
 #ifdef __plusplus
 }
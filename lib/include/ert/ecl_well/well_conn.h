@@ -53,6 +53,8 @@ extern "C" {
 
   bool             well_conn_MSW(const well_conn_type * conn);
 
+  well_conn_dir_enum well_conn_translate_icon_dir( int int_direction );
+
   well_conn_type * well_conn_alloc_from_kw( const ecl_kw_type * icon_kw , const ecl_kw_type * scon_kw , const ecl_kw_type* xcon_kw, const ecl_rsthead_type * header , int well_nr , int conn_nr);
   well_conn_type * well_conn_alloc_wellhead( const ecl_kw_type * iwel_kw , const ecl_rsthead_type * header , int well_nr);
 
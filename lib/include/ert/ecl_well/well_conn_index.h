@@ -0,0 +1,66 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'well_conn_index.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_WELL_CONN_INDEX_H
+#define ERT_WELL_CONN_INDEX_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+#include <ert/util/type_macros.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region.h>
+
+#include <ert/ecl_well/well_conn.h>
+#include <ert/ecl_well/well_info.h>
+
+typedef struct well_conn_index_struct well_conn_index_type;
+
+well_conn_index_type * well_conn_index_alloc(const well_info_type * well_info, const ecl_grid_type * grid);
+well_conn_index_type * well_conn_index_alloc_report(const well_info_type * well_info, const ecl_grid_type * grid, int report_step);
+void                   well_conn_index_free(well_conn_index_type * index);
+
+int                    well_conn_index_get_num_wells(const well_conn_index_type * index);
+const char           * well_conn_index_iget_well_name(const well_conn_index_type * index, int well_index);
+int                    well_conn_index_get_total_size(const well_conn_index_type * index);
+
+bool                   well_conn_index_has_conn(const well_conn_index_type * index, int global_index);
+int                    well_conn_index_get_size(const well_conn_index_type * index, int global_index);
+int                    well_conn_index_get_size3(const well_conn_index_type * index, int i, int j, int k);
+const char           * well_conn_index_iget_well(const well_conn_index_type * index, int global_index, int conn_nr);
+int                    well_conn_index_iget_well_index(const well_conn_index_type * index, int global_index, int conn_nr);
+int                    well_conn_index_iget_report_nr(const well_conn_index_type * index, int global_index, int conn_nr);
+const well_conn_type * well_conn_index_iget_conn(const well_conn_index_type * index, int global_index, int conn_nr);
+
+int                    well_conn_index_get_region_size(const well_conn_index_type * index, ecl_region_type * region);
+int_vector_type      * well_conn_index_alloc_region_cells(const well_conn_index_type * index, ecl_region_type * region);
+stringlist_type      * well_conn_index_alloc_region_wells(const well_conn_index_type * index, ecl_region_type * region);
+
+UTIL_IS_INSTANCE_HEADER(well_conn_index);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
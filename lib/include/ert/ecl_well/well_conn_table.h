@@ -0,0 +1,86 @@
+/*
+   Copyright (C) 2017  Statoil ASA, Norway.
+
+   The file 'well_conn_table.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_WELL_CONN_TABLE_H
+#define ERT_WELL_CONN_TABLE_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <time.h>
+
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_view.h>
+
+#include <ert/ecl_well/well_conn.h>
+
+typedef struct well_conn_table_struct well_conn_table_type;
+
+well_conn_table_type * well_conn_table_alloc_from_view(const ecl_file_view_type * rst_view, int report_nr);
+well_conn_table_type * well_conn_table_alloc_from_file(ecl_file_type * rst_file, int report_nr);
+void                   well_conn_table_free(well_conn_table_type * table);
+void                   well_conn_table_free__(void * arg);
+
+int                    well_conn_table_get_report_nr(const well_conn_table_type * table);
+time_t                 well_conn_table_get_sim_time(const well_conn_table_type * table);
+int                    well_conn_table_get_size(const well_conn_table_type * table);
+int                    well_conn_table_get_num_wells(const well_conn_table_type * table);
+const char           * well_conn_table_iget_well_name(const well_conn_table_type * table, int well_nr);
+int                    well_conn_table_get_well_nr(const well_conn_table_type * table, const char * well_name);
+int                    well_conn_table_iget_well_offset(const well_conn_table_type * table, int well_nr);
+int                    well_conn_table_iget_well_size(const well_conn_table_type * table, int well_nr);
+
+int                    well_conn_table_iget_well(const well_conn_table_type * table, int row);
+int                    well_conn_table_iget_i(const well_conn_table_type * table, int row);
+int                    well_conn_table_iget_j(const well_conn_table_type * table, int row);
+int                    well_conn_table_iget_k(const well_conn_table_type * table, int row);
+int                    well_conn_table_iget_segment_id(const well_conn_table_type * table, int row);
+well_conn_dir_enum     well_conn_table_iget_dir(const well_conn_table_type * table, int row);
+bool                   well_conn_table_iget_open(const well_conn_table_type * table, int row);
+bool                   well_conn_table_iget_matrix_connection(const well_conn_table_type * table, int row);
+double                 well_conn_table_iget_connection_factor(const well_conn_table_type * table, int row);
+double                 well_conn_table_iget_oil_rate(const well_conn_table_type * table, int row);
+double                 well_conn_table_iget_gas_rate(const well_conn_table_type * table, int row);
+double                 well_conn_table_iget_water_rate(const well_conn_table_type * table, int row);
+double                 well_conn_table_iget_volume_rate(const well_conn_table_type * table, int row);
+
+const int                * well_conn_table_get_well_ptr(const well_conn_table_type * table);
+const int                * well_conn_table_get_i_ptr(const well_conn_table_type * table);
+const int                * well_conn_table_get_j_ptr(const well_conn_table_type * table);
+const int                * well_conn_table_get_k_ptr(const well_conn_table_type * table);
+const int                * well_conn_table_get_segment_id_ptr(const well_conn_table_type * table);
+const well_conn_dir_enum * well_conn_table_get_dir_ptr(const well_conn_table_type * table);
+const bool               * well_conn_table_get_open_ptr(const well_conn_table_type * table);
+const bool               * well_conn_table_get_matrix_connection_ptr(const well_conn_table_type * table);
+const double             * well_conn_table_get_connection_factor_ptr(const well_conn_table_type * table);
+const double             * well_conn_table_get_oil_rate_ptr(const well_conn_table_type * table);
+const double             * well_conn_table_get_gas_rate_ptr(const well_conn_table_type * table);
+const double             * well_conn_table_get_water_rate_ptr(const well_conn_table_type * table);
+const double             * well_conn_table_get_volume_rate_ptr(const well_conn_table_type * table);
+
+UTIL_IS_INSTANCE_HEADER(well_conn_table);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -40,6 +40,7 @@ extern "C" {
 #define WELL_SEGMENT_BRANCH_MAIN_STEM_VALUE  (WELL_BRANCH_OFFSET  + ECLIPSE_WELL_SEGMENT_BRANCH_MAIN_STEM_VALUE - ECLIPSE_WELL_BRANCH_OFFSET)  //  0
 #define WELL_SEGMENT_BRANCH_INACTIVE_VALUE   (WELL_BRANCH_OFFSET  + ECLIPSE_WELL_SEGMENT_INACTIVE_VALUE         - ECLIPSE_WELL_BRANCH_OFFSET)  // -1
 #define CONN_NORMAL_WELL_SEGMENT_VALUE       (WELL_SEGMENT_OFFSET + ECLIPSE_CONN_NORMAL_WELL_SEGMENT_VALUE      - ECLIPSE_WELL_SEGMENT_OFFSET)
+#define WELL_CONN_NORMAL_WELL_SEGMENT_ID     -999    // The segment_id of a well_conn in a normal (not MSW) well.
 
 
 
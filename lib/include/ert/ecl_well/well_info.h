@@ -32,8 +32,12 @@ extern "C" {
   typedef struct well_info_struct well_info_type;
   
   well_info_type *  well_info_alloc(const ecl_grid_type * grid);
+  well_info_type *  well_info_alloc_lazy(const ecl_grid_type * grid , int cache_size);
+  bool              well_info_is_lazy( const well_info_type * well_info );
   void              well_info_add_UNRST_wells2( well_info_type * well_info , ecl_file_view_type * rst_view, bool load_segment_information);
   void              well_info_add_UNRST_wells( well_info_type * well_info , ecl_file_type * rst_file, bool load_segment_information);
+  void              well_info_add_UNRST_wells_parallel2( well_info_type * well_info , ecl_file_view_type * rst_view, bool load_segment_information);
+  void              well_info_add_UNRST_wells_parallel( well_info_type * well_info , ecl_file_type * rst_file, bool load_segment_information);
   void              well_info_add_wells( well_info_type * well_info , ecl_file_type * rst_file , int report_nr , bool load_segment_information);
   void              well_info_add_wells2( well_info_type * well_info , ecl_file_view_type * rst_view , int report_nr, bool load_segment_information);
   void              well_info_load_rstfile( well_info_type * well_info , const char * filename, bool load_segment_information);
@@ -44,6 +48,7 @@ extern "C" {
   int               well_info_get_num_wells( const well_info_type * well_info );
   const char      * well_info_iget_well_name( const well_info_type * well_info, int well_index);
   bool              well_info_has_well( well_info_type * well_info , const char * well_name );
+  int               well_info_get_well_size( const well_info_type * well_info , const char * well_name );
   
   well_state_type * well_info_get_state_from_time( const well_info_type * well_info , const char * well_name , time_t sim_time);
   well_state_type * well_info_get_state_from_report( const well_info_type * well_info , const char * well_name , int report_step );
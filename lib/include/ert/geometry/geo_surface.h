@@ -39,6 +39,7 @@ extern "C" {
   geo_surface_type  * geo_surface_alloc_new( int nx, int ny, double xinc, double yinc, double xstart, double ystart, double angle );
   bool                geo_surface_fload_irap_zcoord( const geo_surface_type * surface, const char * filename, double *zlist);
   double              geo_surface_iget_zvalue(const geo_surface_type * surface, int index);
+  void                geo_surface_iset_zvalue(geo_surface_type * surface, int index , double value);
   int                 geo_surface_get_size( const geo_surface_type * surface );
   void                geo_surface_fprintf_irap( const geo_surface_type * surface, const char * filename );
   void                geo_surface_fprintf_irap_external_zcoord( const geo_surface_type * surface, const char * filename , const double * zcoord);